@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <arm_acle.h> /* Header provided by the toolchain. */
+
+uint32_t arch_crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+	for (; len >= 8; len -= 8, data += 8) {
+		crc = __crc32d(crc, UNALIGNED_GET((const uint64_t *)data));
+	}
+
+	for (; len > 0; len--) {
+		crc = __crc32b(crc, *data++);
+	}
+
+	return crc;
+}
+
+uint32_t arch_crc32c_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+	for (; len >= 8; len -= 8, data += 8) {
+		crc = __crc32cd(crc, UNALIGNED_GET((const uint64_t *)data));
+	}
+
+	for (; len > 0; len--) {
+		crc = __crc32cb(crc, *data++);
+	}
+
+	return crc;
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+
+/* The SSE4.2 crc32 instruction computes CRC-32C only.  It works on
+ * general purpose registers, so it needs no FPU context.
+ */
+uint32_t arch_crc32c_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+#ifdef CONFIG_X86_64
+	for (; len >= 8; len -= 8, data += 8) {
+		crc = (uint32_t)__builtin_ia32_crc32di(crc,
+				UNALIGNED_GET((const uint64_t *)data));
+	}
+#endif
+
+	for (; len >= 4; len -= 4, data += 4) {
+		crc = __builtin_ia32_crc32si(crc,
+				UNALIGNED_GET((const uint32_t *)data));
+	}
+
+	for (; len > 0; len--) {
+		crc = __builtin_ia32_crc32qi(crc, *data++);
+	}
+
+	return crc;
+}
@@ -75,6 +75,103 @@ int loopback_set_packet_drop_ratio(float ratio)
 }
 #endif
 
+#ifdef CONFIG_NET_LOOPBACK_SIMULATE_DELAY
+/* Packets wait in a ring, in the order they are sent. All have the same
+ * delay so the oldest one is always the first due.
+ */
+static struct {
+	struct net_pkt *pkt;
+	int64_t due;
+} loopback_delayed[CONFIG_NET_PKT_RX_COUNT];
+static uint32_t loopback_delayed_head;
+static uint32_t loopback_delayed_tail;
+static uint32_t loopback_packet_delay;
+static struct k_spinlock loopback_delay_lock;
+
+static void loopback_delay_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(loopback_delay_work, loopback_delay_handler);
+
+int loopback_set_packet_delay(uint32_t delay_ms)
+{
+	loopback_packet_delay = delay_ms;
+	return 0;
+}
+
+static void loopback_delay_handler(struct k_work *work)
+{
+	struct net_pkt *pkt;
+	int64_t now;
+
+	ARG_UNUSED(work);
+
+	while (true) {
+		k_spinlock_key_t key = k_spin_lock(&loopback_delay_lock);
+		uint32_t tail = loopback_delayed_tail;
+
+		now = k_uptime_get();
+
+		if (loopback_delayed_head == tail) {
+			k_spin_unlock(&loopback_delay_lock, key);
+			break;
+		}
+
+		if (loopback_delayed[tail].due > now) {
+			k_work_reschedule(&loopback_delay_work,
+					  K_MSEC(loopback_delayed[tail].due - now));
+			k_spin_unlock(&loopback_delay_lock, key);
+			break;
+		}
+
+		pkt = loopback_delayed[tail].pkt;
+		loopback_delayed_tail = (loopback_delayed_tail + 1) %
+					ARRAY_SIZE(loopback_delayed);
+		k_spin_unlock(&loopback_delay_lock, key);
+
+		if (net_recv_data(net_pkt_iface(pkt), pkt) < 0) {
+			LOG_ERR("Data receive failed.");
+			net_pkt_unref(pkt);
+		}
+	}
+}
+
+/* Queue the packet if a delay is set, returns false if it is to be
+ * received right away.
+ */
+static bool loopback_delay(struct net_pkt *pkt)
+{
+	k_spinlock_key_t key;
+	uint32_t head;
+
+	if (loopback_packet_delay == 0) {
+		return false;
+	}
+
+	key = k_spin_lock(&loopback_delay_lock);
+
+	head = (loopback_delayed_head + 1) % ARRAY_SIZE(loopback_delayed);
+	if (head == loopback_delayed_tail) {
+		/* Queue full, like a congested link drops the packet */
+		k_spin_unlock(&loopback_delay_lock, key);
+		net_pkt_unref(pkt);
+		return true;
+	}
+
+	loopback_delayed[loopback_delayed_head].pkt = pkt;
+	loopback_delayed[loopback_delayed_head].due = k_uptime_get() +
+						      loopback_packet_delay;
+	if (loopback_delayed_head == loopback_delayed_tail) {
+		k_work_reschedule(&loopback_delay_work,
+				  K_MSEC(loopback_packet_delay));
+	}
+
+	loopback_delayed_head = head;
+
+	k_spin_unlock(&loopback_delay_lock, key);
+
+	return true;
+}
+#endif
+
 static int loopback_send(const struct device *dev, struct net_pkt *pkt)
 {
 	struct net_pkt *cloned;
@@ -135,6 +232,14 @@ static int loopback_send(const struct device *dev, struct net_pkt *pkt)
 		goto out;
 	}
 #endif
+
+#ifdef CONFIG_NET_LOOPBACK_SIMULATE_DELAY
+	if (loopback_delay(cloned)) {
+		res = 0;
+		goto out;
+	}
+#endif
+
 	res = net_recv_data(net_pkt_iface(cloned), cloned);
 	if (res < 0) {
 		LOG_ERR("Data receive failed.");
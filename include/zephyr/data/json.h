@@ -48,6 +48,8 @@ enum json_tokens {
 	JSON_TOK_COLON = ':',
 	JSON_TOK_COMMA = ',',
 	JSON_TOK_NUMBER = '0',
+	JSON_TOK_INT64 = '5',
+	JSON_TOK_DOUBLE = '8',
 	JSON_TOK_TRUE = 't',
 	JSON_TOK_FALSE = 'f',
 	JSON_TOK_NULL = 'n',
@@ -69,10 +71,10 @@ struct json_obj_descr {
 	uint32_t field_name_len : 7;
 
 	/* Valid values here (enum json_tokens): JSON_TOK_STRING,
-	 * JSON_TOK_NUMBER, JSON_TOK_TRUE, JSON_TOK_FALSE,
-	 * JSON_TOK_OBJECT_START, JSON_TOK_ARRAY_START.  (All others
-	 * ignored.) Maximum value is '}' (125), so this has to be 7 bits
-	 * long.
+	 * JSON_TOK_NUMBER, JSON_TOK_INT64, JSON_TOK_DOUBLE,
+	 * JSON_TOK_TRUE, JSON_TOK_FALSE, JSON_TOK_OBJECT_START,
+	 * JSON_TOK_ARRAY_START.  (All others ignored.) Maximum value is
+	 * '}' (125), so this has to be 7 bits long.
 	 */
 	uint32_t type : 7;
 
@@ -118,7 +120,9 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
  * @param field_name_ Field name in the struct
  * @param type_ Token type for JSON value corresponding to a primitive
  * type. Must be one of: JSON_TOK_STRING for strings, JSON_TOK_NUMBER
- * for numbers, JSON_TOK_TRUE (or JSON_TOK_FALSE) for booleans.
+ * for int32_t numbers, JSON_TOK_INT64 for int64_t numbers,
+ * JSON_TOK_DOUBLE for double numbers, JSON_TOK_TRUE (or
+ * JSON_TOK_FALSE) for booleans.
  *
  * Here's an example of use:
  *
@@ -544,14 +548,22 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
  * (1) strings are not unescaped (but only valid escape sequences are
  * accepted);
  * (2) no UTF-8 validation is performed; and
- * (3) only integer numbers are supported (no strtod() in the minimal libc).
+ * (3) JSON_TOK_DOUBLE fields need CONFIG_JSON_LIBRARY_FP_SUPPORT, and
+ * are converted without strtod(), which the minimal libc lacks, so the
+ * result may be off by a few units in the last place for values with
+ * more than 15 significant digits or large exponents.
+ *
+ * Keys of small descriptors are looked up starting after the field
+ * matched last, so documents listing their keys in descriptor order are
+ * matched with one comparison per key.  Descriptors with more than eight
+ * fields are hashed on each call, and keys are looked up in the hash.
  *
  * @param json Pointer to JSON-encoded value to be parsed
  * @param len Length of JSON-encoded value
  * @param descr Pointer to the descriptor array
  * @param descr_len Number of elements in the descriptor array. Must be less
  * than 31 due to implementation detail reasons (if more fields are
- * necessary, use two descriptors)
+ * necessary, use json_obj_parse64() or two descriptors)
  * @param val Pointer to the struct to hold the decoded values
  *
  * @return < 0 if error, bitmap of decoded fields on success (bit 0
@@ -561,6 +573,25 @@ int json_obj_parse(char *json, size_t len,
 	const struct json_obj_descr *descr, size_t descr_len,
 	void *val);
 
+/**
+ * @brief Parses the JSON-encoded object pointed to by @a json like
+ * json_obj_parse(), for descriptors with up to 62 fields.
+ *
+ * @param json Pointer to JSON-encoded value to be parsed
+ * @param len Length of JSON-encoded value
+ * @param descr Pointer to the descriptor array
+ * @param descr_len Number of elements in the descriptor array. Must be less
+ * than 63 due to implementation detail reasons (if more fields are
+ * necessary, use two descriptors)
+ * @param val Pointer to the struct to hold the decoded values
+ *
+ * @return < 0 if error, bitmap of decoded fields on success (bit 0
+ * is set if first field in the descriptor has been properly decoded, etc).
+ */
+int64_t json_obj_parse64(char *json, size_t len,
+	const struct json_obj_descr *descr, size_t descr_len,
+	void *val);
+
 /**
  * @brief Parses the JSON-encoded array pointed to by @a json, with
  * size @a len, according to the descriptor pointed to by @a descr.
@@ -583,7 +614,8 @@ int json_obj_parse(char *json, size_t len,
  * (1) strings are not unescaped (but only valid escape sequences are
  * accepted);
  * (2) no UTF-8 validation is performed; and
- * (3) only integer numbers are supported (no strtod() in the minimal libc).
+ * (3) JSON_TOK_DOUBLE elements need CONFIG_JSON_LIBRARY_FP_SUPPORT and
+ * are converted without strtod().
  *
  * @param json Pointer to JSON-encoded array to be parsed
  * @param len Length of JSON-encoded array
@@ -696,6 +728,115 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 int json_arr_encode(const struct json_obj_descr *descr, const void *val,
 		    json_append_bytes_t append_bytes, void *data);
 
+/** Maximum nesting depth of a document fed to the streaming tokenizer */
+#define JSON_STREAM_MAX_DEPTH 32
+
+/**
+ * @brief A token produced by the streaming tokenizer
+ */
+struct json_stream_token {
+	/** One of JSON_TOK_OBJECT_START, JSON_TOK_OBJECT_END,
+	 * JSON_TOK_ARRAY_START, JSON_TOK_ARRAY_END, JSON_TOK_STRING,
+	 * JSON_TOK_NUMBER, JSON_TOK_TRUE, JSON_TOK_FALSE or JSON_TOK_NULL
+	 */
+	enum json_tokens type;
+	/** Set if a JSON_TOK_STRING is an object key */
+	bool key;
+	/** Nesting depth, 0 for the top level value and its delimiters */
+	uint8_t depth;
+	/** Text of a string (without the quotes, not unescaped), number
+	 * or literal.  Not NUL terminated, and only valid during the
+	 * callback.
+	 */
+	const char *value;
+	/** Length of @a value */
+	size_t len;
+};
+
+/**
+ * @brief Callback receiving the tokens of a streamed document
+ *
+ * @param token The token
+ * @param user_data User data passed to json_stream_init()
+ *
+ * @return 0 to go on, or a negative error code to stop tokenizing.
+ * The error is returned by json_stream_feed().
+ */
+typedef int (*json_stream_cb_t)(const struct json_stream_token *token,
+				void *user_data);
+
+/**
+ * @brief Streaming tokenizer state
+ *
+ * All fields are internal.
+ */
+struct json_stream {
+	json_stream_cb_t cb;
+	void *user_data;
+	char *buf;
+	size_t buf_size;
+	size_t buf_len;
+	uint32_t objects;
+	uint8_t depth;
+	uint8_t state;
+	uint8_t lex;
+	uint8_t lex_state;
+	int error;
+};
+
+/**
+ * @brief Initialize a streaming tokenizer
+ *
+ * The streaming tokenizer checks the syntax of a JSON document fed to
+ * it in arbitrary chunks, for example as it arrives over a network
+ * connection, and hands each token to @a cb as soon as it is
+ * complete.  It does not allocate memory and does not modify the
+ * input.  Tokens lying entirely within one chunk are passed to the
+ * callback in place; only tokens split across chunks are assembled
+ * in @a buf, which must be large enough for the longest such token.
+ *
+ * @param stream Tokenizer state
+ * @param buf Buffer for tokens split across chunks
+ * @param buf_size Size of @a buf
+ * @param cb Callback receiving the tokens
+ * @param user_data Passed to @a cb
+ */
+void json_stream_init(struct json_stream *stream, char *buf, size_t buf_size,
+		      json_stream_cb_t cb, void *user_data);
+
+/**
+ * @brief Feed the next chunk of a document to a streaming tokenizer
+ *
+ * @param stream Tokenizer state
+ * @param data Next part of the document
+ * @param len Length of @a data
+ *
+ * @retval 0 if the chunk has been consumed
+ * @retval -EINVAL if the document is not valid JSON
+ * @retval -ENOMEM if a token split across chunks does not fit the buffer
+ * @retval -E2BIG if the document nests deeper than JSON_STREAM_MAX_DEPTH
+ * @retval other negative error code returned by the callback
+ *
+ * Once an error has been returned, it is returned by all further calls
+ * until the tokenizer is initialized again.
+ */
+int json_stream_feed(struct json_stream *stream, const char *data,
+		     size_t len);
+
+/**
+ * @brief Signal the end of a document fed to a streaming tokenizer
+ *
+ * Passes a trailing top level number to the callback, and checks that
+ * the document is complete.
+ *
+ * @param stream Tokenizer state
+ *
+ * @retval 0 if the document was complete and valid
+ * @retval -EINVAL if the document is not valid JSON or incomplete
+ * @retval other negative error code as for json_stream_feed()
+ */
+int json_stream_finish(struct json_stream *stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -722,7 +722,10 @@ __syscall void k_thread_priority_set(k_tid_t thread, int prio);
  * scheduler (when deadline scheduling is enabled) will choose the
  * next expiring thread when selecting between threads at the same
  * static priority.  Threads at different priorities will be scheduled
- * according to their static priority.
+ * according to their static priority.  Setting a deadline is a
+ * reschedule point: a thread moving its own deadline past that of
+ * another ready thread at its priority is switched out, and a ready
+ * thread given the earliest deadline preempts the running one.
  *
  * @note Deadlines are stored internally using 32 bit unsigned
  * integers.  The number of cycles between the "first" deadline in the
@@ -747,6 +750,48 @@ __syscall void k_thread_priority_set(k_tid_t thread, int prio);
  *
  */
 __syscall void k_thread_deadline_set(k_tid_t thread, int deadline);
+
+#ifdef CONFIG_SCHED_DEADLINE_MISS
+/**
+ * @brief Get the number of deadlines a thread has missed
+ *
+ * A deadline set with k_thread_deadline_set() is missed if the thread is
+ * still runnable after it expires, i.e. it is switched in or out after the
+ * deadline without having blocked (pended, slept, suspended...) before it.
+ * Blocking before the deadline meets it.  Each deadline is counted at
+ * most once.
+ *
+ * @note You should enable @kconfig{CONFIG_SCHED_DEADLINE_MISS} in your
+ * project configuration.
+ *
+ * @param thread Thread to query
+ * @return Number of missed deadlines since the thread was created
+ */
+__syscall uint32_t k_thread_deadline_misses_get(k_tid_t thread);
+
+/**
+ * @brief Set a handler called when a thread misses its deadline
+ *
+ * The handler runs on the context switch path that notices the miss,
+ * with interrupts locked and possibly the scheduler lock held.  It must
+ * be short and must not call kernel APIs that can block or reschedule;
+ * recording the event or giving it to a lock-free log is fine.
+ *
+ * The handler is called in supervisor mode, so this is not a system
+ * call and is not available to user mode threads.  Supervisor threads
+ * may set a handler on user threads.
+ *
+ * @note You should enable @kconfig{CONFIG_SCHED_DEADLINE_MISS} in your
+ * project configuration.
+ *
+ * @param thread Thread to watch
+ * @param handler Handler to call on a miss, or NULL for none
+ * @param data Parameter for the handler
+ */
+void k_thread_deadline_miss_handler_set(k_tid_t thread,
+					k_thread_deadline_miss_fn_t handler,
+					void *data);
+#endif
 #endif
 
 #ifdef CONFIG_SCHED_CPU_MASK
@@ -1522,6 +1567,46 @@ static inline uint32_t k_timer_remaining_get(struct k_timer *timer)
 	return k_ticks_to_ms_floor32(k_timer_remaining_ticks(timer));
 }
 
+/**
+ * @brief Allow a timer's expiry to be deferred.
+ *
+ * With @kconfig{CONFIG_TIMEOUT_SLACK} the kernel may run the timer's
+ * expiry up to @a slack after it is due, so that it shares a system
+ * timer wakeup with other timeouts.  Periodic timers keep their
+ * nominal period.  The slack applies from the next start or period
+ * of the timer; it is ignored without @kconfig{CONFIG_TIMEOUT_SLACK}.
+ *
+ * @param timer     Address of timer.
+ * @param slack     Relative duration the expiry may be deferred by,
+ *                  K_NO_WAIT (the default) for none.
+ */
+__syscall void k_timer_slack_set(struct k_timer *timer, k_timeout_t slack);
+
+#ifdef CONFIG_TIMEOUT_SLACK
+/**
+ * @brief Timeout slack statistics
+ */
+struct k_timeout_slack_stats {
+	/** Timer wakeups saved by handling several expiry ticks at once */
+	uint32_t wakeups_saved;
+	/** Timeouts that expired later than due, within their slack */
+	uint32_t deferred;
+};
+
+/**
+ * @brief Get the timeout slack statistics.
+ *
+ * @param stats Filled with the counters accumulated since boot or the
+ *              last k_timeout_slack_stats_reset().
+ */
+void k_timeout_slack_stats_get(struct k_timeout_slack_stats *stats);
+
+/**
+ * @brief Reset the timeout slack statistics.
+ */
+void k_timeout_slack_stats_reset(void);
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 #endif /* CONFIG_SYS_CLOCK_EXISTS */
 
 /**
@@ -2961,6 +3046,24 @@ __syscall int k_sem_take(struct k_sem *sem, k_timeout_t timeout);
  */
 __syscall void k_sem_give(struct k_sem *sem);
 
+/**
+ * @brief Give a semaphore several times at once.
+ *
+ * This routine has the same effect as calling k_sem_give() @a count
+ * times: up to @a count threads waiting on @a sem are woken, and the
+ * rest of @a count is added to the semaphore count, which saturates
+ * at its maximum permitted value.  Unlike repeated calls it takes the
+ * kernel lock, signals poll events and reschedules only once, which
+ * makes it much cheaper for producers releasing bursts, e.g. from an
+ * interrupt handler.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param sem Address of the semaphore.
+ * @param count Number of times to give the semaphore.
+ */
+__syscall void k_sem_give_n(struct k_sem *sem, unsigned int count);
+
 /**
  * @brief Resets a semaphore's count to zero.
  *
@@ -3241,6 +3344,62 @@ void k_work_queue_start(struct k_work_q *queue,
  */
 static inline k_tid_t k_work_queue_thread_get(struct k_work_q *queue);
 
+#if defined(CONFIG_WORKQUEUE_POOL) || defined(__DOXYGEN__)
+struct k_work_q_worker;
+
+/** @brief Add a worker thread to a running work queue.
+ *
+ * The new thread processes items from the same queue as the thread
+ * created by k_work_queue_start().  A work item is never run by two
+ * threads at the same time: if it is resubmitted while running, the
+ * resubmission is processed only once the current invocation
+ * completes.  Flush, cancel and drain operations take all threads of
+ * the queue into account.
+ *
+ * @note Items submitted to the same pooled queue may run concurrently
+ * with each other, and in a different order than they were submitted.
+ *
+ * @param queue pointer to the queue, already started with
+ * k_work_queue_start().
+ *
+ * @param worker pointer to the worker object.  It must persist for as
+ * long as the queue is in use.
+ *
+ * @param stack pointer to the thread stack area.
+ *
+ * @param stack_size size of the thread stack area, in bytes.
+ *
+ * @param prio initial thread priority
+ *
+ * @param cpu CPU to pin the thread to, or -1 to let it run on any
+ * CPU.  Work items with an affinity for @p cpu are only processed by
+ * the threads pinned to it.  Pinning on SMP requires
+ * CONFIG_SCHED_CPU_MASK.
+ */
+void k_work_queue_worker_add(struct k_work_q *queue,
+			     struct k_work_q_worker *worker,
+			     k_thread_stack_t *stack, size_t stack_size,
+			     int prio, int cpu);
+
+/** @brief Bind a work item to the worker threads of one CPU.
+ *
+ * When submitted to a queue that has worker threads pinned to @p cpu
+ * (see k_work_queue_worker_add()), the item is only processed by one
+ * of those threads.  On queues without such a worker the affinity is
+ * ignored.  The affinity is reset by k_work_init().
+ *
+ * @funcprops \isr_ok
+ *
+ * @param work pointer to the work item.
+ *
+ * @param cpu CPU to bind the item to, or -1 to remove the binding.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if @p cpu is not a valid CPU index
+ */
+int k_work_cpu_affinity_set(struct k_work *work, int cpu);
+#endif
+
 /** @brief Wait until the work queue has drained, optionally plugging it.
  *
  * This blocks submission to the work queue except when coming from queue
@@ -3297,6 +3456,24 @@ int k_work_queue_unplug(struct k_work_q *queue);
 void k_work_init_delayable(struct k_work_delayable *dwork,
 			   k_work_handler_t handler);
 
+/** @brief Allow the submission of delayable work to be deferred.
+ *
+ * With @kconfig{CONFIG_TIMEOUT_SLACK} the work item may be submitted
+ * up to @a slack after its delay elapses, so that its timeout shares
+ * a system timer wakeup with others.  The slack applies from the next
+ * time the item is scheduled; it is ignored without
+ * @kconfig{CONFIG_TIMEOUT_SLACK}.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param dwork pointer to the delayable work item.
+ *
+ * @param slack relative duration the submission may be deferred by,
+ * K_NO_WAIT (the default) for none.
+ */
+void k_work_delayable_slack_set(struct k_work_delayable *dwork,
+				k_timeout_t slack);
+
 /**
  * @brief Get the parent delayable work structure from a work pointer.
  *
@@ -3647,6 +3824,13 @@ struct k_work {
 	 * It can be RUNNING and CANCELING simultaneously.
 	 */
 	uint32_t flags;
+
+#ifdef CONFIG_WORKQUEUE_POOL
+	/* One plus the CPU whose workers must run the item, or zero
+	 * if any worker may.
+	 */
+	uint8_t cpu_affinity;
+#endif
 };
 
 #define Z_WORK_INITIALIZER(work_handler) { \
@@ -3706,6 +3890,12 @@ struct k_work_delayable {
 struct z_work_flusher {
 	struct k_work work;
 	struct k_sem sem;
+#ifdef CONFIG_WORKQUEUE_POOL
+	/* The item being flushed.  On a pooled queue the flusher is not
+	 * processed while this is running on another worker.
+	 */
+	struct k_work *target;
+#endif
 };
 
 /* Record used to wait for work to complete a cancellation.
@@ -3792,8 +3982,36 @@ struct k_work_q {
 
 	/* Flags describing queue state. */
 	uint32_t flags;
+
+#ifdef CONFIG_WORKQUEUE_POOL
+	/* Additional worker threads, struct k_work_q_worker. */
+	sys_slist_t workers;
+
+	/* Number of workers currently running an item. */
+	uint16_t active;
+
+	/* Bitmask of the CPUs that have a worker pinned to them. */
+	uint32_t worker_cpus;
+#endif
 };
 
+#if defined(CONFIG_WORKQUEUE_POOL) || defined(__DOXYGEN__)
+/** @brief A structure holding an additional work queue thread.
+ *
+ * See k_work_queue_worker_add().
+ */
+struct k_work_q_worker {
+	/* The thread that animates the work. */
+	struct k_thread thread;
+
+	/* Node in the list of additional workers of the queue. */
+	sys_snode_t node;
+
+	/* CPU the worker is pinned to, or -1. */
+	int cpu;
+};
+#endif
+
 /* Provide the implementation for inline functions declared above */
 
 static inline bool k_work_is_pending(const struct k_work *work)
@@ -4308,6 +4526,10 @@ struct k_msgq {
 	char *write_ptr;
 	/** Number of used messages */
 	uint32_t used_msgs;
+	/** Number of messages claimed by k_msgq_put_claim() */
+	uint32_t put_claimed;
+	/** Number of messages claimed by k_msgq_get_claim() */
+	uint32_t get_claimed;
 
 	_POLL_EVENT;
 
@@ -4454,6 +4676,8 @@ int k_msgq_cleanup(struct k_msgq *msgq);
  * @retval 0 Message sent.
  * @retval -ENOMSG Returned without waiting or queue purged.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Returned without waiting; space is claimed with
+ *                k_msgq_put_claim().
  */
 __syscall int k_msgq_put(struct k_msgq *msgq, const void *data, k_timeout_t timeout);
 
@@ -4476,9 +4700,144 @@ __syscall int k_msgq_put(struct k_msgq *msgq, const void *data, k_timeout_t time
  * @retval 0 Message received.
  * @retval -ENOMSG Returned without waiting.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Returned without waiting; messages are claimed with
+ *                k_msgq_get_claim().
  */
 __syscall int k_msgq_get(struct k_msgq *msgq, void *data, k_timeout_t timeout);
 
+/**
+ * @brief Send several messages to a message queue.
+ *
+ * This routine sends up to @a num_msgs consecutive messages from @a data
+ * to message queue @a msgq, taking the queue's lock once.  As many
+ * messages as there is room for (or waiting receivers) are sent without
+ * waiting; only if none can be sent does the caller wait, as with
+ * k_msgq_put(), for the first one.
+ *
+ * @note @a timeout must be set to K_NO_WAIT if called from ISR.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param msgq Address of the message queue.
+ * @param data Pointer to the messages.
+ * @param num_msgs Number of messages at @a data.
+ * @param timeout Waiting period to add the first message,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @return Number of messages sent, or one of the negative error codes
+ *         of k_msgq_put() if none could be.
+ */
+__syscall int k_msgq_put_many(struct k_msgq *msgq, const void *data,
+			      uint32_t num_msgs, k_timeout_t timeout);
+
+/**
+ * @brief Receive several messages from a message queue.
+ *
+ * This routine receives up to @a max_msgs messages from message queue
+ * @a msgq into consecutive locations of @a data, taking the queue's
+ * lock once.  All messages available are received without waiting;
+ * only if the queue is empty does the caller wait, as with
+ * k_msgq_get(), for the first one.
+ *
+ * @note @a timeout must be set to K_NO_WAIT if called from ISR.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param msgq Address of the message queue.
+ * @param data Address of area to hold up to @a max_msgs messages.
+ * @param max_msgs Maximum number of messages to receive.
+ * @param timeout Waiting period to receive the first message,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @return Number of messages received, or one of the negative error
+ *         codes of k_msgq_get() if none were.
+ */
+__syscall int k_msgq_get_many(struct k_msgq *msgq, void *data,
+			      uint32_t max_msgs, k_timeout_t timeout);
+
+/**
+ * @brief Claim space in a message queue's ring buffer.
+ *
+ * This routine claims up to @a max_msgs contiguous free messages of
+ * the ring buffer of @a msgq, for the caller to write messages in
+ * place.  They are sent by k_msgq_put_finish().  Until then, other
+ * senders get -EBUSY, so only one sender should use claims.
+ *
+ * The claimed area lives in the queue's buffer, so this is not
+ * available to user mode threads.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param msgq Address of the message queue.
+ * @param data Set to the first claimed message.
+ * @param max_msgs Maximum number of messages to claim.
+ *
+ * @return Number of messages claimed, possibly zero if the queue is
+ *         full, or -EBUSY if space is already claimed.
+ */
+int k_msgq_put_claim(struct k_msgq *msgq, void **data, uint32_t max_msgs);
+
+/**
+ * @brief Send messages written in claimed space.
+ *
+ * This routine sends the first @a num_msgs messages claimed with
+ * k_msgq_put_claim() and releases the claim.  Threads waiting to
+ * receive get the messages.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param msgq Address of the message queue.
+ * @param num_msgs Number of messages written, at most the number
+ *                 claimed.
+ *
+ * @retval 0 Messages sent.
+ * @retval -EINVAL More messages than claimed.
+ */
+int k_msgq_put_finish(struct k_msgq *msgq, uint32_t num_msgs);
+
+/**
+ * @brief Claim messages in a message queue's ring buffer.
+ *
+ * This routine claims up to @a max_msgs contiguous messages at the head
+ * of @a msgq, for the caller to read them in place.  They are removed
+ * from the queue by k_msgq_get_finish().  Until then, other receivers
+ * get -EBUSY, so only one receiver should use claims.  Purging the
+ * queue drops the claim.
+ *
+ * The claimed area lives in the queue's buffer, so this is not
+ * available to user mode threads.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param msgq Address of the message queue.
+ * @param data Set to the first claimed message.
+ * @param max_msgs Maximum number of messages to claim.
+ *
+ * @return Number of messages claimed, possibly zero if the queue is
+ *         empty, or -EBUSY if messages are already claimed.
+ */
+int k_msgq_get_claim(struct k_msgq *msgq, void **data, uint32_t max_msgs);
+
+/**
+ * @brief Remove claimed messages from a message queue.
+ *
+ * This routine removes the first @a num_msgs messages claimed with
+ * k_msgq_get_claim() from the queue and releases the claim.  Threads
+ * waiting to send get the freed space.
+ *
+ * @funcprops \isr_ok
+ *
+ * @param msgq Address of the message queue.
+ * @param num_msgs Number of messages consumed, at most the number
+ *                 claimed.
+ *
+ * @retval 0 Messages removed.
+ * @retval -EINVAL More messages than claimed.
+ */
+int k_msgq_get_finish(struct k_msgq *msgq, uint32_t num_msgs);
+
 /**
  * @brief Peek/read a message from a message queue.
  *
@@ -4724,6 +5083,8 @@ struct k_pipe {
 	size_t         bytes_used;      /**< # bytes used in buffer */
 	size_t         read_index;      /**< Where in buffer to read from */
 	size_t         write_index;     /**< Where in buffer to write */
+	size_t         put_claimed;     /**< # bytes claimed for writing */
+	size_t         get_claimed;     /**< # bytes claimed for reading */
 	struct k_spinlock lock;		/**< Synchronization lock */
 
 	struct {
@@ -4839,6 +5200,8 @@ __syscall int k_pipe_alloc_init(struct k_pipe *pipe, size_t size);
  * @retval -EIO Returned without waiting; zero data bytes were written.
  * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
  *                 minus one data bytes were written.
+ * @retval -EBUSY Returned without waiting; space is claimed with
+ *                k_pipe_put_claim().
  */
 __syscall int k_pipe_put(struct k_pipe *pipe, void *data,
 			 size_t bytes_to_write, size_t *bytes_written,
@@ -4862,11 +5225,84 @@ __syscall int k_pipe_put(struct k_pipe *pipe, void *data,
  * @retval -EIO Returned without waiting; zero data bytes were read.
  * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
  *                 minus one data bytes were read.
+ * @retval -EBUSY Returned without waiting; data is claimed with
+ *                k_pipe_get_claim().
  */
 __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
 			 size_t bytes_to_read, size_t *bytes_read,
 			 size_t min_xfer, k_timeout_t timeout);
 
+/**
+ * @brief Claim space in a pipe's buffer.
+ *
+ * This routine claims up to @a size contiguous free bytes of the buffer
+ * of @a pipe, for the caller to write data in place.  The data is
+ * written to the pipe by k_pipe_put_finish().  Until then, other
+ * writers get -EBUSY, so only one writer should use claims.
+ *
+ * The claimed area lives in the pipe's buffer, so this is not
+ * available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Set to the claimed area.
+ * @param size Maximum number of bytes to claim.
+ *
+ * @return Number of bytes claimed, zero if the buffer is full or the
+ *         pipe has none, or -EBUSY if space is already claimed.
+ */
+int k_pipe_put_claim(struct k_pipe *pipe, uint8_t **data, size_t size);
+
+/**
+ * @brief Write data written in claimed space to a pipe.
+ *
+ * This routine writes the first @a size bytes claimed with
+ * k_pipe_put_claim() to the pipe and releases the claim.  Threads
+ * waiting to read get the data.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes written, at most the number claimed.
+ *
+ * @retval 0 Data written.
+ * @retval -EINVAL More bytes than claimed.
+ */
+int k_pipe_put_finish(struct k_pipe *pipe, size_t size);
+
+/**
+ * @brief Claim data in a pipe's buffer.
+ *
+ * This routine claims up to @a size contiguous bytes of data buffered
+ * in @a pipe, for the caller to read them in place.  They are removed
+ * from the pipe by k_pipe_get_finish().  Until then, other readers get
+ * -EBUSY, so only one reader should use claims.  Flushing the pipe
+ * drops the claim.
+ *
+ * The claimed area lives in the pipe's buffer, so this is not
+ * available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Set to the claimed data.
+ * @param size Maximum number of bytes to claim.
+ *
+ * @return Number of bytes claimed, zero if no data is buffered, or
+ *         -EBUSY if data is already claimed.
+ */
+int k_pipe_get_claim(struct k_pipe *pipe, uint8_t **data, size_t size);
+
+/**
+ * @brief Remove claimed data from a pipe.
+ *
+ * This routine removes the first @a size bytes claimed with
+ * k_pipe_get_claim() from the pipe and releases the claim.  Threads
+ * waiting to write get the freed space.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes consumed, at most the number claimed.
+ *
+ * @retval 0 Data removed.
+ * @retval -EINVAL More bytes than claimed.
+ */
+int k_pipe_get_finish(struct k_pipe *pipe, size_t size);
+
 /**
  * @brief Query the number of bytes that may be read from @a pipe.
  *
@@ -4918,6 +5354,14 @@ __syscall void k_pipe_buffer_flush(struct k_pipe *pipe);
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+struct z_mem_slab_cpu_cache {
+	struct k_spinlock lock;
+	uint32_t count;
+	char *blocks[CONFIG_MEM_SLAB_CPU_CACHE_DEPTH];
+};
+#endif
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
 	struct k_spinlock lock;
@@ -4929,6 +5373,11 @@ struct k_mem_slab {
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	uint32_t max_used;
 #endif
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	/* Set while threads may be pending, makes frees bypass the caches */
+	bool cache_bypass;
+	struct z_mem_slab_cpu_cache cache[CONFIG_MP_NUM_CPUS];
+#endif
 
 	SYS_PORT_TRACING_TRACKING_FIELD(k_mem_slab)
 };
@@ -5081,7 +5530,18 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	uint32_t cached = 0U;
+
+	/* Blocks in the per-CPU caches are free for the user */
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cached += slab->cache[i].count;
+	}
+
+	return slab->num_used - cached;
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -5116,7 +5576,7 @@ static inline uint32_t k_mem_slab_max_used_get(struct k_mem_slab *slab)
  */
 static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
 /** @} */
@@ -5128,10 +5588,29 @@ static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 
 /* kernel synchronized heap struct */
 
+#ifdef CONFIG_HEAP_CPU_CACHE
+struct z_heap_magazine {
+	void *blocks[CONFIG_HEAP_CPU_CACHE_DEPTH];
+	uint8_t count;
+};
+
+struct z_heap_cpu_cache {
+	struct k_spinlock lock;
+	struct z_heap_magazine classes[CONFIG_HEAP_CPU_CACHE_CLASSES];
+	uint32_t hits;
+	uint32_t misses;
+	uint32_t flushes;
+};
+#endif
+
 struct k_heap {
 	struct sys_heap heap;
 	_wait_q_t wait_q;
 	struct k_spinlock lock;
+#ifdef CONFIG_HEAP_CPU_CACHE
+	struct z_heap_cpu_cache cache[CONFIG_MP_NUM_CPUS];
+	uint32_t cache_waiters;
+#endif
 };
 
 /**
@@ -5206,6 +5685,51 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes,
  */
 void k_heap_free(struct k_heap *h, void *mem);
 
+#if defined(CONFIG_HEAP_CPU_CACHE) || defined(__DOXYGEN__)
+/** k_heap per-CPU cache statistics */
+struct k_heap_cache_stats {
+	/** Allocations served from a magazine */
+	uint32_t hits;
+	/** Allocations which found their magazine empty */
+	uint32_t misses;
+	/** Batches of blocks returned from full magazines to the heap */
+	uint32_t flushes;
+	/** Bytes held in magazines, allocated from the heap but unused */
+	size_t cached_bytes;
+	/** Largest block the heap itself could allocate */
+	size_t largest_free;
+};
+
+/**
+ * @brief Get the per-CPU cache statistics of a k_heap
+ *
+ * Sums the counters of all CPUs.  The cached byte count is the
+ * memory parked in magazines: it is unavailable to allocations of
+ * other sizes and thus measures the fragmentation cost of the cache.
+ * Comparing it to the largest free block shows how much that matters:
+ * when the cached bytes are large next to the largest free block,
+ * cached blocks likely split free memory that k_heap_cache_flush()
+ * would merge again.  Allocations which don't fit the largest free
+ * block flush the caches on their own before failing or blocking.
+ *
+ * @param h Heap to query
+ * @param stats Pointer to struct to copy statistics into
+ * @return -EINVAL if null pointers, otherwise 0
+ */
+int k_heap_cache_stats_get(struct k_heap *h, struct k_heap_cache_stats *stats);
+
+/**
+ * @brief Return the cached blocks to a k_heap
+ *
+ * Empties the magazines of all CPUs for the heap, making the memory
+ * available to allocations of any size again.  This also happens
+ * automatically before an allocation from the heap fails or blocks.
+ *
+ * @param h Heap whose cache is flushed
+ */
+void k_heap_cache_flush(struct k_heap *h);
+#endif
+
 /* Hand-calculated minimum heap sizes needed to return a successful
  * 1-byte allocation.  See details in lib/os/heap.[ch]
  */
@@ -5918,6 +6442,53 @@ extern void k_sys_runtime_stats_enable(void);
  */
 extern void k_sys_runtime_stats_disable(void);
 
+/**
+ * @brief Get the scheduler statistics of a thread
+ *
+ * Copies the wake latency and run time histograms, switch count and
+ * preemption count gathered for @a thread with CONFIG_SCHED_STATS_THREAD.
+ * A dispatch still in progress is not included.
+ *
+ * @param thread ID of thread.
+ * @param stats Pointer to struct to copy statistics into.
+ * @retval 0 on success
+ * @retval -EINVAL if null pointers
+ * @retval -ENOTSUP if per-thread statistics are not configured
+ */
+int k_thread_sched_stats_get(k_tid_t thread,
+			     struct k_thread_sched_stats *stats);
+
+/**
+ * @brief Clear the scheduler statistics of a thread
+ *
+ * @param thread ID of thread.
+ * @retval 0 on success
+ * @retval -EINVAL if invalid thread ID
+ * @retval -ENOTSUP if per-thread statistics are not configured
+ */
+int k_thread_sched_stats_reset(k_tid_t thread);
+
+/**
+ * @brief Get the scheduler statistics of a CPU
+ *
+ * Copies the wake latency, run time and run queue depth histograms and
+ * the switch and preemption counts gathered on @a cpu with
+ * CONFIG_SCHED_STATS.
+ *
+ * @param cpu CPU index.
+ * @param stats Pointer to struct to copy statistics into.
+ * @return -EINVAL if invalid CPU or null pointer, otherwise 0
+ */
+int k_cpu_sched_stats_get(int cpu, struct k_cpu_sched_stats *stats);
+
+/**
+ * @brief Clear the scheduler statistics of a CPU
+ *
+ * @param cpu CPU index.
+ * @return -EINVAL if invalid CPU, otherwise 0
+ */
+int k_cpu_sched_stats_reset(int cpu);
+
 #ifdef __cplusplus
 }
 #endif
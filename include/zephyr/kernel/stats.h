@@ -24,4 +24,37 @@ struct k_cycle_stats {
 	bool      track_usage;  /* true if gathering usage stats */
 };
 
+struct k_thread_sched_stats;
+struct k_cpu_sched_stats;
+
+#ifdef CONFIG_SCHED_STATS
+/*
+ * [k_sched_hist] is a log2 histogram of cycle counts (or queue depths):
+ * bucket [i] counts samples in [2^i, 2^(i+1)), bucket 0 also counts zero
+ * and the last bucket counts everything above its lower bound.
+ */
+
+struct k_sched_hist {
+	uint32_t  bucket[CONFIG_SCHED_STATS_BUCKETS];
+};
+
+/* Scheduler statistics kept per thread with CONFIG_SCHED_STATS_THREAD */
+struct k_thread_sched_stats {
+	struct k_sched_hist  wake_latency; /* ready -> switched in, cycles */
+	struct k_sched_hist  run_time;     /* cycles run per dispatch */
+	uint32_t  switches;     /* # of times switched in */
+	uint32_t  preemptions;  /* # of times switched out while runnable */
+};
+
+/* Scheduler statistics kept per CPU */
+struct k_cpu_sched_stats {
+	struct k_sched_hist  wake_latency; /* ready -> switched in, cycles */
+	struct k_sched_hist  run_time;     /* cycles run per dispatch */
+	struct k_sched_hist  runq_depth;   /* run queue depth at switch */
+	uint32_t  switches;       /* # of context switches */
+	uint32_t  preemptions;    /* # of switches away from a runnable thread */
+	uint32_t  runq_depth_max; /* deepest run queue seen at a switch */
+};
+#endif
+
 #endif
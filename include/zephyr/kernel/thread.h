@@ -90,6 +90,14 @@ struct _thread_base {
 	int prio_deadline;
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE_MISS
+	/* true while [prio_deadline] is neither met nor missed */
+	bool deadline_armed;
+	uint32_t deadline_misses;
+	k_thread_deadline_miss_fn_t deadline_miss_fn;
+	void *deadline_miss_data;
+#endif
+
 	uint32_t order_key;
 
 #ifdef CONFIG_SMP
@@ -126,6 +134,17 @@ struct _thread_base {
 #ifdef CONFIG_SCHED_THREAD_USAGE
 	struct k_cycle_stats  usage;   /* Track thread usage statistics */
 #endif
+
+#ifdef CONFIG_SCHED_STATS
+	/* cycle count when last made ready, 0 once accounted */
+	uint32_t sched_ready0;
+#endif
+
+#ifdef CONFIG_SCHED_STATS_THREAD
+	/* odd while sched_stats is written */
+	atomic_t sched_stats_seq;
+	struct k_thread_sched_stats sched_stats;
+#endif
 };
 
 typedef struct _thread_base _thread_base_t;
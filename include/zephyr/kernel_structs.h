@@ -93,6 +93,11 @@ struct _ready_q {
 #elif defined(CONFIG_SCHED_MULTIQ)
 	struct _priq_mq runq;
 #endif
+
+#if defined(CONFIG_SCHED_STATS) || defined(CONFIG_SCHED_CPU_RUNQ)
+	/* number of threads currently in [runq] */
+	uint32_t depth;
+#endif
 };
 
 typedef struct _ready_q _ready_q_t;
@@ -110,7 +115,7 @@ struct _cpu {
 	/* one assigned idle thread per CPU */
 	struct k_thread *idle_thread;
 
-#ifdef CONFIG_SCHED_CPU_MASK_PIN_ONLY
+#if defined(CONFIG_SCHED_CPU_MASK_PIN_ONLY) || defined(CONFIG_SCHED_CPU_RUNQ)
 	struct _ready_q ready_q;
 #endif
 
@@ -145,6 +150,16 @@ struct _cpu {
 #endif
 #endif
 
+#ifdef CONFIG_SCHED_STATS
+	/* thread last accounted as switched in, and when */
+	struct k_thread *sched_stats_thread;
+	uint32_t sched_stats_run0;
+
+	/* odd while sched_stats is written */
+	atomic_t sched_stats_seq;
+	struct k_cpu_sched_stats sched_stats;
+#endif
+
 	/* Per CPU architecture specifics */
 	struct _cpu_arch arch;
 };
@@ -162,10 +177,15 @@ struct z_kernel {
 	 * ready queue: can be big, keep after small fields, since some
 	 * assembly (e.g. ARC) are limited in the encoding of the offset
 	 */
-#ifndef CONFIG_SCHED_CPU_MASK_PIN_ONLY
+#if !defined(CONFIG_SCHED_CPU_MASK_PIN_ONLY) && !defined(CONFIG_SCHED_CPU_RUNQ)
 	struct _ready_q ready_q;
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* bitmask of CPUs whose run queue isn't empty */
+	uint32_t runq_busy;
+#endif
+
 #ifdef CONFIG_FPU_SHARING
 	/*
 	 * A 'current_sse' field does not exist in addition to the 'current_fp'
@@ -241,10 +261,17 @@ struct _timeout {
 #else
 	int32_t dticks;
 #endif
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* Ticks the expiry may be deferred by to share a wakeup */
+	uint32_t slack;
+#endif
 };
 
 typedef void (*k_thread_timeslice_fn_t)(struct k_thread *thread, void *data);
 
+typedef void (*k_thread_deadline_miss_fn_t)(struct k_thread *thread,
+					    void *data);
+
 #ifdef __cplusplus
 }
 #endif
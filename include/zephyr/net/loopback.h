@@ -26,6 +26,20 @@ extern "C" {
 int loopback_set_packet_drop_ratio(float ratio);
 #endif
 
+#ifdef CONFIG_NET_LOOPBACK_SIMULATE_DELAY
+/**
+ * @brief Set the packet delay
+ *
+ * Packets are received the given time after they were sent. Packets
+ * sent while CONFIG_NET_PKT_RX_COUNT of them are waiting are dropped.
+ *
+ * @param[in] delay_ms Delay in milliseconds, 0 = no delay
+ *
+ * @return 0 on success, otherwise a negative integer.
+ */
+int loopback_set_packet_delay(uint32_t delay_ms);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -1517,6 +1517,50 @@ static inline bool net_tcp_seq_greater(uint32_t seq1, uint32_t seq2)
 	return net_tcp_seq_cmp(seq1, seq2) > 0;
 }
 
+/**
+ * @brief Update an Internet checksum after a 16-bit field changed.
+ *
+ * @details Incremental update of RFC 1624, HC' = ~(~HC + ~m + m'), so
+ *          that a header field, like the IPv4 TTL or a port rewritten
+ *          by NAT, can be changed without summing the whole data again.
+ *          All the values must be in the same byte order, usually the
+ *          network byte order they have in the packet.
+ *
+ * @param chksum Checksum covering the field
+ * @param old_val Previous value of the field
+ * @param new_val New value of the field
+ *
+ * @return Updated checksum
+ */
+static inline uint16_t net_chksum_update16(uint16_t chksum, uint16_t old_val,
+					   uint16_t new_val)
+{
+	uint32_t sum;
+
+	sum = (uint16_t)~chksum + (uint16_t)~old_val + (uint32_t)new_val;
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t)~sum;
+}
+
+/**
+ * @brief Update an Internet checksum after a part of the data changed.
+ *
+ * @details Same as net_chksum_update16() for a field of any length, like
+ *          an address in a pseudo header. The field must start at an even
+ *          offset of the data covered by the checksum.
+ *
+ * @param chksum Checksum covering the field, in network byte order
+ * @param old_data Previous content of the field
+ * @param new_data New content of the field
+ * @param len Length of the field
+ *
+ * @return Updated checksum, in network byte order
+ */
+uint16_t net_chksum_update(uint16_t chksum, const void *old_data,
+			   const void *new_data, size_t len);
+
 /**
  * @brief Convert a string of hex values to array of bytes.
  *
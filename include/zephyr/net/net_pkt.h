@@ -118,6 +118,14 @@ struct net_pkt {
 	uint64_t txtime;
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_PKT_CHKSUM_COPY)
+	/** One's complement sum of the last chksum_len bytes of the packet,
+	 * folded while they were written or copied into it.
+	 */
+	uint16_t chksum;
+	uint16_t chksum_len;
+#endif /* CONFIG_NET_PKT_CHKSUM_COPY */
+
 	/** Reference counter */
 	atomic_t atomic_ref;
 
@@ -189,6 +197,12 @@ struct net_pkt {
 				 * defined(CONFIG_NET_ETHERNET_BRIDGE).
 				 */
 
+#if defined(CONFIG_NET_PKT_CHKSUM_COPY)
+	uint8_t chksum_copy : 1; /* Fold the data appended to this packet
+				  * into chksum.
+				  */
+#endif
+
 	union {
 		/* IPv6 hop limit or IPv4 ttl for this network packet.
 		 * The value is shared between IPv6 and IPv4.
@@ -887,6 +901,53 @@ static inline void net_pkt_set_txtime(struct net_pkt *pkt, uint64_t txtime)
 }
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+/**
+ * @brief Start summing the data appended to a packet
+ *
+ * @details The data written with net_pkt_write() or copied with
+ *          net_pkt_copy() from now on, and until net_pkt_chksum_copy_end(),
+ *          is summed as it is copied, so that net_calc_chksum() does not
+ *          read it again. It must be the end of the packet, so this is
+ *          meant for the payload, once the headers are in place.
+ *
+ * @param pkt Network packet
+ */
+static inline void net_pkt_chksum_copy_begin(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_PKT_CHKSUM_COPY)
+	pkt->chksum = 0U;
+	pkt->chksum_len = 0U;
+	pkt->chksum_copy = 1U;
+#else
+	ARG_UNUSED(pkt);
+#endif
+}
+
+/**
+ * @brief Stop summing the data appended to a packet
+ *
+ * @param pkt Network packet
+ */
+static inline void net_pkt_chksum_copy_end(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_PKT_CHKSUM_COPY)
+	pkt->chksum_copy = 0U;
+#else
+	ARG_UNUSED(pkt);
+#endif
+}
+
+static inline bool net_pkt_is_chksum_copy(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_PKT_CHKSUM_COPY)
+	return !!(pkt->chksum_copy);
+#else
+	ARG_UNUSED(pkt);
+
+	return false;
+#endif
+}
+
 #if defined(CONFIG_NET_PKT_TXTIME_STATS_DETAIL) || \
 	defined(CONFIG_NET_PKT_RXTIME_STATS_DETAIL)
 static inline uint32_t *net_pkt_stats_tick(struct net_pkt *pkt)
@@ -1076,6 +1076,50 @@ size_t arch_icache_line_size_get(void);
 
 /** @} */
 
+/**
+ * @defgroup arch-crc Architecture-specific CRC functions
+ * @ingroup arch-interface
+ * @{
+ */
+
+#ifdef CONFIG_ARCH_HAS_CRC32_IEEE
+/**
+ * @brief Update a CRC-32 register using CPU instructions
+ *
+ * Computes the reflected CRC with polynomial 0x04C11DB7 (IEEE 802.3)
+ * over @a data.  No initial or final inversion is applied, that is up
+ * to the caller.
+ *
+ * @see crc32_ieee_update
+ *
+ * @param crc Current value of the CRC register
+ * @param data Input bytes
+ * @param len Number of input bytes
+ * @return Updated value of the CRC register
+ */
+uint32_t arch_crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len);
+#endif /* CONFIG_ARCH_HAS_CRC32_IEEE */
+
+#ifdef CONFIG_ARCH_HAS_CRC32C
+/**
+ * @brief Update a CRC-32C register using CPU instructions
+ *
+ * Computes the reflected CRC with polynomial 0x1EDC6F41 (Castagnoli)
+ * over @a data.  No initial or final inversion is applied, that is up
+ * to the caller.
+ *
+ * @see crc32_c
+ *
+ * @param crc Current value of the CRC register
+ * @param data Input bytes
+ * @param len Number of input bytes
+ * @return Updated value of the CRC register
+ */
+uint32_t arch_crc32c_update(uint32_t crc, const uint8_t *data, size_t len);
+#endif /* CONFIG_ARCH_HAS_CRC32C */
+
+/** @} */
+
 #ifdef CONFIG_TIMING_FUNCTIONS
 #include <timing/types.h>
 
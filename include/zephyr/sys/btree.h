@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief B+tree data structure
+ *
+ * This implements an ordered container for items with integer keys,
+ * built as a B+tree with wide nodes.  Each tree node holds up to
+ * CONFIG_BTREE_NODE_KEYS keys in a contiguous array, so a search
+ * touches a few cache lines per level instead of one node per key
+ * comparison as a red/black tree does, and the tree is only a few
+ * levels deep even with thousands of items.  Leaves are linked, so
+ * in-order iteration is a walk along the leaf level.
+ *
+ * Items are intrusive: a struct btnode holding the key is embedded in
+ * the user struct, and the tree stores pointers to it.  Tree nodes
+ * come from a pool provided when the tree is initialized, nothing is
+ * allocated from the heap.  Items with equal keys are kept in
+ * insertion order.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_BTREE_H_
+#define ZEPHYR_INCLUDE_SYS_BTREE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup btree_apis B+tree
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/** @brief Key type of a B+tree item. */
+typedef uint64_t btree_key_t;
+
+/** @brief B+tree item, to be embedded in the user struct. */
+struct btnode {
+	/** Sort key, must not change while the item is in a tree. */
+	btree_key_t key;
+};
+
+/* Tree nodes hold up to Z_BTREE_KEYS keys. Inner nodes have one child
+ * more than keys, the separator key i being lower or equal to all keys
+ * in child i + 1 and greater or equal to all keys in child i.
+ */
+#define Z_BTREE_KEYS CONFIG_BTREE_NODE_KEYS
+#define Z_BTREE_MIN_KEYS (Z_BTREE_KEYS / 2)
+
+/* Deep enough for any tree made of nodes of at least 2 children */
+#define Z_BTREE_MAX_HEIGHT 32
+
+/** @cond INTERNAL_HIDDEN */
+struct btree_node {
+	/* Next leaf, or next free node in the pool */
+	struct btree_node *next;
+	uint8_t leaf;
+	uint8_t count;
+	btree_key_t keys[Z_BTREE_KEYS];
+	union {
+		struct btnode *items[Z_BTREE_KEYS];
+		struct btree_node *children[Z_BTREE_KEYS + 1];
+	};
+};
+/** @endcond */
+
+/** @brief B+tree */
+struct btree {
+	/** @cond INTERNAL_HIDDEN */
+	struct btree_node *root;
+	/* Freed nodes */
+	struct btree_node *free;
+	/* Nodes of the pool never used so far */
+	struct btree_node *pool;
+	size_t pool_left;
+	/* Total of available nodes */
+	size_t free_cnt;
+	size_t count;
+	uint8_t height;
+	/** @endcond */
+};
+
+/**
+ * @brief Iterator over a B+tree.
+ *
+ * Iterators are invalidated by any modification of the tree.
+ */
+struct btree_iter {
+	/** @cond INTERNAL_HIDDEN */
+	struct btree_node *leaf;
+	uint8_t idx;
+	/** @endcond */
+};
+
+/**
+ * @brief Statically define and initialize a B+tree.
+ *
+ * @param name Name of the tree.
+ * @param num_nodes Number of tree nodes in its pool. A tree of n items
+ * needs about 2 * n / CONFIG_BTREE_NODE_KEYS nodes in the worst case.
+ */
+#define BTREE_DEFINE(name, num_nodes) \
+	static struct btree_node _btree_nodes_##name[num_nodes]; \
+	struct btree name = { \
+		.pool = _btree_nodes_##name, \
+		.pool_left = num_nodes, \
+		.free_cnt = num_nodes, \
+	}
+
+/**
+ * @brief Initialize a B+tree.
+ *
+ * @param tree Tree.
+ * @param nodes Pool of tree nodes, owned by the tree from now on.
+ * @param num_nodes Number of nodes in the pool.
+ */
+void btree_init(struct btree *tree, struct btree_node *nodes,
+		size_t num_nodes);
+
+/**
+ * @brief Insert an item into a B+tree.
+ *
+ * The item is inserted after the items with an equal key.
+ *
+ * @param tree Tree.
+ * @param node Item, with its key set.
+ *
+ * @retval 0 on success.
+ * @retval -ENOMEM if the node pool is exhausted. The tree is unchanged.
+ */
+int btree_insert(struct btree *tree, struct btnode *node);
+
+/**
+ * @brief Insert many items into a B+tree.
+ *
+ * Items must be sorted by key. When the tree is empty, it is built bottom
+ * up from the items, which is considerably faster than inserting them one
+ * by one and leaves the nodes fully packed.
+ *
+ * @param tree Tree.
+ * @param nodes Array of items, sorted by key.
+ * @param count Number of items.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if items are not sorted. The tree is unchanged.
+ * @retval -ENOMEM if the node pool is exhausted. An empty tree is left
+ * unchanged, otherwise the items before the one which failed have been
+ * inserted.
+ */
+int btree_insert_bulk(struct btree *tree, struct btnode **nodes,
+		      size_t count);
+
+/**
+ * @brief Remove an item from a B+tree.
+ *
+ * @param tree Tree.
+ * @param node Item.
+ *
+ * @retval 0 on success.
+ * @retval -ENOENT if the item is not in the tree.
+ */
+int btree_remove(struct btree *tree, struct btnode *node);
+
+/**
+ * @brief Find the first item with a key not less than given key.
+ *
+ * @param tree Tree.
+ * @param key Key.
+ * @param iter If not NULL, set to iterate from the found item.
+ *
+ * @return Item or NULL if all items have smaller keys.
+ */
+struct btnode *btree_lower_bound(struct btree *tree, btree_key_t key,
+				 struct btree_iter *iter);
+
+/**
+ * @brief Find the first item with given key.
+ *
+ * @param tree Tree.
+ * @param key Key.
+ *
+ * @return Item or NULL if there is no item with @p key.
+ */
+static inline struct btnode *btree_find(struct btree *tree, btree_key_t key)
+{
+	struct btnode *node = btree_lower_bound(tree, key, NULL);
+
+	return (node != NULL && node->key == key) ? node : NULL;
+}
+
+/**
+ * @brief Get the item with the lowest key.
+ *
+ * @param tree Tree.
+ * @param iter If not NULL, set to iterate from the found item.
+ *
+ * @return Item or NULL if the tree is empty.
+ */
+struct btnode *btree_get_min(struct btree *tree, struct btree_iter *iter);
+
+/**
+ * @brief Get the item with the highest key.
+ *
+ * @param tree Tree.
+ *
+ * @return Item or NULL if the tree is empty.
+ */
+struct btnode *btree_get_max(struct btree *tree);
+
+/**
+ * @brief Advance an iterator.
+ *
+ * @param iter Iterator set by btree_get_min() or btree_lower_bound().
+ *
+ * @return Next item in key order or NULL when there are no more items.
+ */
+static inline struct btnode *btree_iter_next(struct btree_iter *iter)
+{
+	if (iter->leaf == NULL) {
+		return NULL;
+	}
+
+	if (++iter->idx >= iter->leaf->count) {
+		iter->leaf = iter->leaf->next;
+		iter->idx = 0;
+		if (iter->leaf == NULL) {
+			return NULL;
+		}
+	}
+
+	return iter->leaf->items[iter->idx];
+}
+
+/**
+ * @brief Get the number of items in a B+tree.
+ *
+ * @param tree Tree.
+ *
+ * @return Number of items.
+ */
+static inline size_t btree_count(struct btree *tree)
+{
+	return tree->count;
+}
+
+/**
+ * @brief Check if a B+tree is empty.
+ *
+ * @param tree Tree.
+ *
+ * @return true if the tree has no items.
+ */
+static inline bool btree_is_empty(struct btree *tree)
+{
+	return tree->count == 0;
+}
+
+/**
+ * @brief Walk a B+tree in key order.
+ *
+ * The loop is not safe against modifications of the tree.
+ *
+ * @param tree A pointer to a struct btree to walk
+ * @param node The symbol name of a local struct btnode* variable to
+ *             use as the iterator
+ */
+#define BTREE_FOR_EACH(tree, node) \
+	for (struct btree_iter __i, *__ip = &__i; \
+	     __ip != NULL; __ip = NULL) \
+		for (node = btree_get_min(tree, &__i); node != NULL; \
+		     node = btree_iter_next(&__i))
+
+/**
+ * @brief Walk a B+tree in key order, with implicit container field logic.
+ *
+ * As for BTREE_FOR_EACH(), but "node" can have an arbitrary type
+ * containing a struct btnode.
+ *
+ * @param tree A pointer to a struct btree to walk
+ * @param node The symbol name of a local iterator
+ * @param field The field name of a struct btnode inside node
+ */
+#define BTREE_FOR_EACH_CONTAINER(tree, node, field) \
+	for (struct btree_iter __i, *__ip = &__i; \
+	     __ip != NULL; __ip = NULL) \
+		for (struct btnode *__n = btree_get_min(tree, &__i); \
+		     (node = __n ? CONTAINER_OF(__n, __typeof__(*(node)), \
+						field) : NULL) != NULL; \
+		     __n = btree_iter_next(&__i))
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_BTREE_H_ */
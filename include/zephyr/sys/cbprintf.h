@@ -32,6 +32,10 @@
 /* Z_C_GENERIC is used there */
 #include <sys/cbprintf_internal.h>
 
+#ifdef CONFIG_CBPRINTF_PRECOMPILED
+#include <sys/atomic.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -503,6 +507,116 @@ int cbpprintf(cbprintf_cb out, void *ctx, void *packaged)
 	return cbpprintf_external(out, cbvprintf, ctx, packaged);
 }
 
+#if defined(CONFIG_CBPRINTF_PRECOMPILED) || defined(__DOXYGEN__)
+
+/** @brief Format string with its conversion specifications precompiled.
+ *
+ * The descriptor is compiled on first use, or explicitly with
+ * cbprintf_fmt_compile(), and later output skips parsing of the conversion
+ * specifications. Arguments are packaged as for the format string alone,
+ * preferably with @ref CBPRINTF_STATIC_PACKAGE whose argument layout is
+ * computed at compile time, e.g.:
+ *
+ * @code{.c}
+ * static CBPRINTF_FMT_DESC_DEFINE(desc, "%s: %d\n");
+ *
+ * CBPRINTF_STATIC_PACKAGE(pkg, sizeof(pkg), len, 0, 0, desc.fmt, name, val);
+ * cbpprintf_desc(out, ctx, &desc, pkg);
+ * @endcode
+ *
+ * @note This type is available only when
+ * @kconfig{CONFIG_CBPRINTF_PRECOMPILED} is selected.
+ */
+struct cbprintf_fmt_desc {
+	/** Format string. */
+	const char *fmt;
+
+	/** Compilation state, internal. */
+	atomic_t state;
+
+	/** Number of conversions, internal. */
+	uint8_t conv_cnt;
+
+	/** Parsed conversions, internal. */
+	struct z_cbprintf_fmt_conv conv[CONFIG_CBPRINTF_PRECOMPILED_MAX_CONV];
+};
+
+/** @brief Statically initialize a format string descriptor.
+ *
+ * @param _fmt Format string. It must remain valid and unchanged for the
+ * lifetime of the descriptor.
+ */
+#define CBPRINTF_FMT_DESC_INIT(_fmt) \
+	{ \
+		.fmt = _fmt, \
+		.state = ATOMIC_INIT(Z_CBPRINTF_FMT_DESC_NEW), \
+	}
+
+/** @brief Define a format string descriptor.
+ *
+ * @param _name Name of the descriptor.
+ *
+ * @param _fmt Format string.
+ */
+#define CBPRINTF_FMT_DESC_DEFINE(_name, _fmt) \
+	struct cbprintf_fmt_desc _name = CBPRINTF_FMT_DESC_INIT(_fmt)
+
+/** @brief Precompile a format string descriptor.
+ *
+ * Parses the conversion specifications of the format string unless that has
+ * already been done. Calling it is optional, descriptors are compiled on
+ * first use.
+ *
+ * @param desc Descriptor.
+ *
+ * @retval 0 if descriptor is compiled.
+ * @retval -EBUSY if descriptor is being compiled by another thread.
+ * @retval -EINVAL if format string cannot be precompiled, e.g. because it
+ * has more than @kconfig{CONFIG_CBPRINTF_PRECOMPILED_MAX_CONV} conversions.
+ * Output through such descriptor parses the format string each time.
+ */
+int cbprintf_fmt_compile(struct cbprintf_fmt_desc *desc);
+
+/** @brief Format data using a precompiled format string.
+ *
+ * Like cbvprintf() with the format string of @p desc.
+ *
+ * @param out the function used to emit each generated character.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param desc format string descriptor.
+ *
+ * @param ap a reference to the values to be converted.
+ *
+ * @return the number of characters generated, or a negative error value
+ * returned from invoking @p out.
+ */
+int cbvprintf_desc(cbprintf_cb out, void *ctx, struct cbprintf_fmt_desc *desc,
+		   va_list ap);
+
+/** @brief Generate the output for a previously captured format operation
+ * using a precompiled format string.
+ *
+ * Like cbpprintf(). If the format string of the package is not the one of
+ * @p desc the package is output by parsing its format string.
+ *
+ * @param out the function used to emit each generated character.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param desc format string descriptor.
+ *
+ * @param packaged package with arguments for the format string of @p desc.
+ *
+ * @return the number of characters printed, or a negative error value
+ * returned from invoking @p out.
+ */
+int cbpprintf_desc(cbprintf_cb out, void *ctx, struct cbprintf_fmt_desc *desc,
+		   void *packaged);
+
+#endif /* CONFIG_CBPRINTF_PRECOMPILED */
+
 #ifdef CONFIG_CBPRINTF_LIBC_SUBSTS
 
 /** @brief fprintf using Zephyrs cbprintf infrastructure.
@@ -470,6 +470,27 @@ do { \
 	_Pragma("GCC diagnostic pop") \
 } while (0)
 
+/** @brief Conversion specification parsed by cbprintf_fmt_compile().
+ *
+ * @param lit_len Number of literal characters preceding the specification.
+ *
+ * @param spec_len Number of characters in the specification.
+ *
+ * @param conv Parsed specification, private to the formatter.
+ */
+struct z_cbprintf_fmt_conv {
+	uint16_t lit_len;
+	uint8_t spec_len;
+	uint8_t reserved;
+	uint32_t conv[3];
+};
+
+/* States of a format string descriptor. */
+#define Z_CBPRINTF_FMT_DESC_NEW 0
+#define Z_CBPRINTF_FMT_DESC_BUSY 1
+#define Z_CBPRINTF_FMT_DESC_READY 2
+#define Z_CBPRINTF_FMT_DESC_INVALID 3
+
 #if Z_C_GENERIC
 #define Z_CBPRINTF_STATIC_PACKAGE(packaged, inlen, outlen, align_offset, flags, \
 				  ... /* fmt, ... */) \
@@ -76,10 +76,38 @@ typedef struct sys_multi_mem_blocks sys_multi_mem_blocks_t;
 typedef sys_mem_blocks_t *(*sys_multi_mem_blocks_choice_fn_t)
 	(struct sys_multi_mem_blocks *group, void *cfg);
 
+/**
+ * @brief Fragmentation statistics of a buddy memory blocks allocator
+ */
+struct sys_mem_blocks_buddy_stats {
+	/** Number of free blocks */
+	size_t free_blocks;
+
+	/** Number of blocks in the largest free chunk, i.e. the largest
+	 * number of contiguous blocks that can be allocated
+	 */
+	size_t max_free_chunk;
+
+	/** Number of free chunks of 2^n blocks, indexed by n */
+	uint32_t free_chunks[32];
+};
+
 /**
  * @cond INTERNAL_HIDDEN
  */
 
+/* Free chunks of one order of a buddy allocator */
+struct sys_mem_blocks_buddy_order {
+	/* Offset of the free chunk bitmap of this order in words */
+	uint32_t base;
+
+	/* Number of free chunks */
+	uint32_t free;
+
+	/* All words of the bitmap below this one are zero */
+	uint32_t hint;
+};
+
 struct sys_mem_blocks {
 	/* Number of blocks */
 	uint32_t num_blocks;
@@ -93,6 +121,22 @@ struct sys_mem_blocks {
 	/* Bitmap of allocated blocks */
 	sys_bitarray_t *bitmap;
 
+#ifdef CONFIG_SYS_MEM_BLOCKS_BUDDY
+	/* Per order free chunk state, NULL unless a buddy allocator */
+	struct sys_mem_blocks_buddy_order *buddy_orders;
+
+	/* Bitmaps of free chunks, one per order */
+	uint32_t *buddy_map;
+
+	/* Largest chunk order, only valid once buddy_ready is set */
+	uint8_t buddy_max_order;
+
+	/* Set once the free chunks match the bitmap of allocated blocks */
+	bool buddy_ready;
+
+	/* Spinlock guarding the free chunks */
+	struct k_spinlock buddy_lock;
+#endif
 };
 
 struct sys_multi_mem_blocks {
@@ -142,6 +186,40 @@ struct sys_multi_mem_blocks {
 					   _sys_mem_blocks_buf_##name,	\
 					   mbmod);
 
+/**
+ * @def _SYS_MEM_BLOCKS_DEFINE_BUDDY
+ *
+ * @brief Create a buddy memory block object with a new backing buffer.
+ *
+ * The free chunk bitmap of order k takes (num_blks >> k) / 32 + 1
+ * words, which adds up to at most num_blks / 16 + ilog2(num_blks) + 1.
+ *
+ * @param name     Name of the memory block object.
+ * @param blk_sz   Size of each memory block (in bytes, power of 2).
+ * @param num_blks Total number of memory blocks.
+ * @param balign   Alignment of the memory block buffer (power of 2).
+ * @param mbmod    Modifier to the memory block struct
+ */
+#define _SYS_MEM_BLOCKS_DEFINE_BUDDY(name, blk_sz, num_blks, balign, mbmod) \
+	mbmod uint8_t __noinit_named(sys_mem_blocks_buf_##name)		\
+		__aligned(WB_UP(balign))				\
+		_sys_mem_blocks_buf_##name[num_blks * WB_UP(blk_sz)];	\
+	_SYS_BITARRAY_DEFINE(_sys_mem_blocks_bitmap_##name,		\
+			     num_blks, mbmod);				\
+	mbmod struct sys_mem_blocks_buddy_order				\
+		_sys_mem_blocks_buddy_orders_##name			\
+		[ilog2_compile_time_const_u32(num_blks) + 1];		\
+	mbmod uint32_t _sys_mem_blocks_buddy_map_##name			\
+		[(num_blks) / 16 + ilog2_compile_time_const_u32(num_blks) + 1]; \
+	mbmod sys_mem_blocks_t name = {					\
+		.num_blocks = num_blks,					\
+		.blk_sz_shift = ilog2(blk_sz),				\
+		.buffer = _sys_mem_blocks_buf_##name,			\
+		.bitmap = &_sys_mem_blocks_bitmap_##name,		\
+		.buddy_orders = _sys_mem_blocks_buddy_orders_##name,	\
+		.buddy_map = _sys_mem_blocks_buddy_map_##name,		\
+	}
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -199,6 +277,45 @@ struct sys_multi_mem_blocks {
 #define SYS_MEM_BLOCKS_DEFINE_STATIC_WITH_EXT_BUF(name, blk_sz, num_blks, buf) \
 	_SYS_MEM_BLOCKS_DEFINE_WITH_EXT_BUF(name, blk_sz, num_blks, buf, static)
 
+/**
+ * @def SYS_MEM_BLOCKS_DEFINE_BUDDY
+ *
+ * @brief Create a buddy memory block object with a new backing buffer.
+ *
+ * Contiguous blocks are allocated from this object as by a binary
+ * buddy allocator: a request for n blocks is served from the smallest
+ * free chunk of 2^k >= n blocks, aligned to 2^k blocks, whose unused
+ * tail is returned to the free chunks right away.  Freed blocks are
+ * merged with their free buddies.  Both take at most one step per
+ * order.  The allocated blocks are still tracked in the block bitmap,
+ * so all other memory blocks APIs work as usual.
+ *
+ * Requires CONFIG_SYS_MEM_BLOCKS_BUDDY.
+ *
+ * @param name      Name of the memory block object.
+ * @param blk_sz    Size of each memory block (in bytes).
+ * @param num_blks  Total number of memory blocks.
+ * @param buf_align Alignment of the memory block buffer (power of 2).
+ */
+#define SYS_MEM_BLOCKS_DEFINE_BUDDY(name, blk_sz, num_blks, buf_align) \
+	_SYS_MEM_BLOCKS_DEFINE_BUDDY(name, blk_sz, num_blks, buf_align,)
+
+/**
+ * @def SYS_MEM_BLOCKS_DEFINE_BUDDY_STATIC
+ *
+ * @brief Create a static buddy memory block object with a new backing
+ * buffer.
+ *
+ * @see SYS_MEM_BLOCKS_DEFINE_BUDDY
+ *
+ * @param name      Name of the memory block object.
+ * @param blk_sz    Size of each memory block (in bytes).
+ * @param num_blks  Total number of memory blocks.
+ * @param buf_align Alignment of the memory block buffer (power of 2).
+ */
+#define SYS_MEM_BLOCKS_DEFINE_BUDDY_STATIC(name, blk_sz, num_blks, buf_align) \
+	_SYS_MEM_BLOCKS_DEFINE_BUDDY(name, blk_sz, num_blks, buf_align, static)
+
 /**
  * @brief Allocate multiple memory blocks
  *
@@ -285,6 +402,22 @@ int sys_mem_blocks_free(sys_mem_blocks_t *mem_block, size_t count,
  */
 int sys_mem_blocks_free_contiguous(sys_mem_blocks_t *mem_block, void *block, size_t count);
 
+/**
+ * @brief Get the fragmentation statistics of a buddy memory block object
+ *
+ * The free memory is fragmented to the degree the largest free chunk
+ * is smaller than the free memory as a whole.
+ *
+ * @param[in]  mem_block Pointer to a memory block object defined with
+ *                       SYS_MEM_BLOCKS_DEFINE_BUDDY().
+ * @param[out] stats     Statistics.
+ *
+ * @retval 0       Successful
+ * @retval -EINVAL Invalid argument supplied, or not a buddy allocator.
+ */
+int sys_mem_blocks_buddy_stats_get(sys_mem_blocks_t *mem_block,
+				   struct sys_mem_blocks_buddy_stats *stats);
+
 /**
  * @brief Initialize multi memory blocks allocator group
  *
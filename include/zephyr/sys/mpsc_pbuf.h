@@ -234,6 +234,39 @@ const union mpsc_pbuf_generic *mpsc_pbuf_claim(struct mpsc_pbuf_buffer *buffer);
 void mpsc_pbuf_free(struct mpsc_pbuf_buffer *buffer,
 		    const union mpsc_pbuf_generic *packet);
 
+/** @brief Claim a run of pending packets.
+ *
+ * Claims up to @p max packets in the order they were committed, taking the
+ * buffer lock once. Claiming stops at the first packet which is not yet
+ * committed, so the packets returned are the same ones that successive calls
+ * to @ref mpsc_pbuf_claim would return.
+ *
+ * @param buffer Buffer.
+ *
+ * @param items Array filled with pointers to the claimed packets.
+ *
+ * @param max Size of @p items.
+ *
+ * @return Number of packets claimed.
+ */
+size_t mpsc_pbuf_claim_batch(struct mpsc_pbuf_buffer *buffer,
+			     const union mpsc_pbuf_generic **items, size_t max);
+
+/** @brief Free packets.
+ *
+ * Equivalent of calling @ref mpsc_pbuf_free for each packet but the buffer
+ * lock is taken once. Packets must be passed in the order they were claimed,
+ * typically as returned by @ref mpsc_pbuf_claim_batch.
+ *
+ * @param buffer Buffer.
+ *
+ * @param items Packets.
+ *
+ * @param count Number of packets.
+ */
+void mpsc_pbuf_free_batch(struct mpsc_pbuf_buffer *buffer,
+			  const union mpsc_pbuf_generic **items, size_t count);
+
 /** @brief Check if there are any message pending.
  *
  * @param buffer Buffer.
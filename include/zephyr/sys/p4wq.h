@@ -40,12 +40,34 @@ struct k_p4wq_work {
 	};
 	struct k_thread *thread;
 	struct k_p4wq *queue;
+#ifdef CONFIG_P4WQ_PER_CPU
+	/* Sub-queue holding the item, and whether it is pinned there */
+	uint8_t cpu;
+	bool pinned;
+#endif
+#ifdef CONFIG_P4WQ_STATS
+	uint32_t submit_time;
+#endif
 };
 
 #define K_P4WQ_QUEUE_PER_THREAD		BIT(0)
 #define K_P4WQ_DELAYED_START		BIT(1)
 #define K_P4WQ_USER_CPU_MASK		BIT(2)
 
+/**
+ * @brief P4 Queue statistics
+ *
+ * Gathered with CONFIG_P4WQ_STATS, see k_p4wq_stats_get().
+ */
+struct k_p4wq_stats {
+	uint32_t submitted;     /* # of items submitted */
+	uint32_t executed;      /* # of handler invocations */
+	uint32_t canceled;      /* # of items canceled */
+	uint32_t stolen;        /* # of items run off their sub-queue's CPU */
+	uint32_t latency_max;   /* cycles from submission to handler entry */
+	uint64_t latency_total; /* sum of the above for all executed items */
+};
+
 /**
  * @brief P4 Queue
  *
@@ -65,14 +87,29 @@ struct k_p4wq {
 	 */
 	_wait_q_t waitq;
 
+#ifdef CONFIG_P4WQ_PER_CPU
+	/* Work items waiting for processing, per CPU: items submitted
+	 * from that CPU, which any worker may steal, and items pinned to
+	 * it, which only workers pinned to it run.
+	 */
+	struct {
+		struct rbtree queue;
+		struct rbtree pinned;
+	} cpu[CONFIG_MP_NUM_CPUS];
+#else
 	/* Work items waiting for processing */
 	struct rbtree queue;
+#endif
 
 	/* Work items in progress */
 	sys_dlist_t active;
 
 	/* K_P4WQ_* flags above */
 	uint32_t flags;
+
+#ifdef CONFIG_P4WQ_STATS
+	struct k_p4wq_stats stats;
+#endif
 };
 
 struct k_p4wq_initparam {
@@ -164,6 +201,24 @@ void k_p4wq_add_thread(struct k_p4wq *queue, struct k_thread *thread,
 		       k_thread_stack_t *stack,
 		       size_t stack_size);
 
+/**
+ * @brief Add a thread pinned to a CPU to a P4 Queue pool
+ *
+ * As k_p4wq_add_thread(), but the thread only runs on @p cpu.  Items
+ * submitted with k_p4wq_submit_cpu() for that CPU are only run by such
+ * threads.  Needs CONFIG_SCHED_CPU_MASK.
+ *
+ * @param queue P4 Queue to which to add the thread
+ * @param thread Uninitialized/aborted thread object to add
+ * @param stack Thread stack memory
+ * @param stack_size Thread stack size
+ * @param cpu CPU index
+ * @return Zero on success, otherwise error code from k_thread_cpu_pin(),
+ * in which case the thread is not started.
+ */
+int k_p4wq_add_cpu_thread(struct k_p4wq *queue, struct k_thread *thread,
+			  k_thread_stack_t *stack, size_t stack_size, int cpu);
+
 /**
  * @brief Submit work item to a P4 queue
  *
@@ -187,6 +242,23 @@ void k_p4wq_add_thread(struct k_p4wq *queue, struct k_thread *thread,
  */
 void k_p4wq_submit(struct k_p4wq *queue, struct k_p4wq_work *item);
 
+/**
+ * @brief Submit work item pinned to a CPU to a P4 queue
+ *
+ * As k_p4wq_submit(), but the handler is only invoked by a thread
+ * added with k_p4wq_add_cpu_thread() for @p cpu (or a static thread
+ * enabled with @p cpu as only CPU in its mask).  The item competes on
+ * priority with the other items that such threads may run.
+ *
+ * Needs CONFIG_P4WQ_PER_CPU.
+ *
+ * @param queue P4 Queue to which to submit
+ * @param item P4 work item to be submitted
+ * @param cpu CPU index
+ */
+void k_p4wq_submit_cpu(struct k_p4wq *queue, struct k_p4wq_work *item,
+		       int cpu);
+
 /**
  * @brief Cancel submitted P4 work item
  *
@@ -207,4 +279,22 @@ int k_p4wq_wait(struct k_p4wq_work *work, k_timeout_t timeout);
 void k_p4wq_enable_static_thread(struct k_p4wq *queue, struct k_thread *thread,
 				 uint32_t cpu_mask);
 
+/**
+ * @brief Get P4 Queue statistics
+ *
+ * Needs CONFIG_P4WQ_STATS.
+ *
+ * @param queue P4 Queue
+ * @param stats Filled with the statistics gathered since the queue was
+ * initialized or k_p4wq_stats_reset() was called.
+ */
+void k_p4wq_stats_get(struct k_p4wq *queue, struct k_p4wq_stats *stats);
+
+/**
+ * @brief Reset P4 Queue statistics
+ *
+ * @param queue P4 Queue
+ */
+void k_p4wq_stats_reset(struct k_p4wq *queue);
+
 #endif /* ZEPHYR_INCLUDE_SYS_P4WQ_H_ */
@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/** @file */
+
+#ifndef ZEPHYR_INCLUDE_SYS_RING_BUFFER_LOCKFREE_H_
+#define ZEPHYR_INCLUDE_SYS_RING_BUFFER_LOCKFREE_H_
+
+#include <kernel.h>
+#include <sys/atomic.h>
+#include <sys/util.h>
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_RING_BUFFER_LOCKFREE_ALIGN
+#define Z_RING_BUF_LOCKFREE_ALIGN CONFIG_RING_BUFFER_LOCKFREE_ALIGN
+#else
+#define Z_RING_BUF_LOCKFREE_ALIGN 4
+#endif
+
+#define Z_RING_BUF_IS_POW2(x) (((x) != 0) && (((x) & ((x) - 1)) == 0))
+
+/**
+ * @defgroup ring_buffer_lockfree_apis Lock-free Ring Buffer APIs
+ * @ingroup datastructure_apis
+ *
+ * Ring buffers which can be shared between contexts without a lock. The
+ * single producer, single consumer (SPSC) variant is a byte buffer with the
+ * same claim and finish interface as @ref ring_buf. The multi producer, multi
+ * consumer (MPMC) variant stores records of up to a fixed size in slots.
+ *
+ * Producer and consumer indexes are aligned to
+ * @kconfig{CONFIG_RING_BUFFER_LOCKFREE_ALIGN} bytes so that they do not share
+ * a cache line.
+ * @{
+ */
+
+/**
+ * @brief A single producer, single consumer lock-free byte ring buffer.
+ *
+ * Indexes run freely and are reduced modulo the buffer size, which must be a
+ * power of 2. Each side keeps a copy of the other side's index and refreshes
+ * it only when the copy shows too little data or space.
+ */
+struct ring_buf_spsc {
+	uint8_t *buffer;
+	uint32_t mask;
+
+	struct {
+		atomic_t tail;
+		uint32_t head;
+		uint32_t get_tail;
+	} put __aligned(Z_RING_BUF_LOCKFREE_ALIGN);
+
+	struct {
+		atomic_t tail;
+		uint32_t head;
+		uint32_t put_tail;
+	} get __aligned(Z_RING_BUF_LOCKFREE_ALIGN);
+};
+
+/**
+ * @brief Define and initialize a SPSC lock-free ring buffer.
+ *
+ * @param name  Name of the ring buffer.
+ * @param size8 Size of ring buffer (in bytes), must be a power of 2.
+ */
+#define RING_BUF_SPSC_DECLARE(name, size8) \
+	BUILD_ASSERT(Z_RING_BUF_IS_POW2(size8), \
+		     "Size must be a power of 2"); \
+	static uint8_t __noinit _ring_buf_spsc_data_##name[size8]; \
+	struct ring_buf_spsc name = { \
+		.buffer = _ring_buf_spsc_data_##name, \
+		.mask = (size8) - 1 \
+	}
+
+/**
+ * @brief Force SPSC ring buffer indexes to given value.
+ *
+ * Any value other than 0 makes sense only in validation testing context.
+ */
+static inline void ring_buf_spsc_internal_reset(struct ring_buf_spsc *buf,
+						uint32_t value)
+{
+	buf->put.head = buf->put.get_tail = value;
+	buf->get.head = buf->get.put_tail = value;
+	atomic_set(&buf->put.tail, (atomic_val_t)value);
+	atomic_set(&buf->get.tail, (atomic_val_t)value);
+}
+
+/**
+ * @brief Initialize a SPSC lock-free ring buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param size Ring buffer size (in bytes), must be a power of 2.
+ * @param data Ring buffer data area (uint8_t data[size]).
+ */
+static inline void ring_buf_spsc_init(struct ring_buf_spsc *buf,
+				      uint32_t size, uint8_t *data)
+{
+	__ASSERT(Z_RING_BUF_IS_POW2(size), "Size must be a power of 2");
+
+	buf->buffer = data;
+	buf->mask = size - 1;
+	ring_buf_spsc_internal_reset(buf, 0);
+}
+
+/**
+ * @brief Return SPSC ring buffer capacity.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Ring buffer capacity (in bytes).
+ */
+static inline uint32_t ring_buf_spsc_capacity_get(struct ring_buf_spsc *buf)
+{
+	return buf->mask + 1;
+}
+
+/**
+ * @brief Determine amount of data in a SPSC ring buffer.
+ *
+ * Bytes which are claimed but not finished by either side are not taken into
+ * account. The result may be stale when the other side is active.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Number of bytes written to the ring buffer and not yet read.
+ */
+static inline uint32_t ring_buf_spsc_size_get(struct ring_buf_spsc *buf)
+{
+	return (uint32_t)atomic_get(&buf->put.tail) -
+	       (uint32_t)atomic_get(&buf->get.tail);
+}
+
+/**
+ * @brief Determine free space in a SPSC ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Ring buffer free space (in bytes).
+ */
+static inline uint32_t ring_buf_spsc_space_get(struct ring_buf_spsc *buf)
+{
+	return ring_buf_spsc_capacity_get(buf) - ring_buf_spsc_size_get(buf);
+}
+
+/**
+ * @brief Determine if a SPSC ring buffer is empty.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return true if the ring buffer is empty, or false if not.
+ */
+static inline bool ring_buf_spsc_is_empty(struct ring_buf_spsc *buf)
+{
+	return ring_buf_spsc_size_get(buf) == 0;
+}
+
+/**
+ * @brief Allocate buffer for writing data to a SPSC ring buffer.
+ *
+ * Equivalent of @ref ring_buf_put_claim. Only one context may write to the
+ * ring buffer, while another one reads from it without a lock.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to a location within
+ *		    ring buffer.
+ * @param[in]  size Requested allocation size (in bytes).
+ *
+ * @return Size of allocated buffer which can be smaller than requested if
+ *	   there is not enough free space or buffer wraps.
+ */
+uint32_t ring_buf_spsc_put_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Indicate number of bytes written to allocated buffers.
+ *
+ * Equivalent of @ref ring_buf_put_finish. Written bytes become visible to the
+ * consumer, surplus bytes are returned to the free space.
+ *
+ * @param buf  Address of ring buffer.
+ * @param size Number of valid bytes in the allocated buffers.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds the claimed space.
+ */
+int ring_buf_spsc_put_finish(struct ring_buf_spsc *buf, uint32_t size);
+
+/**
+ * @brief Write (copy) data to a SPSC ring buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written.
+ */
+uint32_t ring_buf_spsc_put(struct ring_buf_spsc *buf, const uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Get address of a valid data in a SPSC ring buffer.
+ *
+ * Equivalent of @ref ring_buf_get_claim. Only one context may read from the
+ * ring buffer, while another one writes to it without a lock.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to a location within
+ *		    ring buffer.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Number of valid bytes in the provided buffer which can be smaller
+ *	   than requested if there is not enough data or buffer wraps.
+ */
+uint32_t ring_buf_spsc_get_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Indicate number of bytes read from claimed buffer.
+ *
+ * Equivalent of @ref ring_buf_get_finish. Surplus bytes remain available in
+ * the buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param size Number of bytes that can be freed.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds the claimed data.
+ */
+int ring_buf_spsc_get_finish(struct ring_buf_spsc *buf, uint32_t size);
+
+/**
+ * @brief Read data from a SPSC ring buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of the output buffer. Can be NULL to discard data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes read.
+ */
+uint32_t ring_buf_spsc_get(struct ring_buf_spsc *buf, uint8_t *data,
+			   uint32_t size);
+
+/** @brief Internal state of a MPMC ring buffer slot. */
+struct ring_buf_mpmc_slot {
+	/** Sequence number, relative to the slot index. */
+	atomic_t seq;
+	/** Number of valid bytes. */
+	uint32_t len;
+};
+
+/**
+ * @brief A multi producer, multi consumer lock-free ring buffer.
+ *
+ * The buffer is split into a power of 2 number of slots of equal size. A
+ * producer claims a slot by advancing the put index with compare and swap and
+ * publishes it by updating the slot's sequence number, so no producer or
+ * consumer ever waits for another one. Slots are read in the order in which
+ * they were claimed for writing.
+ */
+struct ring_buf_mpmc {
+	uint8_t *buffer;
+	struct ring_buf_mpmc_slot *slots;
+	uint32_t slot_size;
+	uint32_t mask;
+
+	struct {
+		atomic_t head;
+	} put __aligned(Z_RING_BUF_LOCKFREE_ALIGN);
+
+	struct {
+		atomic_t head;
+	} get __aligned(Z_RING_BUF_LOCKFREE_ALIGN);
+};
+
+/**
+ * @brief Define and initialize a MPMC lock-free ring buffer.
+ *
+ * Slots are 32-bit aligned when @p slot_sz is a multiple of 4.
+ *
+ * @param name      Name of the ring buffer.
+ * @param slot_sz   Size of a slot (in bytes).
+ * @param num_slots Number of slots, must be a power of 2.
+ */
+#define RING_BUF_MPMC_DECLARE(name, slot_sz, num_slots) \
+	BUILD_ASSERT(Z_RING_BUF_IS_POW2(num_slots), \
+		     "Number of slots must be a power of 2"); \
+	static uint8_t __noinit __aligned(4) \
+		_ring_buf_mpmc_data_##name[(slot_sz) * (num_slots)]; \
+	static struct ring_buf_mpmc_slot \
+		_ring_buf_mpmc_slots_##name[num_slots]; \
+	struct ring_buf_mpmc name = { \
+		.buffer = _ring_buf_mpmc_data_##name, \
+		.slots = _ring_buf_mpmc_slots_##name, \
+		.slot_size = slot_sz, \
+		.mask = (num_slots) - 1 \
+	}
+
+/**
+ * @brief Initialize a MPMC lock-free ring buffer.
+ *
+ * @param buf       Address of ring buffer.
+ * @param slot_size Size of a slot (in bytes).
+ * @param num_slots Number of slots, must be a power of 2.
+ * @param data      Ring buffer data area (uint8_t data[slot_size * num_slots]).
+ * @param slots     Slot state (struct ring_buf_mpmc_slot slots[num_slots]).
+ */
+void ring_buf_mpmc_init(struct ring_buf_mpmc *buf, uint32_t slot_size,
+			uint32_t num_slots, uint8_t *data,
+			struct ring_buf_mpmc_slot *slots);
+
+/**
+ * @brief Claim a slot for writing to a MPMC ring buffer.
+ *
+ * Any number of contexts may claim slots concurrently. A claimed slot must
+ * be passed to @ref ring_buf_mpmc_put_finish, consumers stop at the oldest
+ * slot which is not yet finished.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Set to the claimed slot.
+ *
+ * @return Size of the slot (in bytes) or 0 if the ring buffer is full.
+ */
+uint32_t ring_buf_mpmc_put_claim(struct ring_buf_mpmc *buf, uint8_t **data);
+
+/**
+ * @brief Make a claimed slot available for reading.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Slot returned by @ref ring_buf_mpmc_put_claim.
+ * @param size Number of valid bytes in the slot. A slot finished with 0
+ *             bytes is skipped by consumers.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL @a data is not a slot or @a size exceeds the slot size.
+ */
+int ring_buf_mpmc_put_finish(struct ring_buf_mpmc *buf, uint8_t *data,
+			     uint32_t size);
+
+/**
+ * @brief Write (copy) a record to a MPMC ring buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes). Data beyond the slot size is not
+ *             written.
+ *
+ * @retval Number of bytes written, 0 if the ring buffer is full.
+ */
+uint32_t ring_buf_mpmc_put(struct ring_buf_mpmc *buf, const uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Claim the oldest finished slot of a MPMC ring buffer.
+ *
+ * Any number of contexts may claim slots concurrently. A claimed slot must
+ * be passed to @ref ring_buf_mpmc_get_finish to make it available to
+ * producers again.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Set to the claimed slot.
+ *
+ * @return Number of valid bytes in the slot or 0 if no data is available.
+ */
+uint32_t ring_buf_mpmc_get_claim(struct ring_buf_mpmc *buf, uint8_t **data);
+
+/**
+ * @brief Return a slot claimed for reading to the free space.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Slot returned by @ref ring_buf_mpmc_get_claim.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL @a data is not a slot.
+ */
+int ring_buf_mpmc_get_finish(struct ring_buf_mpmc *buf, uint8_t *data);
+
+/**
+ * @brief Read (copy) a record from a MPMC ring buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of the output buffer. Can be NULL to discard data.
+ * @param size Size of the output buffer (in bytes). The rest of a longer
+ *             record is discarded.
+ *
+ * @retval Number of bytes in the record, 0 if no data is available.
+ */
+uint32_t ring_buf_mpmc_get(struct ring_buf_mpmc *buf, uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_RING_BUFFER_LOCKFREE_H_ */
@@ -200,6 +200,18 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
  */
 size_t sys_heap_usable_size(struct sys_heap *heap, void *mem);
 
+/** @brief Return the size of the largest free block
+ *
+ * Returns the number of bytes the largest single allocation from the
+ * heap would get right now, without alignment constraints.  Compared
+ * to the total free memory, it shows how fragmented the heap is.
+ * This scans the free list of the biggest chunks only.
+ *
+ * @param heap Heap to query
+ * @return Size in bytes of the largest free block, 0 if there is none
+ */
+size_t sys_heap_largest_free(struct sys_heap *heap);
+
 /** @brief Validate heap integrity
  *
  * Validates the internal integrity of a sys_heap.  Intended for unit
@@ -25,6 +25,23 @@ extern "C" {
 static inline void z_init_timeout(struct _timeout *to)
 {
 	sys_dnode_init(&to->node);
+#ifdef CONFIG_TIMEOUT_SLACK
+	to->slack = 0U;
+#endif
+}
+
+static inline void z_timeout_slack_set(struct _timeout *to, k_timeout_t slack)
+{
+#ifdef CONFIG_TIMEOUT_SLACK
+	__ASSERT(!K_TIMEOUT_EQ(slack, K_FOREVER) &&
+		 Z_TICK_ABS(slack.ticks) < 0,
+		 "slack must be a relative duration");
+
+	to->slack = CLAMP(slack.ticks, 0, INT32_MAX);
+#else
+	ARG_UNUSED(to);
+	ARG_UNUSED(slack);
+#endif
 }
 
 void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
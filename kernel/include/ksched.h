@@ -405,4 +405,54 @@ static inline void z_sched_usage_switch(struct k_thread *thread)
 #endif
 }
 
+#ifdef CONFIG_SCHED_STATS
+/**
+ * @brief Account a context switch to @a thread on the current CPU
+ *
+ * Closes the outgoing thread's run time sample, records the incoming
+ * thread's wake latency if it was made ready since it last ran, and
+ * samples the run queue depth.  Like z_sched_usage_switch() it is
+ * idempotent, so both the core switch paths and the architecture's
+ * z_thread_mark_switched_in() hook can call it.  Must be called with
+ * local interrupts masked.
+ */
+void z_sched_stats_switch(struct k_thread *thread);
+#else
+static inline void z_sched_stats_switch(struct k_thread *thread)
+{
+	ARG_UNUSED(thread);
+}
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE_MISS
+/**
+ * @brief Check a thread being switched in or out for a missed deadline
+ *
+ * Must be called with local interrupts masked.
+ */
+void z_sched_deadline_check(struct k_thread *thread, bool switched_out);
+#endif
+
+static inline void z_sched_deadline_switch(struct k_thread *old_thread,
+					   struct k_thread *new_thread)
+{
+	ARG_UNUSED(old_thread);
+	ARG_UNUSED(new_thread);
+#ifdef CONFIG_SCHED_DEADLINE_MISS
+	z_sched_deadline_check(old_thread, true);
+	z_sched_deadline_check(new_thread, false);
+#endif
+}
+
+static inline void z_sched_stats_ready(struct k_thread *thread)
+{
+	ARG_UNUSED(thread);
+#ifdef CONFIG_SCHED_STATS
+	uint32_t now = k_cycle_get_32();
+
+	/* Zero is the null ("already accounted") value */
+	thread->base.sched_ready0 = (now == 0U) ? 1U : now;
+#endif
+}
+
 #endif /* ZEPHYR_KERNEL_INCLUDE_KSCHED_H_ */
@@ -9,11 +9,16 @@
 #include <wait_q.h>
 #include <init.h>
 #include <linker/linker-defs.h>
+#include <string.h>
 
 void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
 {
 	z_waitq_init(&h->wait_q);
 	sys_heap_init(&h->heap, mem, bytes);
+#ifdef CONFIG_HEAP_CPU_CACHE
+	memset(h->cache, 0, sizeof(h->cache));
+	h->cache_waiters = 0U;
+#endif
 
 	SYS_PORT_TRACING_OBJ_INIT(k_heap, h);
 }
@@ -61,22 +66,239 @@ SYS_INIT(statics_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 SYS_INIT(statics_init, POST_KERNEL, 0);
 #endif /* CONFIG_DEMAND_PAGING && !CONFIG_LINKER_GENERIC_SECTIONS_PRESENT_AT_BOOT */
 
+#ifdef CONFIG_HEAP_CPU_CACHE
+/* Per-CPU magazines of small blocks.  Class N holds blocks allocated
+ * as CACHE_CLASS_BYTES(N) bytes, and accepts any freed block whose
+ * usable size is at least that but less than twice that.  A CPU's
+ * magazines are protected by the spinlock of its cache, which other
+ * CPUs only take to drain them, so the fast paths don't contend on
+ * the heap lock.  When both are needed, h->lock is taken first.
+ */
+#define CACHE_CLASS_BYTES(cls) (16U << (cls))
+#define CACHE_MAX_BYTES CACHE_CLASS_BYTES(CONFIG_HEAP_CPU_CACHE_CLASSES - 1)
+#define CACHE_BATCH (CONFIG_HEAP_CPU_CACHE_DEPTH / 2)
+
+static int alloc_class(size_t bytes)
+{
+	int cls = 0;
+
+	while (bytes > CACHE_CLASS_BYTES(cls)) {
+		cls++;
+	}
+	return cls;
+}
+
+static int free_class(size_t usable)
+{
+	if (usable < CACHE_CLASS_BYTES(0)) {
+		return -1;
+	}
+
+	int cls = 31 - __builtin_clz((unsigned int)(usable / CACHE_CLASS_BYTES(0)));
+
+	return cls < CONFIG_HEAP_CPU_CACHE_CLASSES ? cls : -1;
+}
+
+/* must be called with h->lock and the cache lock held */
+static void cache_refill_locked(struct k_heap *h, struct z_heap_magazine *mag,
+				int cls)
+{
+	while (mag->count < CACHE_BATCH) {
+		void *mem = sys_heap_alloc(&h->heap, CACHE_CLASS_BYTES(cls));
+
+		if (mem == NULL) {
+			break;
+		}
+		mag->blocks[mag->count++] = mem;
+	}
+}
+
+/* Frees all but keep blocks of the magazine back to the heap, must
+ * be called with h->lock and the cache lock held.
+ */
+static void cache_drain_locked(struct k_heap *h, struct z_heap_magazine *mag,
+			       int keep)
+{
+	while (mag->count > keep) {
+		sys_heap_free(&h->heap, mag->blocks[--mag->count]);
+	}
+}
+
+static void *cache_alloc(struct k_heap *h, size_t bytes)
+{
+	int cls = alloc_class(bytes);
+	unsigned int irq = arch_irq_lock();
+	struct z_heap_cpu_cache *cache = &h->cache[_current_cpu->id];
+	struct z_heap_magazine *mag = &cache->classes[cls];
+	k_spinlock_key_t key = k_spin_lock(&cache->lock);
+	k_spinlock_key_t hkey;
+	void *ret = NULL;
+
+	if (mag->count == 0U) {
+		k_spin_unlock(&cache->lock, key);
+		hkey = k_spin_lock(&h->lock);
+		key = k_spin_lock(&cache->lock);
+
+		cache->misses++;
+		cache_refill_locked(h, mag, cls);
+		k_spin_unlock(&h->lock, hkey);
+	} else {
+		cache->hits++;
+	}
+
+	if (mag->count != 0U) {
+		ret = mag->blocks[--mag->count];
+	}
+
+	k_spin_unlock(&cache->lock, key);
+	arch_irq_unlock(irq);
+	return ret;
+}
+
+static bool cache_free(struct k_heap *h, void *mem)
+{
+	int cls = free_class(sys_heap_usable_size(&h->heap, mem));
+
+	if (cls < 0) {
+		return false;
+	}
+
+	unsigned int irq = arch_irq_lock();
+	struct z_heap_cpu_cache *cache = &h->cache[_current_cpu->id];
+	struct z_heap_magazine *mag = &cache->classes[cls];
+	k_spinlock_key_t key = k_spin_lock(&cache->lock);
+	k_spinlock_key_t hkey;
+	bool cached;
+
+	if (mag->count == CONFIG_HEAP_CPU_CACHE_DEPTH) {
+		k_spin_unlock(&cache->lock, key);
+		hkey = k_spin_lock(&h->lock);
+		key = k_spin_lock(&cache->lock);
+
+		cache_drain_locked(h, mag, CONFIG_HEAP_CPU_CACHE_DEPTH - CACHE_BATCH);
+		cache->flushes++;
+		k_spin_unlock(&h->lock, hkey);
+	}
+
+	/* Blocked allocators are only woken by the slow path.  They
+	 * raise cache_waiters under h->lock and then drain every cache,
+	 * so a block is either pushed before that drain or not at all.
+	 */
+	cached = (h->cache_waiters == 0U);
+	if (cached) {
+		mag->blocks[mag->count++] = mem;
+	}
+
+	k_spin_unlock(&cache->lock, key);
+	arch_irq_unlock(irq);
+	return cached;
+}
+
+/* Returns the blocks in the magazines of all CPUs to the heap, must
+ * be called with h->lock held.
+ */
+static bool cache_flush_locked(struct k_heap *h)
+{
+	bool flushed = false;
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		struct z_heap_cpu_cache *cache = &h->cache[cpu];
+		k_spinlock_key_t key = k_spin_lock(&cache->lock);
+
+		for (int cls = 0; cls < CONFIG_HEAP_CPU_CACHE_CLASSES; cls++) {
+			flushed = flushed || (cache->classes[cls].count != 0U);
+			cache_drain_locked(h, &cache->classes[cls], 0);
+		}
+
+		k_spin_unlock(&cache->lock, key);
+	}
+
+	return flushed;
+}
+
+void k_heap_cache_flush(struct k_heap *h)
+{
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+
+	(void)cache_flush_locked(h);
+	k_spin_unlock(&h->lock, key);
+}
+
+int k_heap_cache_stats_get(struct k_heap *h, struct k_heap_cache_stats *stats)
+{
+	if ((h == NULL) || (stats == NULL)) {
+		return -EINVAL;
+	}
+
+	*stats = (struct k_heap_cache_stats) { 0 };
+
+	/* The heap lock keeps the chunk headers of cached blocks stable */
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		struct z_heap_cpu_cache *cache = &h->cache[cpu];
+		k_spinlock_key_t ckey = k_spin_lock(&cache->lock);
+
+		stats->hits += cache->hits;
+		stats->misses += cache->misses;
+		stats->flushes += cache->flushes;
+
+		for (int cls = 0; cls < CONFIG_HEAP_CPU_CACHE_CLASSES; cls++) {
+			struct z_heap_magazine *mag = &cache->classes[cls];
+
+			for (int i = 0; i < mag->count; i++) {
+				stats->cached_bytes +=
+					sys_heap_usable_size(&h->heap, mag->blocks[i]);
+			}
+		}
+
+		k_spin_unlock(&cache->lock, ckey);
+	}
+
+	stats->largest_free = sys_heap_largest_free(&h->heap);
+
+	k_spin_unlock(&h->lock, key);
+	return 0;
+}
+#endif /* CONFIG_HEAP_CPU_CACHE */
+
 void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 			k_timeout_t timeout)
 {
 	int64_t now, end = sys_clock_timeout_end_calc(timeout);
 	void *ret = NULL;
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, aligned_alloc, h, timeout);
 
 	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
 
+#ifdef CONFIG_HEAP_CPU_CACHE
+	if ((align <= sizeof(void *)) && (bytes != 0U) &&
+	    (bytes <= CACHE_MAX_BYTES)) {
+		ret = cache_alloc(h, bytes);
+		if (ret != NULL) {
+			SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, h,
+						       timeout, ret);
+			return ret;
+		}
+	}
+#endif
+
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
 	bool blocked_alloc = false;
 
 	while (ret == NULL) {
 		ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
 
+#ifdef CONFIG_HEAP_CPU_CACHE
+		/* Give back memory parked in the magazines of all
+		 * CPUs before failing or blocking.
+		 */
+		if ((ret == NULL) && cache_flush_locked(h)) {
+			continue;
+		}
+#endif
+
 		now = sys_clock_tick_get();
 		if (!IS_ENABLED(CONFIG_MULTITHREADING) ||
 		    (ret != NULL) || ((end - now) <= 0)) {
@@ -93,9 +315,23 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 			 */
 		}
 
+#ifdef CONFIG_HEAP_CPU_CACHE
+		/* Frees bypass the magazines until this thread is woken,
+		 * flush again for those which cached a block before that.
+		 */
+		h->cache_waiters++;
+		if (cache_flush_locked(h)) {
+			h->cache_waiters--;
+			continue;
+		}
+#endif
+
 		(void) z_pend_curr(&h->lock, key, &h->wait_q,
 				   K_TICKS(end - now));
 		key = k_spin_lock(&h->lock);
+#ifdef CONFIG_HEAP_CPU_CACHE
+		h->cache_waiters--;
+#endif
 	}
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc, h, timeout, ret);
@@ -117,6 +353,13 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout)
 
 void k_heap_free(struct k_heap *h, void *mem)
 {
+#ifdef CONFIG_HEAP_CPU_CACHE
+	if ((mem != NULL) && cache_free(h, mem)) {
+		SYS_PORT_TRACING_OBJ_FUNC(k_heap, free, h);
+		return;
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&h->lock);
 
 	sys_heap_free(&h->heap, mem);
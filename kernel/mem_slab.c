@@ -14,6 +14,7 @@
 #include <ksched.h>
 #include <init.h>
 #include <sys/check.h>
+#include <string.h>
 
 /**
  * @brief Initialize kernel memory slab subsystem.
@@ -87,6 +88,10 @@ int k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	slab->max_used = 0U;
 #endif
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	slab->cache_bypass = false;
+	(void)memset(slab->cache, 0, sizeof(slab->cache));
+#endif
 
 	rc = create_free_list(slab);
 	if (rc < 0) {
@@ -101,22 +106,153 @@ out:
 	return rc;
 }
 
+static inline void update_max_used(struct k_mem_slab *slab)
+{
+#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+	slab->max_used = MAX(k_mem_slab_num_used_get(slab), slab->max_used);
+#else
+	ARG_UNUSED(slab);
+#endif
+}
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+/* Each CPU keeps a small stack of free blocks per slab, protected by
+ * its own spinlock so that the common case never touches the slab
+ * lock.  When both are needed the slab lock is taken first.  Blocks
+ * in a cache are counted in num_used (they are off the free list);
+ * k_mem_slab_num_used_get() subtracts them again.
+ */
+#define CACHE_BATCH (CONFIG_MEM_SLAB_CPU_CACHE_DEPTH / 2)
+
+static int cache_alloc(struct k_mem_slab *slab, void **mem)
+{
+	/* Interrupts stay locked throughout to pin us to this CPU */
+	unsigned int key = arch_irq_lock();
+	struct z_mem_slab_cpu_cache *cache = &slab->cache[_current_cpu->id];
+	k_spinlock_key_t ckey = k_spin_lock(&cache->lock);
+	int result = -ENOMEM;
+
+	if (cache->count == 0U) {
+		k_spin_unlock(&cache->lock, ckey);
+
+		k_spinlock_key_t skey = k_spin_lock(&slab->lock);
+
+		ckey = k_spin_lock(&cache->lock);
+		while ((cache->count < CACHE_BATCH) &&
+		       (slab->free_list != NULL)) {
+			cache->blocks[cache->count++] = slab->free_list;
+			slab->free_list = *(char **)(slab->free_list);
+			slab->num_used++;
+		}
+		k_spin_unlock(&slab->lock, skey);
+	}
+
+	if (cache->count != 0U) {
+		*mem = cache->blocks[--cache->count];
+		update_max_used(slab);
+		result = 0;
+	}
+
+	k_spin_unlock(&cache->lock, ckey);
+	arch_irq_unlock(key);
+
+	return result;
+}
+
+static int cache_free(struct k_mem_slab *slab, void *mem)
+{
+	unsigned int key = arch_irq_lock();
+	struct z_mem_slab_cpu_cache *cache = &slab->cache[_current_cpu->id];
+	k_spinlock_key_t ckey = k_spin_lock(&cache->lock);
+	int result = -EAGAIN;
+
+	if (slab->cache_bypass) {
+		goto out;
+	}
+
+	if (cache->count == CONFIG_MEM_SLAB_CPU_CACHE_DEPTH) {
+		k_spin_unlock(&cache->lock, ckey);
+
+		k_spinlock_key_t skey = k_spin_lock(&slab->lock);
+
+		ckey = k_spin_lock(&cache->lock);
+		if (slab->cache_bypass) {
+			k_spin_unlock(&slab->lock, skey);
+			goto out;
+		}
+
+		while (cache->count > CONFIG_MEM_SLAB_CPU_CACHE_DEPTH - CACHE_BATCH) {
+			char *p = cache->blocks[--cache->count];
+
+			*(char **)p = slab->free_list;
+			slab->free_list = p;
+			slab->num_used--;
+		}
+		k_spin_unlock(&slab->lock, skey);
+	}
+
+	cache->blocks[cache->count++] = mem;
+	result = 0;
+
+out:
+	k_spin_unlock(&cache->lock, ckey);
+	arch_irq_unlock(key);
+
+	return result;
+}
+
+/* Returns every CPU's cached blocks to the free list, must be called
+ * with the slab lock held.
+ */
+static void cache_flush_all_locked(struct k_mem_slab *slab)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct z_mem_slab_cpu_cache *cache = &slab->cache[i];
+		k_spinlock_key_t ckey = k_spin_lock(&cache->lock);
+
+		while (cache->count != 0U) {
+			char *p = cache->blocks[--cache->count];
+
+			*(char **)p = slab->free_list;
+			slab->free_list = p;
+			slab->num_used--;
+		}
+		k_spin_unlock(&cache->lock, ckey);
+	}
+}
+#endif /* CONFIG_MEM_SLAB_CPU_CACHE */
+
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 {
-	k_spinlock_key_t key = k_spin_lock(&slab->lock);
 	int result;
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_mem_slab, alloc, slab, timeout);
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (cache_alloc(slab, mem) == 0) {
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, 0);
+		return 0;
+	}
+#endif
+
+	k_spinlock_key_t key = k_spin_lock(&slab->lock);
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (slab->free_list == NULL) {
+		/* Keep frees away from the caches while we may end up
+		 * pending, then reclaim what the other CPUs hold.
+		 */
+		slab->cache_bypass = true;
+		cache_flush_all_locked(slab);
+	}
+#endif
+
 	if (slab->free_list != NULL) {
 		/* take a free block */
 		*mem = slab->free_list;
 		slab->free_list = *(char **)(slab->free_list);
 		slab->num_used++;
-
-#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
-		slab->max_used = MAX(slab->num_used, slab->max_used);
-#endif
+		update_max_used(slab);
 
 		result = 0;
 	} else if (K_TIMEOUT_EQ(timeout, K_NO_WAIT) ||
@@ -138,6 +274,10 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 		return result;
 	}
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	slab->cache_bypass = (z_waitq_head(&slab->wait_q) != NULL);
+#endif
+
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, alloc, slab, timeout, result);
 
 	k_spin_unlock(&slab->lock, key);
@@ -147,13 +287,24 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_mem_slab, free, slab);
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (cache_free(slab, *mem) == 0) {
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
+		return;
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&slab->lock);
 
-	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_mem_slab, free, slab);
 	if (slab->free_list == NULL && IS_ENABLED(CONFIG_MULTITHREADING)) {
 		struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
 
 		if (pending_thread != NULL) {
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+			slab->cache_bypass = (z_waitq_head(&slab->wait_q) != NULL);
+#endif
 			SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
 
 			z_thread_return_value_set_with_data(pending_thread, 0, *mem);
@@ -165,6 +316,9 @@ void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 	**(char ***) mem = slab->free_list;
 	slab->free_list = *(char **) mem;
 	slab->num_used--;
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	slab->cache_bypass = (z_waitq_head(&slab->wait_q) != NULL);
+#endif
 
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mem_slab, free, slab);
 
@@ -42,6 +42,8 @@ void k_msgq_init(struct k_msgq *msgq, char *buffer, size_t msg_size,
 	msgq->read_ptr = buffer;
 	msgq->write_ptr = buffer;
 	msgq->used_msgs = 0;
+	msgq->put_claimed = 0;
+	msgq->get_claimed = 0;
 	msgq->flags = 0;
 	z_waitq_init(&msgq->wait_q);
 	msgq->lock = (struct k_spinlock) {};
@@ -125,7 +127,10 @@ int z_impl_k_msgq_put(struct k_msgq *msgq, const void *data, k_timeout_t timeout
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_msgq, put, msgq, timeout);
 
-	if (msgq->used_msgs < msgq->max_msgs) {
+	if (msgq->put_claimed != 0U) {
+		/* a claim owns the space at write_ptr */
+		result = -EBUSY;
+	} else if (msgq->used_msgs < msgq->max_msgs) {
 		/* message queue isn't full */
 		pending_thread = z_unpend_first_thread(&msgq->wait_q);
 		if (pending_thread != NULL) {
@@ -185,6 +190,349 @@ static inline int z_vrfy_k_msgq_put(struct k_msgq *msgq, const void *data,
 #include <syscalls/k_msgq_put_mrsh.c>
 #endif
 
+/* Copies up to num_msgs messages from src into the free space of the
+ * ring buffer, returns the number copied
+ */
+static uint32_t msgq_copy_in(struct k_msgq *msgq, const char *src,
+			     uint32_t num_msgs)
+{
+	uint32_t copied = 0;
+
+	num_msgs = MIN(num_msgs, msgq->max_msgs - msgq->used_msgs);
+
+	while (copied < num_msgs) {
+		uint32_t run = MIN(num_msgs - copied,
+				   (uint32_t)((msgq->buffer_end - msgq->write_ptr) /
+					      msgq->msg_size));
+
+		(void)memcpy(msgq->write_ptr, src, run * msgq->msg_size);
+		src += run * msgq->msg_size;
+		msgq->write_ptr += run * msgq->msg_size;
+		if (msgq->write_ptr == msgq->buffer_end) {
+			msgq->write_ptr = msgq->buffer_start;
+		}
+		copied += run;
+	}
+	msgq->used_msgs += copied;
+
+	return copied;
+}
+
+/* Copies up to num_msgs messages out of the ring buffer into dst,
+ * returns the number copied
+ */
+static uint32_t msgq_copy_out(struct k_msgq *msgq, char *dst,
+			      uint32_t num_msgs)
+{
+	uint32_t copied = 0;
+
+	num_msgs = MIN(num_msgs, msgq->used_msgs);
+
+	while (copied < num_msgs) {
+		uint32_t run = MIN(num_msgs - copied,
+				   (uint32_t)((msgq->buffer_end - msgq->read_ptr) /
+					      msgq->msg_size));
+
+		(void)memcpy(dst, msgq->read_ptr, run * msgq->msg_size);
+		dst += run * msgq->msg_size;
+		msgq->read_ptr += run * msgq->msg_size;
+		if (msgq->read_ptr == msgq->buffer_end) {
+			msgq->read_ptr = msgq->buffer_start;
+		}
+		copied += run;
+	}
+	msgq->used_msgs -= copied;
+
+	return copied;
+}
+
+/* Hands queued messages to the threads waiting to receive, which
+ * only wait while the queue is empty, so must only be called if it
+ * was.  Returns true if any thread was readied.
+ */
+static bool msgq_feed_readers(struct k_msgq *msgq)
+{
+	struct k_thread *pending_thread;
+	bool readied = false;
+
+	while ((msgq->used_msgs > 0U) &&
+	       ((pending_thread = z_unpend_first_thread(&msgq->wait_q)) != NULL)) {
+		(void)msgq_copy_out(msgq, pending_thread->base.swap_data, 1);
+		arch_thread_return_value_set(pending_thread, 0);
+		z_ready_thread(pending_thread);
+		readied = true;
+	}
+
+	return readied;
+}
+
+/* Moves the messages of threads waiting to send, which only wait
+ * while the queue is full, into freed space.  Returns true if any
+ * thread was readied.
+ */
+static bool msgq_drain_writers(struct k_msgq *msgq)
+{
+	struct k_thread *pending_thread;
+	bool readied = false;
+
+	while ((msgq->used_msgs < msgq->max_msgs) &&
+	       ((pending_thread = z_unpend_first_thread(&msgq->wait_q)) != NULL)) {
+		(void)msgq_copy_in(msgq, pending_thread->base.swap_data, 1);
+		arch_thread_return_value_set(pending_thread, 0);
+		z_ready_thread(pending_thread);
+		readied = true;
+	}
+
+	return readied;
+}
+
+int z_impl_k_msgq_put_many(struct k_msgq *msgq, const void *data,
+			   uint32_t num_msgs, k_timeout_t timeout)
+{
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	const char *src = data;
+	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
+	bool readied = false;
+	uint32_t sent = 0;
+	int result;
+
+	if (num_msgs == 0U) {
+		return 0;
+	}
+
+	key = k_spin_lock(&msgq->lock);
+
+	if (msgq->put_claimed != 0U) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EBUSY;
+	}
+
+	/* Receivers only wait on an empty queue */
+	while ((msgq->used_msgs == 0U) && (sent < num_msgs) &&
+	       ((pending_thread = z_unpend_first_thread(&msgq->wait_q)) != NULL)) {
+		(void)memcpy(pending_thread->base.swap_data,
+			     src + sent * msgq->msg_size, msgq->msg_size);
+		arch_thread_return_value_set(pending_thread, 0);
+		z_ready_thread(pending_thread);
+		readied = true;
+		sent++;
+	}
+
+	if (sent < num_msgs) {
+		uint32_t queued = msgq_copy_in(msgq, src + sent * msgq->msg_size,
+					       num_msgs - sent);
+
+#ifdef CONFIG_POLL
+		if (queued > 0U) {
+			handle_poll_events(msgq, K_POLL_STATE_MSGQ_DATA_AVAILABLE);
+		}
+#endif /* CONFIG_POLL */
+		sent += queued;
+	}
+
+	if (sent > 0U) {
+		if (readied) {
+			z_reschedule(&msgq->lock, key);
+		} else {
+			k_spin_unlock(&msgq->lock, key);
+		}
+		return sent;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		k_spin_unlock(&msgq->lock, key);
+		return -ENOMSG;
+	}
+
+	/* wait to send the first message, as k_msgq_put() */
+	_current->base.swap_data = (void *)data;
+	result = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+
+	return result == 0 ? 1 : result;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_msgq_put_many(struct k_msgq *msgq,
+					 const void *data, uint32_t num_msgs,
+					 k_timeout_t timeout)
+{
+	size_t size;
+
+	Z_OOPS(Z_SYSCALL_OBJ(msgq, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_VERIFY_MSG(!size_mul_overflow(msgq->msg_size,
+						       num_msgs, &size),
+				    "message size overflow"));
+	Z_OOPS(Z_SYSCALL_MEMORY_READ(data, size));
+
+	return z_impl_k_msgq_put_many(msgq, data, num_msgs, timeout);
+}
+#include <syscalls/k_msgq_put_many_mrsh.c>
+#endif
+
+int z_impl_k_msgq_get_many(struct k_msgq *msgq, void *data,
+			   uint32_t max_msgs, k_timeout_t timeout)
+{
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	k_spinlock_key_t key;
+	uint32_t received;
+	int result;
+
+	if (max_msgs == 0U) {
+		return 0;
+	}
+
+	key = k_spin_lock(&msgq->lock);
+
+	if (msgq->get_claimed != 0U) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EBUSY;
+	}
+
+	if (msgq->used_msgs > 0U) {
+		received = msgq_copy_out(msgq, data, max_msgs);
+
+		if (msgq_drain_writers(msgq)) {
+			z_reschedule(&msgq->lock, key);
+		} else {
+			k_spin_unlock(&msgq->lock, key);
+		}
+		return received;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		k_spin_unlock(&msgq->lock, key);
+		return -ENOMSG;
+	}
+
+	/* wait to receive the first message, as k_msgq_get() */
+	_current->base.swap_data = data;
+	result = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+
+	return result == 0 ? 1 : result;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_msgq_get_many(struct k_msgq *msgq, void *data,
+					 uint32_t max_msgs,
+					 k_timeout_t timeout)
+{
+	size_t size;
+
+	Z_OOPS(Z_SYSCALL_OBJ(msgq, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_VERIFY_MSG(!size_mul_overflow(msgq->msg_size,
+						       max_msgs, &size),
+				    "message size overflow"));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(data, size));
+
+	return z_impl_k_msgq_get_many(msgq, data, max_msgs, timeout);
+}
+#include <syscalls/k_msgq_get_many_mrsh.c>
+#endif
+
+int k_msgq_put_claim(struct k_msgq *msgq, void **data, uint32_t max_msgs)
+{
+	k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+	int result;
+
+	if (msgq->put_claimed != 0U) {
+		result = -EBUSY;
+	} else {
+		msgq->put_claimed = MIN(MIN(max_msgs,
+					    msgq->max_msgs - msgq->used_msgs),
+					(uint32_t)((msgq->buffer_end - msgq->write_ptr) /
+						   msgq->msg_size));
+		*data = msgq->write_ptr;
+		result = msgq->put_claimed;
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+
+	return result;
+}
+
+int k_msgq_put_finish(struct k_msgq *msgq, uint32_t num_msgs)
+{
+	k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+	bool was_empty = msgq->used_msgs == 0U;
+	bool readied;
+
+	if (num_msgs > msgq->put_claimed) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EINVAL;
+	}
+
+	msgq->put_claimed = 0U;
+	msgq->write_ptr += num_msgs * msgq->msg_size;
+	if (msgq->write_ptr == msgq->buffer_end) {
+		msgq->write_ptr = msgq->buffer_start;
+	}
+	msgq->used_msgs += num_msgs;
+
+	readied = was_empty && msgq_feed_readers(msgq);
+
+#ifdef CONFIG_POLL
+	if ((num_msgs > 0U) && (msgq->used_msgs > 0U)) {
+		handle_poll_events(msgq, K_POLL_STATE_MSGQ_DATA_AVAILABLE);
+	}
+#endif /* CONFIG_POLL */
+
+	if (readied) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+
+	return 0;
+}
+
+int k_msgq_get_claim(struct k_msgq *msgq, void **data, uint32_t max_msgs)
+{
+	k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+	int result;
+
+	if (msgq->get_claimed != 0U) {
+		result = -EBUSY;
+	} else {
+		msgq->get_claimed = MIN(MIN(max_msgs, msgq->used_msgs),
+					(uint32_t)((msgq->buffer_end - msgq->read_ptr) /
+						   msgq->msg_size));
+		*data = msgq->read_ptr;
+		result = msgq->get_claimed;
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+
+	return result;
+}
+
+int k_msgq_get_finish(struct k_msgq *msgq, uint32_t num_msgs)
+{
+	k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+
+	if (num_msgs > msgq->get_claimed) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EINVAL;
+	}
+
+	msgq->get_claimed = 0U;
+	msgq->read_ptr += num_msgs * msgq->msg_size;
+	if (msgq->read_ptr == msgq->buffer_end) {
+		msgq->read_ptr = msgq->buffer_start;
+	}
+	msgq->used_msgs -= num_msgs;
+
+	if ((num_msgs > 0U) && msgq_drain_writers(msgq)) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+
+	return 0;
+}
+
 void z_impl_k_msgq_get_attrs(struct k_msgq *msgq, struct k_msgq_attrs *attrs)
 {
 	attrs->msg_size = msgq->msg_size;
@@ -215,7 +563,10 @@ int z_impl_k_msgq_get(struct k_msgq *msgq, void *data, k_timeout_t timeout)
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_msgq, get, msgq, timeout);
 
-	if (msgq->used_msgs > 0U) {
+	if (msgq->get_claimed != 0U) {
+		/* a claim owns the messages at read_ptr */
+		result = -EBUSY;
+	} else if (msgq->used_msgs > 0U) {
 		/* take first available message from queue */
 		(void)memcpy(data, msgq->read_ptr, msgq->msg_size);
 		msgq->read_ptr += msgq->msg_size;
@@ -331,6 +682,7 @@ void z_impl_k_msgq_purge(struct k_msgq *msgq)
 	}
 
 	msgq->used_msgs = 0;
+	msgq->get_claimed = 0;
 	msgq->read_ptr = msgq->write_ptr;
 
 	z_reschedule(&msgq->lock, key);
@@ -92,6 +92,86 @@ static bool adjust_owner_prio(struct k_mutex *mutex, int32_t new_prio)
 	return false;
 }
 
+/* Takes a free (or recursively locked) mutex and releases the lock */
+static int take_locked(struct k_mutex *mutex, k_spinlock_key_t key,
+		       k_timeout_t timeout)
+{
+	mutex->owner_orig_prio = (mutex->lock_count == 0U) ?
+				_current->base.prio :
+				mutex->owner_orig_prio;
+
+	mutex->lock_count++;
+	mutex->owner = _current;
+
+	LOG_DBG("%p took mutex %p, count: %d, orig prio: %d",
+		_current, mutex, mutex->lock_count,
+		mutex->owner_orig_prio);
+
+	k_spin_unlock(&lock, key);
+
+	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mutex, lock, mutex, timeout, 0);
+
+	return 0;
+}
+
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+static inline bool owner_is_running(struct k_thread *owner)
+{
+	struct k_thread *volatile *current =
+		&_kernel.cpus[owner->base.cpu].current;
+
+	return *current == owner;
+}
+
+/* Busy-waits while the mutex is held by a thread running on another
+ * CPU, which is likely to release it before a pend and a context
+ * switch would complete.  Gives up as soon as the owner stops running
+ * or the spin limit is reached.  Threads already pending have
+ * precedence, so this doesn't spin if there are any.
+ *
+ * Called and returns with the lock held, never for K_NO_WAIT.  Returns
+ * true if the mutex is now free.  Otherwise the time spent spinning is
+ * taken off @a timeout, which is K_NO_WAIT if none is left.
+ */
+static bool spin_on_owner(struct k_mutex *mutex, k_spinlock_key_t *key,
+			  k_timeout_t *timeout)
+{
+	struct k_thread *owner = mutex->owner;
+	volatile uint32_t *lock_count = &mutex->lock_count;
+	int64_t end;
+
+	if ((z_waitq_head(&mutex->wait_q) != NULL) ||
+	    !owner_is_running(owner)) {
+		return false;
+	}
+
+	k_spin_unlock(&lock, *key);
+
+	end = sys_clock_timeout_end_calc(*timeout);
+
+	for (int i = 0; i < CONFIG_MUTEX_ADAPTIVE_SPIN_LIMIT; i++) {
+		if ((*lock_count == 0U) || !owner_is_running(owner)) {
+			break;
+		}
+		arch_nop();
+	}
+
+	*key = k_spin_lock(&lock);
+
+	if (mutex->lock_count == 0U) {
+		return true;
+	}
+
+	if (!K_TIMEOUT_EQ(*timeout, K_FOREVER)) {
+		int64_t left = end - sys_clock_tick_get();
+
+		*timeout = (left > 0) ? K_TICKS(left) : K_NO_WAIT;
+	}
+
+	return false;
+}
+#endif /* CONFIG_MUTEX_ADAPTIVE_SPIN */
+
 int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 {
 	int new_prio;
@@ -105,32 +185,31 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 	key = k_spin_lock(&lock);
 
 	if (likely((mutex->lock_count == 0U) || (mutex->owner == _current))) {
+		return take_locked(mutex, key, timeout);
+	}
 
-		mutex->owner_orig_prio = (mutex->lock_count == 0U) ?
-					_current->base.prio :
-					mutex->owner_orig_prio;
-
-		mutex->lock_count++;
-		mutex->owner = _current;
-
-		LOG_DBG("%p took mutex %p, count: %d, orig prio: %d",
-			_current, mutex, mutex->lock_count,
-			mutex->owner_orig_prio);
-
+	if (unlikely(K_TIMEOUT_EQ(timeout, K_NO_WAIT))) {
 		k_spin_unlock(&lock, key);
 
-		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mutex, lock, mutex, timeout, 0);
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mutex, lock, mutex, timeout, -EBUSY);
 
-		return 0;
+		return -EBUSY;
+	}
+
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+	if (spin_on_owner(mutex, &key, &timeout)) {
+		return take_locked(mutex, key, timeout);
 	}
 
 	if (unlikely(K_TIMEOUT_EQ(timeout, K_NO_WAIT))) {
+		/* The whole timeout went spinning */
 		k_spin_unlock(&lock, key);
 
-		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mutex, lock, mutex, timeout, -EBUSY);
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_mutex, lock, mutex, timeout, -EAGAIN);
 
-		return -EBUSY;
+		return -EAGAIN;
 	}
+#endif
 
 	SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(k_mutex, lock, mutex, timeout);
 
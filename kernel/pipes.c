@@ -14,6 +14,7 @@
 #include <kernel_structs.h>
 
 #include <toolchain.h>
+#include <string.h>
 #include <ksched.h>
 #include <wait_q.h>
 #include <init.h>
@@ -38,6 +39,8 @@ void k_pipe_init(struct k_pipe *pipe, unsigned char *buffer, size_t size)
 	pipe->bytes_used = 0;
 	pipe->read_index = 0;
 	pipe->write_index = 0;
+	pipe->put_claimed = 0;
+	pipe->get_claimed = 0;
 	pipe->lock = (struct k_spinlock){};
 	z_waitq_init(&pipe->wait_q.writers);
 	z_waitq_init(&pipe->wait_q.readers);
@@ -91,6 +94,7 @@ void z_impl_k_pipe_flush(struct k_pipe *pipe)
 
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
+	pipe->get_claimed = 0;
 	(void) pipe_get_internal(key, pipe, NULL, (size_t) -1, &bytes_read, 0,
 				 K_NO_WAIT);
 
@@ -116,6 +120,7 @@ void z_impl_k_pipe_buffer_flush(struct k_pipe *pipe)
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
 	if (pipe->buffer != NULL) {
+		pipe->get_claimed = 0;
 		(void) pipe_get_internal(key, pipe, NULL, pipe->size,
 					 &bytes_read, 0, K_NO_WAIT);
 	}
@@ -160,6 +165,8 @@ int k_pipe_cleanup(struct k_pipe *pipe)
 		pipe->bytes_used = 0;
 		pipe->read_index = 0;
 		pipe->write_index = 0;
+		pipe->put_claimed = 0;
+		pipe->get_claimed = 0;
 		pipe->flags &= ~K_PIPE_FLAG_ALLOC;
 	}
 
@@ -179,18 +186,13 @@ static size_t pipe_xfer(unsigned char *dest, size_t dest_size,
 			 const unsigned char *src, size_t src_size)
 {
 	size_t num_bytes = MIN(dest_size, src_size);
-	const unsigned char *end = src + num_bytes;
 
 	if (dest == NULL) {
 		/* Data is being flushed. Pretend the data was copied. */
 		return num_bytes;
 	}
 
-	while (src != end) {
-		*dest = *src;
-		dest++;
-		src++;
-	}
+	(void)memcpy(dest, src, num_bytes);
 
 	return num_bytes;
 }
@@ -412,6 +414,16 @@ int z_impl_k_pipe_put(struct k_pipe *pipe, void *data, size_t bytes_to_write,
 
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
+	if (pipe->put_claimed != 0U) {
+		/* A claim owns the space at write_index */
+		k_spin_unlock(&pipe->lock, key);
+		*bytes_written = 0;
+
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_pipe, put, pipe, timeout, -EBUSY);
+
+		return -EBUSY;
+	}
+
 	/*
 	 * Create a list of "working readers" into which the data will be
 	 * directly copied.
@@ -735,6 +747,16 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
+	if (pipe->get_claimed != 0U) {
+		/* A claim owns the data at read_index */
+		k_spin_unlock(&pipe->lock, key);
+		*bytes_read = 0;
+
+		SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_pipe, get, pipe, timeout, -EBUSY);
+
+		return -EBUSY;
+	}
+
 	int ret = pipe_get_internal(key, pipe, data, bytes_to_read, bytes_read,
 				    min_xfer, timeout);
 
@@ -758,6 +780,138 @@ int z_vrfy_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 #include <syscalls/k_pipe_get_mrsh.c>
 #endif
 
+int k_pipe_put_claim(struct k_pipe *pipe, uint8_t **data, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+	int ret;
+
+	if (pipe->put_claimed != 0U) {
+		ret = -EBUSY;
+	} else {
+		pipe->put_claimed = MIN(MIN(size, (size_t)INT_MAX),
+					MIN(pipe->size - pipe->bytes_used,
+					    pipe->size - pipe->write_index));
+		*data = pipe->buffer + pipe->write_index;
+		ret = pipe->put_claimed;
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return ret;
+}
+
+int k_pipe_put_finish(struct k_pipe *pipe, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+	struct k_thread *reader;
+	struct k_pipe_desc *desc;
+	bool readied = false;
+
+	if (size > pipe->put_claimed) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->put_claimed = 0;
+	pipe->bytes_used += size;
+	pipe->write_index += size;
+	if (pipe->write_index == pipe->size) {
+		pipe->write_index = 0;
+	}
+
+	/*
+	 * Readers only wait on an empty buffer: hand them the data, in
+	 * the order they are waiting.  One whose request can't be
+	 * completed keeps waiting with what it got, as in k_pipe_put().
+	 */
+	while ((pipe->bytes_used > 0U) &&
+	       ((reader = z_waitq_head(&pipe->wait_q.readers)) != NULL)) {
+		desc = (struct k_pipe_desc *)reader->base.swap_data;
+		size = pipe_buffer_get(pipe, desc->buffer, desc->bytes_to_xfer);
+		desc->buffer        += size;
+		desc->bytes_to_xfer -= size;
+
+		if (desc->bytes_to_xfer != 0U) {
+			break;
+		}
+		z_unpend_thread(reader);
+		z_ready_thread(reader);
+		readied = true;
+	}
+
+	if (readied) {
+		z_reschedule(&pipe->lock, key);
+	} else {
+		k_spin_unlock(&pipe->lock, key);
+	}
+
+	return 0;
+}
+
+int k_pipe_get_claim(struct k_pipe *pipe, uint8_t **data, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+	int ret;
+
+	if (pipe->get_claimed != 0U) {
+		ret = -EBUSY;
+	} else {
+		pipe->get_claimed = MIN(MIN(size, (size_t)INT_MAX),
+					MIN(pipe->bytes_used,
+					    pipe->size - pipe->read_index));
+		*data = pipe->buffer + pipe->read_index;
+		ret = pipe->get_claimed;
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return ret;
+}
+
+int k_pipe_get_finish(struct k_pipe *pipe, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+	struct k_thread *writer;
+	struct k_pipe_desc *desc;
+	bool readied = false;
+
+	if (size > pipe->get_claimed) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->get_claimed = 0;
+	pipe->bytes_used -= size;
+	pipe->read_index += size;
+	if (pipe->read_index == pipe->size) {
+		pipe->read_index = 0;
+	}
+
+	/* Writers only wait on a full buffer: let them refill it */
+	while ((pipe->bytes_used < pipe->size) &&
+	       ((writer = z_waitq_head(&pipe->wait_q.writers)) != NULL)) {
+		desc = (struct k_pipe_desc *)writer->base.swap_data;
+		size = pipe_buffer_put(pipe, desc->buffer, desc->bytes_to_xfer);
+		desc->buffer        += size;
+		desc->bytes_to_xfer -= size;
+
+		if (desc->bytes_to_xfer != 0U) {
+			break;
+		}
+		z_unpend_thread(writer);
+		z_ready_thread(writer);
+		readied = true;
+	}
+
+	if (readied) {
+		z_reschedule(&pipe->lock, key);
+	} else {
+		k_spin_unlock(&pipe->lock, key);
+	}
+
+	return 0;
+}
+
 size_t z_impl_k_pipe_read_avail(struct k_pipe *pipe)
 {
 	size_t res;
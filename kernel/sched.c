@@ -210,6 +210,9 @@ static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
 	cpu = m == 0 ? 0 : u32_count_trailing_zeros(m);
 
 	return &_kernel.cpus[cpu].ready_q.runq;
+#elif defined(CONFIG_SCHED_CPU_RUNQ)
+	/* base.cpu is never changed while the thread is queued */
+	return &_kernel.cpus[thread->base.cpu].ready_q.runq;
 #else
 	return &_kernel.ready_q.runq;
 #endif
@@ -217,26 +220,138 @@ static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
 
 static ALWAYS_INLINE void *curr_cpu_runq(void)
 {
-#ifdef CONFIG_SCHED_CPU_MASK_PIN_ONLY
+#if defined(CONFIG_SCHED_CPU_MASK_PIN_ONLY) || defined(CONFIG_SCHED_CPU_RUNQ)
 	return &arch_curr_cpu()->ready_q.runq;
 #else
 	return &_kernel.ready_q.runq;
 #endif
 }
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* Picks the CPU whose run queue a thread is added to: the one it last
+ * ran on for cache locality, unless its mask forbids it.
+ */
+static ALWAYS_INLINE void runq_place(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	uint32_t m = thread->base.cpu_mask;
+
+	if ((m != 0U) && ((m & BIT(thread->base.cpu)) == 0U)) {
+		thread->base.cpu = u32_count_trailing_zeros(m);
+	}
+#endif
+	if (thread->base.cpu >= CONFIG_MP_NUM_CPUS) {
+		thread->base.cpu = 0;
+	}
+}
+
+/* True if a thread found on another CPU's queue should be run instead
+ * of the best local one.
+ */
+static ALWAYS_INLINE bool should_steal(struct k_thread *remote,
+				       struct k_thread *local)
+{
+	if (local == NULL) {
+		return true;
+	}
+
+	/* Never take a thread that isn't more urgent, deadline included */
+	if (z_sched_prio_cmp(remote, local) <= 0) {
+		return false;
+	}
+
+	/* The tolerance counts static priority levels, deadlines only
+	 * order threads within a level: with a zero threshold an earlier
+	 * deadline at the same priority is stolen, with any other it
+	 * isn't.
+	 */
+	return (local->base.prio - remote->base.prio) >=
+		CONFIG_SCHED_CPU_RUNQ_STEAL_THRESHOLD;
+}
+#endif
+
+/* Tracks the thread count of a run queue for the SCHED_STATS depth
+ * histogram, and which per-CPU run queues have threads to steal
+ */
+static ALWAYS_INLINE void runq_count(void *runq, int delta)
+{
+#if defined(CONFIG_SCHED_STATS) || defined(CONFIG_SCHED_CPU_RUNQ)
+	struct _ready_q *ready_q = CONTAINER_OF(runq, struct _ready_q, runq);
+
+	ready_q->depth += delta;
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* Not _cpu.id, which isn't set until the CPU starts */
+	uint32_t cpu = CONTAINER_OF(ready_q, struct _cpu, ready_q) - _kernel.cpus;
+
+	if (ready_q->depth == 0U) {
+		_kernel.runq_busy &= ~BIT(cpu);
+	} else {
+		_kernel.runq_busy |= BIT(cpu);
+	}
+#endif
+#else
+	ARG_UNUSED(runq);
+	ARG_UNUSED(delta);
+#endif
+}
+
 static ALWAYS_INLINE void runq_add(struct k_thread *thread)
 {
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	runq_place(thread);
+#endif
 	_priq_run_add(thread_runq(thread), thread);
+	runq_count(thread_runq(thread), 1);
 }
 
 static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
 {
 	_priq_run_remove(thread_runq(thread), thread);
+	runq_count(thread_runq(thread), -1);
 }
 
 static ALWAYS_INLINE struct k_thread *runq_best(void)
 {
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	struct k_thread *local = _priq_run_best(curr_cpu_runq());
+	struct k_thread *remote = NULL;
+	int id = _current_cpu->id;
+	uint32_t busy = _kernel.runq_busy & ~BIT(id);
+
+	/* This runs with sched_spinlock held on every scheduling
+	 * decision, so only look at the queues of other CPUs that have
+	 * threads: usually none, or few, and then no remote data is
+	 * touched at all.
+	 */
+	if (busy == 0U) {
+		return local;
+	}
+
+	/* Walk the other CPUs starting after ours, so that idle CPUs
+	 * don't all pile onto the same victim queue.  With
+	 * SCHED_CPU_MASK the "best" call already skips threads this
+	 * CPU isn't allowed to run.
+	 */
+	for (int i = 1; i < CONFIG_MP_NUM_CPUS; i++) {
+		int cpu = (id + i) % CONFIG_MP_NUM_CPUS;
+		struct k_thread *t;
+
+		if ((busy & BIT(cpu)) == 0U) {
+			continue;
+		}
+
+		t = _priq_run_best(&_kernel.cpus[cpu].ready_q.runq);
+
+		if ((t != NULL) &&
+		    ((remote == NULL) || (z_sched_prio_cmp(t, remote) > 0))) {
+			remote = t;
+		}
+	}
+
+	return ((remote != NULL) && should_steal(remote, local)) ? remote : local;
+#else
 	return _priq_run_best(curr_cpu_runq());
+#endif
 }
 
 /* _current is never in the run queue until context switch on
@@ -595,6 +710,7 @@ static void ready_thread(struct k_thread *thread)
 	if (!z_is_thread_queued(thread) && z_is_thread_ready(thread)) {
 		SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_ready, thread);
 
+		z_sched_stats_ready(thread);
 		queue_thread(thread);
 		update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
@@ -1033,12 +1149,15 @@ void *z_get_next_switch_handle(void *interrupted)
 		z_sched_usage_switch(new_thread);
 
 		if (old_thread != new_thread) {
+			z_sched_stats_switch(new_thread);
+			z_sched_deadline_switch(old_thread, new_thread);
 			update_metairq_preempt(new_thread);
 			wait_for_switch(new_thread);
 			arch_cohere_stacks(old_thread, interrupted, new_thread);
 
 			_current_cpu->swap_ok = 0;
 			set_current(new_thread);
+			new_thread->base.cpu = arch_curr_cpu()->id;
 
 #ifdef CONFIG_TIMESLICING
 			z_reset_time_slice(new_thread);
@@ -1073,6 +1192,10 @@ void *z_get_next_switch_handle(void *interrupted)
 	return ret;
 #else
 	z_sched_usage_switch(_kernel.ready_q.cache);
+	z_sched_stats_switch(_kernel.ready_q.cache);
+	if (_current != _kernel.ready_q.cache) {
+		z_sched_deadline_switch(_current, _kernel.ready_q.cache);
+	}
 	_current->switch_handle = interrupted;
 	set_current(_kernel.ready_q.cache);
 	return _current->switch_handle;
@@ -1238,7 +1361,7 @@ void init_ready_q(struct _ready_q *rq)
 
 void z_sched_init(void)
 {
-#ifdef CONFIG_SCHED_CPU_MASK_PIN_ONLY
+#if defined(CONFIG_SCHED_CPU_MASK_PIN_ONLY) || defined(CONFIG_SCHED_CPU_RUNQ)
 	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
 		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
@@ -1299,13 +1422,36 @@ static inline void z_vrfy_k_thread_priority_set(k_tid_t thread, int prio)
 void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 {
 	struct k_thread *thread = tid;
+	bool need_sched;
 
 	LOCKED(&sched_spinlock) {
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
+#ifdef CONFIG_SCHED_DEADLINE_MISS
+		thread->base.deadline_armed = true;
+#endif
 		if (z_is_thread_queued(thread)) {
 			dequeue_thread(thread);
 			queue_thread(thread);
 		}
+
+		/* As for a priority change, the new deadline may put a
+		 * ready thread ahead of, or behind, the running one.  A
+		 * thread pushing its own deadline out is allowed to be
+		 * switched out, like z_set_prio() does.
+		 */
+		need_sched = z_is_thread_ready(thread);
+		if (need_sched) {
+			update_cache(thread == _current);
+		}
+	}
+
+	if (need_sched) {
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+		arch_sched_ipi();
+#endif
+		if (_current->base.sched_locked == 0U) {
+			z_reschedule_unlocked();
+		}
 	}
 }
 
@@ -1323,6 +1469,60 @@ static inline void z_vrfy_k_thread_deadline_set(k_tid_t tid, int deadline)
 }
 #include <syscalls/k_thread_deadline_set_mrsh.c>
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE_MISS
+/* A deadline is missed if its thread is still runnable once it has
+ * passed, which the scheduler notices the next time the thread is
+ * switched in or out.  Blocking before the deadline meets it.
+ */
+void z_sched_deadline_check(struct k_thread *thread, bool switched_out)
+{
+	int32_t late;
+
+	if (!thread->base.deadline_armed) {
+		return;
+	}
+
+	late = (int32_t)(k_cycle_get_32() - thread->base.prio_deadline);
+
+	if (late > 0) {
+		thread->base.deadline_armed = false;
+		thread->base.deadline_misses++;
+		if (thread->base.deadline_miss_fn != NULL) {
+			thread->base.deadline_miss_fn(thread,
+					thread->base.deadline_miss_data);
+		}
+	} else if (switched_out && !z_is_thread_ready(thread)) {
+		/* Blocked in time: the deadline was met */
+		thread->base.deadline_armed = false;
+	}
+}
+
+void k_thread_deadline_miss_handler_set(k_tid_t thread,
+					k_thread_deadline_miss_fn_t handler,
+					void *data)
+{
+	LOCKED(&sched_spinlock) {
+		thread->base.deadline_miss_fn = handler;
+		thread->base.deadline_miss_data = data;
+	}
+}
+
+uint32_t z_impl_k_thread_deadline_misses_get(k_tid_t thread)
+{
+	return thread->base.deadline_misses;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline uint32_t z_vrfy_k_thread_deadline_misses_get(k_tid_t thread)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(thread, K_OBJ_THREAD));
+
+	return z_impl_k_thread_deadline_misses_get(thread);
+}
+#include <syscalls/k_thread_deadline_misses_get_mrsh.c>
+#endif
+#endif /* CONFIG_SCHED_DEADLINE_MISS */
 #endif
 
 void z_impl_k_yield(void)
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+
+#include <ksched.h>
+#include <kswap.h>
+#include <string.h>
+
+/* Need one of these for this to work */
+#if !defined(CONFIG_USE_SWITCH) && !defined(CONFIG_INSTRUMENT_THREAD_SWITCHING)
+#error "No data backend configured for CONFIG_SCHED_STATS"
+#endif
+
+/* The stats are only written on context switches, which hold
+ * sched_spinlock (or, without CONFIG_USE_SWITCH, which is uniprocessor
+ * only, run with interrupts locked), and by the reset calls, which
+ * take it.  Writers are therefore serialized already, and the sequence
+ * count only protects the readers, which take no lock so as to stay
+ * off the switch path: it is odd while the stats are written, and a
+ * reader copies them until the count shows no write overlapped the
+ * copy.
+ */
+static ALWAYS_INLINE void stats_write_begin(atomic_t *seq)
+{
+	(void)atomic_inc(seq);
+}
+
+static ALWAYS_INLINE void stats_write_end(atomic_t *seq)
+{
+	(void)atomic_inc(seq);
+}
+
+static void stats_reset(atomic_t *seq, void *stats, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&sched_spinlock);
+
+	stats_write_begin(seq);
+	(void)memset(stats, 0, size);
+	stats_write_end(seq);
+
+	k_spin_unlock(&sched_spinlock, key);
+}
+
+static void stats_read(atomic_t *seq, void *dst, const void *src,
+		       size_t size)
+{
+	atomic_val_t start;
+
+	do {
+		start = atomic_get(seq);
+		(void)memcpy(dst, src, size);
+
+		/* Fully ordered, unlike a plain load, so that the copy
+		 * above can't be delayed past it.
+		 */
+	} while (((start & 1) != 0) || (atomic_add(seq, 0) != start));
+}
+
+static ALWAYS_INLINE void hist_add(struct k_sched_hist *hist, uint32_t val)
+{
+	int i = (val == 0U) ? 0 : (31 - __builtin_clz(val));
+
+	hist->bucket[MIN(i, CONFIG_SCHED_STATS_BUCKETS - 1)]++;
+}
+
+static ALWAYS_INLINE uint32_t runq_depth(struct _cpu *cpu)
+{
+#if defined(CONFIG_SCHED_CPU_MASK_PIN_ONLY) || defined(CONFIG_SCHED_CPU_RUNQ)
+	return cpu->ready_q.depth;
+#else
+	ARG_UNUSED(cpu);
+	return _kernel.ready_q.depth;
+#endif
+}
+
+#ifdef CONFIG_SCHED_STATS_THREAD
+static ALWAYS_INLINE struct k_thread_sched_stats *
+thread_write_begin(struct k_thread *thread)
+{
+	stats_write_begin(&thread->base.sched_stats_seq);
+
+	return &thread->base.sched_stats;
+}
+#endif
+
+static void account_out(struct _cpu *cpu, struct k_thread *thread,
+			uint32_t now)
+{
+	uint32_t cycles = now - cpu->sched_stats_run0;
+	bool preempted = z_is_thread_ready(thread);
+
+	hist_add(&cpu->sched_stats.run_time, cycles);
+	if (preempted) {
+		cpu->sched_stats.preemptions++;
+	}
+
+#ifdef CONFIG_SCHED_STATS_THREAD
+	struct k_thread_sched_stats *stats = thread_write_begin(thread);
+
+	hist_add(&stats->run_time, cycles);
+	if (preempted) {
+		stats->preemptions++;
+	}
+
+	stats_write_end(&thread->base.sched_stats_seq);
+#endif
+}
+
+static void account_in(struct _cpu *cpu, struct k_thread *thread,
+		       uint32_t now)
+{
+	uint32_t ready0 = thread->base.sched_ready0;
+	uint32_t depth = runq_depth(cpu);
+#ifdef CONFIG_SCHED_STATS_THREAD
+	struct k_thread_sched_stats *stats = thread_write_begin(thread);
+#endif
+
+	if (ready0 != 0U) {
+		hist_add(&cpu->sched_stats.wake_latency, now - ready0);
+#ifdef CONFIG_SCHED_STATS_THREAD
+		hist_add(&stats->wake_latency, now - ready0);
+#endif
+		thread->base.sched_ready0 = 0U;
+	}
+
+	cpu->sched_stats.switches++;
+#ifdef CONFIG_SCHED_STATS_THREAD
+	stats->switches++;
+	stats_write_end(&thread->base.sched_stats_seq);
+#endif
+
+	hist_add(&cpu->sched_stats.runq_depth, depth);
+	cpu->sched_stats.runq_depth_max = MAX(cpu->sched_stats.runq_depth_max,
+					      depth);
+}
+
+void z_sched_stats_switch(struct k_thread *thread)
+{
+	struct _cpu *cpu = _current_cpu;
+	struct k_thread *old = cpu->sched_stats_thread;
+	uint32_t now;
+
+	if (old == thread) {
+		return;
+	}
+
+	now = k_cycle_get_32();
+	stats_write_begin(&cpu->sched_stats_seq);
+
+	/* The idle thread's dispatches aren't time slices, and
+	 * switching away from it is never a preemption.
+	 */
+	if ((old != NULL) && !z_is_idle_thread_object(old)) {
+		account_out(cpu, old, now);
+	}
+
+	if (!z_is_idle_thread_object(thread)) {
+		account_in(cpu, thread, now);
+	}
+
+	cpu->sched_stats_thread = thread;
+	cpu->sched_stats_run0 = now;
+
+	stats_write_end(&cpu->sched_stats_seq);
+}
+
+int k_thread_sched_stats_get(k_tid_t thread,
+			     struct k_thread_sched_stats *stats)
+{
+	if ((thread == NULL) || (stats == NULL)) {
+		return -EINVAL;
+	}
+
+#ifdef CONFIG_SCHED_STATS_THREAD
+	stats_read(&thread->base.sched_stats_seq, stats,
+		   &thread->base.sched_stats, sizeof(*stats));
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+int k_thread_sched_stats_reset(k_tid_t thread)
+{
+	if (thread == NULL) {
+		return -EINVAL;
+	}
+
+#ifdef CONFIG_SCHED_STATS_THREAD
+	stats_reset(&thread->base.sched_stats_seq, &thread->base.sched_stats,
+		    sizeof(thread->base.sched_stats));
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+int k_cpu_sched_stats_get(int cpu, struct k_cpu_sched_stats *stats)
+{
+	if ((cpu < 0) || (cpu >= CONFIG_MP_NUM_CPUS) || (stats == NULL)) {
+		return -EINVAL;
+	}
+
+	stats_read(&_kernel.cpus[cpu].sched_stats_seq, stats,
+		   &_kernel.cpus[cpu].sched_stats, sizeof(*stats));
+
+	return 0;
+}
+
+int k_cpu_sched_stats_reset(int cpu)
+{
+	if ((cpu < 0) || (cpu >= CONFIG_MP_NUM_CPUS)) {
+		return -EINVAL;
+	}
+
+	stats_reset(&_kernel.cpus[cpu].sched_stats_seq,
+		    &_kernel.cpus[cpu].sched_stats,
+		    sizeof(_kernel.cpus[cpu].sched_stats));
+
+	return 0;
+}
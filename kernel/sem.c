@@ -114,6 +114,43 @@ static inline void z_vrfy_k_sem_give(struct k_sem *sem)
 #include <syscalls/k_sem_give_mrsh.c>
 #endif
 
+void z_impl_k_sem_give_n(struct k_sem *sem, unsigned int count)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct k_thread *thread;
+
+	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_sem, give, sem);
+
+	/* Hand units to the waiters first, as k_sem_give() would */
+	while (count > 0U) {
+		thread = z_unpend_first_thread(&sem->wait_q);
+		if (thread == NULL) {
+			break;
+		}
+		arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+		count--;
+	}
+
+	if (count > 0U) {
+		sem->count += MIN(count, sem->limit - sem->count);
+		handle_poll_events(sem);
+	}
+
+	z_reschedule(&lock, key);
+
+	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_sem, give, sem);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline void z_vrfy_k_sem_give_n(struct k_sem *sem, unsigned int count)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(sem, K_OBJ_SEM));
+	z_impl_k_sem_give_n(sem, count);
+}
+#include <syscalls/k_sem_give_n_mrsh.c>
+#endif
+
 int z_impl_k_sem_take(struct k_sem *sem, k_timeout_t timeout)
 {
 	int ret = 0;
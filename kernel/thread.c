@@ -623,6 +623,11 @@ char *z_setup_new_thread(struct k_thread *new_thread,
 #endif
 #ifdef CONFIG_SCHED_DEADLINE
 	new_thread->base.prio_deadline = 0;
+#endif
+#ifdef CONFIG_SCHED_DEADLINE_MISS
+	new_thread->base.deadline_armed = false;
+	new_thread->base.deadline_misses = 0U;
+	new_thread->base.deadline_miss_fn = NULL;
 #endif
 	new_thread->resource_pool = _current->resource_pool;
 
@@ -632,6 +637,14 @@ char *z_setup_new_thread(struct k_thread *new_thread,
 		CONFIG_SCHED_THREAD_USAGE_AUTO_ENABLE;
 #endif
 
+#ifdef CONFIG_SCHED_STATS
+	new_thread->base.sched_ready0 = 0U;
+#endif
+#ifdef CONFIG_SCHED_STATS_THREAD
+	atomic_clear(&new_thread->base.sched_stats_seq);
+	new_thread->base.sched_stats = (struct k_thread_sched_stats) {};
+#endif
+
 	SYS_PORT_TRACING_OBJ_FUNC(k_thread, create, new_thread);
 
 	return stack_ptr;
@@ -802,6 +815,7 @@ void z_init_thread_base(struct _thread_base *thread_base, int priority,
 
 #ifdef CONFIG_SMP
 	thread_base->is_idle = 0;
+	thread_base->cpu = 0;
 #endif
 
 #ifdef CONFIG_TIMESLICE_PER_THREAD
@@ -1046,6 +1060,14 @@ void z_thread_mark_switched_in(void)
 	z_sched_usage_start(_current);
 #endif
 
+#if defined(CONFIG_SCHED_STATS) && !defined(CONFIG_USE_SWITCH)
+	z_sched_stats_switch(_current);
+#endif
+
+#if defined(CONFIG_SCHED_DEADLINE_MISS) && !defined(CONFIG_USE_SWITCH)
+	z_sched_deadline_check(_current, false);
+#endif
+
 #ifdef CONFIG_TRACING
 	SYS_PORT_TRACING_FUNC(k_thread, switched_in);
 #endif
@@ -1057,6 +1079,10 @@ void z_thread_mark_switched_out(void)
 	z_sched_usage_stop();
 #endif
 
+#if defined(CONFIG_SCHED_DEADLINE_MISS) && !defined(CONFIG_USE_SWITCH)
+	z_sched_deadline_check(_current, true);
+#endif
+
 #ifdef CONFIG_TRACING
 	SYS_PORT_TRACING_FUNC(k_thread, switched_out);
 #endif
@@ -11,11 +11,10 @@
 #include <syscall_handler.h>
 #include <drivers/timer/system_timer.h>
 #include <sys_clock.h>
+#include <sys/math_extras.h>
 
 static uint64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
 #define MAX_WAIT (IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE) \
@@ -36,6 +35,299 @@ static inline int z_vrfy_sys_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+static int32_t elapsed(void)
+{
+	return announce_remaining == 0 ? sys_clock_elapsed() : 0U;
+}
+
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+
+/* Hierarchical timing wheel.  Each timeout stores its absolute
+ * expiry tick in dticks (only the low word when !TIMEOUT_64BIT) and
+ * lives in exactly one slot, selected by the highest group of
+ * WHEEL_BITS bits in which the expiry differs from curr_tick.  Level
+ * N therefore holds timeouts that share all bits above group N with
+ * the current tick, and every timeout in level N expires before any
+ * timeout in level N+1.  Timeouts differing above the last level go
+ * to an unsorted overflow list.  As curr_tick advances, the slot it
+ * enters at each level is cascaded down by reinserting its entries.
+ *
+ * A slot list is only valid while its bit is set in the level's
+ * occupancy mask, which lets the (large) slot array live in BSS
+ * without an init hook.
+ */
+#define WHEEL_BITS 5
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1U)
+#define WHEEL_LEVELS CONFIG_TIMEOUT_QUEUE_WHEEL_LEVELS
+
+static sys_dlist_t wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint32_t wheel_occupied[WHEEL_LEVELS];
+static sys_dlist_t wheel_overflow = SYS_DLIST_STATIC_INIT(&wheel_overflow);
+
+/* Cached expiry of the earliest timeout, recomputed lazily */
+static uint64_t wheel_first;
+static bool wheel_first_valid;
+
+static uint64_t expiry(const struct _timeout *t)
+{
+	if (IS_ENABLED(CONFIG_TIMEOUT_64BIT)) {
+		return (uint64_t)t->dticks;
+	}
+
+	/* Pending timeouts are always within INT32_MAX of curr_tick */
+	return curr_tick + (int32_t)((uint32_t)t->dticks - (uint32_t)curr_tick);
+}
+
+static sys_dlist_t *wheel_slot(uint64_t exp, int *level, uint32_t *slot)
+{
+	uint64_t diff = exp ^ curr_tick;
+	int lvl = diff == 0U ? 0 : (63 - u64_count_leading_zeros(diff)) / WHEEL_BITS;
+
+	*level = lvl;
+	if (lvl >= WHEEL_LEVELS) {
+		*slot = 0U;
+		return &wheel_overflow;
+	}
+
+	*slot = (uint32_t)(exp >> (lvl * WHEEL_BITS)) & WHEEL_MASK;
+	return &wheel[lvl][*slot];
+}
+
+static void wheel_insert(struct _timeout *t)
+{
+	int lvl;
+	uint32_t slot;
+	sys_dlist_t *list = wheel_slot(expiry(t), &lvl, &slot);
+
+	if (list != &wheel_overflow) {
+		if ((wheel_occupied[lvl] & BIT(slot)) == 0U) {
+			sys_dlist_init(list);
+			wheel_occupied[lvl] |= BIT(slot);
+		}
+	}
+
+	sys_dlist_append(list, &t->node);
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	uint64_t exp = expiry(t);
+	int lvl;
+	uint32_t slot;
+	sys_dlist_t *list = wheel_slot(exp, &lvl, &slot);
+
+	sys_dlist_remove(&t->node);
+
+	if ((list != &wheel_overflow) && sys_dlist_is_empty(list)) {
+		wheel_occupied[lvl] &= ~BIT(slot);
+	}
+
+	if (wheel_first_valid && (exp == wheel_first)) {
+		wheel_first_valid = false;
+	}
+}
+
+static bool min_expiry(sys_dlist_t *list, uint64_t *exp)
+{
+	struct _timeout *t;
+	bool found = false;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(list, t, node) {
+		if (!found || (expiry(t) < *exp)) {
+			*exp = expiry(t);
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+static bool wheel_first_expiry(uint64_t *exp)
+{
+	if (wheel_first_valid) {
+		*exp = wheel_first;
+		return true;
+	}
+
+	for (int lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		if (wheel_occupied[lvl] != 0U) {
+			uint32_t slot = u32_count_trailing_zeros(wheel_occupied[lvl]);
+
+			if (lvl == 0) {
+				/* Level 0 slots are exactly one tick wide */
+				*exp = (curr_tick & ~(uint64_t)WHEEL_MASK) | slot;
+			} else {
+				(void)min_expiry(&wheel[lvl][slot], exp);
+			}
+			wheel_first = *exp;
+			wheel_first_valid = true;
+			return true;
+		}
+	}
+
+	wheel_first_valid = min_expiry(&wheel_overflow, &wheel_first);
+	*exp = wheel_first;
+	return wheel_first_valid;
+}
+
+/* Moves the wheel from tick prev to curr_tick.  Must only be called
+ * when no timeout expires before the new curr_tick.
+ */
+static void wheel_advance(uint64_t prev)
+{
+	sys_dnode_t *node;
+
+	if ((prev >> (WHEEL_LEVELS * WHEEL_BITS)) !=
+	    (curr_tick >> (WHEEL_LEVELS * WHEEL_BITS))) {
+		sys_dlist_t tmp = SYS_DLIST_STATIC_INIT(&tmp);
+
+		while ((node = sys_dlist_get(&wheel_overflow)) != NULL) {
+			sys_dlist_append(&tmp, node);
+		}
+		while ((node = sys_dlist_get(&tmp)) != NULL) {
+			wheel_insert(CONTAINER_OF(node, struct _timeout, node));
+		}
+	}
+
+	for (int lvl = WHEEL_LEVELS - 1; lvl > 0; lvl--) {
+		uint32_t slot = (uint32_t)(curr_tick >> (lvl * WHEEL_BITS)) & WHEEL_MASK;
+
+		if (((prev >> (lvl * WHEEL_BITS)) ==
+		     (curr_tick >> (lvl * WHEEL_BITS))) ||
+		    ((wheel_occupied[lvl] & BIT(slot)) == 0U)) {
+			continue;
+		}
+
+		/* Entries of the slot now being entered all land in
+		 * lower levels, never back in this list.
+		 */
+		while ((node = sys_dlist_get(&wheel[lvl][slot])) != NULL) {
+			wheel_insert(CONTAINER_OF(node, struct _timeout, node));
+		}
+		wheel_occupied[lvl] &= ~BIT(slot);
+	}
+}
+
+static int64_t first_dticks(void)
+{
+	uint64_t exp;
+
+	return wheel_first_expiry(&exp) ? (int64_t)(exp - curr_tick) : -1;
+}
+
+#ifdef CONFIG_TIMEOUT_SLACK
+static uint64_t slack_visit(sys_dlist_t *list, uint64_t wake)
+{
+	struct _timeout *t;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(list, t, node) {
+		uint64_t exp = expiry(t);
+
+		if (exp <= wake) {
+			wake = MIN(wake, exp + t->slack);
+		}
+	}
+
+	return wake;
+}
+
+/* Latest tick by which every timeout expiring up to it is still
+ * within its slack.  Slots are visited in expiry order until one
+ * starts after the candidate.  Entries within a slot are unsorted,
+ * but the candidate only ever shrinks, and never below the expiry of
+ * an entry that reduced it, so visiting one that later falls outside
+ * the window is harmless.
+ */
+static int64_t wake_dticks(void)
+{
+	uint64_t wake = UINT64_MAX;
+
+	for (int lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		uint64_t base = curr_tick & ~BIT64_MASK((lvl + 1) * WHEEL_BITS);
+		uint32_t mask = wheel_occupied[lvl];
+
+		while (mask != 0U) {
+			uint32_t slot = u32_count_trailing_zeros(mask);
+
+			if ((base + ((uint64_t)slot << (lvl * WHEEL_BITS))) > wake) {
+				goto out;
+			}
+			wake = slack_visit(&wheel[lvl][slot], wake);
+			mask &= mask - 1U;
+		}
+	}
+	wake = slack_visit(&wheel_overflow, wake);
+out:
+	return wake == UINT64_MAX ? -1 : (int64_t)(wake - curr_tick);
+}
+#endif /* CONFIG_TIMEOUT_SLACK */
+
+/* Inserts a timeout expiring ticks after curr_tick, returns true if
+ * it became the first one to expire.
+ */
+static bool insert_timeout(struct _timeout *to, int64_t ticks)
+{
+	uint64_t exp = curr_tick + ticks;
+	uint64_t first;
+
+	to->dticks = exp;
+	wheel_insert(to);
+
+	if (wheel_first_valid) {
+		wheel_first = MIN(wheel_first, exp);
+	} else {
+		(void)wheel_first_expiry(&first);
+	}
+
+	return exp == wheel_first;
+}
+
+/* must be locked */
+static k_ticks_t timeout_dticks(const struct _timeout *timeout)
+{
+	return expiry(timeout) - curr_tick;
+}
+
+/* Pops the next timeout expiring within the announced ticks, if any,
+ * advancing curr_tick to its expiry.
+ */
+static struct _timeout *expire_next(void)
+{
+	int64_t dt = first_dticks();
+	uint64_t prev = curr_tick;
+	struct _timeout *t;
+	int lvl;
+	uint32_t slot;
+
+	if ((dt < 0) || (dt > announce_remaining)) {
+		return NULL;
+	}
+
+	curr_tick += dt;
+	announce_remaining -= dt;
+	wheel_advance(prev);
+
+	t = CONTAINER_OF(sys_dlist_peek_head(wheel_slot(curr_tick, &lvl, &slot)),
+			 struct _timeout, node);
+	remove_timeout(t);
+	t->dticks = 0;
+
+	return t;
+}
+
+static void announce_done(void)
+{
+	uint64_t prev = curr_tick;
+
+	curr_tick += announce_remaining;
+	wheel_advance(prev);
+}
+
+#else
+
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -59,22 +351,138 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
-static int32_t elapsed(void)
+#ifndef CONFIG_TIMEOUT_SLACK
+static int64_t first_dticks(void)
 {
-	return announce_remaining == 0 ? sys_clock_elapsed() : 0U;
+	struct _timeout *to = first();
+
+	return to == NULL ? -1 : to->dticks;
+}
+#endif
+
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Latest tick by which every timeout expiring up to it is still
+ * within its slack
+ */
+static int64_t wake_dticks(void)
+{
+	int64_t exp = 0, wake = -1;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		exp += t->dticks;
+		if ((wake >= 0) && (exp > wake)) {
+			break;
+		}
+		wake = (wake < 0) ? exp + t->slack : MIN(wake, exp + t->slack);
+	}
+
+	return wake;
+}
+#endif /* CONFIG_TIMEOUT_SLACK */
+
+static bool insert_timeout(struct _timeout *to, int64_t ticks)
+{
+	struct _timeout *t;
+
+	to->dticks = ticks;
+
+	for (t = first(); t != NULL; t = next(t)) {
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+
+	return to == first();
+}
+
+/* must be locked */
+static k_ticks_t timeout_dticks(const struct _timeout *timeout)
+{
+	k_ticks_t ticks = 0;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (timeout == t) {
+			break;
+		}
+	}
+
+	return ticks;
+}
+
+static struct _timeout *expire_next(void)
+{
+	struct _timeout *t = first();
+	int dt;
+
+	if ((t == NULL) || (t->dticks > announce_remaining)) {
+		return NULL;
+	}
+
+	dt = t->dticks;
+	curr_tick += dt;
+	announce_remaining -= dt;
+	t->dticks = 0;
+	remove_timeout(t);
+
+	return t;
 }
 
+static void announce_done(void)
+{
+	if (first() != NULL) {
+		first()->dticks -= announce_remaining;
+	}
+
+	curr_tick += announce_remaining;
+}
+
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
+
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Tick the timer was last programmed to wake up at, and counters of
+ * the wakeups coalesced away and of the expiries that were deferred
+ */
+static uint64_t slack_wake = UINT64_MAX;
+static struct k_timeout_slack_stats slack_stats;
+
+/* Called for each expiring timeout, with curr_tick at its expiry and
+ * end the tick the announcement reaches
+ */
+static void slack_account(uint64_t *last, uint64_t end)
+{
+	if ((*last != UINT64_MAX) && (*last != curr_tick)) {
+		slack_stats.wakeups_saved++;
+	}
+	if (curr_tick < end) {
+		slack_stats.deferred++;
+	}
+	*last = curr_tick;
+}
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 static int32_t next_timeout(void)
 {
-	struct _timeout *to = first();
+#ifdef CONFIG_TIMEOUT_SLACK
+	int64_t dticks = wake_dticks();
+#else
+	int64_t dticks = first_dticks();
+#endif
 	int32_t ticks_elapsed = elapsed();
 	int32_t ret;
 
-	if ((to == NULL) ||
-	    ((int64_t)(to->dticks - ticks_elapsed) > (int64_t)INT_MAX)) {
+	if ((dticks < 0) ||
+	    ((int64_t)(dticks - ticks_elapsed) > (int64_t)INT_MAX)) {
 		ret = MAX_WAIT;
 	} else {
-		ret = MAX(0, to->dticks - ticks_elapsed);
+		ret = MAX(0, dticks - ticks_elapsed);
 	}
 
 #ifdef CONFIG_TIMESLICING
@@ -85,6 +493,18 @@ static int32_t next_timeout(void)
 	return ret;
 }
 
+/* All timer programming goes through here, so that slack_wake
+ * follows what the driver was actually asked for
+ */
+static void set_timeout(int32_t ticks, bool idle)
+{
+#ifdef CONFIG_TIMEOUT_SLACK
+	slack_wake = (ticks == K_TICKS_FOREVER || ticks == INT_MAX) ?
+		     UINT64_MAX : curr_tick + elapsed() + ticks;
+#endif
+	sys_clock_set_timeout(ticks, idle);
+}
+
 void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 		   k_timeout_t timeout)
 {
@@ -100,31 +520,29 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 	to->fn = fn;
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
+		int64_t dticks;
 
 		if (IS_ENABLED(CONFIG_TIMEOUT_64BIT) &&
 		    Z_TICK_ABS(timeout.ticks) >= 0) {
 			k_ticks_t ticks = Z_TICK_ABS(timeout.ticks) - curr_tick;
 
-			to->dticks = MAX(1, ticks);
+			dticks = MAX(1, ticks);
 		} else {
-			to->dticks = timeout.ticks + 1 + elapsed();
+			dticks = timeout.ticks + 1 + elapsed();
 		}
 
-		for (t = first(); t != NULL; t = next(t)) {
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
+		bool reprogram = insert_timeout(to, dticks);
 
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
+#ifdef CONFIG_TIMEOUT_SLACK
+		/* A timeout that isn't the first to expire may still
+		 * be due before a wakeup deferred by the slack of
+		 * earlier ones
+		 */
+		reprogram = reprogram ||
+			    (curr_tick + dticks + to->slack < slack_wake);
+#endif
 
-		if (to == first()) {
+		if (reprogram) {
 #if CONFIG_TIMESLICING
 			/*
 			 * This is not ideal, since it does not
@@ -138,10 +556,10 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 
 			if (next_time == 0 ||
 			    _current_cpu->slice_ticks != next_time) {
-				sys_clock_set_timeout(next_time, false);
+				set_timeout(next_time, false);
 			}
 #else
-			sys_clock_set_timeout(next_timeout(), false);
+			set_timeout(next_timeout(), false);
 #endif	/* CONFIG_TIMESLICING */
 		}
 	}
@@ -164,20 +582,11 @@ int z_abort_timeout(struct _timeout *to)
 /* must be locked */
 static k_ticks_t timeout_rem(const struct _timeout *timeout)
 {
-	k_ticks_t ticks = 0;
-
 	if (z_is_inactive_timeout(timeout)) {
 		return 0;
 	}
 
-	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
-		ticks += t->dticks;
-		if (timeout == t) {
-			break;
-		}
-	}
-
-	return ticks - elapsed();
+	return timeout_dticks(timeout) - elapsed();
 }
 
 k_ticks_t z_timeout_remaining(const struct _timeout *timeout)
@@ -231,7 +640,7 @@ void z_set_timeout_expiry(int32_t ticks, bool is_idle)
 		 * in.
 		 */
 		if (!imminent && (sooner || IS_ENABLED(CONFIG_SMP))) {
-			sys_clock_set_timeout(MIN(ticks, next_to), is_idle);
+			set_timeout(MIN(ticks, next_to), is_idle);
 		}
 	}
 }
@@ -258,32 +667,44 @@ void sys_clock_announce(int32_t ticks)
 
 	announce_remaining = ticks;
 
-	while (first() != NULL && first()->dticks <= announce_remaining) {
-		struct _timeout *t = first();
-		int dt = t->dticks;
-
-		curr_tick += dt;
-		announce_remaining -= dt;
-		t->dticks = 0;
-		remove_timeout(t);
+#ifdef CONFIG_TIMEOUT_SLACK
+	uint64_t last = UINT64_MAX;
+	uint64_t end = curr_tick + ticks;
+#endif
 
+	for (struct _timeout *t = expire_next(); t != NULL; t = expire_next()) {
+#ifdef CONFIG_TIMEOUT_SLACK
+		slack_account(&last, end);
+#endif
 		k_spin_unlock(&timeout_lock, key);
 		t->fn(t);
 		key = k_spin_lock(&timeout_lock);
 	}
 
-	if (first() != NULL) {
-		first()->dticks -= announce_remaining;
-	}
-
-	curr_tick += announce_remaining;
+	announce_done();
 	announce_remaining = 0;
 
-	sys_clock_set_timeout(next_timeout(), false);
+	set_timeout(next_timeout(), false);
 
 	k_spin_unlock(&timeout_lock, key);
 }
 
+#ifdef CONFIG_TIMEOUT_SLACK
+void k_timeout_slack_stats_get(struct k_timeout_slack_stats *stats)
+{
+	LOCKED(&timeout_lock) {
+		*stats = slack_stats;
+	}
+}
+
+void k_timeout_slack_stats_reset(void)
+{
+	LOCKED(&timeout_lock) {
+		slack_stats = (struct k_timeout_slack_stats){ 0 };
+	}
+}
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 int64_t sys_clock_tick_get(void)
 {
 	uint64_t t = 0U;
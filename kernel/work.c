@@ -184,6 +184,9 @@ static void queue_flusher_locked(struct k_work_q *queue,
 	}
 
 	init_flusher(flusher);
+#ifdef CONFIG_WORKQUEUE_POOL
+	flusher->target = work;
+#endif
 	if (in_list) {
 		sys_slist_insert(&queue->pending, &work->node,
 				 &flusher->work.node);
@@ -229,6 +232,30 @@ static inline bool notify_queue_locked(struct k_work_q *queue)
 	return rv;
 }
 
+/* Test whether a thread is one of the threads animating a queue.
+ *
+ * Invoked with work lock held.
+ */
+static inline bool is_queue_thread(struct k_work_q *queue,
+				   const struct k_thread *thread)
+{
+	if (thread == &queue->thread) {
+		return true;
+	}
+
+#ifdef CONFIG_WORKQUEUE_POOL
+	struct k_work_q_worker *worker;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&queue->workers, worker, node) {
+		if (thread == &worker->thread) {
+			return true;
+		}
+	}
+#endif
+
+	return false;
+}
+
 /* Submit an work item to a queue if queue state allows new work.
  *
  * Submission is rejected if no queue is provided, or if the queue is
@@ -256,8 +283,9 @@ static inline int queue_submit_locked(struct k_work_q *queue,
 	}
 
 	int ret = -EBUSY;
-	bool chained = (_current == &queue->thread) && !k_is_in_isr();
 	bool draining = flag_test(&queue->flags, K_WORK_QUEUE_DRAIN_BIT);
+	bool chained = draining && !k_is_in_isr()
+		&& is_queue_thread(queue, _current);
 	bool plugged = flag_test(&queue->flags, K_WORK_QUEUE_PLUGGED_BIT);
 
 	/* Test for acceptability, in priority order:
@@ -276,7 +304,18 @@ static inline int queue_submit_locked(struct k_work_q *queue,
 	} else {
 		sys_slist_append(&queue->pending, &work->node);
 		ret = 1;
+#ifdef CONFIG_WORKQUEUE_POOL
+		/* Only some of the workers may take a bound item, and
+		 * the one woken first may not be among them.
+		 */
+		if (work->cpu_affinity != 0U) {
+			(void)z_sched_wake_all(&queue->notifyq, 0, NULL);
+		} else {
+			(void)notify_queue_locked(queue);
+		}
+#else
 		(void)notify_queue_locked(queue);
+#endif
 	}
 
 	return ret;
@@ -573,13 +612,104 @@ bool k_work_cancel_sync(struct k_work *work,
 	return pending;
 }
 
+#ifdef CONFIG_WORKQUEUE_POOL
+/* Test whether a flusher has to wait for its target: either the
+ * target is running on another worker, or it is still queued ahead of
+ * the flusher.
+ *
+ * Invoked with work lock held.
+ */
+static bool flusher_blocked_locked(struct k_work_q *queue,
+				   struct z_work_flusher *flusher)
+{
+	struct k_work *target = flusher->target;
+	sys_snode_t *node;
+
+	if (flag_test(&target->flags, K_WORK_RUNNING_BIT)) {
+		return true;
+	}
+
+	if (flag_test(&target->flags, K_WORK_QUEUED_BIT)) {
+		SYS_SLIST_FOR_EACH_NODE(&queue->pending, node) {
+			if (node == &flusher->work.node) {
+				break;
+			}
+			if (node == &target->node) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+/* Test whether a worker may start a pending work item.
+ *
+ * Items already running on another worker, flushers which have to
+ * wait for their target and items bound to another CPU's workers must
+ * be left in the queue.
+ *
+ * Invoked with work lock held.
+ */
+static bool work_startable_locked(struct k_work_q *queue,
+				  struct k_work *work, int cpu)
+{
+	int bound = (int)work->cpu_affinity - 1;
+
+	if (flag_test(&work->flags, K_WORK_RUNNING_BIT)) {
+		return false;
+	}
+
+	if ((work->handler == handle_flush)
+	    && flusher_blocked_locked(queue, CONTAINER_OF(work,
+					struct z_work_flusher, work))) {
+		return false;
+	}
+
+	return (bound < 0) || (bound == cpu)
+		|| ((queue->worker_cpus & BIT(bound)) == 0U);
+}
+
+/* Remove the first work item the worker may start from the queue.
+ *
+ * Invoked with work lock held.
+ */
+static sys_snode_t *queue_get_locked(struct k_work_q *queue, int cpu)
+{
+	sys_snode_t *node, *prev = NULL;
+
+	SYS_SLIST_FOR_EACH_NODE(&queue->pending, node) {
+		if (work_startable_locked(queue,
+					  CONTAINER_OF(node, struct k_work, node),
+					  cpu)) {
+			sys_slist_remove(&queue->pending, prev, node);
+
+			/* Let another worker look at the rest */
+			if (!sys_slist_is_empty(&queue->pending)) {
+				(void)notify_queue_locked(queue);
+			}
+			return node;
+		}
+		prev = node;
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_WORKQUEUE_POOL */
+
 /* Loop executed by a work queue thread.
  *
  * @param workq_ptr pointer to the work queue structure
+ * @param worker_ptr pointer to the k_work_q_worker structure of an
+ * additional pool thread, or null for the queue's own thread
  */
-static void work_queue_main(void *workq_ptr, void *p2, void *p3)
+static void work_queue_main(void *workq_ptr, void *worker_ptr, void *p3)
 {
 	struct k_work_q *queue = (struct k_work_q *)workq_ptr;
+#ifdef CONFIG_WORKQUEUE_POOL
+	struct k_work_q_worker *worker = worker_ptr;
+	int cpu = (worker != NULL) ? worker->cpu : -1;
+#endif
 
 	while (true) {
 		sys_snode_t *node;
@@ -589,12 +719,19 @@ static void work_queue_main(void *workq_ptr, void *p2, void *p3)
 		bool yield;
 
 		/* Check for and prepare any new work. */
+#ifdef CONFIG_WORKQUEUE_POOL
+		node = queue_get_locked(queue, cpu);
+#else
 		node = sys_slist_get(&queue->pending);
+#endif
 		if (node != NULL) {
 			/* Mark that there's some work active that's
 			 * not on the pending list.
 			 */
 			flag_set(&queue->flags, K_WORK_QUEUE_BUSY_BIT);
+#ifdef CONFIG_WORKQUEUE_POOL
+			queue->active++;
+#endif
 			work = CONTAINER_OF(node, struct k_work, node);
 			flag_set(&work->flags, K_WORK_RUNNING_BIT);
 			flag_clear(&work->flags, K_WORK_QUEUED_BIT);
@@ -612,8 +749,10 @@ static void work_queue_main(void *workq_ptr, void *p2, void *p3)
 			 * This means that if node is not NULL, then work will not be NULL.
 			 */
 			handler = work->handler;
-		} else if (flag_test_and_clear(&queue->flags,
-					       K_WORK_QUEUE_DRAIN_BIT)) {
+		} else if (sys_slist_is_empty(&queue->pending)
+			   && !flag_test(&queue->flags, K_WORK_QUEUE_BUSY_BIT)
+			   && flag_test_and_clear(&queue->flags,
+						  K_WORK_QUEUE_DRAIN_BIT)) {
 			/* Not busy and draining: move threads waiting for
 			 * drain to ready state.  The held spinlock inhibits
 			 * immediate reschedule; released threads get their
@@ -660,7 +799,13 @@ static void work_queue_main(void *workq_ptr, void *p2, void *p3)
 			finalize_cancel_locked(work);
 		}
 
+#ifdef CONFIG_WORKQUEUE_POOL
+		if (--queue->active == 0U) {
+			flag_clear(&queue->flags, K_WORK_QUEUE_BUSY_BIT);
+		}
+#else
 		flag_clear(&queue->flags, K_WORK_QUEUE_BUSY_BIT);
+#endif
 		yield = !flag_test(&queue->flags, K_WORK_QUEUE_NO_YIELD_BIT);
 		k_spin_unlock(&lock, key);
 
@@ -700,6 +845,11 @@ void k_work_queue_start(struct k_work_q *queue,
 	sys_slist_init(&queue->pending);
 	z_waitq_init(&queue->notifyq);
 	z_waitq_init(&queue->drainq);
+#ifdef CONFIG_WORKQUEUE_POOL
+	sys_slist_init(&queue->workers);
+	queue->active = 0U;
+	queue->worker_cpus = 0U;
+#endif
 
 	if ((cfg != NULL) && cfg->no_yield) {
 		flags |= K_WORK_QUEUE_NO_YIELD;
@@ -724,6 +874,73 @@ void k_work_queue_start(struct k_work_q *queue,
 	SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_work_queue, start, queue);
 }
 
+#ifdef CONFIG_WORKQUEUE_POOL
+void k_work_queue_worker_add(struct k_work_q *queue,
+			     struct k_work_q_worker *worker,
+			     k_thread_stack_t *stack,
+			     size_t stack_size,
+			     int prio,
+			     int cpu)
+{
+	__ASSERT_NO_MSG(queue);
+	__ASSERT_NO_MSG(worker);
+	__ASSERT_NO_MSG(stack);
+	__ASSERT_NO_MSG(flag_test(&queue->flags, K_WORK_QUEUE_STARTED_BIT));
+	__ASSERT_NO_MSG((cpu >= -1) && (cpu < CONFIG_MP_NUM_CPUS));
+	__ASSERT((cpu < 0) || IS_ENABLED(CONFIG_SCHED_CPU_MASK)
+		 || (CONFIG_MP_NUM_CPUS == 1),
+		 "pinning workers requires CONFIG_SCHED_CPU_MASK");
+
+	worker->cpu = cpu;
+
+	(void)k_thread_create(&worker->thread, stack, stack_size,
+			      work_queue_main, queue, worker, NULL,
+			      prio, 0, K_FOREVER);
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	if (cpu >= 0) {
+		(void)k_thread_cpu_pin(&worker->thread, cpu);
+	}
+#endif
+
+#ifdef CONFIG_THREAD_NAME
+	const char *name = k_thread_name_get(&queue->thread);
+
+	if (name != NULL) {
+		k_thread_name_set(&worker->thread, name);
+	}
+#endif
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	sys_slist_append(&queue->workers, &worker->node);
+	if (cpu >= 0) {
+		queue->worker_cpus |= BIT(cpu);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	k_thread_start(&worker->thread);
+}
+
+int k_work_cpu_affinity_set(struct k_work *work, int cpu)
+{
+	__ASSERT_NO_MSG(work != NULL);
+
+	if ((cpu < -1) || (cpu >= CONFIG_MP_NUM_CPUS)) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	work->cpu_affinity = (uint8_t)(cpu + 1);
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+#endif /* CONFIG_WORKQUEUE_POOL */
+
 int k_work_queue_drain(struct k_work_q *queue,
 		       bool plug)
 {
@@ -824,6 +1041,14 @@ void k_work_init_delayable(struct k_work_delayable *dwork,
 	SYS_PORT_TRACING_OBJ_INIT(k_work_delayable, dwork);
 }
 
+void k_work_delayable_slack_set(struct k_work_delayable *dwork,
+				k_timeout_t slack)
+{
+	__ASSERT_NO_MSG(dwork != NULL);
+
+	z_timeout_slack_set(&dwork->timeout, slack);
+}
+
 static inline int work_delayable_busy_get_locked(const struct k_work_delayable *dwork)
 {
 	return flags_get(&dwork->work.flags) & K_WORK_MASK;
@@ -381,15 +381,59 @@ out:
 	return ret;
 }
 
+/*
+ * Find the next set or cleared bit.
+ *
+ * Whole bundles without a matching bit are skipped, and the matching
+ * bit within a bundle is located by counting trailing zeros.
+ *
+ * @param bitarray Bitarray struct
+ * @param bit      Bit location to start searching from
+ * @param end      Bit location to stop searching at
+ * @param find_set True to find a set bit,
+ *                 False to find a cleared bit
+ *
+ * @return Offset of the first matching bit at or after @p bit,
+ *         or @p end if there is none before it.
+ */
+static size_t find_next_bit(sys_bitarray_t *bitarray, size_t bit,
+			    size_t end, bool find_set)
+{
+	size_t idx = bit / bundle_bitness(bitarray);
+	size_t eidx;
+	uint32_t bundle;
+
+	if (bit >= end) {
+		return end;
+	}
+
+	eidx = (end - 1) / bundle_bitness(bitarray);
+
+	/* Ignore the bits before the starting location */
+	bundle = find_set ? bitarray->bundles[idx] : ~bitarray->bundles[idx];
+	bundle &= ~(uint32_t)BIT_MASK(bit % bundle_bitness(bitarray));
+
+	while (bundle == 0U) {
+		if (idx == eidx) {
+			return end;
+		}
+
+		idx++;
+		bundle = find_set ? bitarray->bundles[idx] :
+				    ~bitarray->bundles[idx];
+	}
+
+	bit = idx * bundle_bitness(bitarray) + find_lsb_set(bundle) - 1;
+
+	return MIN(bit, end);
+}
+
 int sys_bitarray_alloc(sys_bitarray_t *bitarray, size_t num_bits,
 		       size_t *offset)
 {
 	k_spinlock_key_t key;
-	uint32_t bit_idx;
+	size_t bit_idx, run_end;
 	int ret;
-	struct bundle_data bd;
-	size_t off_start, off_end;
-	size_t mismatch;
 
 	__ASSERT_NO_MSG(bitarray != NULL);
 	__ASSERT_NO_MSG(bitarray->num_bits > 0);
@@ -406,48 +450,27 @@ int sys_bitarray_alloc(sys_bitarray_t *bitarray, size_t num_bits,
 		goto out;
 	}
 
-	bit_idx = 0;
-
-	/* Find the first non-allocated bit by looking at bundles
-	 * instead of individual bits.
-	 *
-	 * On RISC-V 64-bit, it complains about undefined reference to `ffs`.
-	 * So don't use this on RISCV64.
+	/* First fit: alternate between finding the start of a run of
+	 * cleared bits and the set bit ending it, until a run is long
+	 * enough.  Both searches go a bundle at a time, so allocated and
+	 * free areas cost one probe per bundle rather than one per
+	 * mismatching bit.
 	 */
-	for (ret = 0; ret < bitarray->num_bundles; ret++) {
-		if (~bitarray->bundles[ret] == 0U) {
-			/* bundle is all 1s => all allocated, skip */
-			bit_idx += bundle_bitness(bitarray);
-			continue;
-		}
-
-		if (bitarray->bundles[ret] != 0U) {
-			/* Find the first free bit in bundle if not all free */
-			off_start = find_lsb_set(~bitarray->bundles[ret]) - 1;
-			bit_idx += off_start;
-		}
-
-		break;
-	}
-
-	off_end = bitarray->num_bits - num_bits;
 	ret = -ENOSPC;
-	while (bit_idx <= off_end) {
-		if (match_region(bitarray, bit_idx, num_bits, false,
-				 &bd, &mismatch)) {
-			off_end = bit_idx + num_bits - 1;
-
-			set_region(bitarray, bit_idx, num_bits, true, &bd);
+	bit_idx = find_next_bit(bitarray, 0, bitarray->num_bits, false);
+	while (bit_idx <= bitarray->num_bits - num_bits) {
+		run_end = find_next_bit(bitarray, bit_idx, bit_idx + num_bits,
+					true);
+		if (run_end == bit_idx + num_bits) {
+			set_region(bitarray, bit_idx, num_bits, true, NULL);
 
 			*offset = bit_idx;
 			ret = 0;
 			break;
 		}
 
-		/* Fast-forward to the bit just after
-		 * the mismatched bit.
-		 */
-		bit_idx = mismatch + 1;
+		bit_idx = find_next_bit(bitarray, run_end + 1,
+					bitarray->num_bits, false);
 	}
 
 out:
@@ -0,0 +1,620 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/btree.h>
+#include <sys/__assert.h>
+
+BUILD_ASSERT(Z_BTREE_MIN_KEYS >= 1, "Tree nodes must hold at least 2 keys");
+
+/* Nodes and slots taken from the root down to a leaf. For inner nodes the
+ * slot is the index of the child taken, for the leaf it is the item index.
+ */
+struct btree_path {
+	struct btree_node *node[Z_BTREE_MAX_HEIGHT];
+	uint8_t idx[Z_BTREE_MAX_HEIGHT];
+};
+
+static struct btree_node *node_alloc(struct btree *tree, bool leaf)
+{
+	struct btree_node *node;
+
+	if (tree->free != NULL) {
+		node = tree->free;
+		tree->free = node->next;
+	} else {
+		__ASSERT_NO_MSG(tree->pool_left > 0);
+		node = tree->pool++;
+		tree->pool_left--;
+	}
+
+	tree->free_cnt--;
+	node->next = NULL;
+	node->leaf = leaf;
+	node->count = 0;
+
+	return node;
+}
+
+static void node_free(struct btree *tree, struct btree_node *node)
+{
+	node->next = tree->free;
+	tree->free = node;
+	tree->free_cnt++;
+}
+
+/* Index of the first key not less than @p key, or count if there is none. */
+static inline uint8_t lower_idx(struct btree_node *node, btree_key_t key)
+{
+	uint8_t i = 0;
+
+	while (i < node->count && node->keys[i] < key) {
+		i++;
+	}
+
+	return i;
+}
+
+/* Index of the first key greater than @p key, or count if there is none. */
+static inline uint8_t upper_idx(struct btree_node *node, btree_key_t key)
+{
+	uint8_t i = 0;
+
+	while (i < node->count && node->keys[i] <= key) {
+		i++;
+	}
+
+	return i;
+}
+
+static btree_key_t min_key(struct btree_node *node)
+{
+	while (!node->leaf) {
+		node = node->children[0];
+	}
+
+	return node->keys[0];
+}
+
+void btree_init(struct btree *tree, struct btree_node *nodes,
+		size_t num_nodes)
+{
+	*tree = (struct btree) {
+		.pool = nodes,
+		.pool_left = num_nodes,
+		.free_cnt = num_nodes,
+	};
+}
+
+static void leaf_insert(struct btree_node *leaf, uint8_t pos,
+			struct btnode *item)
+{
+	memmove(&leaf->keys[pos + 1], &leaf->keys[pos],
+		(leaf->count - pos) * sizeof(leaf->keys[0]));
+	memmove(&leaf->items[pos + 1], &leaf->items[pos],
+		(leaf->count - pos) * sizeof(leaf->items[0]));
+	leaf->keys[pos] = item->key;
+	leaf->items[pos] = item;
+	leaf->count++;
+}
+
+/* Split a full leaf while inserting @p item at @p pos, returning the new
+ * right sibling.
+ */
+static struct btree_node *leaf_split(struct btree *tree,
+				     struct btree_node *leaf, uint8_t pos,
+				     struct btnode *item)
+{
+	struct btree_node *right = node_alloc(tree, true);
+	uint8_t split = (Z_BTREE_KEYS + 1) / 2;
+	uint8_t from = (pos < split) ? split - 1 : split;
+
+	right->count = Z_BTREE_KEYS - from;
+	memcpy(right->keys, &leaf->keys[from],
+	       right->count * sizeof(leaf->keys[0]));
+	memcpy(right->items, &leaf->items[from],
+	       right->count * sizeof(leaf->items[0]));
+	leaf->count = from;
+
+	if (pos < split) {
+		leaf_insert(leaf, pos, item);
+	} else {
+		leaf_insert(right, pos - split, item);
+	}
+
+	right->next = leaf->next;
+	leaf->next = right;
+
+	return right;
+}
+
+/* Insert separator @p key and its right @p child into inner node at
+ * @p level of @p path, splitting nodes up to the root as needed.
+ */
+static void inner_insert(struct btree *tree, struct btree_path *path,
+			 int level, btree_key_t key, struct btree_node *child)
+{
+	while (level >= 0) {
+		struct btree_node *node = path->node[level];
+		uint8_t ci = path->idx[level];
+
+		if (node->count < Z_BTREE_KEYS) {
+			memmove(&node->keys[ci + 1], &node->keys[ci],
+				(node->count - ci) * sizeof(node->keys[0]));
+			memmove(&node->children[ci + 2], &node->children[ci + 1],
+				(node->count - ci) * sizeof(node->children[0]));
+			node->keys[ci] = key;
+			node->children[ci + 1] = child;
+			node->count++;
+			return;
+		}
+
+		/* Split the node as if it held Z_BTREE_KEYS + 1 keys with the
+		 * new one at index ci. Key mid moves up to the parent.
+		 */
+		struct btree_node *right = node_alloc(tree, false);
+		uint8_t total = Z_BTREE_KEYS + 1;
+		uint8_t mid = total / 2;
+		btree_key_t up_key;
+
+#define VKEY(j) (((j) < ci) ? node->keys[j] : \
+		 (((j) == ci) ? key : node->keys[(j) - 1]))
+#define VCHILD(j) (((j) <= ci) ? node->children[j] : \
+		   (((j) == ci + 1) ? child : node->children[(j) - 1]))
+
+		for (uint8_t j = mid + 1; j < total; j++) {
+			right->keys[j - mid - 1] = VKEY(j);
+		}
+		for (uint8_t j = mid + 1; j <= total; j++) {
+			right->children[j - mid - 1] = VCHILD(j);
+		}
+		right->count = total - mid - 1;
+		up_key = VKEY(mid);
+
+#undef VKEY
+#undef VCHILD
+
+		if (ci < mid) {
+			memmove(&node->keys[ci + 1], &node->keys[ci],
+				(mid - 1 - ci) * sizeof(node->keys[0]));
+			memmove(&node->children[ci + 2],
+				&node->children[ci + 1],
+				(mid - 1 - ci) * sizeof(node->children[0]));
+			node->keys[ci] = key;
+			node->children[ci + 1] = child;
+		}
+		node->count = mid;
+
+		key = up_key;
+		child = right;
+		level--;
+	}
+
+	/* Root was split, grow the tree. */
+	struct btree_node *root = node_alloc(tree, false);
+
+	root->keys[0] = key;
+	root->children[0] = tree->root;
+	root->children[1] = child;
+	root->count = 1;
+	tree->root = root;
+	tree->height++;
+}
+
+int btree_insert(struct btree *tree, struct btnode *item)
+{
+	struct btree_path path;
+	struct btree_node *node;
+	size_t needed = 0;
+	int level;
+	uint8_t pos;
+
+	if (tree->root == NULL) {
+		if (tree->free_cnt == 0) {
+			return -ENOMEM;
+		}
+
+		tree->root = node_alloc(tree, true);
+		tree->height = 1;
+	}
+
+	node = tree->root;
+	for (level = 0; !node->leaf; level++) {
+		path.node[level] = node;
+		path.idx[level] = upper_idx(node, item->key);
+		node = node->children[path.idx[level]];
+	}
+	pos = upper_idx(node, item->key);
+
+	/* Make sure all splits can be done before changing anything. */
+	path.node[level] = node;
+	for (int l = level; l >= 0 && path.node[l]->count == Z_BTREE_KEYS;
+	     l--) {
+		needed += (l == 0) ? 2 : 1;
+	}
+	if (needed > tree->free_cnt) {
+		return -ENOMEM;
+	}
+
+	if (node->count < Z_BTREE_KEYS) {
+		leaf_insert(node, pos, item);
+	} else {
+		struct btree_node *right = leaf_split(tree, node, pos, item);
+
+		inner_insert(tree, &path, level - 1, right->keys[0], right);
+	}
+
+	tree->count++;
+
+	return 0;
+}
+
+int btree_insert_bulk(struct btree *tree, struct btnode **items,
+		      size_t count)
+{
+	struct btree_node *first = NULL;
+	struct btree_node *prev = NULL;
+	size_t num, needed;
+	uint8_t height = 1;
+	int rc;
+
+	for (size_t i = 1; i < count; i++) {
+		if (items[i]->key < items[i - 1]->key) {
+			return -EINVAL;
+		}
+	}
+
+	if (tree->root != NULL) {
+		for (size_t i = 0; i < count; i++) {
+			rc = btree_insert(tree, items[i]);
+			if (rc < 0) {
+				return rc;
+			}
+		}
+
+		return 0;
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+	/* Empty tree, build it level by level with nodes as full as
+	 * possible while keeping them all above the minimum fill.
+	 */
+	num = ceiling_fraction(count, Z_BTREE_KEYS);
+	needed = num;
+	for (size_t n = num; n > 1; ) {
+		n = ceiling_fraction(n, Z_BTREE_KEYS + 1);
+		needed += n;
+	}
+	if (needed > tree->free_cnt) {
+		return -ENOMEM;
+	}
+
+	for (size_t i = 0, n = 0; n < num; n++) {
+		struct btree_node *leaf = node_alloc(tree, true);
+		size_t cnt = count / num + ((n < count % num) ? 1 : 0);
+
+		for (size_t j = 0; j < cnt; j++, i++) {
+			leaf->keys[j] = items[i]->key;
+			leaf->items[j] = items[i];
+		}
+		leaf->count = cnt;
+
+		if (prev != NULL) {
+			prev->next = leaf;
+		} else {
+			first = leaf;
+		}
+		prev = leaf;
+	}
+
+	/* Inner nodes are linked through their next field while building,
+	 * like leaves, so each level can be walked to build the next one.
+	 */
+	while (num > 1) {
+		size_t parents = ceiling_fraction(num, Z_BTREE_KEYS + 1);
+		struct btree_node *child = first;
+
+		first = NULL;
+		prev = NULL;
+		for (size_t n = 0; n < parents; n++) {
+			struct btree_node *parent = node_alloc(tree, false);
+			size_t cnt = num / parents +
+				     ((n < num % parents) ? 1 : 0);
+
+			for (size_t c = 0; c < cnt; c++) {
+				if (c > 0) {
+					parent->keys[c - 1] = min_key(child);
+				}
+				parent->children[c] = child;
+				child = child->next;
+			}
+			parent->count = cnt - 1;
+
+			if (prev != NULL) {
+				prev->next = parent;
+			} else {
+				first = parent;
+			}
+			prev = parent;
+		}
+
+		num = parents;
+		height++;
+	}
+
+	tree->root = first;
+	tree->height = height;
+	tree->count = count;
+
+	return 0;
+}
+
+/* Move @p path to the first item of the next leaf. */
+static bool path_next_leaf(struct btree *tree, struct btree_path *path)
+{
+	int leaf_level = tree->height - 1;
+
+	for (int l = leaf_level - 1; l >= 0; l--) {
+		if (path->idx[l] < path->node[l]->count) {
+			path->idx[l]++;
+			for (l++; l <= leaf_level; l++) {
+				path->node[l] = path->node[l - 1]->children[
+					path->idx[l - 1]];
+				path->idx[l] = 0;
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void remove_child(struct btree_node *node, uint8_t idx)
+{
+	memmove(&node->keys[idx], &node->keys[idx + 1],
+		(node->count - idx - 1) * sizeof(node->keys[0]));
+	memmove(&node->children[idx + 1], &node->children[idx + 2],
+		(node->count - idx - 1) * sizeof(node->children[0]));
+	node->count--;
+}
+
+static void borrow_left(struct btree_node *parent, uint8_t ci,
+			struct btree_node *node, struct btree_node *left)
+{
+	memmove(&node->keys[1], &node->keys[0],
+		node->count * sizeof(node->keys[0]));
+
+	if (node->leaf) {
+		memmove(&node->items[1], &node->items[0],
+			node->count * sizeof(node->items[0]));
+		node->keys[0] = left->keys[left->count - 1];
+		node->items[0] = left->items[left->count - 1];
+		parent->keys[ci - 1] = node->keys[0];
+	} else {
+		memmove(&node->children[1], &node->children[0],
+			(node->count + 1) * sizeof(node->children[0]));
+		node->keys[0] = parent->keys[ci - 1];
+		node->children[0] = left->children[left->count];
+		parent->keys[ci - 1] = left->keys[left->count - 1];
+	}
+
+	left->count--;
+	node->count++;
+}
+
+static void borrow_right(struct btree_node *parent, uint8_t ci,
+			 struct btree_node *node, struct btree_node *right)
+{
+	if (node->leaf) {
+		node->keys[node->count] = right->keys[0];
+		node->items[node->count] = right->items[0];
+		memmove(&right->items[0], &right->items[1],
+			(right->count - 1) * sizeof(right->items[0]));
+	} else {
+		node->keys[node->count] = parent->keys[ci];
+		node->children[node->count + 1] = right->children[0];
+		parent->keys[ci] = right->keys[0];
+		memmove(&right->children[0], &right->children[1],
+			right->count * sizeof(right->children[0]));
+	}
+
+	memmove(&right->keys[0], &right->keys[1],
+		(right->count - 1) * sizeof(right->keys[0]));
+	right->count--;
+	node->count++;
+
+	if (node->leaf) {
+		parent->keys[ci] = right->keys[0];
+	}
+}
+
+/* Append @p right to its left sibling @p left and free it. */
+static void merge(struct btree *tree, struct btree_node *left,
+		  btree_key_t sep, struct btree_node *right)
+{
+	if (left->leaf) {
+		memcpy(&left->keys[left->count], right->keys,
+		       right->count * sizeof(right->keys[0]));
+		memcpy(&left->items[left->count], right->items,
+		       right->count * sizeof(right->items[0]));
+		left->count += right->count;
+		left->next = right->next;
+	} else {
+		left->keys[left->count] = sep;
+		memcpy(&left->keys[left->count + 1], right->keys,
+		       right->count * sizeof(right->keys[0]));
+		memcpy(&left->children[left->count + 1], right->children,
+		       (right->count + 1) * sizeof(right->children[0]));
+		left->count += right->count + 1;
+	}
+
+	node_free(tree, right);
+}
+
+/* Restore the minimum fill of nodes on @p path from @p level upwards. */
+static void rebalance(struct btree *tree, struct btree_path *path, int level)
+{
+	for (; level > 0; level--) {
+		struct btree_node *node = path->node[level];
+		struct btree_node *parent = path->node[level - 1];
+		uint8_t ci = path->idx[level - 1];
+
+		if (node->count >= Z_BTREE_MIN_KEYS) {
+			return;
+		}
+
+		if (ci > 0 &&
+		    parent->children[ci - 1]->count > Z_BTREE_MIN_KEYS) {
+			borrow_left(parent, ci, node, parent->children[ci - 1]);
+			return;
+		}
+
+		if (ci < parent->count &&
+		    parent->children[ci + 1]->count > Z_BTREE_MIN_KEYS) {
+			borrow_right(parent, ci, node,
+				     parent->children[ci + 1]);
+			return;
+		}
+
+		if (ci > 0) {
+			merge(tree, parent->children[ci - 1],
+			      parent->keys[ci - 1], node);
+			remove_child(parent, ci - 1);
+		} else {
+			merge(tree, node, parent->keys[ci],
+			      parent->children[ci + 1]);
+			remove_child(parent, ci);
+		}
+	}
+
+	/* Shrink the tree when the root is left empty. */
+	struct btree_node *root = tree->root;
+
+	if (root->count == 0) {
+		tree->root = root->leaf ? NULL : root->children[0];
+		tree->height--;
+		node_free(tree, root);
+	}
+}
+
+int btree_remove(struct btree *tree, struct btnode *item)
+{
+	struct btree_path path;
+	struct btree_node *node = tree->root;
+	int level;
+	uint8_t idx;
+
+	if (node == NULL) {
+		return -ENOENT;
+	}
+
+	for (level = 0; !node->leaf; level++) {
+		path.node[level] = node;
+		path.idx[level] = lower_idx(node, item->key);
+		node = node->children[path.idx[level]];
+	}
+	path.node[level] = node;
+	idx = lower_idx(node, item->key);
+
+	/* Items with equal keys may span several leaves. */
+	while (true) {
+		if (idx == node->count) {
+			if (!path_next_leaf(tree, &path)) {
+				return -ENOENT;
+			}
+			node = path.node[level];
+			idx = 0;
+		}
+
+		if (node->keys[idx] != item->key) {
+			return -ENOENT;
+		}
+
+		if (node->items[idx] == item) {
+			break;
+		}
+
+		idx++;
+	}
+
+	memmove(&node->keys[idx], &node->keys[idx + 1],
+		(node->count - idx - 1) * sizeof(node->keys[0]));
+	memmove(&node->items[idx], &node->items[idx + 1],
+		(node->count - idx - 1) * sizeof(node->items[0]));
+	node->count--;
+	tree->count--;
+
+	rebalance(tree, &path, level);
+
+	return 0;
+}
+
+struct btnode *btree_lower_bound(struct btree *tree, btree_key_t key,
+				 struct btree_iter *iter)
+{
+	struct btree_node *node = tree->root;
+	uint8_t idx = 0;
+
+	if (node != NULL) {
+		while (!node->leaf) {
+			node = node->children[lower_idx(node, key)];
+		}
+
+		/* If all keys of the leaf are smaller, the first item of the
+		 * next leaf is the one.
+		 */
+		idx = lower_idx(node, key);
+		if (idx == node->count) {
+			node = node->next;
+			idx = 0;
+		}
+	}
+
+	if (iter != NULL) {
+		iter->leaf = node;
+		iter->idx = idx;
+	}
+
+	return (node != NULL) ? node->items[idx] : NULL;
+}
+
+struct btnode *btree_get_min(struct btree *tree, struct btree_iter *iter)
+{
+	struct btree_node *node = tree->root;
+
+	if (node != NULL) {
+		while (!node->leaf) {
+			node = node->children[0];
+		}
+	}
+
+	if (iter != NULL) {
+		iter->leaf = node;
+		iter->idx = 0;
+	}
+
+	return (node != NULL) ? node->items[0] : NULL;
+}
+
+struct btnode *btree_get_max(struct btree *tree)
+{
+	struct btree_node *node = tree->root;
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	while (!node->leaf) {
+		node = node->children[node->count];
+	}
+
+	return node->items[node->count - 1];
+}
@@ -1335,11 +1335,84 @@ static int outs(cbprintf_cb out,
 	return (int)count;
 }
 
-int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
+#ifdef CONFIG_CBPRINTF_PRECOMPILED
+BUILD_ASSERT(sizeof(struct conversion) <=
+	     sizeof(((struct z_cbprintf_fmt_conv *)0)->conv),
+	     "Precompiled conversion does not fit");
+
+static int fmt_compile(struct cbprintf_fmt_desc *desc)
+{
+	const char *fp = desc->fmt;
+	const char *lp = fp;
+	size_t cnt = 0;
+
+	while (*fp != 0) {
+		if (*fp != '%') {
+			++fp;
+			continue;
+		}
+
+		struct z_cbprintf_fmt_conv *fc = &desc->conv[cnt];
+		struct conversion conv;
+		const char *sp = fp;
+
+		if (cnt == ARRAY_SIZE(desc->conv)) {
+			return -EINVAL;
+		}
+
+		fp = extract_conversion(&conv, sp);
+		if (((sp - lp) > UINT16_MAX) || ((fp - sp) > UINT8_MAX)) {
+			return -EINVAL;
+		}
+
+		fc->lit_len = sp - lp;
+		fc->spec_len = fp - sp;
+		memcpy(fc->conv, &conv, sizeof(conv));
+		++cnt;
+		lp = fp;
+	}
+
+	desc->conv_cnt = cnt;
+
+	return 0;
+}
+
+int cbprintf_fmt_compile(struct cbprintf_fmt_desc *desc)
+{
+	atomic_val_t state = atomic_get(&desc->state);
+
+	if ((state == Z_CBPRINTF_FMT_DESC_NEW) &&
+	    atomic_cas(&desc->state, state, Z_CBPRINTF_FMT_DESC_BUSY)) {
+		state = (fmt_compile(desc) == 0) ? Z_CBPRINTF_FMT_DESC_READY :
+						   Z_CBPRINTF_FMT_DESC_INVALID;
+		atomic_set(&desc->state, state);
+	}
+
+	switch (state) {
+	case Z_CBPRINTF_FMT_DESC_READY:
+		return 0;
+	case Z_CBPRINTF_FMT_DESC_INVALID:
+		return -EINVAL;
+	default:
+		return -EBUSY;
+	}
+}
+#else
+struct cbprintf_fmt_desc;
+#endif /* CONFIG_CBPRINTF_PRECOMPILED */
+
+/* Format with conversion specifications parsed from fp or, if desc is not
+ * null, taken from the precompiled descriptor of fp.
+ */
+static int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *fp,
+			    const struct cbprintf_fmt_desc *desc, va_list ap)
 {
 	char buf[CONVERTED_BUFLEN];
 	size_t count = 0;
 	sint_value_type sint;
+#ifdef CONFIG_CBPRINTF_PRECOMPILED
+	size_t conv_idx = 0;
+#endif
 
 /* Output character, returning EOF if output failed, otherwise
  * updating count.
@@ -1368,12 +1441,7 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
 	count += rc; \
 } while (false)
 
-	while (*fp != 0) {
-		if (*fp != '%') {
-			OUTC(*fp++);
-			continue;
-		}
-
+	while (true) {
 		/* Force union into RAM with conversion state to
 		 * mitigate LLVM code generation bug.
 		 */
@@ -1394,7 +1462,37 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
 		const char *bpe = buf + sizeof(buf);
 		char sign = 0;
 
-		fp = extract_conversion(conv, sp);
+#ifdef CONFIG_CBPRINTF_PRECOMPILED
+		if (desc != NULL) {
+			const struct z_cbprintf_fmt_conv *fc;
+
+			/* Emit literal text up to the next conversion, or
+			 * the rest of the string after the last one.
+			 */
+			if (conv_idx == desc->conv_cnt) {
+				OUTS(fp, NULL);
+				break;
+			}
+
+			fc = &desc->conv[conv_idx++];
+			sp = fp + fc->lit_len;
+			OUTS(fp, sp);
+			fp = sp + fc->spec_len;
+			memcpy(conv, fc->conv, sizeof(*conv));
+		} else
+#endif
+		{
+			if (*fp == 0) {
+				break;
+			}
+
+			if (*fp != '%') {
+				OUTC(*fp++);
+				continue;
+			}
+
+			fp = extract_conversion(conv, sp);
+		}
 
 		/* If dynamic width is specified, process it,
 		 * otherwise set width if present.
@@ -1830,3 +1928,20 @@ int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
 #undef OUTS
 #undef OUTC
 }
+
+int cbvprintf(cbprintf_cb out, void *ctx, const char *fp, va_list ap)
+{
+	return z_cbvprintf_impl(out, ctx, fp, NULL, ap);
+}
+
+#ifdef CONFIG_CBPRINTF_PRECOMPILED
+int cbvprintf_desc(cbprintf_cb out, void *ctx, struct cbprintf_fmt_desc *desc,
+		   va_list ap)
+{
+	if (cbprintf_fmt_compile(desc) != 0) {
+		return z_cbvprintf_impl(out, ctx, desc->fmt, NULL, ap);
+	}
+
+	return z_cbvprintf_impl(out, ctx, desc->fmt, desc, ap);
+}
+#endif /* CONFIG_CBPRINTF_PRECOMPILED */
@@ -715,6 +715,37 @@ int cbpprintf_external(cbprintf_cb out,
 	return cbprintf_via_va_list(out, formatter, ctx, fmt, buf);
 }
 
+#ifdef CONFIG_CBPRINTF_PRECOMPILED
+struct desc_ctx {
+	struct cbprintf_fmt_desc *desc;
+	void *ctx;
+};
+
+static int desc_formatter(cbprintf_cb out, void *ctx, const char *fmt,
+			  va_list ap)
+{
+	struct desc_ctx *dctx = ctx;
+
+	/* Package was not created for the descriptor's format string. */
+	if (fmt != dctx->desc->fmt) {
+		return cbvprintf(out, dctx->ctx, fmt, ap);
+	}
+
+	return cbvprintf_desc(out, dctx->ctx, dctx->desc, ap);
+}
+
+int cbpprintf_desc(cbprintf_cb out, void *ctx, struct cbprintf_fmt_desc *desc,
+		   void *packaged)
+{
+	struct desc_ctx dctx = {
+		.desc = desc,
+		.ctx = ctx,
+	};
+
+	return cbpprintf_external(out, desc_formatter, &dctx, packaged);
+}
+#endif /* CONFIG_CBPRINTF_PRECOMPILED */
+
 int cbprintf_package_copy(void *in_packaged,
 			  size_t in_len,
 			  void *packaged,
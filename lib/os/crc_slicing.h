@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef ZEPHYR_INCLUDE_LIB_OS_CRC_SLICING_H_
+#define ZEPHYR_INCLUDE_LIB_OS_CRC_SLICING_H_
+
+/*
+ * Internal helpers for the table driven CRC implementations
+ */
+
+#include <sys/byteorder.h>
+
+/* Number of bytes consumed per table lookup round.  Slice k of a
+ * table holds the CRC contribution of a byte followed by k zero
+ * bytes, so a round of CRC_SLICES bytes needs one lookup per byte and
+ * no dependency between the lookups.
+ */
+#if defined(CONFIG_CRC_SLICING_BY_8)
+#define CRC_SLICES 8
+#elif defined(CONFIG_CRC_SLICING_BY_4)
+#define CRC_SLICES 4
+#endif
+
+#ifdef CRC_SLICES
+
+/* Update a reflected 32 bit CRC register, no pre or post inversion */
+static inline uint32_t crc_slicing_reflect32(const uint32_t table[][256],
+					     uint32_t crc, const uint8_t *data,
+					     size_t len)
+{
+	for (; len >= CRC_SLICES; len -= CRC_SLICES, data += CRC_SLICES) {
+		uint32_t w = crc ^ sys_get_le32(data);
+
+		crc = table[CRC_SLICES - 1][w & 0xff] ^
+		      table[CRC_SLICES - 2][(w >> 8) & 0xff] ^
+		      table[CRC_SLICES - 3][(w >> 16) & 0xff] ^
+		      table[CRC_SLICES - 4][w >> 24];
+#if CRC_SLICES == 8
+		w = sys_get_le32(data + 4);
+		crc ^= table[3][w & 0xff] ^
+		       table[2][(w >> 8) & 0xff] ^
+		       table[1][(w >> 16) & 0xff] ^
+		       table[0][w >> 24];
+#endif
+	}
+
+	for (; len > 0; len--) {
+		crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xff];
+	}
+
+	return crc;
+}
+
+#endif /* CRC_SLICES */
+
+#endif /* ZEPHYR_INCLUDE_LIB_OS_CRC_SLICING_H_ */
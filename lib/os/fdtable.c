@@ -55,16 +55,84 @@ static struct fd_entry fdtable[CONFIG_POSIX_MAX_FDS] = {
 #endif
 };
 
-static K_MUTEX_DEFINE(fdtable_lock);
+/* Entries in use. A bit is set when a descriptor is reserved and cleared
+ * only after the entry has been released, so allocation never needs a lock.
+ */
+static ATOMIC_DEFINE(fdtable_used, CONFIG_POSIX_MAX_FDS) = {
+#ifdef CONFIG_POSIX_API
+	ATOMIC_INIT(BIT_MASK(3)),
+#endif
+};
+
+#if CONFIG_POSIX_MAX_FDS_DYNAMIC > 0
+#define FD_BLOCK_SIZE ATOMIC_BITS
+#define FD_BLOCKS ceiling_fraction(CONFIG_POSIX_MAX_FDS_DYNAMIC, FD_BLOCK_SIZE)
+#define FD_MAX (CONFIG_POSIX_MAX_FDS + CONFIG_POSIX_MAX_FDS_DYNAMIC)
+
+/* Descriptors beyond the static table live in blocks allocated from the
+ * heap when the table fills up. Blocks are never freed so an entry, once
+ * published, stays valid without any lock.
+ */
+struct fd_block {
+	atomic_t used;
+	struct fd_entry entries[FD_BLOCK_SIZE];
+};
+
+static atomic_ptr_t fd_blocks[FD_BLOCKS];
+#else
+#define FD_MAX CONFIG_POSIX_MAX_FDS
+#endif
 
-static int z_fd_ref(int fd)
+/* Get the entry of a descriptor and the bitmap tracking it, or NULL if the
+ * descriptor is out of range or its block is not allocated.
+ */
+static struct fd_entry *fd_entry(int fd, atomic_t **used, int *bit)
 {
-	return atomic_inc(&fdtable[fd].refcount) + 1;
+	if (fd < 0 || fd >= FD_MAX) {
+		return NULL;
+	}
+
+	fd = k_array_index_sanitize(fd, FD_MAX);
+
+	if (fd < CONFIG_POSIX_MAX_FDS) {
+		*used = fdtable_used;
+		*bit = fd;
+		return &fdtable[fd];
+	}
+
+#if CONFIG_POSIX_MAX_FDS_DYNAMIC > 0
+	struct fd_block *block;
+
+	fd -= CONFIG_POSIX_MAX_FDS;
+	block = atomic_ptr_get(&fd_blocks[fd / FD_BLOCK_SIZE]);
+	if (block == NULL) {
+		return NULL;
+	}
+
+	*used = &block->used;
+	*bit = fd % FD_BLOCK_SIZE;
+	return &block->entries[fd % FD_BLOCK_SIZE];
+#else
+	return NULL;
+#endif
+}
+
+static int z_fd_ref(struct fd_entry *entry)
+{
+	return atomic_inc(&entry->refcount) + 1;
 }
 
 static int z_fd_unref(int fd)
 {
+	struct fd_entry *entry;
 	atomic_val_t old_rc;
+	atomic_t *used;
+	int bit;
+
+	entry = fd_entry(fd, &used, &bit);
+	if (entry == NULL) {
+		return 0;
+	}
 
 	/* Reference counter must be checked to avoid decrement refcount below
 	 * zero causing file descriptor leak. Loop statement below executes
@@ -72,63 +140,127 @@ static int z_fd_unref(int fd)
 	 * refcount is not going to be written.
 	 */
 	do {
-		old_rc = atomic_get(&fdtable[fd].refcount);
+		old_rc = atomic_get(&entry->refcount);
 		if (!old_rc) {
 			return 0;
 		}
-	} while (!atomic_cas(&fdtable[fd].refcount, old_rc, old_rc - 1));
+	} while (!atomic_cas(&entry->refcount, old_rc, old_rc - 1));
 
 	if (old_rc != 1) {
 		return old_rc - 1;
 	}
 
-	fdtable[fd].obj = NULL;
-	fdtable[fd].vtable = NULL;
+	entry->obj = NULL;
+	entry->vtable = NULL;
+
+	/* Entry can be reused from now on. */
+	atomic_clear_bit(used, bit);
 
 	return 0;
 }
 
-static int _find_fd_entry(void)
+/* Set the first clear bit out of @p bits, returning its index or -1 if all
+ * are set.
+ */
+static int fd_bitmap_reserve(atomic_t *bitmap, int bits)
 {
-	int fd;
+	for (int i = 0; i < bits; i += ATOMIC_BITS) {
+		atomic_t *word = &bitmap[i / ATOMIC_BITS];
+		atomic_val_t val = atomic_get(word);
+
+		while (~val != 0) {
+			int bit = __builtin_ctzl((unsigned long)~val);
 
-	for (fd = 0; fd < ARRAY_SIZE(fdtable); fd++) {
-		if (!atomic_get(&fdtable[fd].refcount)) {
-			return fd;
+			if (i + bit >= bits) {
+				break;
+			}
+
+			if (atomic_cas(word, val, val | BIT(bit))) {
+				return i + bit;
+			}
+
+			val = atomic_get(word);
 		}
 	}
 
-	errno = ENFILE;
 	return -1;
 }
 
-static int _check_fd(int fd)
+#if CONFIG_POSIX_MAX_FDS_DYNAMIC > 0
+static int _find_block_fd(void)
 {
-	if (fd < 0 || fd >= ARRAY_SIZE(fdtable)) {
-		errno = EBADF;
-		return -1;
+	for (int i = 0; i < FD_BLOCKS; i++) {
+		int bits = MIN(FD_BLOCK_SIZE,
+			       CONFIG_POSIX_MAX_FDS_DYNAMIC - i * FD_BLOCK_SIZE);
+		struct fd_block *block = atomic_ptr_get(&fd_blocks[i]);
+		int fd;
+
+		if (block == NULL) {
+			block = k_calloc(1, sizeof(*block));
+			if (block == NULL) {
+				break;
+			}
+
+			/* Another thread may have added the block meanwhile. */
+			if (!atomic_ptr_cas(&fd_blocks[i], NULL, block)) {
+				k_free(block);
+				block = atomic_ptr_get(&fd_blocks[i]);
+			}
+		}
+
+		fd = fd_bitmap_reserve(&block->used, bits);
+		if (fd >= 0) {
+			return CONFIG_POSIX_MAX_FDS + i * FD_BLOCK_SIZE + fd;
+		}
+	}
+
+	return -1;
+}
+#endif
+
+static int _find_fd_entry(void)
+{
+	int fd;
+
+	fd = fd_bitmap_reserve(fdtable_used, CONFIG_POSIX_MAX_FDS);
+
+#if CONFIG_POSIX_MAX_FDS_DYNAMIC > 0
+	if (fd < 0) {
+		fd = _find_block_fd();
+	}
+#endif
+
+	if (fd < 0) {
+		errno = ENFILE;
 	}
 
-	fd = k_array_index_sanitize(fd, ARRAY_SIZE(fdtable));
+	return fd;
+}
 
-	if (!atomic_get(&fdtable[fd].refcount)) {
+static struct fd_entry *_check_fd(int fd)
+{
+	struct fd_entry *entry;
+	atomic_t *used;
+	int bit;
+
+	entry = fd_entry(fd, &used, &bit);
+	if (entry == NULL || !atomic_get(&entry->refcount)) {
 		errno = EBADF;
-		return -1;
+		return NULL;
 	}
 
-	return 0;
+	return entry;
 }
 
 void *z_get_fd_obj(int fd, const struct fd_op_vtable *vtable, int err)
 {
 	struct fd_entry *entry;
 
-	if (_check_fd(fd) < 0) {
+	entry = _check_fd(fd);
+	if (entry == NULL) {
 		return NULL;
 	}
 
-	entry = &fdtable[fd];
-
 	if (vtable != NULL && entry->vtable != vtable) {
 		errno = err;
 		return NULL;
@@ -142,11 +274,11 @@ void *z_get_fd_obj_and_vtable(int fd, const struct fd_op_vtable **vtable,
 {
 	struct fd_entry *entry;
 
-	if (_check_fd(fd) < 0) {
+	entry = _check_fd(fd);
+	if (entry == NULL) {
 		return NULL;
 	}
 
-	entry = &fdtable[fd];
 	*vtable = entry->vtable;
 
 	if (lock) {
@@ -158,27 +290,33 @@ void *z_get_fd_obj_and_vtable(int fd, const struct fd_op_vtable **vtable,
 
 int z_reserve_fd(void)
 {
+	struct fd_entry *entry;
+	atomic_t *used;
+	int bit;
 	int fd;
 
-	(void)k_mutex_lock(&fdtable_lock, K_FOREVER);
-
 	fd = _find_fd_entry();
 	if (fd >= 0) {
 		/* Mark entry as used, z_finalize_fd() will fill it in. */
-		(void)z_fd_ref(fd);
-		fdtable[fd].obj = NULL;
-		fdtable[fd].vtable = NULL;
-		k_mutex_init(&fdtable[fd].lock);
+		entry = fd_entry(fd, &used, &bit);
+		entry->obj = NULL;
+		entry->vtable = NULL;
+		k_mutex_init(&entry->lock);
+		(void)z_fd_ref(entry);
 	}
 
-	k_mutex_unlock(&fdtable_lock);
-
 	return fd;
 }
 
 void z_finalize_fd(int fd, void *obj, const struct fd_op_vtable *vtable)
 {
+	struct fd_entry *entry;
+	atomic_t *used;
+	int bit;
+
 	/* Assumes fd was already bounds-checked. */
+	entry = fd_entry(fd, &used, &bit);
+
 #ifdef CONFIG_USERSPACE
 	/* descriptor context objects are inserted into the table when they
 	 * are ready for use. Mark the object as initialized and grant the
@@ -189,8 +327,8 @@ void z_finalize_fd(int fd, void *obj, const struct fd_op_vtable *vtable)
 	 */
 	z_object_recycle(obj);
 #endif
-	fdtable[fd].obj = obj;
-	fdtable[fd].vtable = vtable;
+	entry->obj = obj;
+	entry->vtable = vtable;
 
 	/* Let the object know about the lock just in case it needs it
 	 * for something. For BSD sockets, the lock is used with condition
@@ -198,7 +336,7 @@ void z_finalize_fd(int fd, void *obj, const struct fd_op_vtable *vtable)
 	 */
 	if (vtable && vtable->ioctl) {
 		(void)z_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_SET_LOCK,
-					   &fdtable[fd].lock);
+					   &entry->lock);
 	}
 }
 
@@ -224,17 +362,19 @@ int z_alloc_fd(void *obj, const struct fd_op_vtable *vtable)
 
 ssize_t read(int fd, void *buf, size_t sz)
 {
+	struct fd_entry *entry;
 	ssize_t res;
 
-	if (_check_fd(fd) < 0) {
+	entry = _check_fd(fd);
+	if (entry == NULL) {
 		return -1;
 	}
 
-	(void)k_mutex_lock(&fdtable[fd].lock, K_FOREVER);
+	(void)k_mutex_lock(&entry->lock, K_FOREVER);
 
-	res = fdtable[fd].vtable->read(fdtable[fd].obj, buf, sz);
+	res = entry->vtable->read(entry->obj, buf, sz);
 
-	k_mutex_unlock(&fdtable[fd].lock);
+	k_mutex_unlock(&entry->lock);
 
 	return res;
 }
@@ -242,17 +382,19 @@ FUNC_ALIAS(read, _read, ssize_t);
 
 ssize_t write(int fd, const void *buf, size_t sz)
 {
+	struct fd_entry *entry;
 	ssize_t res;
 
-	if (_check_fd(fd) < 0) {
+	entry = _check_fd(fd);
+	if (entry == NULL) {
 		return -1;
 	}
 
-	(void)k_mutex_lock(&fdtable[fd].lock, K_FOREVER);
+	(void)k_mutex_lock(&entry->lock, K_FOREVER);
 
-	res = fdtable[fd].vtable->write(fdtable[fd].obj, buf, sz);
+	res = entry->vtable->write(entry->obj, buf, sz);
 
-	k_mutex_unlock(&fdtable[fd].lock);
+	k_mutex_unlock(&entry->lock);
 
 	return res;
 }
@@ -260,17 +402,19 @@ FUNC_ALIAS(write, _write, ssize_t);
 
 int close(int fd)
 {
+	struct fd_entry *entry;
 	int res;
 
-	if (_check_fd(fd) < 0) {
+	entry = _check_fd(fd);
+	if (entry == NULL) {
 		return -1;
 	}
 
-	(void)k_mutex_lock(&fdtable[fd].lock, K_FOREVER);
+	(void)k_mutex_lock(&entry->lock, K_FOREVER);
 
-	res = fdtable[fd].vtable->close(fdtable[fd].obj);
+	res = entry->vtable->close(entry->obj);
 
-	k_mutex_unlock(&fdtable[fd].lock);
+	k_mutex_unlock(&entry->lock);
 
 	z_free_fd(fd);
 
@@ -280,35 +424,41 @@ FUNC_ALIAS(close, _close, int);
 
 int fsync(int fd)
 {
-	if (_check_fd(fd) < 0) {
+	struct fd_entry *entry = _check_fd(fd);
+
+	if (entry == NULL) {
 		return -1;
 	}
 
-	return z_fdtable_call_ioctl(fdtable[fd].vtable, fdtable[fd].obj, ZFD_IOCTL_FSYNC);
+	return z_fdtable_call_ioctl(entry->vtable, entry->obj, ZFD_IOCTL_FSYNC);
 }
 
 off_t lseek(int fd, off_t offset, int whence)
 {
-	if (_check_fd(fd) < 0) {
+	struct fd_entry *entry = _check_fd(fd);
+
+	if (entry == NULL) {
 		return -1;
 	}
 
-	return z_fdtable_call_ioctl(fdtable[fd].vtable, fdtable[fd].obj, ZFD_IOCTL_LSEEK,
+	return z_fdtable_call_ioctl(entry->vtable, entry->obj, ZFD_IOCTL_LSEEK,
 			  offset, whence);
 }
 FUNC_ALIAS(lseek, _lseek, off_t);
 
 int ioctl(int fd, unsigned long request, ...)
 {
+	struct fd_entry *entry;
 	va_list args;
 	int res;
 
-	if (_check_fd(fd) < 0) {
+	entry = _check_fd(fd);
+	if (entry == NULL) {
 		return -1;
 	}
 
 	va_start(args, request);
-	res = fdtable[fd].vtable->ioctl(fdtable[fd].obj, request, args);
+	res = entry->vtable->ioctl(entry->obj, request, args);
 	va_end(args);
 
 	return res;
@@ -316,10 +466,12 @@ int ioctl(int fd, unsigned long request, ...)
 
 int fcntl(int fd, int cmd, ...)
 {
+	struct fd_entry *entry;
 	va_list args;
 	int res;
 
-	if (_check_fd(fd) < 0) {
+	entry = _check_fd(fd);
+	if (entry == NULL) {
 		return -1;
 	}
 
@@ -332,7 +484,7 @@ int fcntl(int fd, int cmd, ...)
 
 	/* The rest of commands are per-fd, handled by ioctl vmethod. */
 	va_start(args, cmd);
-	res = fdtable[fd].vtable->ioctl(fdtable[fd].obj, cmd, args);
+	res = entry->vtable->ioctl(entry->obj, cmd, args);
 	va_end(args);
 
 	return res;
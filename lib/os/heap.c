@@ -205,6 +205,27 @@ size_t sys_heap_usable_size(struct sys_heap *heap, void *mem)
 	return chunk_sz - (addr - chunk_base);
 }
 
+size_t sys_heap_largest_free(struct sys_heap *heap)
+{
+	struct z_heap *h = heap->heap;
+	chunksz_t largest = 0;
+	chunkid_t first, c;
+
+	if (h->avail_buckets == 0U) {
+		return 0;
+	}
+
+	/* Chunks in lower buckets are all smaller */
+	first = h->buckets[31 - __builtin_clz(h->avail_buckets)].next;
+	c = first;
+	do {
+		largest = MAX(largest, chunk_size(h, c));
+		c = next_free_chunk(h, c);
+	} while (c != first);
+
+	return chunksz_to_bytes(h, largest);
+}
+
 static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 {
 	int bi = bucket_idx(h, sz);
@@ -7,6 +7,7 @@
 #include <sys/__assert.h>
 #include <ctype.h>
 #include <errno.h>
+#include <float.h>
 #include <limits.h>
 #include <sys/printk.h>
 #include <sys/util.h>
@@ -219,7 +220,8 @@ static void *lexer_number(struct lexer *lex)
 	while (true) {
 		int chr = next(lex);
 
-		if (isdigit(chr) || chr == '.') {
+		if (isdigit(chr) || chr == '.' || chr == 'e' || chr == 'E' ||
+		    chr == '+' || chr == '-') {
 			continue;
 		}
 
@@ -432,18 +434,158 @@ static int decode_num(const struct token *token, int32_t *num)
 	return 0;
 }
 
+static int decode_int64(const struct token *token, int64_t *num)
+{
+	char *endptr;
+	char prev_end;
+
+	prev_end = *token->end;
+	*token->end = '\0';
+
+	errno = 0;
+	*num = strtoll(token->start, &endptr, 10);
+
+	*token->end = prev_end;
+
+	if (errno != 0) {
+		return -errno;
+	}
+
+	if (endptr != token->end) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_JSON_LIBRARY_FP_SUPPORT
+/* 10^(2^i), for scaling by any decimal exponent DBL_MAX_10_EXP allows */
+static const double pow10_pow2[] = {
+	1e1, 1e2, 1e4, 1e8, 1e16, 1e32, 1e64, 1e128, 1e256,
+};
+
+static double scale_pow10(double val, int exp)
+{
+	double scale = 1.0;
+	bool neg = exp < 0;
+
+	exp = neg ? -exp : exp;
+	if (exp >= (1 << ARRAY_SIZE(pow10_pow2))) {
+		return neg ? 0.0 : __builtin_inf();
+	}
+
+	for (int i = 0; exp != 0; i++, exp >>= 1) {
+		if (exp & 1) {
+			scale *= pow10_pow2[i];
+		}
+	}
+
+	/* Dividing by the exact power rounds better than multiplying
+	 * by its inexact reciprocal
+	 */
+	return neg ? val / scale : val * scale;
+}
+
+/* There is no strtod() in the minimal libc.  Up to 19 significant
+ * digits are collected into an integer and scaled by the decimal
+ * exponent, which is exact for mantissas below 2^53 and exponents up
+ * to 22, and within a few units in the last place otherwise.
+ */
+static int decode_double(const struct token *token, double *num)
+{
+	const char *pos = token->start;
+	uint64_t mant = 0U;
+	int digits = 0, exp = 0, exp_val = 0;
+	bool neg = false, exp_neg = false, any = false;
+
+	if (pos < token->end && *pos == '-') {
+		neg = true;
+		pos++;
+	}
+
+	for (; pos < token->end && isdigit((int)*pos); pos++, any = true) {
+		if (digits < 19) {
+			mant = mant * 10U + (*pos - '0');
+			digits += mant != 0U;
+		} else {
+			exp++;
+		}
+	}
+
+	if (pos < token->end && *pos == '.') {
+		for (pos++; pos < token->end && isdigit((int)*pos);
+		     pos++, any = true) {
+			if (digits < 19) {
+				mant = mant * 10U + (*pos - '0');
+				digits += mant != 0U;
+				exp--;
+			}
+		}
+	}
+
+	if (!any) {
+		return -EINVAL;
+	}
+
+	if (pos < token->end && (*pos == 'e' || *pos == 'E')) {
+		pos++;
+		if (pos < token->end && (*pos == '+' || *pos == '-')) {
+			exp_neg = *pos++ == '-';
+		}
+
+		if (pos == token->end) {
+			return -EINVAL;
+		}
+
+		for (; pos < token->end && isdigit((int)*pos); pos++) {
+			if (exp_val < 100000) {
+				exp_val = exp_val * 10 + (*pos - '0');
+			}
+		}
+	}
+
+	if (pos != token->end) {
+		return -EINVAL;
+	}
+
+	*num = scale_pow10((double)mant, exp + (exp_neg ? -exp_val : exp_val));
+	if (*num > DBL_MAX) {
+		return -ERANGE;
+	}
+
+	if (neg) {
+		*num = -*num;
+	}
+
+	return 0;
+}
+#else
+static int decode_double(const struct token *token, double *num)
+{
+	ARG_UNUSED(token);
+	ARG_UNUSED(num);
+
+	return -ENOTSUP;
+}
+#endif /* CONFIG_JSON_LIBRARY_FP_SUPPORT */
+
 static bool equivalent_types(enum json_tokens type1, enum json_tokens type2)
 {
 	if (type1 == JSON_TOK_TRUE || type1 == JSON_TOK_FALSE) {
 		return type2 == JSON_TOK_TRUE || type2 == JSON_TOK_FALSE;
 	}
 
+	if (type1 == JSON_TOK_NUMBER) {
+		return type2 == JSON_TOK_NUMBER || type2 == JSON_TOK_INT64 ||
+		       type2 == JSON_TOK_DOUBLE;
+	}
+
 	return type1 == type2;
 }
 
-static int obj_parse(struct json_obj *obj,
-		     const struct json_obj_descr *descr, size_t descr_len,
-		     void *val);
+static int64_t obj_parse(struct json_obj *obj,
+			 const struct json_obj_descr *descr, size_t descr_len,
+			 void *val);
 static int arr_parse(struct json_obj *obj,
 		     const struct json_obj_descr *elem_descr,
 		     size_t max_elements, void *field, void *val);
@@ -458,10 +600,12 @@ static int decode_value(struct json_obj *obj,
 	}
 
 	switch (descr->type) {
-	case JSON_TOK_OBJECT_START:
-		return obj_parse(obj, descr->object.sub_descr,
-				 descr->object.sub_descr_len,
-				 field);
+	case JSON_TOK_OBJECT_START: {
+		int64_t ret = obj_parse(obj, descr->object.sub_descr,
+					descr->object.sub_descr_len, field);
+
+		return ret < 0 ? (int)ret : 0;
+	}
 	case JSON_TOK_ARRAY_START:
 		return arr_parse(obj, descr->array.element_descr,
 				 descr->array.n_elements, field, val);
@@ -478,6 +622,16 @@ static int decode_value(struct json_obj *obj,
 
 		return decode_num(value, num);
 	}
+	case JSON_TOK_INT64: {
+		int64_t *num = field;
+
+		return decode_int64(value, num);
+	}
+	case JSON_TOK_DOUBLE: {
+		double *num = field;
+
+		return decode_double(value, num);
+	}
 	case JSON_TOK_STRING: {
 		char **str = field;
 
@@ -496,6 +650,10 @@ static ptrdiff_t get_elem_size(const struct json_obj_descr *descr)
 	switch (descr->type) {
 	case JSON_TOK_NUMBER:
 		return sizeof(int32_t);
+	case JSON_TOK_INT64:
+		return sizeof(int64_t);
+	case JSON_TOK_DOUBLE:
+		return sizeof(double);
 	case JSON_TOK_STRING:
 		return sizeof(char *);
 	case JSON_TOK_TRUE:
@@ -561,49 +719,138 @@ static int arr_parse(struct json_obj *obj,
 	return -EINVAL;
 }
 
-static int obj_parse(struct json_obj *obj, const struct json_obj_descr *descr,
-		     size_t descr_len, void *val)
+/* Descriptors with more fields than this get a hash index of their
+ * keys for the duration of a parse.  Smaller ones are scanned starting
+ * after the field matched last, which for keys in descriptor order is
+ * one comparison per key, and cheaper than hashing.
+ */
+#define OBJ_INDEX_MIN_FIELDS 8
+/* Power of two, over twice the 62 fields of json_obj_parse64() */
+#define OBJ_INDEX_MAX_SLOTS 128
+
+struct obj_index {
+	/* Index of the field plus one, 0 for an empty slot */
+	uint8_t slots[OBJ_INDEX_MAX_SLOTS];
+	uint8_t mask;
+};
+
+static uint32_t key_hash(const char *key, size_t len)
 {
-	struct json_obj_key_value kv;
-	int32_t decoded_fields = 0;
-	size_t i;
-	int ret;
+	uint32_t hash = 2166136261U;
 
-	while (!obj_next(obj, &kv)) {
-		if (kv.value.type == JSON_TOK_OBJECT_END) {
-			return decoded_fields;
+	/* FNV-1a */
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ (uint8_t)key[i]) * 16777619U;
+	}
+
+	return hash;
+}
+
+static void obj_index_init(struct obj_index *index,
+			   const struct json_obj_descr *descr,
+			   size_t descr_len)
+{
+	size_t size = 16;
+
+	while (size < 2 * descr_len) {
+		size *= 2;
+	}
+
+	index->mask = size - 1;
+	(void)memset(index->slots, 0, size);
+
+	for (size_t i = 0; i < descr_len; i++) {
+		uint32_t slot = key_hash(descr[i].field_name,
+					 descr[i].field_name_len);
+
+		while (index->slots[slot & index->mask] != 0U) {
+			slot++;
 		}
 
-		for (i = 0; i < descr_len; i++) {
-			void *decode_field = (char *)val + descr[i].offset;
+		index->slots[slot & index->mask] = i + 1;
+	}
+}
 
-			/* Field has been decoded already, skip */
-			if (decoded_fields & (1 << i)) {
-				continue;
-			}
+static bool key_matches(const struct json_obj_key_value *kv,
+			const struct json_obj_descr *descr)
+{
+	return kv->key_len == descr->field_name_len &&
+	       memcmp(kv->key, descr->field_name, kv->key_len) == 0;
+}
 
-			/* Check if it's the i-th field */
-			if (kv.key_len != descr[i].field_name_len) {
-				continue;
-			}
+/* Returns the index of the first field not decoded yet whose name is
+ * the key, -1 if there is none.
+ */
+static int obj_find_field(const struct json_obj_key_value *kv,
+			  const struct json_obj_descr *descr, size_t descr_len,
+			  int64_t decoded_fields, size_t next,
+			  const struct obj_index *index)
+{
+	size_t i, n;
 
-			if (memcmp(kv.key, descr[i].field_name,
-				   descr[i].field_name_len)) {
-				continue;
-			}
+	if (index != NULL) {
+		uint32_t slot = key_hash(kv->key, kv->key_len);
 
-			/* Store the decoded value */
-			ret = decode_value(obj, &descr[i], &kv.value,
-					   decode_field, val);
-			if (ret < 0) {
-				return ret;
+		for (; index->slots[slot & index->mask] != 0U; slot++) {
+			i = index->slots[slot & index->mask] - 1;
+
+			if (!(decoded_fields & BIT64(i)) &&
+			    key_matches(kv, &descr[i])) {
+				return i;
 			}
+		}
 
-			decoded_fields |= 1<<i;
-			break;
+		return -1;
+	}
+
+	for (n = 0, i = next; n < descr_len;
+	     n++, i = (i + 1 == descr_len) ? 0 : i + 1) {
+		if (!(decoded_fields & BIT64(i)) &&
+		    key_matches(kv, &descr[i])) {
+			return i;
 		}
 	}
 
+	return -1;
+}
+
+static int64_t obj_parse(struct json_obj *obj,
+			 const struct json_obj_descr *descr, size_t descr_len,
+			 void *val)
+{
+	struct json_obj_key_value kv;
+	struct obj_index index;
+	bool indexed = descr_len > OBJ_INDEX_MIN_FIELDS;
+	int64_t decoded_fields = 0;
+	size_t next = 0;
+	int i, ret;
+
+	if (indexed) {
+		obj_index_init(&index, descr, descr_len);
+	}
+
+	while (!obj_next(obj, &kv)) {
+		if (kv.value.type == JSON_TOK_OBJECT_END) {
+			return decoded_fields;
+		}
+
+		i = obj_find_field(&kv, descr, descr_len, decoded_fields, next,
+				   indexed ? &index : NULL);
+		if (i < 0) {
+			continue;
+		}
+
+		/* Store the decoded value */
+		ret = decode_value(obj, &descr[i], &kv.value,
+				   (char *)val + descr[i].offset, val);
+		if (ret < 0) {
+			return ret;
+		}
+
+		decoded_fields |= BIT64(i);
+		next = (i + 1 == descr_len) ? 0 : i + 1;
+	}
+
 	return -EINVAL;
 }
 
@@ -621,6 +868,23 @@ int json_obj_parse(char *payload, size_t len,
 		return ret;
 	}
 
+	return (int)obj_parse(&obj, descr, descr_len, val);
+}
+
+int64_t json_obj_parse64(char *payload, size_t len,
+			 const struct json_obj_descr *descr, size_t descr_len,
+			 void *val)
+{
+	struct json_obj obj;
+	int64_t ret;
+
+	__ASSERT_NO_MSG(descr_len < (sizeof(ret) * CHAR_BIT - 1));
+
+	ret = obj_init(&obj, payload, len);
+	if (ret < 0) {
+		return ret;
+	}
+
 	return obj_parse(&obj, descr, descr_len, val);
 }
 
@@ -641,6 +905,436 @@ int json_arr_parse(char *payload, size_t len,
 			 descr->array.n_elements, ptr, val);
 }
 
+/* Streaming tokenizer.  The grammar state says what may come next;
+ * the lexer state tracks a string, number or literal that may be split
+ * across chunks.
+ */
+enum {
+	STREAM_VALUE,		/* A value */
+	STREAM_VALUE_OR_END,	/* A value or ']', after '[' */
+	STREAM_KEY,		/* A key, after ',' in an object */
+	STREAM_KEY_OR_END,	/* A key or '}', after '{' */
+	STREAM_COLON,		/* ':' after a key */
+	STREAM_NEXT,		/* ',' or the end of the container */
+	STREAM_DONE,		/* Only white space after the top level value */
+};
+
+enum {
+	STREAM_LEX_NONE,
+	STREAM_LEX_STRING,
+	STREAM_LEX_NUMBER,
+	STREAM_LEX_TRUE,
+	STREAM_LEX_FALSE,
+	STREAM_LEX_NULL,
+};
+
+/* String lexer states, other than the number of \u hex digits left */
+#define STREAM_STR_PLAIN 0
+#define STREAM_STR_ESCAPE 5
+
+static const char *const stream_literals[] = {
+	[STREAM_LEX_TRUE] = "true",
+	[STREAM_LEX_FALSE] = "false",
+	[STREAM_LEX_NULL] = "null",
+};
+
+static const enum json_tokens stream_literal_tokens[] = {
+	[STREAM_LEX_TRUE] = JSON_TOK_TRUE,
+	[STREAM_LEX_FALSE] = JSON_TOK_FALSE,
+	[STREAM_LEX_NULL] = JSON_TOK_NULL,
+};
+
+static bool stream_in_object(const struct json_stream *stream)
+{
+	return stream->depth > 0 &&
+	       (stream->objects & BIT(stream->depth - 1)) != 0U;
+}
+
+static bool stream_expects_value(const struct json_stream *stream)
+{
+	return stream->state == STREAM_VALUE ||
+	       stream->state == STREAM_VALUE_OR_END;
+}
+
+static bool stream_expects_key(const struct json_stream *stream)
+{
+	return stream->state == STREAM_KEY ||
+	       stream->state == STREAM_KEY_OR_END;
+}
+
+static int stream_emit(struct json_stream *stream, enum json_tokens type,
+		       const char *value, size_t len)
+{
+	struct json_stream_token token = {
+		.type = type,
+		.key = type == JSON_TOK_STRING && stream_expects_key(stream),
+		.depth = stream->depth,
+		.value = value,
+		.len = len,
+	};
+	int ret = stream->cb(&token, stream->user_data);
+
+	return ret < 0 ? ret : 0;
+}
+
+static void stream_value_done(struct json_stream *stream)
+{
+	stream->state = stream->depth == 0 ? STREAM_DONE : STREAM_NEXT;
+}
+
+static int stream_save(struct json_stream *stream, const char *start,
+		       const char *end)
+{
+	size_t len = end - start;
+
+	if (len > stream->buf_size - stream->buf_len) {
+		return -ENOMEM;
+	}
+
+	memcpy(stream->buf + stream->buf_len, start, len);
+	stream->buf_len += len;
+
+	return 0;
+}
+
+/* Numbers are lexed as any run of the characters they may contain, so
+ * check the JSON number grammar once the whole number is known.
+ */
+static bool stream_number_valid(const char *pos, const char *end)
+{
+	const char *digits;
+
+	if (pos < end && *pos == '-') {
+		pos++;
+	}
+
+	if (pos < end && *pos == '0') {
+		pos++;
+	} else {
+		for (digits = pos; pos < end && isdigit((int)*pos); pos++) {
+		}
+		if (pos == digits) {
+			return false;
+		}
+	}
+
+	if (pos < end && *pos == '.') {
+		for (digits = ++pos; pos < end && isdigit((int)*pos); pos++) {
+		}
+		if (pos == digits) {
+			return false;
+		}
+	}
+
+	if (pos < end && (*pos == 'e' || *pos == 'E')) {
+		pos++;
+		if (pos < end && (*pos == '+' || *pos == '-')) {
+			pos++;
+		}
+		for (digits = pos; pos < end && isdigit((int)*pos); pos++) {
+		}
+		if (pos == digits) {
+			return false;
+		}
+	}
+
+	return pos == end;
+}
+
+/* A string, number or literal ending at @a end is complete.  If its
+ * beginning came with an earlier chunk, it's assembled in the buffer.
+ */
+static int stream_scalar(struct json_stream *stream, enum json_tokens type,
+			 const char *start, const char *end)
+{
+	const char *value = start;
+	size_t len = end - start;
+	int ret;
+
+	if (stream->buf_len > 0) {
+		ret = stream_save(stream, start, end);
+		if (ret < 0) {
+			return ret;
+		}
+
+		value = stream->buf;
+		len = stream->buf_len;
+		stream->buf_len = 0;
+	}
+
+	if (type == JSON_TOK_NUMBER && !stream_number_valid(value, value + len)) {
+		return -EINVAL;
+	}
+
+	stream->lex = STREAM_LEX_NONE;
+	ret = stream_emit(stream, type, value, len);
+
+	if (stream_expects_key(stream)) {
+		stream->state = STREAM_COLON;
+	} else {
+		stream_value_done(stream);
+	}
+
+	return ret;
+}
+
+/* The stream_lex_*() functions continue lexing the scalar that started
+ * at @a start (or in an earlier chunk) from @a pos.  They return where
+ * tokenizing goes on, which is @a end if the scalar continues in the
+ * next chunk.
+ */
+static const char *stream_lex_string(struct json_stream *stream,
+				     const char *start, const char *pos,
+				     const char *end, int *ret)
+{
+	for (; pos < end; pos++) {
+		char chr = *pos;
+
+		if (stream->lex_state == STREAM_STR_PLAIN) {
+			if (chr == '"') {
+				*ret = stream_scalar(stream, JSON_TOK_STRING,
+						     start, pos);
+				return pos + 1;
+			}
+
+			if (chr == '\\') {
+				stream->lex_state = STREAM_STR_ESCAPE;
+			} else if ((unsigned char)chr < ' ') {
+				/* Control characters have to be escaped */
+				*ret = -EINVAL;
+				return end;
+			}
+		} else if (stream->lex_state == STREAM_STR_ESCAPE) {
+			if (chr == 'u') {
+				stream->lex_state = 4;
+			} else if (chr != '\0' && strchr("\"\\/bfnrt", chr)) {
+				stream->lex_state = STREAM_STR_PLAIN;
+			} else {
+				*ret = -EINVAL;
+				return end;
+			}
+		} else if (isxdigit((int)chr)) {
+			stream->lex_state--;
+		} else {
+			*ret = -EINVAL;
+			return end;
+		}
+	}
+
+	return end;
+}
+
+static const char *stream_lex_number(struct json_stream *stream,
+				     const char *start, const char *pos,
+				     const char *end, int *ret)
+{
+	for (; pos < end; pos++) {
+		char chr = *pos;
+
+		if (!isdigit((int)chr) && chr != '.' && chr != 'e' &&
+		    chr != 'E' && chr != '+' && chr != '-') {
+			*ret = stream_scalar(stream, JSON_TOK_NUMBER, start,
+					     pos);
+			return pos;
+		}
+	}
+
+	return end;
+}
+
+/* For literals lex_state counts the characters matched so far */
+static const char *stream_lex_literal(struct json_stream *stream,
+				      const char *start, const char *pos,
+				      const char *end, int *ret)
+{
+	const char *literal = stream_literals[stream->lex];
+
+	for (; pos < end && literal[stream->lex_state] != '\0'; pos++) {
+		if (*pos != literal[stream->lex_state]) {
+			*ret = -EINVAL;
+			return end;
+		}
+
+		stream->lex_state++;
+	}
+
+	if (literal[stream->lex_state] == '\0') {
+		*ret = stream_scalar(stream, stream_literal_tokens[stream->lex],
+				     start, pos);
+	}
+
+	return pos;
+}
+
+static int stream_open(struct json_stream *stream, char chr)
+{
+	bool object = chr == '{';
+	int ret;
+
+	if (!stream_expects_value(stream)) {
+		return -EINVAL;
+	}
+
+	if (stream->depth == JSON_STREAM_MAX_DEPTH) {
+		return -E2BIG;
+	}
+
+	ret = stream_emit(stream, (enum json_tokens)chr, NULL, 0);
+
+	WRITE_BIT(stream->objects, stream->depth, object);
+	stream->depth++;
+	stream->state = object ? STREAM_KEY_OR_END : STREAM_VALUE_OR_END;
+
+	return ret;
+}
+
+static int stream_close(struct json_stream *stream, char chr)
+{
+	bool object = chr == '}';
+
+	if (stream->depth == 0 || stream_in_object(stream) != object) {
+		return -EINVAL;
+	}
+
+	if (stream->state != STREAM_NEXT &&
+	    stream->state != (object ? STREAM_KEY_OR_END : STREAM_VALUE_OR_END)) {
+		return -EINVAL;
+	}
+
+	stream->depth--;
+	stream_value_done(stream);
+
+	return stream_emit(stream, (enum json_tokens)chr, NULL, 0);
+}
+
+void json_stream_init(struct json_stream *stream, char *buf, size_t buf_size,
+		      json_stream_cb_t cb, void *user_data)
+{
+	*stream = (struct json_stream) {
+		.cb = cb,
+		.user_data = user_data,
+		.buf = buf,
+		.buf_size = buf_size,
+		.state = STREAM_VALUE,
+		.lex = STREAM_LEX_NONE,
+	};
+}
+
+int json_stream_feed(struct json_stream *stream, const char *data,
+		     size_t len)
+{
+	const char *end = data + len;
+	const char *pos = data;
+	const char *start = data;
+	int ret = stream->error;
+
+	while (ret == 0 && pos < end) {
+		char chr;
+
+		switch (stream->lex) {
+		case STREAM_LEX_NONE:
+			break;
+		case STREAM_LEX_STRING:
+			pos = stream_lex_string(stream, start, pos, end, &ret);
+			continue;
+		case STREAM_LEX_NUMBER:
+			pos = stream_lex_number(stream, start, pos, end, &ret);
+			continue;
+		default:
+			pos = stream_lex_literal(stream, start, pos, end, &ret);
+			continue;
+		}
+
+		chr = *pos++;
+		switch (chr) {
+		case ' ':
+		case '\t':
+		case '\n':
+		case '\r':
+			break;
+		case '{':
+		case '[':
+			ret = stream_open(stream, chr);
+			break;
+		case '}':
+		case ']':
+			ret = stream_close(stream, chr);
+			break;
+		case ':':
+			if (stream->state != STREAM_COLON) {
+				ret = -EINVAL;
+			}
+			stream->state = STREAM_VALUE;
+			break;
+		case ',':
+			if (stream->state != STREAM_NEXT) {
+				ret = -EINVAL;
+			}
+			stream->state = stream_in_object(stream) ?
+					STREAM_KEY : STREAM_VALUE;
+			break;
+		case '"':
+			if (!stream_expects_value(stream) &&
+			    !stream_expects_key(stream)) {
+				ret = -EINVAL;
+			}
+			stream->lex = STREAM_LEX_STRING;
+			stream->lex_state = STREAM_STR_PLAIN;
+			start = pos;
+			break;
+		case 't':
+		case 'f':
+		case 'n':
+			if (!stream_expects_value(stream)) {
+				ret = -EINVAL;
+			}
+			stream->lex = chr == 't' ? STREAM_LEX_TRUE :
+				      chr == 'f' ? STREAM_LEX_FALSE :
+				      STREAM_LEX_NULL;
+			stream->lex_state = 1;
+			start = pos - 1;
+			break;
+		default:
+			if ((chr != '-' && !isdigit((int)chr)) ||
+			    !stream_expects_value(stream)) {
+				ret = -EINVAL;
+			}
+			stream->lex = STREAM_LEX_NUMBER;
+			start = pos - 1;
+			break;
+		}
+	}
+
+	/* Keep what this chunk holds of an unfinished scalar */
+	if (ret == 0 && stream->lex != STREAM_LEX_NONE) {
+		ret = stream_save(stream, start, end);
+	}
+
+	stream->error = ret;
+
+	return ret;
+}
+
+int json_stream_finish(struct json_stream *stream)
+{
+	int ret = stream->error;
+
+	/* Only the end of the document ends a top level number */
+	if (ret == 0 && stream->lex == STREAM_LEX_NUMBER) {
+		ret = stream_scalar(stream, JSON_TOK_NUMBER, stream->buf,
+				    stream->buf);
+	}
+
+	if (ret == 0 && (stream->lex != STREAM_LEX_NONE ||
+			 stream->state != STREAM_DONE)) {
+		ret = -EINVAL;
+	}
+
+	stream->error = ret;
+
+	return ret;
+}
+
 static char escape_as(char chr)
 {
 	switch (chr) {
@@ -832,6 +1526,58 @@ static int num_encode(const int32_t *num, json_append_bytes_t append_bytes,
 	return append_bytes(buf, (size_t)ret, data);
 }
 
+static int int64_encode(const int64_t *num, json_append_bytes_t append_bytes,
+			void *data)
+{
+	char buf[sizeof("-9223372036854775808")];
+	char *pos = buf + sizeof(buf);
+	uint64_t val = *num < 0 ? -(uint64_t)*num : (uint64_t)*num;
+
+	/* Formatted here, as the nano cbprintf may lack 64 bit support */
+	do {
+		*--pos = '0' + (val % 10U);
+		val /= 10U;
+	} while (val != 0U);
+
+	if (*num < 0) {
+		*--pos = '-';
+	}
+
+	return append_bytes(pos, buf + sizeof(buf) - pos, data);
+}
+
+static int double_encode(const double *num, json_append_bytes_t append_bytes,
+			 void *data)
+{
+#if defined(CONFIG_JSON_LIBRARY_FP_SUPPORT) && defined(CONFIG_CBPRINTF_FP_SUPPORT)
+	/* cbprintf produces at most 16 significant digits, so doubles
+	 * needing all 17 do not read back exactly
+	 */
+	char buf[sizeof("-1.234567890123456e-308")];
+	int ret;
+
+	if (__builtin_isnan(*num) || __builtin_isinf(*num)) {
+		return -EINVAL;
+	}
+
+	ret = snprintk(buf, sizeof(buf), "%.16g", *num);
+	if (ret < 0) {
+		return ret;
+	}
+	if (ret >= (int)sizeof(buf)) {
+		return -ENOMEM;
+	}
+
+	return append_bytes(buf, (size_t)ret, data);
+#else
+	ARG_UNUSED(num);
+	ARG_UNUSED(append_bytes);
+	ARG_UNUSED(data);
+
+	return -ENOTSUP;
+#endif
+}
+
 static int bool_encode(const bool *value, json_append_bytes_t append_bytes,
 		       void *data)
 {
@@ -862,6 +1608,10 @@ static int encode(const struct json_obj_descr *descr, const void *val,
 				       ptr, append_bytes, data);
 	case JSON_TOK_NUMBER:
 		return num_encode(ptr, append_bytes, data);
+	case JSON_TOK_INT64:
+		return int64_encode(ptr, append_bytes, data);
+	case JSON_TOK_DOUBLE:
+		return double_encode(ptr, append_bytes, data);
 	default:
 		return -EINVAL;
 	}
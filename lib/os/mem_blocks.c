@@ -10,6 +10,325 @@
 #include <sys/heap_listener.h>
 #include <sys/mem_blocks.h>
 #include <sys/util.h>
+#include <string.h>
+
+#ifdef CONFIG_SYS_MEM_BLOCKS_BUDDY
+/*
+ * A buddy allocator keeps a bitmap of free chunks for each order next
+ * to the bitmap of allocated blocks, outside of the buffer as well.
+ * Bit i of the order k bitmap is set if blocks i * 2^k up to
+ * (i + 1) * 2^k - 1 are free, and are not part of a larger free chunk.
+ * All functions below are called with buddy_lock held.
+ */
+
+static inline bool is_buddy(sys_mem_blocks_t *mem_block)
+{
+	return mem_block->buddy_map != NULL;
+}
+
+static inline uint32_t *order_map(sys_mem_blocks_t *mem_block, int order)
+{
+	return mem_block->buddy_map + mem_block->buddy_orders[order].base;
+}
+
+static bool chunk_is_free(sys_mem_blocks_t *mem_block, int order, size_t idx)
+{
+	return (order_map(mem_block, order)[idx / 32] & BIT(idx % 32)) != 0U;
+}
+
+static void chunk_set_free(sys_mem_blocks_t *mem_block, int order, size_t idx)
+{
+	struct sys_mem_blocks_buddy_order *ord = &mem_block->buddy_orders[order];
+
+	order_map(mem_block, order)[idx / 32] |= BIT(idx % 32);
+	ord->free++;
+	ord->hint = MIN(ord->hint, idx / 32);
+}
+
+static void chunk_clear_free(sys_mem_blocks_t *mem_block, int order,
+			     size_t idx)
+{
+	order_map(mem_block, order)[idx / 32] &= ~BIT(idx % 32);
+	mem_block->buddy_orders[order].free--;
+}
+
+/* Free a chunk, merging it with its buddy as long as that is free too */
+static void buddy_free_chunk(sys_mem_blocks_t *mem_block, size_t offset,
+			     int order)
+{
+	while (order < mem_block->buddy_max_order) {
+		size_t buddy = (offset >> order) ^ 1U;
+
+		if (!chunk_is_free(mem_block, order, buddy)) {
+			break;
+		}
+
+		chunk_clear_free(mem_block, order, buddy);
+		order++;
+		offset &= ~(BIT(order) - 1U);
+	}
+
+	chunk_set_free(mem_block, order, offset >> order);
+}
+
+/* Free any run of blocks, as the largest aligned chunks it contains */
+static void buddy_free_range(sys_mem_blocks_t *mem_block, size_t offset,
+			     size_t count)
+{
+	while (count > 0) {
+		int order = find_msb_set(count) - 1;
+
+		if (offset != 0) {
+			order = MIN(order, find_lsb_set(offset) - 1);
+		}
+
+		buddy_free_chunk(mem_block, offset, order);
+		offset += BIT(order);
+		count -= BIT(order);
+	}
+}
+
+/* Take the lowest free chunk of the smallest order from @a order up,
+ * and split it down to @a order.  Returns its offset or -ENOMEM.
+ */
+static int buddy_alloc_chunk(sys_mem_blocks_t *mem_block, int order)
+{
+	struct sys_mem_blocks_buddy_order *ord;
+	uint32_t *map;
+	size_t idx, word;
+	int k;
+
+	for (k = order; k <= mem_block->buddy_max_order; k++) {
+		if (mem_block->buddy_orders[k].free != 0U) {
+			break;
+		}
+	}
+
+	if (k > mem_block->buddy_max_order) {
+		return -ENOMEM;
+	}
+
+	ord = &mem_block->buddy_orders[k];
+	map = order_map(mem_block, k);
+	for (word = ord->hint; map[word] == 0U; word++) {
+	}
+	ord->hint = word;
+
+	idx = word * 32 + find_lsb_set(map[word]) - 1;
+	chunk_clear_free(mem_block, k, idx);
+
+	/* Put the upper halves back while splitting */
+	while (k > order) {
+		k--;
+		idx <<= 1;
+		chunk_set_free(mem_block, k, idx + 1);
+	}
+
+	return idx << order;
+}
+
+/* Remove a run of free blocks from the free chunks */
+static void buddy_claim_range(sys_mem_blocks_t *mem_block, size_t offset,
+			      size_t count)
+{
+	size_t pos = offset, end = offset + count;
+
+	while (pos < end) {
+		size_t chunk_start, chunk_end, claim_end;
+		int order;
+
+		/* Find the free chunk the block belongs to */
+		for (order = 0; order <= mem_block->buddy_max_order; order++) {
+			if (chunk_is_free(mem_block, order, pos >> order)) {
+				break;
+			}
+		}
+
+		__ASSERT_NO_MSG(order <= mem_block->buddy_max_order);
+
+		chunk_clear_free(mem_block, order, pos >> order);
+		chunk_start = pos & ~(BIT(order) - 1U);
+		chunk_end = chunk_start + BIT(order);
+		claim_end = MIN(chunk_end, end);
+
+		buddy_free_range(mem_block, chunk_start, pos - chunk_start);
+		buddy_free_range(mem_block, claim_end, chunk_end - claim_end);
+		pos = claim_end;
+	}
+}
+
+/* Set up the free chunks from the bitmap on first use, as objects are
+ * defined statically.
+ */
+static void buddy_init(sys_mem_blocks_t *mem_block)
+{
+	size_t run = 0;
+	uint32_t base = 0;
+	int val;
+
+	if (mem_block->buddy_ready) {
+		return;
+	}
+
+	mem_block->buddy_max_order = find_msb_set(mem_block->num_blocks) - 1;
+	for (int k = 0; k <= mem_block->buddy_max_order; k++) {
+		uint32_t words = (mem_block->num_blocks >> k) / 32 + 1;
+
+		mem_block->buddy_orders[k].base = base;
+		mem_block->buddy_orders[k].free = 0U;
+		mem_block->buddy_orders[k].hint = words;
+		memset(mem_block->buddy_map + base, 0, words * sizeof(uint32_t));
+		base += words;
+	}
+
+	for (size_t i = 0; i < mem_block->num_blocks; i++) {
+		(void)sys_bitarray_test_bit(mem_block->bitmap, i, &val);
+		if (val == 0) {
+			run++;
+			continue;
+		}
+
+		buddy_free_range(mem_block, i - run, run);
+		run = 0;
+	}
+	buddy_free_range(mem_block, mem_block->num_blocks - run, run);
+
+	mem_block->buddy_ready = true;
+}
+
+static void *buddy_alloc(sys_mem_blocks_t *mem_block, size_t num_blocks)
+{
+	int order = num_blocks == 1 ? 0 : find_msb_set(num_blocks - 1);
+	k_spinlock_key_t key;
+	void *ret = NULL;
+	int offset;
+
+	key = k_spin_lock(&mem_block->buddy_lock);
+	buddy_init(mem_block);
+
+	if (order > mem_block->buddy_max_order) {
+		goto out;
+	}
+
+	offset = buddy_alloc_chunk(mem_block, order);
+	if (offset < 0) {
+		goto out;
+	}
+
+	/* Only the blocks asked for are allocated, the tail of the chunk
+	 * is free again right away
+	 */
+	(void)sys_bitarray_set_region(mem_block->bitmap, num_blocks, offset);
+	buddy_free_range(mem_block, offset + num_blocks,
+			 BIT(order) - num_blocks);
+
+	ret = mem_block->buffer + ((size_t)offset << mem_block->blk_sz_shift);
+
+out:
+	k_spin_unlock(&mem_block->buddy_lock, key);
+	return ret;
+}
+
+static int buddy_free(sys_mem_blocks_t *mem_block, size_t offset,
+		      size_t num_blocks)
+{
+	k_spinlock_key_t key;
+	int ret;
+
+	key = k_spin_lock(&mem_block->buddy_lock);
+	buddy_init(mem_block);
+
+	ret = sys_bitarray_free(mem_block->bitmap, num_blocks, offset);
+	if (ret == 0) {
+		buddy_free_range(mem_block, offset, num_blocks);
+	}
+
+	k_spin_unlock(&mem_block->buddy_lock, key);
+	return ret;
+}
+
+static int buddy_get(sys_mem_blocks_t *mem_block, size_t offset,
+		     size_t num_blocks)
+{
+	k_spinlock_key_t key;
+	int ret;
+
+	key = k_spin_lock(&mem_block->buddy_lock);
+	buddy_init(mem_block);
+
+	ret = sys_bitarray_test_and_set_region(mem_block->bitmap, num_blocks,
+					       offset, true);
+	if (ret == 0) {
+		buddy_claim_range(mem_block, offset, num_blocks);
+	}
+
+	k_spin_unlock(&mem_block->buddy_lock, key);
+	return ret;
+}
+
+int sys_mem_blocks_buddy_stats_get(sys_mem_blocks_t *mem_block,
+				   struct sys_mem_blocks_buddy_stats *stats)
+{
+	k_spinlock_key_t key;
+
+	CHECKIF((mem_block == NULL) || (stats == NULL) || !is_buddy(mem_block)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&mem_block->buddy_lock);
+	buddy_init(mem_block);
+
+	memset(stats, 0, sizeof(*stats));
+	for (int k = 0; k <= mem_block->buddy_max_order; k++) {
+		uint32_t free = mem_block->buddy_orders[k].free;
+
+		stats->free_chunks[k] = free;
+		stats->free_blocks += (size_t)free << k;
+		if (free != 0U) {
+			stats->max_free_chunk = BIT(k);
+		}
+	}
+
+	k_spin_unlock(&mem_block->buddy_lock, key);
+	return 0;
+}
+#else
+static inline bool is_buddy(sys_mem_blocks_t *mem_block)
+{
+	ARG_UNUSED(mem_block);
+
+	return false;
+}
+
+static inline void *buddy_alloc(sys_mem_blocks_t *mem_block,
+				size_t num_blocks)
+{
+	ARG_UNUSED(mem_block);
+	ARG_UNUSED(num_blocks);
+
+	return NULL;
+}
+
+static inline int buddy_free(sys_mem_blocks_t *mem_block, size_t offset,
+			     size_t num_blocks)
+{
+	ARG_UNUSED(mem_block);
+	ARG_UNUSED(offset);
+	ARG_UNUSED(num_blocks);
+
+	return -EINVAL;
+}
+
+static inline int buddy_get(sys_mem_blocks_t *mem_block, size_t offset,
+			    size_t num_blocks)
+{
+	ARG_UNUSED(mem_block);
+	ARG_UNUSED(offset);
+	ARG_UNUSED(num_blocks);
+
+	return -EINVAL;
+}
+#endif /* CONFIG_SYS_MEM_BLOCKS_BUDDY */
 
 static void *alloc_blocks(sys_mem_blocks_t *mem_block, size_t num_blocks)
 {
@@ -18,6 +337,10 @@ static void *alloc_blocks(sys_mem_blocks_t *mem_block, size_t num_blocks)
 	uint8_t *blk;
 	void *ret = NULL;
 
+	if (is_buddy(mem_block)) {
+		return buddy_alloc(mem_block, num_blocks);
+	}
+
 	/* Find an unallocated block */
 	r = sys_bitarray_alloc(mem_block->bitmap, num_blocks, &offset);
 	if (r != 0) {
@@ -51,7 +374,11 @@ static int free_blocks(sys_mem_blocks_t *mem_block, void *ptr, size_t num_blocks
 		goto out;
 	}
 
-	ret = sys_bitarray_free(mem_block->bitmap, num_blocks, offset);
+	if (is_buddy(mem_block)) {
+		ret = buddy_free(mem_block, offset, num_blocks);
+	} else {
+		ret = sys_bitarray_free(mem_block->bitmap, num_blocks, offset);
+	}
 
 out:
 	return ret;
@@ -163,7 +490,12 @@ int sys_mem_blocks_get(sys_mem_blocks_t *mem_block, void *in_block, size_t count
 		goto out;
 	}
 
-	ret = sys_bitarray_test_and_set_region(mem_block->bitmap, count, offset, true);
+	if (is_buddy(mem_block)) {
+		ret = buddy_get(mem_block, offset, count);
+	} else {
+		ret = sys_bitarray_test_and_set_region(mem_block->bitmap, count,
+						       offset, true);
+	}
 	if (ret != 0) {
 		ret = -ENOMEM;
 		goto out;
@@ -117,6 +117,12 @@ static inline uint32_t idx_inc(struct mpsc_pbuf_buffer *buffer,
 	return (i >= buffer->size) ? i - buffer->size : i;
 }
 
+static inline uint32_t idx_dist(struct mpsc_pbuf_buffer *buffer,
+				uint32_t from, uint32_t to)
+{
+	return (to >= from) ? to - from : buffer->size - from + to;
+}
+
 static inline uint32_t get_skip(union mpsc_pbuf_generic *item)
 {
 	if (item->hdr.busy && !item->hdr.valid) {
@@ -162,15 +168,32 @@ static union mpsc_pbuf_generic *drop_item_locked(struct mpsc_pbuf_buffer *buffer
 		allow_drop = true;
 	} else if (allow_drop) {
 		if (item->hdr.busy) {
-			/* item is currently processed and cannot be overwritten. */
+			/* Claimed items cannot be overwritten. Those are all
+			 * items up to the temporary read index and, if claimed
+			 * items were already moved once, a run of busy items.
+			 * If nothing follows them then there is nothing to drop.
+			 */
+			uint32_t claimed_wlen = idx_dist(buffer, buffer->rd_idx,
+							 buffer->tmp_rd_idx);
+			uint32_t next_rd_idx;
+
+			rd_wlen = 0;
+			do {
+				skip_wlen = get_skip(item);
+				rd_wlen += skip_wlen ? skip_wlen : buffer->get_wlen(item);
+				next_rd_idx = idx_inc(buffer, buffer->rd_idx, rd_wlen);
+				if (next_rd_idx == buffer->wr_idx) {
+					return NULL;
+				}
+				item = (union mpsc_pbuf_generic *)&buffer->buf[next_rd_idx];
+			} while (rd_wlen < claimed_wlen ||
+				 (item->hdr.busy && item->hdr.valid));
+
 			add_skip_item(buffer, free_wlen + 1);
 			buffer->wr_idx = idx_inc(buffer, buffer->wr_idx, rd_wlen);
 			buffer->tmp_wr_idx = idx_inc(buffer, buffer->tmp_wr_idx, rd_wlen);
 
-			/* Get next itme followed the busy one. */
-			uint32_t next_rd_idx = idx_inc(buffer, buffer->rd_idx, rd_wlen);
-
-			item = (union mpsc_pbuf_generic *)&buffer->buf[next_rd_idx];
+			/* Drop the item which follows the busy ones. */
 			skip_wlen = get_skip(item);
 			if (skip_wlen) {
 				rd_wlen += skip_wlen;
@@ -409,58 +432,75 @@ void mpsc_pbuf_put_data(struct mpsc_pbuf_buffer *buffer, const uint32_t *data,
 	} while (cont);
 }
 
-const union mpsc_pbuf_generic *mpsc_pbuf_claim(struct mpsc_pbuf_buffer *buffer)
+/* Claims the first pending packet, moving past skip packets and packets
+ * invalidated by the producer. Returns null when the packet at the read
+ * index is not yet committed or when the buffer is empty.
+ */
+static union mpsc_pbuf_generic *claim_locked(struct mpsc_pbuf_buffer *buffer)
 {
 	union mpsc_pbuf_generic *item;
-	bool cont;
-
-	do {
-		uint32_t a;
-		k_spinlock_key_t key;
-		bool wrap;
+	uint32_t a;
 
-		cont = false;
-		key = k_spin_lock(&buffer->lock);
-		wrap = available(buffer, &a);
+	while (true) {
+		(void)available(buffer, &a);
 		item = (union mpsc_pbuf_generic *)
 			&buffer->buf[buffer->tmp_rd_idx];
 
 		if (!a || is_invalid(item)) {
-			item = NULL;
-		} else {
-			uint32_t skip = get_skip(item);
+			return NULL;
+		}
 
-			if (skip || !is_valid(item)) {
-				uint32_t inc =
-					skip ? skip : buffer->get_wlen(item);
+		uint32_t skip = get_skip(item);
 
-				buffer->tmp_rd_idx =
-				      idx_inc(buffer, buffer->tmp_rd_idx, inc);
-				buffer->rd_idx =
-					idx_inc(buffer, buffer->rd_idx, inc);
-				cont = true;
-			} else {
-				item->hdr.busy = 1;
-				buffer->tmp_rd_idx =
-					idx_inc(buffer, buffer->tmp_rd_idx,
-						buffer->get_wlen(item));
-			}
-		}
+		if (skip || !is_valid(item)) {
+			uint32_t inc = skip ? skip : buffer->get_wlen(item);
 
-		if (!cont) {
-			MPSC_PBUF_DBG(buffer, "claimed: %p ", item);
+			buffer->tmp_rd_idx =
+				idx_inc(buffer, buffer->tmp_rd_idx, inc);
+			buffer->rd_idx = idx_inc(buffer, buffer->rd_idx, inc);
+		} else {
+			item->hdr.busy = 1;
+			buffer->tmp_rd_idx = idx_inc(buffer, buffer->tmp_rd_idx,
+						     buffer->get_wlen(item));
+			return item;
 		}
-		k_spin_unlock(&buffer->lock, key);
-	} while (cont);
+	}
+}
+
+const union mpsc_pbuf_generic *mpsc_pbuf_claim(struct mpsc_pbuf_buffer *buffer)
+{
+	union mpsc_pbuf_generic *item;
+	k_spinlock_key_t key = k_spin_lock(&buffer->lock);
+
+	item = claim_locked(buffer);
+	MPSC_PBUF_DBG(buffer, "claimed: %p ", item);
+	k_spin_unlock(&buffer->lock, key);
 
 	return item;
 }
 
-void mpsc_pbuf_free(struct mpsc_pbuf_buffer *buffer,
-		     const union mpsc_pbuf_generic *item)
+size_t mpsc_pbuf_claim_batch(struct mpsc_pbuf_buffer *buffer,
+			     const union mpsc_pbuf_generic **items, size_t max)
 {
-	uint32_t wlen = buffer->get_wlen(item);
 	k_spinlock_key_t key = k_spin_lock(&buffer->lock);
+	size_t n;
+
+	for (n = 0; n < max; n++) {
+		items[n] = claim_locked(buffer);
+		if (items[n] == NULL) {
+			break;
+		}
+	}
+
+	MPSC_PBUF_DBG(buffer, "claimed %d packets ", (int)n);
+	k_spin_unlock(&buffer->lock, key);
+
+	return n;
+}
+
+static void free_locked(struct mpsc_pbuf_buffer *buffer,
+			const union mpsc_pbuf_generic *item, uint32_t wlen)
+{
 	union mpsc_pbuf_generic *witem = (union mpsc_pbuf_generic *)item;
 
 	witem->hdr.valid = 0;
@@ -472,7 +512,36 @@ void mpsc_pbuf_free(struct mpsc_pbuf_buffer *buffer,
 		witem->skip.len = wlen;
 	}
 	MPSC_PBUF_DBG(buffer, "freed: %p ", item);
+}
+
+void mpsc_pbuf_free(struct mpsc_pbuf_buffer *buffer,
+		     const union mpsc_pbuf_generic *item)
+{
+	uint32_t wlen = buffer->get_wlen(item);
+	k_spinlock_key_t key = k_spin_lock(&buffer->lock);
+
+	free_locked(buffer, item, wlen);
+
+	k_spin_unlock(&buffer->lock, key);
+	k_sem_give(&buffer->sem);
+}
+
+void mpsc_pbuf_free_batch(struct mpsc_pbuf_buffer *buffer,
+			  const union mpsc_pbuf_generic **items, size_t count)
+{
+	k_spinlock_key_t key;
 
+	if (count == 0) {
+		return;
+	}
+
+	key = k_spin_lock(&buffer->lock);
+	for (size_t i = 0; i < count; i++) {
+		/* Claimed packets are busy so they cannot be overwritten and
+		 * their length can be read under the lock.
+		 */
+		free_locked(buffer, items[i], buffer->get_wlen(items[i]));
+	}
 	k_spin_unlock(&buffer->lock, key);
 	k_sem_give(&buffer->sem);
 }
@@ -70,6 +70,123 @@ static inline bool item_lessthan(struct k_p4wq_work *a, struct k_p4wq_work *b)
 	return false;
 }
 
+static struct k_p4wq_work *tree_max(struct rbtree *tree)
+{
+	struct rbnode *r = rb_get_max(tree);
+
+	return r ? CONTAINER_OF(r, struct k_p4wq_work, rbnode) : NULL;
+}
+
+#ifdef CONFIG_P4WQ_PER_CPU
+static struct rbtree *item_tree(struct k_p4wq *queue, struct k_p4wq_work *item)
+{
+	return item->pinned ? &queue->cpu[item->cpu].pinned
+			    : &queue->cpu[item->cpu].queue;
+}
+
+/* The CPU a thread is pinned to, -1 if it may run on several */
+static int thread_home_cpu(struct k_thread *th)
+{
+	uint8_t mask = th->base.cpu_mask & BIT_MASK(CONFIG_MP_NUM_CPUS);
+
+	return (mask != 0 && (mask & (mask - 1)) == 0) ?
+		(int)find_lsb_set(mask) - 1 : -1;
+}
+
+/* Keeps a over b unless b has strictly higher priority */
+static struct k_p4wq_work *better(struct k_p4wq_work *a,
+				  struct k_p4wq_work *b)
+{
+	return (a == NULL || (b != NULL && item_lessthan(a, b))) ? b : a;
+}
+
+/* Best item the current thread may run: items pinned to its CPU and
+ * items of the current CPU's sub-queue come first, those of the other
+ * sub-queues are stolen only when more urgent.
+ */
+static struct k_p4wq_work *next_item(struct k_p4wq *queue)
+{
+	int home = thread_home_cpu(_current);
+	unsigned int me = _current_cpu->id;
+	struct k_p4wq_work *best = NULL;
+
+	if (home >= 0) {
+		best = tree_max(&queue->cpu[home].pinned);
+	}
+	best = better(best, tree_max(&queue->cpu[me].queue));
+
+	for (unsigned int i = 1; i < CONFIG_MP_NUM_CPUS; i++) {
+		unsigned int cpu = (me + i) % CONFIG_MP_NUM_CPUS;
+
+		best = better(best, tree_max(&queue->cpu[cpu].queue));
+	}
+
+	return best;
+}
+
+/* Items pinned to a CPU only compete with the active items pinned to
+ * the same CPU for its single processor.
+ */
+static bool item_competes(struct k_p4wq_work *active, struct k_p4wq_work *item)
+{
+	if (item->pinned) {
+		return active->pinned && active->cpu == item->cpu;
+	}
+
+	return true;
+}
+#else
+static struct rbtree *item_tree(struct k_p4wq *queue, struct k_p4wq_work *item)
+{
+	ARG_UNUSED(item);
+
+	return &queue->queue;
+}
+
+static struct k_p4wq_work *next_item(struct k_p4wq *queue)
+{
+	return tree_max(&queue->queue);
+}
+
+static bool item_competes(struct k_p4wq_work *active, struct k_p4wq_work *item)
+{
+	ARG_UNUSED(active);
+	ARG_UNUSED(item);
+
+	return true;
+}
+#endif
+
+static bool item_is_pinned(struct k_p4wq_work *item)
+{
+#ifdef CONFIG_P4WQ_PER_CPU
+	return item->pinned;
+#else
+	ARG_UNUSED(item);
+
+	return false;
+#endif
+}
+
+static void stats_item_started(struct k_p4wq *queue, struct k_p4wq_work *w)
+{
+#ifdef CONFIG_P4WQ_STATS
+	uint32_t latency = k_cycle_get_32() - w->submit_time;
+
+	queue->stats.executed++;
+	queue->stats.latency_total += latency;
+	queue->stats.latency_max = MAX(queue->stats.latency_max, latency);
+#ifdef CONFIG_P4WQ_PER_CPU
+	if (!w->pinned && w->cpu != _current_cpu->id) {
+		queue->stats.stolen++;
+	}
+#endif
+#else
+	ARG_UNUSED(queue);
+	ARG_UNUSED(w);
+#endif
+}
+
 static FUNC_NORETURN void p4wq_loop(void *p0, void *p1, void *p2)
 {
 	ARG_UNUSED(p1);
@@ -78,13 +195,11 @@ static FUNC_NORETURN void p4wq_loop(void *p0, void *p1, void *p2)
 	k_spinlock_key_t k = k_spin_lock(&queue->lock);
 
 	while (true) {
-		struct rbnode *r = rb_get_max(&queue->queue);
+		struct k_p4wq_work *w = next_item(queue);
 
-		if (r) {
-			struct k_p4wq_work *w
-				= CONTAINER_OF(r, struct k_p4wq_work, rbnode);
-
-			rb_remove(&queue->queue, r);
+		if (w) {
+			rb_remove(item_tree(queue, w), &w->rbnode);
+			stats_item_started(queue, w);
 			w->thread = _current;
 			sys_dlist_append(&queue->active, &w->dlnode);
 			set_prio(_current, w);
@@ -125,7 +240,14 @@ void k_p4wq_init(struct k_p4wq *queue)
 {
 	memset(queue, 0, sizeof(*queue));
 	z_waitq_init(&queue->waitq);
+#ifdef CONFIG_P4WQ_PER_CPU
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		queue->cpu[i].queue.lessthan_fn = rb_lessthan;
+		queue->cpu[i].pinned.lessthan_fn = rb_lessthan;
+	}
+#else
 	queue->queue.lessthan_fn = rb_lessthan;
+#endif
 	sys_dlist_init(&queue->active);
 }
 
@@ -139,6 +261,25 @@ void k_p4wq_add_thread(struct k_p4wq *queue, struct k_thread *thread,
 			queue->flags & K_P4WQ_DELAYED_START ? K_FOREVER : K_NO_WAIT);
 }
 
+#ifdef CONFIG_SCHED_CPU_MASK
+int k_p4wq_add_cpu_thread(struct k_p4wq *queue, struct k_thread *thread,
+			  k_thread_stack_t *stack, size_t stack_size, int cpu)
+{
+	int ret;
+
+	k_thread_create(thread, stack, stack_size,
+			p4wq_loop, queue, NULL, NULL,
+			K_HIGHEST_THREAD_PRIO, 0, K_FOREVER);
+
+	ret = k_thread_cpu_pin(thread, cpu);
+	if (ret == 0) {
+		k_thread_start(thread);
+	}
+
+	return ret;
+}
+#endif
+
 static int static_init(const struct device *dev)
 {
 	ARG_UNUSED(dev);
@@ -214,15 +355,49 @@ void k_p4wq_enable_static_thread(struct k_p4wq *queue, struct k_thread *thread,
  */
 SYS_INIT(static_init, APPLICATION, 99);
 
-void k_p4wq_submit(struct k_p4wq *queue, struct k_p4wq_work *item)
+/* Wakes a worker for an item: pinned items need a worker pinned to
+ * their CPU, others preferably get one allowed to run on the CPU which
+ * submitted them.
+ */
+static struct k_thread *unpend_worker(struct k_p4wq *queue,
+				      struct k_p4wq_work *item)
+{
+#ifdef CONFIG_P4WQ_PER_CPU
+	struct k_thread *th;
+
+	_WAIT_Q_FOR_EACH(&queue->waitq, th) {
+		if (item->pinned ? thread_home_cpu(th) == item->cpu :
+		    (th->base.cpu_mask & BIT(item->cpu)) != 0) {
+			z_unpend_thread(th);
+			return th;
+		}
+	}
+
+	if (item->pinned) {
+		return NULL;
+	}
+#endif
+
+	return z_unpend_first_thread(&queue->waitq);
+}
+
+static void p4wq_submit(struct k_p4wq *queue, struct k_p4wq_work *item,
+			int cpu)
 {
 	k_spinlock_key_t k = k_spin_lock(&queue->lock);
+	uint32_t now = k_cycle_get_32();
+	struct rbtree *tree;
 
 	/* Input is a delta time from now (to match
 	 * k_thread_deadline_set()), but we store and use the absolute
 	 * cycle count.
 	 */
-	item->deadline += k_cycle_get_32();
+	item->deadline += now;
+
+#ifdef CONFIG_P4WQ_STATS
+	item->submit_time = now;
+	queue->stats.submitted++;
+#endif
 
 	/* Resubmission from within handler?  Remove from active list */
 	if (item->thread == _current) {
@@ -234,14 +409,22 @@ void k_p4wq_submit(struct k_p4wq *queue, struct k_p4wq_work *item)
 	}
 	__ASSERT_NO_MSG(item->thread == NULL);
 
-	rb_insert(&queue->queue, &item->rbnode);
+#ifdef CONFIG_P4WQ_PER_CPU
+	item->pinned = cpu >= 0;
+	item->cpu = item->pinned ? cpu : _current_cpu->id;
+#else
+	ARG_UNUSED(cpu);
+#endif
+
+	tree = item_tree(queue, item);
+	rb_insert(tree, &item->rbnode);
 	item->queue = queue;
 
 	/* If there were other items already ahead of it in the queue,
 	 * then we don't need to revisit active thread state and can
 	 * return.
 	 */
-	if (rb_get_max(&queue->queue) != &item->rbnode) {
+	if (rb_get_max(tree) != &item->rbnode) {
 		goto out;
 	}
 
@@ -251,7 +434,8 @@ void k_p4wq_submit(struct k_p4wq *queue, struct k_p4wq_work *item)
 	 * preempted and we can return.
 	 */
 	struct k_p4wq_work *wi;
-	uint32_t n_beaten_by = 0, active_target = CONFIG_MP_NUM_CPUS;
+	uint32_t n_beaten_by = 0;
+	uint32_t active_target = item_is_pinned(item) ? 1 : CONFIG_MP_NUM_CPUS;
 
 	SYS_DLIST_FOR_EACH_CONTAINER(&queue->active, wi, dlnode) {
 		/*
@@ -259,7 +443,7 @@ void k_p4wq_submit(struct k_p4wq *queue, struct k_p4wq_work *item)
 		 * !item_lessthan(a, b) counts all work items with higher or
 		 * equal priority
 		 */
-		if (!item_lessthan(wi, item)) {
+		if (item_competes(wi, item) && !item_lessthan(wi, item)) {
 			n_beaten_by++;
 		}
 	}
@@ -272,11 +456,19 @@ void k_p4wq_submit(struct k_p4wq *queue, struct k_p4wq_work *item)
 	/* Grab a thread, set its priority and queue it.  If there are
 	 * no threads available to unpend, this is a soft runtime
 	 * error: we are breaking our promise about run order.
-	 * Complain.
+	 * Complain.  A pinned item whose CPU's worker is busy simply
+	 * waits for it though, even if workers of other CPUs are idle.
 	 */
-	struct k_thread *th = z_unpend_first_thread(&queue->waitq);
+	struct k_thread *th = unpend_worker(queue, item);
 
 	if (th == NULL) {
+#ifdef CONFIG_P4WQ_PER_CPU
+		if (item->pinned && z_waitq_head(&queue->waitq) != NULL) {
+			LOG_DBG("Worker of CPU %d busy, pinned item waits",
+				item->cpu);
+			goto out;
+		}
+#endif
 		LOG_WRN("Out of worker threads, priority guarantee violated");
 		goto out;
 	}
@@ -291,16 +483,63 @@ out:
 	k_spin_unlock(&queue->lock, k);
 }
 
+void k_p4wq_submit(struct k_p4wq *queue, struct k_p4wq_work *item)
+{
+	p4wq_submit(queue, item, -1);
+}
+
+#ifdef CONFIG_P4WQ_PER_CPU
+void k_p4wq_submit_cpu(struct k_p4wq *queue, struct k_p4wq_work *item,
+		       int cpu)
+{
+	__ASSERT_NO_MSG(cpu >= 0 && cpu < CONFIG_MP_NUM_CPUS);
+
+	p4wq_submit(queue, item, cpu);
+}
+#endif
+
 bool k_p4wq_cancel(struct k_p4wq *queue, struct k_p4wq_work *item)
 {
 	k_spinlock_key_t k = k_spin_lock(&queue->lock);
-	bool ret = rb_contains(&queue->queue, &item->rbnode);
+	bool ret = false;
 
+#ifdef CONFIG_P4WQ_PER_CPU
+	/* The sub-queue index is only meaningful once submitted */
+	if (item->queue != queue || item->cpu >= CONFIG_MP_NUM_CPUS) {
+		goto out;
+	}
+#endif
+
+	ret = rb_contains(item_tree(queue, item), &item->rbnode);
 	if (ret) {
-		rb_remove(&queue->queue, &item->rbnode);
+		rb_remove(item_tree(queue, item), &item->rbnode);
 		k_sem_give(&item->done_sem);
+#ifdef CONFIG_P4WQ_STATS
+		queue->stats.canceled++;
+#endif
 	}
 
+#ifdef CONFIG_P4WQ_PER_CPU
+out:
+#endif
 	k_spin_unlock(&queue->lock, k);
 	return ret;
 }
+
+#ifdef CONFIG_P4WQ_STATS
+void k_p4wq_stats_get(struct k_p4wq *queue, struct k_p4wq_stats *stats)
+{
+	k_spinlock_key_t k = k_spin_lock(&queue->lock);
+
+	*stats = queue->stats;
+	k_spin_unlock(&queue->lock, k);
+}
+
+void k_p4wq_stats_reset(struct k_p4wq *queue)
+{
+	k_spinlock_key_t k = k_spin_lock(&queue->lock);
+
+	queue->stats = (struct k_p4wq_stats){};
+	k_spin_unlock(&queue->lock, k);
+}
+#endif
@@ -64,9 +64,9 @@ static void set_color(struct rbnode *n, enum rb_color color)
 {
 	CHECK(n);
 
-	uintptr_t *p = (void *) &n->children[0];
+	uintptr_t p = (uintptr_t) n->children[0];
 
-	*p = (*p & ~1UL) | (uint8_t)color;
+	n->children[0] = (void *) ((p & ~1UL) | (uint8_t)color);
 }
 
 /* Searches the tree down to a node that is either identical with the
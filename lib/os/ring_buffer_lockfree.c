@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/ring_buffer_lockfree.h>
+#include <string.h>
+
+BUILD_ASSERT(Z_RING_BUF_IS_POW2(Z_RING_BUF_LOCKFREE_ALIGN),
+	     "Alignment must be a power of 2");
+
+/* Publishing an index with atomic_set() orders all preceding accesses to the
+ * buffer before it, and reading the other side's index with atomic_get()
+ * orders all following accesses after it. Each index has a single writer.
+ */
+
+uint32_t ring_buf_spsc_put_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size)
+{
+	uint32_t head = buf->put.head;
+	uint32_t capacity = buf->mask + 1;
+	uint32_t free_space = capacity - (head - buf->put.get_tail);
+	uint32_t offset = head & buf->mask;
+
+	if (free_space < size) {
+		buf->put.get_tail = (uint32_t)atomic_get(&buf->get.tail);
+		free_space = capacity - (head - buf->put.get_tail);
+	}
+
+	size = MIN(size, free_space);
+	size = MIN(size, capacity - offset);
+
+	*data = &buf->buffer[offset];
+	buf->put.head = head + size;
+
+	return size;
+}
+
+int ring_buf_spsc_put_finish(struct ring_buf_spsc *buf, uint32_t size)
+{
+	uint32_t tail = (uint32_t)atomic_get(&buf->put.tail);
+
+	if (unlikely(size > buf->put.head - tail)) {
+		return -EINVAL;
+	}
+
+	tail += size;
+	buf->put.head = tail;
+	atomic_set(&buf->put.tail, (atomic_val_t)tail);
+
+	return 0;
+}
+
+uint32_t ring_buf_spsc_put(struct ring_buf_spsc *buf, const uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *dst;
+	uint32_t partial_size;
+	uint32_t total_size = 0U;
+	int err;
+
+	do {
+		partial_size = ring_buf_spsc_put_claim(buf, &dst, size);
+		memcpy(dst, data, partial_size);
+		total_size += partial_size;
+		size -= partial_size;
+		data += partial_size;
+	} while (size && partial_size);
+
+	err = ring_buf_spsc_put_finish(buf, total_size);
+	__ASSERT_NO_MSG(err == 0);
+
+	return total_size;
+}
+
+uint32_t ring_buf_spsc_get_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size)
+{
+	uint32_t head = buf->get.head;
+	uint32_t available = buf->get.put_tail - head;
+	uint32_t offset = head & buf->mask;
+
+	if (available < size) {
+		buf->get.put_tail = (uint32_t)atomic_get(&buf->put.tail);
+		available = buf->get.put_tail - head;
+	}
+
+	size = MIN(size, available);
+	size = MIN(size, buf->mask + 1 - offset);
+
+	*data = &buf->buffer[offset];
+	buf->get.head = head + size;
+
+	return size;
+}
+
+int ring_buf_spsc_get_finish(struct ring_buf_spsc *buf, uint32_t size)
+{
+	uint32_t tail = (uint32_t)atomic_get(&buf->get.tail);
+
+	if (unlikely(size > buf->get.head - tail)) {
+		return -EINVAL;
+	}
+
+	tail += size;
+	buf->get.head = tail;
+	atomic_set(&buf->get.tail, (atomic_val_t)tail);
+
+	return 0;
+}
+
+uint32_t ring_buf_spsc_get(struct ring_buf_spsc *buf, uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *src;
+	uint32_t partial_size;
+	uint32_t total_size = 0U;
+	int err;
+
+	do {
+		partial_size = ring_buf_spsc_get_claim(buf, &src, size);
+		if (data) {
+			memcpy(data, src, partial_size);
+			data += partial_size;
+		}
+		total_size += partial_size;
+		size -= partial_size;
+	} while (size && partial_size);
+
+	err = ring_buf_spsc_get_finish(buf, total_size);
+	__ASSERT_NO_MSG(err == 0);
+
+	return total_size;
+}
+
+/* A slot is free for the producer which claims put index pos when its
+ * sequence number equals pos and holds data for the consumer which claims get
+ * index pos when it equals pos + 1. Finishing a read moves it on to the next
+ * lap, pos + number of slots. Sequence numbers are stored relative to the
+ * slot index so that zeroed slot state is a valid, empty ring buffer.
+ */
+static inline uint32_t slot_seq(struct ring_buf_mpmc *buf, uint32_t idx)
+{
+	return (uint32_t)atomic_get(&buf->slots[idx].seq) + idx;
+}
+
+static int slot_idx(struct ring_buf_mpmc *buf, uint8_t *data, uint32_t *idx)
+{
+	uintptr_t offset = (uintptr_t)(data - buf->buffer);
+
+	if (offset % buf->slot_size ||
+	    offset / buf->slot_size > buf->mask) {
+		return -EINVAL;
+	}
+
+	*idx = offset / buf->slot_size;
+
+	return 0;
+}
+
+void ring_buf_mpmc_init(struct ring_buf_mpmc *buf, uint32_t slot_size,
+			uint32_t num_slots, uint8_t *data,
+			struct ring_buf_mpmc_slot *slots)
+{
+	__ASSERT(Z_RING_BUF_IS_POW2(num_slots),
+		 "Number of slots must be a power of 2");
+	__ASSERT(slot_size > 0, "Slot size must not be 0");
+
+	buf->buffer = data;
+	buf->slots = slots;
+	buf->slot_size = slot_size;
+	buf->mask = num_slots - 1;
+	memset(slots, 0, num_slots * sizeof(*slots));
+	atomic_set(&buf->put.head, 0);
+	atomic_set(&buf->get.head, 0);
+}
+
+uint32_t ring_buf_mpmc_put_claim(struct ring_buf_mpmc *buf, uint8_t **data)
+{
+	atomic_val_t pos = atomic_get(&buf->put.head);
+
+	while (true) {
+		uint32_t idx = (uint32_t)pos & buf->mask;
+		int32_t diff = (int32_t)(slot_seq(buf, idx) - (uint32_t)pos);
+
+		if (diff < 0) {
+			/* Slot still holds data from the previous lap. */
+			return 0;
+		}
+
+		if (diff == 0 &&
+		    atomic_cas(&buf->put.head, pos,
+			       (atomic_val_t)((uint32_t)pos + 1))) {
+			*data = &buf->buffer[idx * buf->slot_size];
+			return buf->slot_size;
+		}
+
+		/* Another producer claimed the slot first. */
+		pos = atomic_get(&buf->put.head);
+	}
+}
+
+int ring_buf_mpmc_put_finish(struct ring_buf_mpmc *buf, uint8_t *data,
+			     uint32_t size)
+{
+	uint32_t idx;
+
+	if (slot_idx(buf, data, &idx) || size > buf->slot_size) {
+		return -EINVAL;
+	}
+
+	buf->slots[idx].len = size;
+	(void)atomic_inc(&buf->slots[idx].seq);
+
+	return 0;
+}
+
+uint32_t ring_buf_mpmc_put(struct ring_buf_mpmc *buf, const uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *dst;
+	int err;
+
+	if (size == 0 || ring_buf_mpmc_put_claim(buf, &dst) == 0) {
+		return 0;
+	}
+
+	size = MIN(size, buf->slot_size);
+	memcpy(dst, data, size);
+
+	err = ring_buf_mpmc_put_finish(buf, dst, size);
+	__ASSERT_NO_MSG(err == 0);
+
+	return size;
+}
+
+uint32_t ring_buf_mpmc_get_claim(struct ring_buf_mpmc *buf, uint8_t **data)
+{
+	atomic_val_t pos = atomic_get(&buf->get.head);
+
+	while (true) {
+		uint32_t idx = (uint32_t)pos & buf->mask;
+		int32_t diff = (int32_t)(slot_seq(buf, idx) -
+					 ((uint32_t)pos + 1));
+
+		if (diff < 0) {
+			/* Slot is not yet finished by its producer. */
+			return 0;
+		}
+
+		if (diff == 0 &&
+		    atomic_cas(&buf->get.head, pos,
+			       (atomic_val_t)((uint32_t)pos + 1))) {
+			uint32_t len = buf->slots[idx].len;
+
+			*data = &buf->buffer[idx * buf->slot_size];
+			if (len) {
+				return len;
+			}
+
+			/* Empty record, release the slot and try the next. */
+			(void)ring_buf_mpmc_get_finish(buf, *data);
+		}
+
+		pos = atomic_get(&buf->get.head);
+	}
+}
+
+int ring_buf_mpmc_get_finish(struct ring_buf_mpmc *buf, uint8_t *data)
+{
+	uint32_t idx;
+
+	if (slot_idx(buf, data, &idx)) {
+		return -EINVAL;
+	}
+
+	(void)atomic_add(&buf->slots[idx].seq, (atomic_val_t)buf->mask);
+
+	return 0;
+}
+
+uint32_t ring_buf_mpmc_get(struct ring_buf_mpmc *buf, uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *src;
+	uint32_t len;
+	int err;
+
+	len = ring_buf_mpmc_get_claim(buf, &src);
+	if (len == 0) {
+		return 0;
+	}
+
+	if (data) {
+		memcpy(data, src, MIN(size, len));
+	}
+
+	err = ring_buf_mpmc_get_finish(buf, src);
+	__ASSERT_NO_MSG(err == 0);
+
+	return len;
+}
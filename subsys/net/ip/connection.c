@@ -13,6 +13,7 @@ LOG_MODULE_REGISTER(net_conn, CONFIG_NET_CONN_LOG_LEVEL);
 
 #include <errno.h>
 #include <sys/util.h>
+#include <sys/byteorder.h>
 
 #include <net/net_core.h>
 #include <net/net_pkt.h>
@@ -59,6 +60,177 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+#if defined(CONFIG_NET_CONN_HASH)
+/* UDP and TCP handlers with a local port are also hashed, by remote
+ * address and both ports when the remote end is fully specified, by
+ * local port otherwise. All the other handlers are kept on conn_wild.
+ * Like conn_used, each chain is newest first, so merging the chains a
+ * packet may match on the registration sequence number visits the
+ * candidates in the same order as walking conn_used does, and the
+ * ranking in net_conn_input() picks the same handler.
+ */
+static sys_slist_t conn_connected[CONFIG_NET_CONN_HASH_BUCKETS];
+static sys_slist_t conn_bound[CONFIG_NET_CONN_HASH_BUCKETS];
+static sys_slist_t conn_wild;
+static uint32_t conn_seq;
+
+static inline uint32_t conn_hash(uint32_t hash, uint32_t val)
+{
+	hash = (hash ^ val) * 0x9e3779b1U;
+
+	return hash ^ (hash >> 16);
+}
+
+/* Ports are in network byte order */
+static sys_slist_t *conn_chain_connected(uint16_t proto,
+					 const uint8_t *remote_addr,
+					 size_t addr_len,
+					 uint16_t remote_port,
+					 uint16_t local_port)
+{
+	uint32_t hash;
+
+	hash = conn_hash(proto, ((uint32_t)remote_port << 16) | local_port);
+
+	for (size_t i = 0; i < addr_len; i += sizeof(uint32_t)) {
+		hash = conn_hash(hash, sys_get_be32(&remote_addr[i]));
+	}
+
+	return &conn_connected[hash % CONFIG_NET_CONN_HASH_BUCKETS];
+}
+
+static sys_slist_t *conn_chain_bound(uint16_t proto, uint16_t local_port)
+{
+	return &conn_bound[conn_hash(proto, local_port) %
+			   CONFIG_NET_CONN_HASH_BUCKETS];
+}
+
+static sys_slist_t *conn_chain(uint16_t proto,
+			       const struct sockaddr *remote_addr,
+			       uint16_t remote_port,
+			       uint16_t local_port)
+{
+	if ((proto != IPPROTO_UDP && proto != IPPROTO_TCP) || !local_port) {
+		return &conn_wild;
+	}
+
+	if (remote_addr == NULL || !remote_port) {
+		return conn_chain_bound(proto, local_port);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    remote_addr->sa_family == AF_INET6 &&
+	    !net_ipv6_is_addr_unspecified(&net_sin6(remote_addr)->sin6_addr)) {
+		return conn_chain_connected(
+			proto, net_sin6(remote_addr)->sin6_addr.s6_addr,
+			sizeof(struct in6_addr), remote_port, local_port);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) &&
+	    remote_addr->sa_family == AF_INET &&
+	    net_sin(remote_addr)->sin_addr.s_addr) {
+		return conn_chain_connected(
+			proto, (const uint8_t *)&net_sin(remote_addr)->sin_addr,
+			sizeof(struct in_addr), remote_port, local_port);
+	}
+
+	return conn_chain_bound(proto, local_port);
+}
+
+static sys_slist_t *conn_get_chain(struct net_conn *conn)
+{
+	return conn_chain(conn->proto, &conn->remote_addr,
+			  net_sin(&conn->remote_addr)->sin_port,
+			  net_sin(&conn->local_addr)->sin_port);
+}
+#endif /* CONFIG_NET_CONN_HASH */
+
+/* Handlers a packet is matched against, newest first */
+struct conn_iter {
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_snode_t *next[3];
+	bool hashed;
+#else
+	sys_snode_t *next[1];
+#endif
+};
+
+static void conn_iter_init(struct conn_iter *iter, struct net_pkt *pkt,
+			   union net_ip_header *ip_hdr, uint8_t proto,
+			   uint16_t src_port, uint16_t dst_port)
+{
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_slist_t *connected = NULL;
+
+	if (proto == IPPROTO_UDP || proto == IPPROTO_TCP) {
+		if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		    net_pkt_family(pkt) == AF_INET6) {
+			connected = conn_chain_connected(
+				proto, ip_hdr->ipv6->src,
+				sizeof(struct in6_addr), src_port, dst_port);
+		} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+			   net_pkt_family(pkt) == AF_INET) {
+			connected = conn_chain_connected(
+				proto, ip_hdr->ipv4->src,
+				sizeof(struct in_addr), src_port, dst_port);
+		}
+	}
+
+	/* Packets for other families, AF_PACKET or AF_CAN, are
+	 * checked against all handlers.
+	 */
+	iter->hashed = connected != NULL;
+	if (iter->hashed) {
+		iter->next[0] = sys_slist_peek_head(connected);
+		iter->next[1] = sys_slist_peek_head(
+			conn_chain_bound(proto, dst_port));
+		iter->next[2] = sys_slist_peek_head(&conn_wild);
+		return;
+	}
+#endif
+
+	iter->next[0] = sys_slist_peek_head(&conn_used);
+}
+
+static struct net_conn *conn_iter_next(struct conn_iter *iter)
+{
+	struct net_conn *conn = NULL;
+
+#if defined(CONFIG_NET_CONN_HASH)
+	if (iter->hashed) {
+		size_t chain = 0;
+
+		for (size_t i = 0; i < ARRAY_SIZE(iter->next); i++) {
+			struct net_conn *head;
+
+			if (iter->next[i] == NULL) {
+				continue;
+			}
+
+			head = CONTAINER_OF(iter->next[i], struct net_conn,
+					    hash_node);
+			if (conn == NULL || (int32_t)(head->seq - conn->seq) > 0) {
+				conn = head;
+				chain = i;
+			}
+		}
+
+		if (conn != NULL) {
+			iter->next[chain] = sys_slist_peek_next(iter->next[chain]);
+		}
+
+		return conn;
+	}
+#endif
+
+	if (iter->next[0] != NULL) {
+		conn = CONTAINER_OF(iter->next[0], struct net_conn, node);
+		iter->next[0] = sys_slist_peek_next(iter->next[0]);
+	}
+
+	return conn;
+}
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -132,6 +304,11 @@ static void conn_set_used(struct net_conn *conn)
 	conn->flags |= NET_CONN_IN_USE;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+
+#if defined(CONFIG_NET_CONN_HASH)
+	conn->seq = ++conn_seq;
+	sys_slist_prepend(conn_get_chain(conn), &conn->hash_node);
+#endif
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -149,9 +326,16 @@ static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 					  uint16_t local_port)
 {
 	struct net_conn *conn;
-	struct net_conn *tmp;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&conn_used, conn, tmp, node) {
+#if defined(CONFIG_NET_CONN_HASH)
+	/* An identical handler is on the same chain */
+	sys_slist_t *chain = conn_chain(proto, remote_addr, htons(remote_port),
+					htons(local_port));
+
+	SYS_SLIST_FOR_EACH_CONTAINER(chain, conn, hash_node) {
+#else
+	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+#endif
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -381,6 +565,10 @@ int net_conn_unregister(struct net_conn_handle *handle)
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_slist_find_and_remove(conn_get_chain(conn), &conn->hash_node);
+#endif
+
 	conn_set_unused(conn);
 
 	return 0;
@@ -562,6 +750,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool raw_pkt_delivered = false;
 	bool raw_pkt_continue = false;
 	int16_t best_rank = -1;
+	struct conn_iter iter;
 	struct net_conn *conn;
 	enum net_verdict ret;
 	uint16_t src_port;
@@ -627,7 +816,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	conn_iter_init(&iter, pkt, ip_hdr, proto, src_port, dst_port);
+
+	while ((conn = conn_iter_next(&iter)) != NULL) {
 		if (conn->context != NULL &&
 		    net_context_is_bound_to_iface(conn->context) &&
 		    net_pkt_iface(pkt) != net_context_get_iface(conn->context)) {
@@ -860,6 +1051,15 @@ void net_conn_init(void)
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	for (i = 0; i < CONFIG_NET_CONN_HASH_BUCKETS; i++) {
+		sys_slist_init(&conn_connected[i]);
+		sys_slist_init(&conn_bound[i]);
+	}
+
+	sys_slist_init(&conn_wild);
+#endif
+
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
 	}
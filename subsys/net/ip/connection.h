@@ -51,6 +51,14 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+#if defined(CONFIG_NET_CONN_HASH)
+	/** Internal slist node in the hash chain */
+	sys_snode_t hash_node;
+
+	/** Registration order, newest first in the hash chains */
+	uint32_t seq;
+#endif
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
@@ -465,11 +465,18 @@ static enum net_verdict icmpv4_handle_echo_request(struct net_pkt *pkt,
 		}
 	}
 
-	if (icmpv4_create(reply, NET_ICMPV4_ECHO_REPLY, 0) ||
-	    net_pkt_copy(reply, pkt, payload_len)) {
+	if (icmpv4_create(reply, NET_ICMPV4_ECHO_REPLY, 0)) {
 		goto drop;
 	}
 
+	net_pkt_chksum_copy_begin(reply);
+
+	if (net_pkt_copy(reply, pkt, payload_len)) {
+		goto drop;
+	}
+
+	net_pkt_chksum_copy_end(reply);
+
 	net_pkt_cursor_init(reply);
 	net_ipv4_finalize(reply, IPPROTO_ICMP);
 
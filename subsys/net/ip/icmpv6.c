@@ -151,12 +151,20 @@ enum net_verdict icmpv6_handle_echo_request(struct net_pkt *pkt,
 		goto drop;
 	}
 
-	if (net_icmpv6_create(reply, NET_ICMPV6_ECHO_REPLY, 0) ||
-	    net_pkt_copy(reply, pkt, payload_len)) {
+	if (net_icmpv6_create(reply, NET_ICMPV6_ECHO_REPLY, 0)) {
 		NET_DBG("DROP: wrong buffer");
 		goto drop;
 	}
 
+	net_pkt_chksum_copy_begin(reply);
+
+	if (net_pkt_copy(reply, pkt, payload_len)) {
+		NET_DBG("DROP: wrong buffer");
+		goto drop;
+	}
+
+	net_pkt_chksum_copy_end(reply);
+
 	net_pkt_cursor_init(reply);
 	net_ipv6_finalize(reply, IPPROTO_ICMPV6);
 
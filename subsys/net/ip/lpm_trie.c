@@ -0,0 +1,284 @@
+/** @file
+ * @brief Longest prefix match trie
+ *
+ * Binary trie where chains of nodes with a single child are collapsed,
+ * so that a lookup visits at most one node per distinct prefix length
+ * on the path to the address. Entries with children stay in the trie as
+ * inner nodes, glue nodes from a pool join the subtrees of prefixes that
+ * diverge where no entry is.
+ */
+
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/__assert.h>
+#include <sys/math_extras.h>
+#include <sys/util.h>
+
+#include "lpm_trie.h"
+
+static inline uint8_t key_bit(const uint8_t *key, uint8_t bit)
+{
+	return (key[bit / 8] >> (7 - (bit % 8))) & 1;
+}
+
+/* Number of leading bits, up to max, which both keys have in common */
+static uint8_t common_len(const uint8_t *a, const uint8_t *b, uint8_t max)
+{
+	uint8_t len = 0U;
+
+	for (int i = 0; len < max; i++) {
+		uint8_t diff = a[i] ^ b[i];
+
+		if (diff) {
+			len += u32_count_leading_zeros(diff) - 24;
+			break;
+		}
+
+		len += 8U;
+	}
+
+	return MIN(len, max);
+}
+
+static void replace(struct net_lpm_trie *trie, struct net_lpm_node *old,
+		    struct net_lpm_node *new)
+{
+	struct net_lpm_node *parent = old->parent;
+
+	new->parent = parent;
+
+	if (!parent) {
+		trie->root = new;
+	} else {
+		parent->child[parent->child[1] == old] = new;
+	}
+}
+
+static void adopt_children(struct net_lpm_node *node,
+			   struct net_lpm_node *from)
+{
+	for (int i = 0; i < 2; i++) {
+		node->child[i] = from->child[i];
+		if (node->child[i]) {
+			node->child[i]->parent = node;
+		}
+	}
+}
+
+static struct net_lpm_node *glue_alloc(struct net_lpm_trie *trie,
+				       const uint8_t *key, uint8_t len)
+{
+	struct net_lpm_node *glue = trie->free_glue;
+
+	if (!glue) {
+		return NULL;
+	}
+
+	trie->free_glue = glue->child[0];
+
+	memcpy((uint8_t *)glue->key, key, ceiling_fraction(len, 8));
+	glue->len = len;
+	glue->child[0] = NULL;
+	glue->child[1] = NULL;
+
+	return glue;
+}
+
+static void glue_free(struct net_lpm_trie *trie, struct net_lpm_node *glue)
+{
+	glue->child[0] = trie->free_glue;
+	trie->free_glue = glue;
+}
+
+void net_lpm_init(struct net_lpm_trie *trie, uint8_t key_bits,
+		  struct net_lpm_glue *glue, size_t glue_count)
+{
+	__ASSERT_NO_MSG(key_bits <= NET_LPM_KEY_MAX_LEN * 8);
+
+	trie->root = NULL;
+	trie->free_glue = NULL;
+	trie->key_bits = key_bits;
+
+	for (size_t i = 0; i < glue_count; i++) {
+		glue[i].node.key = glue[i].key;
+		glue[i].node.is_glue = 1U;
+		glue[i].node.is_dup = 0U;
+		glue[i].node.dup = NULL;
+		glue_free(trie, &glue[i].node);
+	}
+}
+
+int net_lpm_insert(struct net_lpm_trie *trie, struct net_lpm_node *node,
+		   const uint8_t *key, uint8_t len)
+{
+	struct net_lpm_node *cur = trie->root;
+	struct net_lpm_node *glue;
+	uint8_t common;
+
+	__ASSERT_NO_MSG(len <= trie->key_bits);
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	node->parent = NULL;
+	node->dup = NULL;
+	node->key = key;
+	node->len = len;
+	node->is_glue = 0U;
+	node->is_dup = 0U;
+
+	if (!cur) {
+		trie->root = node;
+		return 0;
+	}
+
+	while (true) {
+		common = common_len(key, cur->key, MIN(len, cur->len));
+
+		if (common < cur->len) {
+			/* The prefix diverges from cur, or is shorter */
+			if (common == len) {
+				replace(trie, cur, node);
+				node->child[key_bit(cur->key, len)] = cur;
+				cur->parent = node;
+				return 0;
+			}
+
+			glue = glue_alloc(trie, key, common);
+			if (!glue) {
+				return -ENOMEM;
+			}
+
+			replace(trie, cur, glue);
+			glue->child[key_bit(key, common)] = node;
+			glue->child[key_bit(cur->key, common)] = cur;
+			node->parent = glue;
+			cur->parent = glue;
+			return 0;
+		}
+
+		if (cur->len == len) {
+			if (cur->is_glue) {
+				replace(trie, cur, node);
+				adopt_children(node, cur);
+				glue_free(trie, cur);
+				return 0;
+			}
+
+			while (cur->dup) {
+				cur = cur->dup;
+			}
+
+			cur->dup = node;
+			node->parent = cur;
+			node->is_dup = 1U;
+			return 0;
+		}
+
+		if (!cur->child[key_bit(key, cur->len)]) {
+			cur->child[key_bit(key, cur->len)] = node;
+			node->parent = cur;
+			return 0;
+		}
+
+		cur = cur->child[key_bit(key, cur->len)];
+	}
+}
+
+void net_lpm_remove(struct net_lpm_trie *trie, struct net_lpm_node *node)
+{
+	struct net_lpm_node *parent, *child;
+
+	if (node->is_dup) {
+		node->parent->dup = node->dup;
+		if (node->dup) {
+			node->dup->parent = node->parent;
+		}
+
+		return;
+	}
+
+	if (node->dup) {
+		/* The next entry with the same prefix takes the place */
+		child = node->dup;
+		child->is_dup = 0U;
+		replace(trie, node, child);
+		adopt_children(child, node);
+		return;
+	}
+
+	if (node->child[0] && node->child[1]) {
+		child = glue_alloc(trie, node->key, node->len);
+
+		/* There are fewer glue nodes than entries with no children */
+		__ASSERT(child, "No glue node left");
+
+		replace(trie, node, child);
+		adopt_children(child, node);
+		return;
+	}
+
+	child = node->child[0] ? node->child[0] : node->child[1];
+	if (child) {
+		replace(trie, node, child);
+		return;
+	}
+
+	parent = node->parent;
+	if (!parent) {
+		trie->root = NULL;
+		return;
+	}
+
+	parent->child[parent->child[1] == node] = NULL;
+
+	if (parent->is_glue) {
+		/* Glue nodes always join two subtrees */
+		child = parent->child[0] ? parent->child[0] : parent->child[1];
+		replace(trie, parent, child);
+		glue_free(trie, parent);
+	}
+}
+
+struct net_lpm_node *net_lpm_lookup(struct net_lpm_trie *trie,
+				    const uint8_t *addr,
+				    net_lpm_match_cb_t match,
+				    void *user_data)
+{
+	struct net_lpm_node *cur = trie->root;
+	struct net_lpm_node *found = NULL;
+	uint8_t matched = 0U;
+
+	while (cur) {
+		/* The bits above the parent prefix are known to match */
+		if (common_len(addr + matched / 8, cur->key + matched / 8,
+			       cur->len - (matched & ~7)) <
+		    cur->len - (matched & ~7)) {
+			break;
+		}
+
+		matched = cur->len;
+
+		if (!cur->is_glue) {
+			for (struct net_lpm_node *n = cur; n; n = n->dup) {
+				if (!match || match(n, user_data)) {
+					found = n;
+					break;
+				}
+			}
+		}
+
+		if (cur->len >= trie->key_bits) {
+			break;
+		}
+
+		cur = cur->child[key_bit(addr, cur->len)];
+	}
+
+	return found;
+}
@@ -0,0 +1,145 @@
+/** @file
+ * @brief Longest prefix match trie
+ *
+ * This is not to be included by the application.
+ */
+
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __LPM_TRIE_H
+#define __LPM_TRIE_H
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Longest key, in bytes, an IPv6 address. */
+#define NET_LPM_KEY_MAX_LEN 16
+
+/**
+ * @brief Trie node, embedded in every entry stored in the trie.
+ *
+ * Entries with the same prefix are chained after the one linked in the
+ * trie, in the order they were inserted.
+ */
+struct net_lpm_node {
+	/** Subtrees for the next bit after the prefix being 0 or 1. */
+	struct net_lpm_node *child[2];
+
+	/** Parent node, or previous entry in a chain of duplicates. */
+	struct net_lpm_node *parent;
+
+	/** Next entry with the same prefix. */
+	struct net_lpm_node *dup;
+
+	/** Prefix, in network byte order. */
+	const uint8_t *key;
+
+	/** Prefix length in bits. */
+	uint8_t len;
+
+	/** Node only joining two subtrees, not an entry. */
+	uint8_t is_glue : 1;
+
+	/** Entry chained after another one with the same prefix. */
+	uint8_t is_dup : 1;
+};
+
+/**
+ * @brief Node joining two subtrees which diverge after a common prefix.
+ *
+ * A trie holding N entries needs at most N - 1 of them.
+ */
+struct net_lpm_glue {
+	struct net_lpm_node node;
+	uint8_t key[NET_LPM_KEY_MAX_LEN];
+};
+
+/**
+ * @brief Path compressed binary trie.
+ */
+struct net_lpm_trie {
+	struct net_lpm_node *root;
+
+	/** Unused glue nodes, linked through child[0]. */
+	struct net_lpm_node *free_glue;
+
+	/** Length of the keys looked up, in bits. */
+	uint8_t key_bits;
+};
+
+/**
+ * @brief Callback telling whether an entry is acceptable for a lookup.
+ *
+ * @param node Entry whose prefix matches the address.
+ * @param user_data User data given to net_lpm_lookup().
+ *
+ * @return True to accept the entry.
+ */
+typedef bool (*net_lpm_match_cb_t)(struct net_lpm_node *node,
+				   void *user_data);
+
+/**
+ * @brief Initialize an empty trie.
+ *
+ * @param trie Trie to initialize.
+ * @param key_bits Length of the keys, 32 for IPv4 and 128 for IPv6.
+ * @param glue Glue nodes for the trie to use.
+ * @param glue_count Number of glue nodes, at least the number of entries
+ *        the trie will hold minus one for insertions to never fail.
+ */
+void net_lpm_init(struct net_lpm_trie *trie, uint8_t key_bits,
+		  struct net_lpm_glue *glue, size_t glue_count);
+
+/**
+ * @brief Insert an entry into the trie.
+ *
+ * @param trie Trie.
+ * @param node Node of the entry.
+ * @param key Prefix of the entry, which must stay valid while the entry
+ *        is in the trie.
+ * @param len Prefix length in bits.
+ *
+ * @return 0 if ok, -ENOMEM if a glue node was needed but none was left.
+ */
+int net_lpm_insert(struct net_lpm_trie *trie, struct net_lpm_node *node,
+		   const uint8_t *key, uint8_t len);
+
+/**
+ * @brief Remove an entry from the trie.
+ *
+ * @param trie Trie.
+ * @param node Node of the entry, which must be in the trie.
+ */
+void net_lpm_remove(struct net_lpm_trie *trie, struct net_lpm_node *node);
+
+/**
+ * @brief Find the entry with the longest prefix matching an address.
+ *
+ * @param trie Trie.
+ * @param addr Address, key_bits long.
+ * @param match Optional callback to skip some of the entries.
+ * @param user_data User data given to the callback.
+ *
+ * @return Entry with the longest matching prefix accepted by the
+ *         callback, the first inserted if several have the same prefix,
+ *         NULL if there is none.
+ */
+struct net_lpm_node *net_lpm_lookup(struct net_lpm_trie *trie,
+				    const uint8_t *addr,
+				    net_lpm_match_cb_t match,
+				    void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LPM_TRIE_H */
@@ -57,9 +57,11 @@ struct net_nbr *net_nbr_ref(struct net_nbr *nbr)
 	return nbr;
 }
 
-static inline struct net_nbr *get_nbr(struct net_nbr *start, int idx)
+static inline struct net_nbr *get_nbr(struct net_nbr_table *table, int idx)
 {
-	NET_ASSERT(idx < CONFIG_NET_IPV6_MAX_NEIGHBORS);
+	struct net_nbr *start = table->nbr;
+
+	NET_ASSERT(idx < table->nbr_count);
 
 	return (struct net_nbr *)((uint8_t *)start +
 			((sizeof(struct net_nbr) +
@@ -71,7 +73,7 @@ struct net_nbr *net_nbr_get(struct net_nbr_table *table)
 	int i;
 
 	for (i = 0; i < table->nbr_count; i++) {
-		struct net_nbr *nbr = get_nbr(table->nbr, i);
+		struct net_nbr *nbr = get_nbr(table, i);
 
 		if (!nbr->ref) {
 			nbr->data = nbr->__nbr;
@@ -164,7 +166,7 @@ struct net_nbr *net_nbr_lookup(struct net_nbr_table *table,
 	int i;
 
 	for (i = 0; i < table->nbr_count; i++) {
-		struct net_nbr *nbr = get_nbr(table->nbr, i);
+		struct net_nbr *nbr = get_nbr(table, i);
 
 		if (nbr->ref && nbr->iface == iface &&
 		    net_neighbor_lladdr[nbr->idx].ref &&
@@ -191,7 +193,7 @@ void net_nbr_clear_table(struct net_nbr_table *table)
 	int i;
 
 	for (i = 0; i < table->nbr_count; i++) {
-		struct net_nbr *nbr = get_nbr(table->nbr, i);
+		struct net_nbr *nbr = get_nbr(table, i);
 		struct net_linkaddr lladdr = {
 			.addr = net_neighbor_lladdr[i].lladdr.addr,
 			.len = net_neighbor_lladdr[i].lladdr.len
@@ -211,7 +213,7 @@ void net_nbr_print(struct net_nbr_table *table)
 		int i;
 
 		for (i = 0; i < table->nbr_count; i++) {
-			struct net_nbr *nbr = get_nbr(table->nbr, i);
+			struct net_nbr *nbr = get_nbr(table, i);
 
 			if (!nbr->ref) {
 				continue;
@@ -44,8 +44,8 @@ struct net_nbr_lladdr {
  * data at the end of the node.
  */
 struct net_nbr {
-	/** Reference count. */
-	uint8_t ref;
+	/** Reference count. Every route through a next hop holds one. */
+	uint16_t ref;
 
 	/** Link to ll address. This is the index into lladdr array.
 	 * The value NET_NBR_LLADDR_UNKNOWN tells that this neighbor
@@ -1353,7 +1353,12 @@ static int context_setup_udp_packet(struct net_context *context,
 		return ret;
 	}
 
+	net_pkt_chksum_copy_begin(pkt);
+
 	ret = context_write_data(pkt, buf, len, msg);
+
+	net_pkt_chksum_copy_end(pkt);
+
 	if (ret) {
 		return ret;
 	}
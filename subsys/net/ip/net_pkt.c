@@ -1703,6 +1703,10 @@ int net_pkt_write(struct net_pkt *pkt, const void *data, size_t length)
 {
 	NET_DBG("pkt %p data %p length %zu", pkt, data, length);
 
+	if (net_pkt_is_chksum_copy(pkt) && !net_pkt_is_being_overwritten(pkt)) {
+		net_pkt_chksum_add(pkt, data, length);
+	}
+
 	if (data == pkt->cursor.pos && net_pkt_is_contiguous(pkt, length)) {
 		return net_pkt_skip(pkt, length);
 	}
@@ -1747,6 +1751,10 @@ int net_pkt_copy(struct net_pkt *pkt_dst,
 
 		if (!net_pkt_is_being_overwritten(pkt_dst)) {
 			net_buf_add(c_dst->buf, len);
+
+			if (net_pkt_is_chksum_copy(pkt_dst)) {
+				net_pkt_chksum_add(pkt_dst, c_dst->pos, len);
+			}
 		}
 
 		pkt_cursor_update(pkt_dst, len, true);
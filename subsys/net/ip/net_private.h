@@ -163,6 +163,12 @@ enum net_verdict net_context_packet_received(struct net_conn *conn,
 					     union net_proto_header *proto_hdr,
 					     void *user_data);
 
+#if defined(CONFIG_NET_PKT_CHKSUM_COPY)
+void net_pkt_chksum_add(struct net_pkt *pkt, const uint8_t *data, size_t len);
+#else
+#define net_pkt_chksum_add(...)
+#endif /* CONFIG_NET_PKT_CHKSUM_COPY */
+
 #if defined(CONFIG_NET_IPV4)
 extern uint16_t net_calc_chksum_ipv4(struct net_pkt *pkt);
 #endif /* CONFIG_NET_IPV4 */
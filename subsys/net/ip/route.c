@@ -36,7 +36,48 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
+
+/* Longest prefix match trie of the routes, searched by net_route_lookup().
+ * It needs one glue node less than there are routes.
+ */
+static struct net_lpm_trie route_trie;
+static struct net_lpm_glue route_trie_glue[MAX(CONFIG_NET_MAX_ROUTES - 1, 1)];
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+/* Results of the latest lookups, hashed by destination. It is flushed
+ * whenever a route is added or deleted.
+ */
+struct route_cache_entry {
+	struct in6_addr dst;
+	struct net_if *iface;
+	struct net_route_entry *route;
+};
+
+static struct route_cache_entry route_cache[CONFIG_NET_ROUTE_CACHE_SIZE];
+
+static struct route_cache_entry *route_cache_slot(struct net_if *iface,
+						   struct in6_addr *dst)
+{
+	uint32_t hash = UNALIGNED_GET(&dst->s6_addr32[0]) ^
+			UNALIGNED_GET(&dst->s6_addr32[1]) ^
+			UNALIGNED_GET(&dst->s6_addr32[2]) ^
+			UNALIGNED_GET(&dst->s6_addr32[3]) ^
+			(uint32_t)POINTER_TO_UINT(iface);
+
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+
+	return &route_cache[hash % CONFIG_NET_ROUTE_CACHE_SIZE];
+}
+
+static void route_cache_flush(void)
+{
+	memset(route_cache, 0, sizeof(route_cache));
+}
+#else
+#define route_cache_flush()
+#endif /* CONFIG_NET_ROUTE_CACHE_SIZE > 0 */
 
 /* Track currently active route lifetime timers */
 static sys_slist_t active_route_lifetime_timers;
@@ -135,32 +176,31 @@ static inline struct net_route_entry *net_route_data(struct net_nbr *nbr)
 
 struct net_nbr *net_route_get_nbr(struct net_route_entry *route)
 {
-	int i;
+	struct net_nbr *nbr = NULL;
+	uintptr_t offset;
+	size_t i;
 
 	NET_ASSERT(route);
 
-	k_mutex_lock(&lock, K_FOREVER);
+	/* The route is the data of its entry in the pool */
+	offset = (uintptr_t)route -
+		 (uintptr_t)net_route_entries_pool[0].data;
+	i = offset / sizeof(net_route_entries_pool[0]);
 
-	for (i = 0; i < CONFIG_NET_MAX_ROUTES; i++) {
-		struct net_nbr *nbr = get_nbr(i);
-
-		if (!nbr->ref) {
-			continue;
-		}
+	if ((uintptr_t)route < (uintptr_t)net_route_entries_pool[0].data ||
+	    i >= CONFIG_NET_MAX_ROUTES ||
+	    offset % sizeof(net_route_entries_pool[0])) {
+		return NULL;
+	}
 
-		if (nbr->data == (uint8_t *)route) {
-			if (!nbr->ref) {
-				k_mutex_unlock(&lock);
-				return NULL;
-			}
+	k_mutex_lock(&lock, K_FOREVER);
 
-			k_mutex_unlock(&lock);
-			return nbr;
-		}
+	if (get_nbr(i)->ref && get_nbr(i)->data == (uint8_t *)route) {
+		nbr = get_nbr(i);
 	}
 
 	k_mutex_unlock(&lock);
-	return NULL;
+	return nbr;
 }
 
 void net_routes_print(void)
@@ -277,41 +317,52 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
+}
+
+static bool route_iface_match(struct net_lpm_node *node, void *user_data)
+{
+	struct net_route_entry *route =
+		CONTAINER_OF(node, struct net_route_entry, trie_node);
+
+	return route->iface == user_data;
 }
 
 struct net_route_entry *net_route_lookup(struct net_if *iface,
 					 struct in6_addr *dst)
 {
-	struct net_route_entry *route, *found = NULL;
-	uint8_t longest_match = 0U;
-	int i;
+	struct net_route_entry *found = NULL;
+	struct net_lpm_node *node;
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	struct route_cache_entry *cached = route_cache_slot(iface, dst);
+#endif
 
 	k_mutex_lock(&lock, K_FOREVER);
 
-	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
-		struct net_nbr *nbr = get_nbr(i);
-
-		if (!nbr->ref) {
-			continue;
-		}
-
-		if (iface && nbr->iface != iface) {
-			continue;
-		}
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	if (cached->route && cached->iface == iface &&
+	    net_ipv6_addr_cmp(&cached->dst, dst)) {
+		found = cached->route;
+		goto out;
+	}
+#endif
 
-		route = net_route_data(nbr);
+	node = net_lpm_lookup(&route_trie, dst->s6_addr,
+			      iface ? route_iface_match : NULL, iface);
+	if (node) {
+		found = CONTAINER_OF(node, struct net_route_entry, trie_node);
 
-		if (route->prefix_len >= longest_match &&
-		    net_ipv6_is_prefix(dst->s6_addr,
-				       route->addr.s6_addr,
-				       route->prefix_len)) {
-			found = route;
-			longest_match = route->prefix_len;
-		}
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+		net_ipaddr_copy(&cached->dst, dst);
+		cached->iface = iface;
+		cached->route = found;
+#endif
 	}
 
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+out:
+#endif
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -409,9 +460,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -462,7 +511,12 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 
 	net_route_update_lifetime(route, lifetime);
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
+
+	/* Cannot fail, there is a glue node for every route but one */
+	(void)net_lpm_insert(&route_trie, &route->trie_node,
+			     route->addr.s6_addr, prefix_len);
+	route_cache_flush();
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -582,6 +636,12 @@ int net_route_del(struct net_route_entry *route)
 
 	k_mutex_lock(&lock, K_FOREVER);
 
+	nbr = net_route_get_nbr(route);
+	if (!nbr) {
+		k_mutex_unlock(&lock);
+		return -ENOENT;
+	}
+
 #if defined(CONFIG_NET_MGMT_EVENT_INFO)
 	net_ipaddr_copy(&info.addr, &route->addr);
 	info.prefix_len = route->prefix_len;
@@ -604,13 +664,10 @@ int net_route_del(struct net_route_entry *route)
 		}
 	}
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	sys_dlist_remove(&route->node);
 
-	nbr = net_route_get_nbr(route);
-	if (!nbr) {
-		k_mutex_unlock(&lock);
-		return -ENOENT;
-	}
+	net_lpm_remove(&route_trie, &route->trie_node);
+	route_cache_flush();
 
 	net_route_info("Deleted", route, &route->addr);
 
@@ -1110,5 +1167,8 @@ void net_route_init(void)
 	NET_DBG("Allocated %d nexthop entries (%zu bytes)",
 		CONFIG_NET_MAX_NEXTHOPS, sizeof(net_route_nexthop_pool));
 
+	net_lpm_init(&route_trie, 128, route_trie_glue,
+		     ARRAY_SIZE(route_trie_glue));
+
 	k_work_init_delayable(&route_lifetime_timer, route_lifetime_timeout);
 }
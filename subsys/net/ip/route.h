@@ -15,11 +15,13 @@
 
 #include <kernel.h>
 #include <sys/slist.h>
+#include <sys/dlist.h>
 
 #include <net/net_ip.h>
 #include <net/net_timeout.h>
 
 #include "nbr.h"
+#include "lpm_trie.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -47,7 +49,10 @@ struct net_route_entry {
 	 * we can remove it if we run out of available routes.
 	 * The oldest one is the last entry in the list.
 	 */
-	sys_snode_t node;
+	sys_dnode_t node;
+
+	/** Node in the longest prefix match trie of the routes. */
+	struct net_lpm_node trie_node;
 
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
@@ -44,11 +44,26 @@ static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
 static K_MUTEX_DEFINE(tcp_lock);
 
+/* Connections with their end points set, hashed on both of them, so
+ * that incoming segments are matched without taking tcp_lock.
+ */
+struct tcp_bucket {
+	struct k_spinlock lock;
+	sys_slist_t conns;
+};
+
+static struct tcp_bucket tcp_buckets[CONFIG_NET_TCP_CONN_HASH_BUCKETS];
+
 K_MEM_SLAB_DEFINE_STATIC(tcp_conns_slab, sizeof(struct tcp),
 				CONFIG_NET_MAX_CONTEXTS, 4);
 
-static struct k_work_q tcp_work_q;
-static K_KERNEL_STACK_DEFINE(work_q_stack, CONFIG_NET_TCP_WORKQ_STACK_SIZE);
+/* Connections are spread over the work queues, each one always uses
+ * the same queue so its timers never run concurrently.
+ */
+static struct k_work_q tcp_work_q[CONFIG_NET_TCP_WORKQ_COUNT];
+static K_KERNEL_STACK_ARRAY_DEFINE(work_q_stack, CONFIG_NET_TCP_WORKQ_COUNT,
+				   CONFIG_NET_TCP_WORKQ_STACK_SIZE);
+static atomic_t tcp_work_q_next;
 
 static void tcp_in(struct tcp *conn, struct net_pkt *pkt);
 static bool is_destination_local(struct net_pkt *pkt);
@@ -209,6 +224,56 @@ static int tcp_endpoint_set(union tcp_endpoint *ep, struct net_pkt *pkt,
 	return ret;
 }
 
+static struct tcp_bucket *tcp_bucket_get(const union tcp_endpoint *src,
+					 const union tcp_endpoint *dst)
+{
+	const union tcp_endpoint *ep[] = { src, dst };
+	uint32_t hash = 2166136261U;
+
+	/* FNV-1a over the bytes the connection lookup compares */
+	for (int i = 0; i < ARRAY_SIZE(ep); i++) {
+		const uint8_t *p = (const uint8_t *)ep[i];
+		size_t len = tcp_endpoint_len(ep[i]->sa.sa_family);
+
+		while (len-- > 0) {
+			hash = (hash ^ *p++) * 16777619U;
+		}
+	}
+
+	return &tcp_buckets[hash % CONFIG_NET_TCP_CONN_HASH_BUCKETS];
+}
+
+static void tcp_conn_unhash(struct tcp *conn)
+{
+	struct tcp_bucket *bucket = conn->bucket;
+	k_spinlock_key_t key;
+
+	if (bucket == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&bucket->lock);
+	sys_slist_find_and_remove(&bucket->conns, &conn->hash_next);
+	conn->bucket = NULL;
+	k_spin_unlock(&bucket->lock, key);
+}
+
+/* Make the connection visible to tcp_conn_search() once its end points
+ * are set.
+ */
+static void tcp_conn_hash(struct tcp *conn)
+{
+	struct tcp_bucket *bucket = tcp_bucket_get(&conn->src, &conn->dst);
+	k_spinlock_key_t key;
+
+	tcp_conn_unhash(conn);
+
+	key = k_spin_lock(&bucket->lock);
+	sys_slist_append(&bucket->conns, &conn->hash_next);
+	conn->bucket = bucket;
+	k_spin_unlock(&bucket->lock, key);
+}
+
 static const char *tcp_flags(uint8_t flags)
 {
 #define BUF_SIZE 25 /* 6 * 4 + 1 */
@@ -427,6 +492,7 @@ static int tcp_conn_unref(struct tcp *conn)
 	k_work_cancel_delayable(&conn->timewait_timer);
 	k_work_cancel_delayable(&conn->fin_timer);
 
+	tcp_conn_unhash(conn);
 	sys_slist_find_and_remove(&tcp_conns, &conn->next);
 
 	memset(conn, 0, sizeof(*conn));
@@ -505,10 +571,10 @@ static bool tcp_send_process_no_lock(struct tcp *conn)
 	}
 
 	if (conn->in_retransmission) {
-		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_timer,
+		k_work_reschedule_for_queue(conn->work_q, &conn->send_timer,
 					    K_MSEC(tcp_rto));
 	} else if (local && !sys_slist_is_empty(&conn->send_queue)) {
-		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_timer,
+		k_work_reschedule_for_queue(conn->work_q, &conn->send_timer,
 					    K_NO_WAIT);
 	}
 
@@ -554,7 +620,7 @@ static void tcp_send_timer_cancel(struct tcp *conn)
 		conn->in_retransmission = false;
 	} else {
 		conn->send_retries = tcp_retries;
-		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_timer,
+		k_work_reschedule_for_queue(conn->work_q, &conn->send_timer,
 					    K_MSEC(tcp_rto));
 	}
 }
@@ -625,9 +691,9 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
-	recv_options->wnd_found = false;
-
+	/* MSS, window scale and SACK permitted are only sent in SYN
+	 * segments, so what was found there is kept for the connection.
+	 */
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
 
@@ -675,6 +741,34 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 			recv_options->window = opt;
 			recv_options->wnd_found = true;
 			break;
+#if defined(CONFIG_NET_TCP_SACK)
+		case NET_TCP_SACK_PERM_OPT:
+			if (opt_len != NET_TCP_SACK_PERM_SIZE) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm_found = true;
+			break;
+		case NET_TCP_SACK_OPT:
+			if ((opt_len - 2) % NET_TCP_SACK_BLOCK_SIZE) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_cnt = 0;
+
+			for (int i = 2; i < opt_len &&
+			     recv_options->sack_cnt < TCP_SACK_BLOCKS;
+			     i += NET_TCP_SACK_BLOCK_SIZE) {
+				struct tcp_sack_block *block;
+
+				block = &recv_options->sack[recv_options->sack_cnt++];
+				block->start = sys_get_be32(options + i);
+				block->end = sys_get_be32(options + i + 4);
+			}
+			break;
+#endif
 		default:
 			continue;
 		}
@@ -771,6 +865,53 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+#if defined(CONFIG_NET_TCP_SACK)
+/* SACK permitted goes in our SYN, and in the SYN-ACK if the peer's SYN
+ * had it. ACKs report the out-of-order data queued as one SACK block.
+ */
+static size_t tcp_sack_opt_len(struct tcp *conn, uint8_t flags)
+{
+	if (flags & SYN) {
+		if (!(flags & ACK) || conn->recv_options.sack_perm_found) {
+			return 2 * NET_TCP_NOP_SIZE + NET_TCP_SACK_PERM_SIZE;
+		}
+
+		return 0;
+	}
+
+	if (conn->sack_ok && (flags & ACK) &&
+	    CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT &&
+	    !net_pkt_is_empty(conn->queue_recv_data)) {
+		return 2 * NET_TCP_NOP_SIZE + 2 + NET_TCP_SACK_BLOCK_SIZE;
+	}
+
+	return 0;
+}
+
+static int tcp_sack_opt_set(struct tcp *conn, struct net_pkt *pkt,
+			    size_t len)
+{
+	uint8_t opt[2 * NET_TCP_NOP_SIZE + 2 + NET_TCP_SACK_BLOCK_SIZE] = {
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT,
+	};
+
+	if (len == 2 * NET_TCP_NOP_SIZE + NET_TCP_SACK_PERM_SIZE) {
+		opt[2] = NET_TCP_SACK_PERM_OPT;
+		opt[3] = NET_TCP_SACK_PERM_SIZE;
+	} else {
+		uint32_t start = tcp_get_seq(conn->queue_recv_data->buffer);
+
+		opt[2] = NET_TCP_SACK_OPT;
+		opt[3] = 2 + NET_TCP_SACK_BLOCK_SIZE;
+		sys_put_be32(start, &opt[4]);
+		sys_put_be32(start + net_pkt_get_len(conn->queue_recv_data),
+			     &opt[8]);
+	}
+
+	return net_pkt_write(pkt, opt, len);
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 			  uint32_t seq)
 {
@@ -792,6 +933,10 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 		th->th_off++;
 	}
 
+#if defined(CONFIG_NET_TCP_SACK)
+	th->th_off += tcp_sack_opt_len(conn, flags) / 4;
+#endif
+
 	UNALIGNED_PUT(flags, &th->th_flags);
 	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
@@ -868,6 +1013,11 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 	size_t alloc_len = sizeof(struct tcphdr);
 	struct net_pkt *pkt;
 	int ret = 0;
+#if defined(CONFIG_NET_TCP_SACK)
+	size_t sack_len = tcp_sack_opt_len(conn, flags);
+
+	alloc_len += sack_len;
+#endif
 
 	if (conn->send_options.mss_found) {
 		alloc_len += sizeof(uint32_t);
@@ -905,6 +1055,16 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		}
 	}
 
+#if defined(CONFIG_NET_TCP_SACK)
+	if (sack_len) {
+		ret = tcp_sack_opt_set(conn, pkt, sack_len);
+		if (ret < 0) {
+			tcp_pkt_unref(pkt);
+			goto out;
+		}
+	}
+#endif
+
 	ret = tcp_finalize_pkt(pkt);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
@@ -925,7 +1085,7 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		 * thread to finish with any state-machine changes before
 		 * sending the packet, or it might lead to state inconsistencies
 		 */
-		k_work_schedule_for_queue(&tcp_work_q,
+		k_work_schedule_for_queue(conn->work_q,
 					  &conn->send_timer, K_NO_WAIT);
 	} else if (tcp_send_process_no_lock(conn)) {
 		tcp_conn_unref(conn);
@@ -971,9 +1131,30 @@ static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 	return net_pkt_copy(to, from, len);
 }
 
+/* Data allowed in flight, the congestion window also applies if enabled */
+static int tcp_send_window(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	return MIN(conn->send_win, conn->cwnd);
+#else
+	return conn->send_win;
+#endif
+}
+
+static k_timeout_t tcp_conn_rto(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	return K_MSEC(conn->rto);
+#else
+	ARG_UNUSED(conn);
+
+	return K_MSEC(tcp_rto);
+#endif
+}
+
 static bool tcp_window_full(struct tcp *conn)
 {
-	bool window_full = !(conn->unacked_len < conn->send_win);
+	bool window_full = !(conn->unacked_len < tcp_send_window(conn));
 
 	NET_DBG("conn: %p window_full=%hu", conn, window_full);
 
@@ -998,37 +1179,333 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
-static int tcp_send_data(struct tcp *conn)
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+#define TCP_RTO_MAX_MS 60000
+
+/* Windows are 16 bits without window scaling */
+#define TCP_CWND_MAX UINT16_MAX
+
+static void tcp_cc_init(struct tcp *conn)
 {
-	int ret = 0;
-	int pos, len;
-	struct net_pkt *pkt;
+	conn->cc->init(conn);
+	conn->dup_acks = 0;
+	conn->in_recovery = false;
+	conn->snd_max = conn->seq;
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->sack_ok = conn->recv_options.sack_perm_found;
+	conn->sacked_cnt = 0;
+#endif
+}
 
-	pos = conn->unacked_len;
-	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
-		   conn_mss(conn));
-	if (len == 0) {
-		NET_DBG("conn: %p no data to send", conn);
-		ret = -ENODATA;
-		goto out;
+/* Time the first segment of new data sent while no measurement is in
+ * progress. Retransmitted data is never timed (Karn's algorithm).
+ */
+static void tcp_rtt_sent(struct tcp *conn, int pos, int len)
+{
+	uint32_t start = conn->seq + pos;
+	bool new_data = net_tcp_seq_cmp(start, conn->snd_max) >= 0;
+
+	if (net_tcp_seq_cmp(start + len, conn->snd_max) > 0) {
+		conn->snd_max = start + len;
 	}
 
+	if (new_data && !conn->rtt_timing) {
+		conn->rtt_timing = true;
+		conn->rtt_seq = start + len;
+		conn->rtt_start = k_uptime_get_32();
+	}
+}
+
+/* RFC 6298 chapter 2, with the RTO clamped to [tcp_rto, 60s] */
+static void tcp_rtt_update(struct tcp *conn, uint32_t ack)
+{
+	uint32_t rtt;
+	int32_t delta;
+
+	if (!conn->rtt_timing || net_tcp_seq_cmp(ack, conn->rtt_seq) < 0) {
+		return;
+	}
+
+	conn->rtt_timing = false;
+	rtt = k_uptime_get_32() - conn->rtt_start;
+
+	if (conn->srtt8 == 0) {
+		conn->srtt8 = rtt << 3;
+		conn->rttvar4 = rtt << 1;
+	} else {
+		delta = (int32_t)rtt - (int32_t)(conn->srtt8 >> 3);
+		conn->srtt8 += delta;
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		delta -= conn->rttvar4 >> 2;
+		conn->rttvar4 += delta;
+	}
+
+	conn->rto = (conn->srtt8 >> 3) + MAX(1, conn->rttvar4);
+	conn->rto = CLAMP(conn->rto, tcp_rto, TCP_RTO_MAX_MS);
+
+	NET_DBG("conn: %p rtt %u srtt %u rttvar %u rto %u", conn, rtt,
+		conn->srtt8 >> 3, conn->rttvar4 >> 2, conn->rto);
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+static void tcp_sack_remove(struct tcp *conn, int i)
+{
+	conn->sacked[i] = conn->sacked[--conn->sacked_cnt];
+}
+
+/* Drop what the cumulative ACK covers from the scoreboard and merge the
+ * blocks of the last segment into it.
+ */
+static void tcp_sack_update(struct tcp *conn)
+{
+	uint32_t snd_end = conn->seq + conn->unacked_len;
+
+	for (int i = 0; i < conn->sacked_cnt; ) {
+		struct tcp_sack_block *b = &conn->sacked[i];
+
+		if (net_tcp_seq_cmp(b->end, conn->seq) <= 0) {
+			tcp_sack_remove(conn, i);
+			continue;
+		}
+
+		if (net_tcp_seq_cmp(b->start, conn->seq) < 0) {
+			b->start = conn->seq;
+		}
+
+		i++;
+	}
+
+	for (int j = 0; j < conn->recv_options.sack_cnt; j++) {
+		struct tcp_sack_block blk = conn->recv_options.sack[j];
+
+		if (net_tcp_seq_cmp(blk.start, conn->seq) < 0 ||
+		    net_tcp_seq_cmp(blk.end, snd_end) > 0 ||
+		    net_tcp_seq_cmp(blk.start, blk.end) >= 0) {
+			continue;
+		}
+
+		for (int i = 0; i < conn->sacked_cnt; ) {
+			struct tcp_sack_block *b = &conn->sacked[i];
+
+			if (net_tcp_seq_cmp(blk.end, b->start) < 0 ||
+			    net_tcp_seq_cmp(b->end, blk.start) < 0) {
+				i++;
+				continue;
+			}
+
+			/* Overlapping or adjacent, take the union */
+			if (net_tcp_seq_cmp(b->start, blk.start) < 0) {
+				blk.start = b->start;
+			}
+
+			if (net_tcp_seq_cmp(b->end, blk.end) > 0) {
+				blk.end = b->end;
+			}
+
+			tcp_sack_remove(conn, i);
+		}
+
+		if (conn->sacked_cnt < TCP_SACK_BLOCKS) {
+			conn->sacked[conn->sacked_cnt++] = blk;
+		}
+	}
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
+static int tcp_send_segment(struct tcp *conn, int pos, int len);
+
+/* Retransmit the next segment that was not (selectively) acknowledged,
+ * from conn->rexmit_next on. Without SACK information only the segment
+ * at the start of the window is retransmitted, once per (partial) ACK.
+ */
+static void tcp_retransmit(struct tcp *conn)
+{
+	uint32_t start = conn->rexmit_next;
+	uint32_t end = conn->seq + conn->unacked_len;
+	bool hole = false;
+	int len;
+
+	if (net_tcp_seq_cmp(start, conn->seq) < 0) {
+		start = conn->seq;
+	}
+
+#if defined(CONFIG_NET_TCP_SACK)
+	for (int i = 0; i < conn->sacked_cnt; i++) {
+		struct tcp_sack_block *b = &conn->sacked[i];
+
+		if (net_tcp_seq_cmp(start, b->start) >= 0 &&
+		    net_tcp_seq_cmp(start, b->end) < 0) {
+			/* Skip data the peer has, and look again */
+			start = b->end;
+			i = -1;
+		}
+	}
+
+	/* Data below the highest SACKed sequence number is lost, the end
+	 * of the hole is the start of the next block.
+	 */
+	for (int i = 0; i < conn->sacked_cnt; i++) {
+		struct tcp_sack_block *b = &conn->sacked[i];
+
+		if (net_tcp_seq_cmp(b->start, start) > 0) {
+			if (!hole || net_tcp_seq_cmp(b->start, end) < 0) {
+				end = b->start;
+			}
+
+			hole = true;
+		}
+	}
+#endif
+
+	if ((!hole && start != conn->seq) ||
+	    net_tcp_seq_cmp(end, start) <= 0) {
+		return;
+	}
+
+	len = MIN(end - start, conn_mss(conn));
+
+	if (tcp_send_segment(conn, start - conn->seq, len) == 0) {
+		conn->rexmit_next = start + len;
+		conn->rtt_timing = false;
+
+		net_stats_update_tcp_resent(conn->iface, len);
+		net_stats_update_tcp_seg_rexmit(conn->iface);
+	}
+}
+
+/* Duplicate ACK: start fast recovery on the third one (RFC 5681 chapter
+ * 3.2), later ones inflate the window and retransmit the next hole.
+ */
+static void tcp_cc_dup_ack(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+#if defined(CONFIG_NET_TCP_SACK)
+	tcp_sack_update(conn);
+#endif
+
+	if (conn->in_recovery) {
+		conn->cwnd = MIN(conn->cwnd + mss, TCP_CWND_MAX);
+		tcp_retransmit(conn);
+		return;
+	}
+
+	if (++conn->dup_acks < 3) {
+		return;
+	}
+
+	NET_DBG("conn: %p fast retransmit seq %u", conn, conn->seq);
+
+	conn->in_recovery = true;
+	conn->recover = conn->seq + conn->unacked_len;
+	conn->rexmit_next = conn->seq;
+	conn->cc->loss(conn, false);
+	conn->cwnd = MIN(conn->ssthresh + 3 * mss, TCP_CWND_MAX);
+
+	tcp_retransmit(conn);
+}
+
+/* New data acknowledged, conn->seq has already been advanced */
+static void tcp_cc_new_ack(struct tcp *conn, uint32_t len_acked)
+{
+	uint32_t mss = conn_mss(conn);
+
+	tcp_rtt_update(conn, conn->seq);
+#if defined(CONFIG_NET_TCP_SACK)
+	tcp_sack_update(conn);
+#endif
+	conn->dup_acks = 0;
+
+	if (conn->in_recovery) {
+		if (net_tcp_seq_cmp(conn->seq, conn->recover) >= 0) {
+			/* Full ACK, RFC 6582 chapter 3.2 step 3 */
+			conn->in_recovery = false;
+			conn->cwnd = conn->ssthresh;
+		} else {
+			/* Partial ACK, retransmit the next segment and
+			 * deflate the window by the amount acked.
+			 */
+			conn->cwnd -= MIN(conn->cwnd, len_acked);
+			conn->cwnd = MIN(conn->cwnd + mss, TCP_CWND_MAX);
+			conn->rexmit_next = conn->seq;
+			tcp_retransmit(conn);
+		}
+
+		return;
+	}
+
+	conn->cc->acked(conn, len_acked);
+	conn->cwnd = MIN(conn->cwnd, TCP_CWND_MAX);
+}
+
+/* Retransmission timeout, RFC 5681 chapter 3.1 and RFC 6298 chapter 5 */
+static void tcp_cc_timeout(struct tcp *conn)
+{
+	if (conn->send_data_retries == 0) {
+		conn->cc->loss(conn, true);
+	}
+
+	conn->cwnd = conn_mss(conn);
+	conn->in_recovery = false;
+	conn->dup_acks = 0;
+	conn->rtt_timing = false;
+	conn->rto = MIN(conn->rto * 2, TCP_RTO_MAX_MS);
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->sacked_cnt = 0;
+#endif
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
+/* Send len bytes from offset pos of the send_data, i.e. starting at
+ * sequence number conn->seq + pos.
+ */
+static int tcp_send_segment(struct tcp *conn, int pos, int len)
+{
+	struct net_pkt *pkt;
+	int ret;
+
 	pkt = tcp_pkt_alloc(conn, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
-		ret = -ENOBUFS;
-		goto out;
+		return -ENOBUFS;
 	}
 
 	ret = tcp_pkt_peek(pkt, conn->send_data, pos, len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
-		ret = -ENOBUFS;
+		return -ENOBUFS;
+	}
+
+	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + pos);
+
+	/* The data we want to send, has been moved to the send queue so we
+	 * can unref the head net_pkt. If there was an error, we need to remove
+	 * the packet anyway.
+	 */
+	tcp_pkt_unref(pkt);
+
+	return ret;
+}
+
+static int tcp_send_data(struct tcp *conn)
+{
+	int ret = 0;
+	int pos, len;
+
+	pos = conn->unacked_len;
+	len = MIN3(conn->send_data_total - conn->unacked_len,
+		   tcp_send_window(conn) - conn->unacked_len,
+		   conn_mss(conn));
+	if (len <= 0) {
+		NET_DBG("conn: %p no data to send", conn);
+		ret = -ENODATA;
 		goto out;
 	}
 
-	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
+	ret = tcp_send_segment(conn, pos, len);
 	if (ret == 0) {
 		conn->unacked_len += len;
 
@@ -1039,13 +1516,11 @@ static int tcp_send_data(struct tcp *conn)
 			net_stats_update_tcp_sent(conn->iface, len);
 			net_stats_update_tcp_seg_sent(conn->iface);
 		}
-	}
 
-	/* The data we want to send, has been moved to the send queue so we
-	 * can unref the head net_pkt. If there was an error, we need to remove
-	 * the packet anyway.
-	 */
-	tcp_pkt_unref(pkt);
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		tcp_rtt_sent(conn, pos, len);
+#endif
+	}
 
 	conn_send_data_dump(conn);
 
@@ -1094,8 +1569,8 @@ static int tcp_send_queued_data(struct tcp *conn)
 
 	if (subscribe) {
 		conn->send_data_retries = 0;
-		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
-					    K_MSEC(tcp_rto));
+		k_work_reschedule_for_queue(conn->work_q, &conn->send_data_timer,
+					    tcp_conn_rto(conn));
 	}
  out:
 	return ret;
@@ -1135,6 +1610,10 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	tcp_cc_timeout(conn);
+#endif
+
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
@@ -1145,7 +1624,7 @@ static void tcp_resend_data(struct k_work *work)
 			NET_DBG("TCP connection in active close, "
 				"not disposing yet (waiting %dms)",
 				FIN_TIMEOUT_MS);
-			k_work_reschedule_for_queue(&tcp_work_q,
+			k_work_reschedule_for_queue(conn->work_q,
 						    &conn->fin_timer,
 						    FIN_TIMEOUT);
 
@@ -1164,8 +1643,8 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
-	k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
-				    K_MSEC(tcp_rto));
+	k_work_reschedule_for_queue(conn->work_q, &conn->send_data_timer,
+				    tcp_conn_rto(conn));
 
  out:
 	k_mutex_unlock(&conn->lock);
@@ -1271,6 +1750,15 @@ static struct tcp *tcp_conn_alloc(struct net_context *context)
 
 	sys_slist_init(&conn->send_queue);
 
+	conn->work_q = &tcp_work_q[(uint32_t)atomic_inc(&tcp_work_q_next) %
+				   CONFIG_NET_TCP_WORKQ_COUNT];
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	conn->cc = tcp_cc_default;
+	conn->rto = tcp_rto;
+	tcp_cc_init(conn);
+#endif
+
 	k_work_init_delayable(&conn->send_timer, tcp_send_process);
 	k_work_init_delayable(&conn->timewait_timer, tcp_timewait_timeout);
 	k_work_init_delayable(&conn->fin_timer, tcp_fin_timeout);
@@ -1317,38 +1805,36 @@ out:
 	return ret;
 }
 
-static bool tcp_endpoint_cmp(union tcp_endpoint *ep, struct net_pkt *pkt,
-			     enum pkt_addr which)
+static struct tcp *tcp_conn_search(struct net_pkt *pkt)
 {
-	union tcp_endpoint ep_tmp;
+	union tcp_endpoint src, dst;
+	struct tcp_bucket *bucket;
+	struct tcp *found = NULL;
+	struct tcp *conn;
+	k_spinlock_key_t key;
+	size_t len;
 
-	if (tcp_endpoint_set(&ep_tmp, pkt, which) < 0) {
-		return false;
+	if (tcp_endpoint_set(&src, pkt, TCP_EP_DST) < 0 ||
+	    tcp_endpoint_set(&dst, pkt, TCP_EP_SRC) < 0) {
+		return NULL;
 	}
 
-	return !memcmp(ep, &ep_tmp, tcp_endpoint_len(ep->sa.sa_family));
-}
+	len = tcp_endpoint_len(src.sa.sa_family);
+	bucket = tcp_bucket_get(&src, &dst);
 
-static bool tcp_conn_cmp(struct tcp *conn, struct net_pkt *pkt)
-{
-	return tcp_endpoint_cmp(&conn->src, pkt, TCP_EP_DST) &&
-		tcp_endpoint_cmp(&conn->dst, pkt, TCP_EP_SRC);
-}
-
-static struct tcp *tcp_conn_search(struct net_pkt *pkt)
-{
-	bool found = false;
-	struct tcp *conn;
-	struct tcp *tmp;
+	key = k_spin_lock(&bucket->lock);
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
-		found = tcp_conn_cmp(conn, pkt);
-		if (found) {
+	SYS_SLIST_FOR_EACH_CONTAINER(&bucket->conns, conn, hash_next) {
+		if (!memcmp(&conn->src, &src, len) &&
+		    !memcmp(&conn->dst, &dst, len)) {
+			found = conn;
 			break;
 		}
 	}
 
-	return found ? conn : NULL;
+	k_spin_unlock(&bucket->lock, key);
+
+	return found;
 }
 
 static struct tcp *tcp_conn_new(struct net_pkt *pkt);
@@ -1525,6 +2011,8 @@ static struct tcp *tcp_conn_new(struct net_pkt *pkt)
 		goto err;
 	}
 
+	tcp_conn_hash(conn);
+
 	NET_DBG("conn: src: %s, dst: %s",
 		log_strdup(net_sprint_addr(conn->src.sa.sa_family,
 				(const void *)&conn->src.sin.sin_addr)),
@@ -1684,7 +2172,7 @@ static void tcp_queue_recv_data(struct tcp *conn, struct net_pkt *pkt,
 
 		if (!k_work_delayable_is_pending(&conn->recv_queue_timer)) {
 			k_work_reschedule_for_queue(
-				&tcp_work_q, &conn->recv_queue_timer,
+				conn->work_q, &conn->recv_queue_timer,
 				K_MSEC(CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT));
 		}
 	}
@@ -1743,6 +2231,9 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	struct k_fifo *recv_data_fifo;
 	size_t len;
 	int ret;
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	bool same_win = false;
+#endif
 
 	if (th) {
 		/* Currently we ignore ECN and CWR flags */
@@ -1772,6 +2263,10 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->recv_options.sack_cnt = 0;
+#endif
+
 	if (tcp_options_len && !tcp_options_check(&conn->recv_options, pkt,
 						  tcp_options_len)) {
 		NET_DBG("DROP: Invalid TCP option list");
@@ -1788,6 +2283,11 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 
 		conn->send_win = ntohs(th_win(th));
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		same_win = (conn->send_win == conn->last_win);
+		conn->last_win = conn->send_win;
+#endif
+
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
 		if (CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE) {
 			max_win = CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE;
@@ -1837,7 +2337,7 @@ next_state:
 
 			/* Close the connection if we do not receive ACK on time.
 			 */
-			k_work_reschedule_for_queue(&tcp_work_q,
+			k_work_reschedule_for_queue(conn->work_q,
 						    &conn->establish_timer,
 						    ACK_TIMEOUT);
 		} else {
@@ -1854,6 +2354,9 @@ next_state:
 			k_work_cancel_delayable(&conn->establish_timer);
 			tcp_send_timer_cancel(conn);
 			next = TCP_ESTABLISHED;
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+			tcp_cc_init(conn);
+#endif
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
 
@@ -1898,6 +2401,9 @@ next_state:
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+			tcp_cc_init(conn);
+#endif
 			tcp_out(conn, ACK);
 
 			/* The connection semaphore is released *after*
@@ -1941,6 +2447,19 @@ next_state:
 			break;
 		}
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		/* Duplicate ACK as defined in RFC 5681 chapter 2, window
+		 * updates don't count.
+		 */
+		if (th && th_ack(th) == conn->seq && len == 0 &&
+		    (th_flags(th) & (ACK | SYN | FIN)) == ACK && same_win &&
+		    conn->unacked_len > 0 &&
+		    conn->data_mode == TCP_DATA_MODE_SEND) {
+			tcp_cc_dup_ack(conn);
+			(void)tcp_send_queued_data(conn);
+		}
+#endif
+
 		if (th && net_tcp_seq_cmp(th_ack(th), conn->seq) > 0) {
 			uint32_t len_acked = th_ack(th) - conn->seq;
 
@@ -1969,6 +2488,10 @@ next_state:
 
 			conn_send_data_dump(conn);
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+			tcp_cc_new_ack(conn, len_acked);
+#endif
+
 			if (!k_work_delayable_remaining_get(
 				    &conn->send_data_timer)) {
 				NET_DBG("conn: %p, Missing a subscription "
@@ -2012,6 +2535,14 @@ next_state:
 			} else if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
 				tcp_out_of_order_data(conn, pkt, len,
 						      th_seq(th));
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+				/* Immediate duplicate ACK for the sender's
+				 * fast retransmit, RFC 5681 chapter 4.2
+				 */
+				if (len) {
+					tcp_out(conn, ACK);
+				}
+#endif
 			}
 		}
 		break;
@@ -2068,7 +2599,7 @@ next_state:
 		break;
 	case TCP_TIME_WAIT:
 		k_work_reschedule_for_queue(
-			&tcp_work_q, &conn->timewait_timer,
+			conn->work_q, &conn->timewait_timer,
 			K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
 		break;
 	default:
@@ -2150,15 +2681,15 @@ int net_tcp_put(struct net_context *context)
 
 			/* How long to wait until all the data has been sent?
 			 */
-			k_work_reschedule_for_queue(&tcp_work_q,
+			k_work_reschedule_for_queue(conn->work_q,
 						    &conn->send_data_timer,
-						    K_MSEC(tcp_rto));
+						    tcp_conn_rto(conn));
 		} else {
 			int ret;
 
 			NET_DBG("TCP connection in active close, not "
 				"disposing yet (waiting %dms)", FIN_TIMEOUT_MS);
-			k_work_reschedule_for_queue(&tcp_work_q,
+			k_work_reschedule_for_queue(conn->work_q,
 						    &conn->fin_timer,
 						    FIN_TIMEOUT);
 
@@ -2253,7 +2784,7 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 		 * conn is embedded, and calling that function directly here
 		 * and in the work handler.
 		 */
-		(void)k_work_schedule_for_queue(&tcp_work_q,
+		(void)k_work_schedule_for_queue(conn->work_q,
 						&conn->send_data_timer,
 						K_NO_WAIT);
 		ret = -EAGAIN;
@@ -2402,6 +2933,8 @@ int net_tcp_connect(struct net_context *context,
 		ret = -EPROTONOSUPPORT;
 	}
 
+	tcp_conn_hash(conn);
+
 	if (!(IS_ENABLED(CONFIG_NET_TEST_PROTOCOL) ||
 	      IS_ENABLED(CONFIG_NET_TEST))) {
 		conn->seq = tcp_init_isn(&conn->src.sa, &conn->dst.sa);
@@ -2607,6 +3140,7 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			conn = context->tcp;
 			tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 			tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+			tcp_conn_hash(conn);
 			/* Make an extra reference, the sanity check suite
 			 * will delete the connection explicitly
 			 */
@@ -2920,12 +3454,24 @@ void net_tcp_init(void)
 #define THREAD_PRIORITY K_PRIO_PREEMPT(0)
 #endif
 
-	/* Use private workqueue in order not to block the system work queue.
+	for (int i = 0; i < ARRAY_SIZE(tcp_buckets); i++) {
+		sys_slist_init(&tcp_buckets[i].conns);
+	}
+
+	/* Use private workqueues in order not to block the system work
+	 * queue.
 	 */
-	k_work_queue_start(&tcp_work_q, work_q_stack,
-			   K_KERNEL_STACK_SIZEOF(work_q_stack), THREAD_PRIORITY,
-			   NULL);
+	for (int i = 0; i < ARRAY_SIZE(tcp_work_q); i++) {
+		char name[sizeof("tcp_workNN")];
+
+		k_work_queue_start(&tcp_work_q[i], work_q_stack[i],
+				   K_KERNEL_STACK_SIZEOF(work_q_stack[i]),
+				   THREAD_PRIORITY, NULL);
 
-	k_thread_name_set(&tcp_work_q.thread, "tcp_work");
-	NET_DBG("Workq started. Thread ID: %p", &tcp_work_q.thread);
+		snprintk(name, sizeof(name), "tcp_work%d", i);
+		k_thread_name_set(&tcp_work_q[i].thread,
+				  ARRAY_SIZE(tcp_work_q) > 1 ? name : "tcp_work");
+
+		NET_DBG("Workq started. Thread ID: %p", &tcp_work_q[i].thread);
+	}
 }
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* TCP congestion control algorithms. The connection core in tcp.c
+ * detects the losses, runs fast recovery and sets cwnd to ssthresh when
+ * it ends, the algorithms below decide how the window grows on new
+ * ACKs and how far it is reduced on loss.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <kernel.h>
+#include "tcp_internal.h"
+
+/* Initial window, RFC 5681 chapter 3.1 */
+static uint32_t tcp_cc_initial_window(uint32_t mss)
+{
+	if (mss > 2190) {
+		return 2 * mss;
+	}
+
+	if (mss > 1095) {
+		return 3 * mss;
+	}
+
+	return 4 * mss;
+}
+
+static void tcp_cc_slow_start(struct tcp *conn, uint32_t len)
+{
+	conn->cwnd += MIN(len, conn_mss(conn));
+}
+
+static void newreno_init(struct tcp *conn)
+{
+	conn->cwnd = tcp_cc_initial_window(conn_mss(conn));
+	conn->ssthresh = UINT32_MAX;
+}
+
+static void newreno_acked(struct tcp *conn, uint32_t len)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (conn->cwnd < conn->ssthresh) {
+		tcp_cc_slow_start(conn, len);
+		return;
+	}
+
+	/* Congestion avoidance, about one segment per round trip */
+	conn->cwnd += MAX(1, mss * mss / conn->cwnd);
+}
+
+static void newreno_loss(struct tcp *conn, bool timeout)
+{
+	uint32_t mss = conn_mss(conn);
+
+	conn->ssthresh = MAX((uint32_t)conn->unacked_len / 2, 2 * mss);
+	conn->cwnd = timeout ? mss : conn->ssthresh;
+}
+
+const struct tcp_cc_ops tcp_cc_newreno = {
+	.name = "newreno",
+	.init = newreno_init,
+	.acked = newreno_acked,
+	.loss = newreno_loss,
+};
+
+/* CUBIC, RFC 9438, in integer arithmetic with times in ms and windows
+ * in bytes. C is 0.4 segments/s^3 and beta 0.7.
+ */
+#define CUBIC_BETA_NUM 7
+#define CUBIC_BETA_DEN 10
+/* Window growth of the Reno-friendly estimate, 3 * (1 - beta) / (1 + beta) */
+#define CUBIC_ALPHA_PERMILLE 529
+/* Cap on |t - K| so that the cube fits in 64 bits */
+#define CUBIC_MAX_DELTA_MS 100000
+
+static uint32_t icbrt64(uint64_t x)
+{
+	uint64_t y = 0;
+
+	for (int s = 63; s >= 0; s -= 3) {
+		uint64_t b;
+
+		y *= 2;
+		b = 3 * y * (y + 1) + 1;
+		if ((x >> s) >= b) {
+			x -= b << s;
+			y++;
+		}
+	}
+
+	return (uint32_t)y;
+}
+
+static uint32_t cubic_window(struct tcp *conn, uint32_t t)
+{
+	struct tcp_cubic *cubic = &conn->cc_data.cubic;
+	int64_t d = (int64_t)t - cubic->k;
+	int64_t w;
+
+	d = CLAMP(d, -CUBIC_MAX_DELTA_MS, CUBIC_MAX_DELTA_MS);
+
+	/* W(t) = C * (t - K)^3 + W_max, C * mss / 1000^3 per ms^3 */
+	w = (d * d * d / 1000) * 4 * conn_mss(conn) / 10000000 +
+	    cubic->w_max;
+
+	return (uint32_t)CLAMP(w, 0, (int64_t)UINT32_MAX);
+}
+
+static void cubic_init(struct tcp *conn)
+{
+	newreno_init(conn);
+	memset(&conn->cc_data.cubic, 0, sizeof(conn->cc_data.cubic));
+}
+
+static void cubic_acked(struct tcp *conn, uint32_t len)
+{
+	struct tcp_cubic *cubic = &conn->cc_data.cubic;
+	uint32_t mss = conn_mss(conn);
+	uint32_t now = k_uptime_get_32();
+	uint32_t target;
+
+	if (conn->cwnd < conn->ssthresh) {
+		tcp_cc_slow_start(conn, len);
+		return;
+	}
+
+	if (cubic->epoch_start == 0) {
+		cubic->epoch_start = now ? now : 1;
+		cubic->w_est = conn->cwnd;
+
+		if (conn->cwnd < cubic->w_max) {
+			uint64_t w = cubic->w_max - conn->cwnd;
+
+			/* K = cbrt((W_max - cwnd) / C), in ms */
+			cubic->k = icbrt64(w * 2500000000ULL / mss);
+		} else {
+			cubic->k = 0;
+			cubic->w_max = conn->cwnd;
+		}
+	}
+
+	/* Aim at the window one round trip from now */
+	target = cubic_window(conn, now - cubic->epoch_start +
+				    (conn->srtt8 >> 3));
+	target = CLAMP(target, conn->cwnd, conn->cwnd + conn->cwnd / 2);
+
+	cubic->w_est += (uint32_t)((uint64_t)CUBIC_ALPHA_PERMILLE * mss * len /
+				   (1000ULL * conn->cwnd));
+
+	if (cubic->w_est > target) {
+		conn->cwnd = cubic->w_est;
+	} else {
+		conn->cwnd += (uint32_t)((uint64_t)(target - conn->cwnd) * len /
+					 conn->cwnd);
+	}
+}
+
+static void cubic_loss(struct tcp *conn, bool timeout)
+{
+	struct tcp_cubic *cubic = &conn->cc_data.cubic;
+	uint32_t mss = conn_mss(conn);
+
+	cubic->epoch_start = 0;
+
+	/* Fast convergence, release bandwidth to newer flows */
+	if (conn->cwnd < cubic->w_max) {
+		cubic->w_max = conn->cwnd * (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+			       (2 * CUBIC_BETA_DEN);
+	} else {
+		cubic->w_max = conn->cwnd;
+	}
+
+	conn->ssthresh = MAX(conn->cwnd * CUBIC_BETA_NUM / CUBIC_BETA_DEN,
+			     2 * mss);
+	conn->cwnd = timeout ? mss : conn->ssthresh;
+}
+
+const struct tcp_cc_ops tcp_cc_cubic = {
+	.name = "cubic",
+	.init = cubic_init,
+	.acked = cubic_acked,
+	.loss = cubic_loss,
+};
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+const struct tcp_cc_ops *const tcp_cc_default = &tcp_cc_cubic;
+#else
+const struct tcp_cc_ops *const tcp_cc_default = &tcp_cc_newreno;
+#endif
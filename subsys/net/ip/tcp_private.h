@@ -206,22 +206,66 @@ union tcp_endpoint {
 #define NET_TCP_NOP_OPT          1
 #define NET_TCP_MSS_OPT          2
 #define NET_TCP_WINDOW_SCALE_OPT 3
+#define NET_TCP_SACK_PERM_OPT    4
+#define NET_TCP_SACK_OPT         5
 
 /* TCP Option sizes */
 #define NET_TCP_END_SIZE          1
 #define NET_TCP_NOP_SIZE          1
 #define NET_TCP_MSS_SIZE          4
 #define NET_TCP_WINDOW_SCALE_SIZE 3
+#define NET_TCP_SACK_PERM_SIZE    2
+#define NET_TCP_SACK_BLOCK_SIZE   8
+
+/* Selective acknowledgment blocks kept, both received from the peer and
+ * in the sender's scoreboard.
+ */
+#define TCP_SACK_BLOCKS 4
+
+struct tcp_sack_block {
+	uint32_t start;
+	uint32_t end;
+};
 
 struct tcp_options {
 	uint16_t mss;
 	uint16_t window;
 	bool mss_found : 1;
 	bool wnd_found : 1;
+#if defined(CONFIG_NET_TCP_SACK)
+	bool sack_perm_found : 1;
+	uint8_t sack_cnt; /* blocks of the last segment */
+	struct tcp_sack_block sack[TCP_SACK_BLOCKS];
+#endif
+};
+
+struct tcp;
+
+/* Congestion control algorithm, see tcp_cc.c. The callbacks are called
+ * with the connection locked and adjust conn->cwnd and conn->ssthresh.
+ */
+struct tcp_cc_ops {
+	const char *name;
+	/* Start of the connection */
+	void (*init)(struct tcp *conn);
+	/* New data acknowledged, outside of fast recovery */
+	void (*acked)(struct tcp *conn, uint32_t len);
+	/* Loss detected by duplicate ACKs, or by a timeout */
+	void (*loss)(struct tcp *conn, bool timeout);
+};
+
+struct tcp_cubic {
+	uint32_t w_max;       /* window before the last reduction */
+	uint32_t k;           /* ms from epoch start to reach w_max again */
+	uint32_t epoch_start; /* uptime in ms, 0 when no epoch */
+	uint32_t w_est;       /* Reno-friendly window estimate */
 };
 
 struct tcp { /* TCP connection */
 	sys_snode_t next;
+	sys_snode_t hash_next;
+	struct tcp_bucket *bucket; /* hash bucket, once end points are set */
+	struct k_work_q *work_q;
 	struct net_context *context;
 	struct net_pkt *send_data;
 	struct net_pkt *queue_recv_data;
@@ -265,8 +309,39 @@ struct tcp { /* TCP connection */
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	const struct tcp_cc_ops *cc;
+	union {
+		struct tcp_cubic cubic;
+	} cc_data;
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint32_t snd_max;    /* highest sequence number sent */
+	uint32_t recover;    /* snd_max when fast recovery started */
+	uint32_t rexmit_next; /* next sequence number to retransmit */
+	uint32_t rtt_seq;    /* ACK ending the timed segment */
+	uint32_t rtt_start;
+	uint32_t srtt8;      /* smoothed RTT, ms << 3 */
+	uint32_t rttvar4;    /* RTT variation, ms << 2 */
+	uint32_t rto;        /* current retransmission timeout, ms */
+	uint16_t last_win;   /* window advertised by the last segment */
+	uint8_t dup_acks;
+	bool in_recovery : 1;
+	bool rtt_timing : 1;
+#if defined(CONFIG_NET_TCP_SACK)
+	bool sack_ok : 1;
+	uint8_t sacked_cnt;
+	struct tcp_sack_block sacked[TCP_SACK_BLOCKS];
+#endif
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
 };
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+extern const struct tcp_cc_ops tcp_cc_newreno;
+extern const struct tcp_cc_ops tcp_cc_cubic;
+extern const struct tcp_cc_ops *const tcp_cc_default;
+#endif
+
 #define _flags(_fl, _op, _mask, _cond)					\
 ({									\
 	bool result = false;						\
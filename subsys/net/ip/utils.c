@@ -487,92 +487,162 @@ int z_vrfy_net_addr_pton(sa_family_t family, const char *src,
 #include <syscalls/net_addr_pton_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
-static uint16_t calc_chksum(uint16_t sum, const uint8_t *data, size_t len)
+/* One's complement sum of the data, read one 32-bit word at a time in
+ * the CPU byte order into a 64-bit accumulator, so that the carries only
+ * need to be folded back once at the end. The result is the sum of the
+ * 16-bit words as they are in memory, see RFC 1071 chapter 2 (B).
+ */
+static uint16_t chksum_partial(const uint8_t *data, size_t len)
 {
-	const uint8_t *end;
-	uint16_t tmp;
+	uint64_t acc = 0U;
 
-	end = data + len - 1;
+	while (len >= 16) {
+		acc += UNALIGNED_GET((const uint32_t *)data);
+		acc += UNALIGNED_GET((const uint32_t *)(data + 4));
+		acc += UNALIGNED_GET((const uint32_t *)(data + 8));
+		acc += UNALIGNED_GET((const uint32_t *)(data + 12));
+		data += 16;
+		len -= 16;
+	}
 
-	while (data < end) {
-		tmp = (data[0] << 8) + data[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	while (len >= 4) {
+		acc += UNALIGNED_GET((const uint32_t *)data);
+		data += 4;
+		len -= 4;
+	}
 
+	if (len >= 2) {
+		acc += UNALIGNED_GET((const uint16_t *)data);
 		data += 2;
+		len -= 2;
 	}
 
-	if (data == end) {
-		tmp = data[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	if (len) {
+		/* Odd byte, padded with zero at the end */
+		acc += sys_be16_to_cpu((uint16_t)data[0] << 8);
+	}
+
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffff) + (acc >> 16);
+	acc = (acc & 0xffff) + (acc >> 16);
+
+	return (uint16_t)acc;
+}
+
+static inline uint16_t chksum_add16(uint16_t sum, uint16_t val)
+{
+	sum += val;
+	if (sum < val) {
+		sum++;
 	}
 
 	return sum;
 }
 
-static inline uint16_t pkt_calc_chksum(struct net_pkt *pkt, uint16_t sum)
+static uint16_t calc_chksum(uint16_t sum, const uint8_t *data, size_t len)
+{
+	return chksum_add16(sum, sys_be16_to_cpu(chksum_partial(data, len)));
+}
+
+/* Sum the len bytes following the cursor, or all of them if len is
+ * SIZE_MAX. A fragment starting at an odd offset has its bytes paired
+ * the other way around, so its sum is swapped before it is added.
+ */
+static inline uint16_t pkt_calc_chksum(struct net_pkt *pkt, uint16_t sum,
+				       size_t len)
 {
 	struct net_pkt_cursor *cur = &pkt->cursor;
-	size_t len;
+	bool odd = false;
 
 	if (!cur->buf || !cur->pos) {
 		return sum;
 	}
 
-	len = cur->buf->len - (cur->pos - cur->buf->data);
+	while (cur->buf && len) {
+		size_t frag_len = MIN(len, cur->buf->len -
+					   (cur->pos - cur->buf->data));
+		uint16_t part = calc_chksum(0U, cur->pos, frag_len);
 
-	while (cur->buf) {
-		sum = calc_chksum(sum, cur->pos, len);
+		sum = chksum_add16(sum, odd ? __bswap_16(part) : part);
+		odd ^= frag_len & 1;
+		len -= frag_len;
 
 		cur->buf = cur->buf->frags;
-		if (!cur->buf || !cur->buf->len) {
-			break;
+		if (cur->buf) {
+			cur->pos = cur->buf->data;
 		}
+	}
 
-		cur->pos = cur->buf->data;
+	return sum;
+}
 
-		if (len % 2) {
-			sum += *cur->pos;
-			if (sum < *cur->pos) {
-				sum++;
-			}
+#if defined(CONFIG_NET_PKT_CHKSUM_COPY)
+void net_pkt_chksum_add(struct net_pkt *pkt, const uint8_t *data, size_t len)
+{
+	uint16_t part;
 
-			cur->pos++;
-			len = cur->buf->len - 1;
-		} else {
-			len = cur->buf->len;
-		}
+	if (len > UINT16_MAX - pkt->chksum_len) {
+		net_pkt_chksum_copy_end(pkt);
+		pkt->chksum_len = 0U;
+		return;
 	}
 
-	return sum;
+	part = calc_chksum(0U, data, len);
+
+	pkt->chksum = chksum_add16(pkt->chksum, (pkt->chksum_len & 1) ?
+				   __bswap_16(part) : part);
+	pkt->chksum_len += len;
 }
 
+/* Sum the data after the cursor, using the sum folded while its end was
+ * written or copied into the packet.
+ */
+static uint16_t pkt_calc_chksum_copied(struct net_pkt *pkt, uint16_t sum,
+				       size_t len)
+{
+	size_t head;
+
+	if (!pkt->chksum_len || pkt->chksum_len > len) {
+		return pkt_calc_chksum(pkt, sum, SIZE_MAX);
+	}
+
+	head = len - pkt->chksum_len;
+	sum = pkt_calc_chksum(pkt, sum, head);
+
+	return chksum_add16(sum, (head & 1) ? __bswap_16(pkt->chksum) :
+				 pkt->chksum);
+}
+#else
+#define pkt_calc_chksum_copied(pkt, sum, len) \
+	pkt_calc_chksum(pkt, sum, SIZE_MAX)
+#endif /* CONFIG_NET_PKT_CHKSUM_COPY */
+
 uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto)
 {
 	size_t len = 0U;
+	size_t data_len;
 	uint16_t sum = 0U;
 	struct net_pkt_cursor backup;
 	bool ow;
 
 	if (IS_ENABLED(CONFIG_NET_IPV4) &&
 	    net_pkt_family(pkt) == AF_INET) {
+		data_len = net_pkt_get_len(pkt) -
+			net_pkt_ip_hdr_len(pkt) -
+			net_pkt_ipv4_opts_len(pkt);
+
 		if (proto != IPPROTO_ICMP) {
 			len = 2 * sizeof(struct in_addr);
-			sum = net_pkt_get_len(pkt) -
-				net_pkt_ip_hdr_len(pkt) -
-				net_pkt_ipv4_opts_len(pkt) + proto;
+			sum = data_len + proto;
 		}
 	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
 		   net_pkt_family(pkt) == AF_INET6) {
 		len = 2 * sizeof(struct in6_addr);
-		sum =  net_pkt_get_len(pkt) -
+		data_len = net_pkt_get_len(pkt) -
 			net_pkt_ip_hdr_len(pkt) -
-			net_pkt_ipv6_ext_len(pkt) + proto;
+			net_pkt_ipv6_ext_len(pkt);
+		sum = data_len + proto;
 	} else {
 		NET_DBG("Unknown protocol family %d", net_pkt_family(pkt));
 		return 0;
@@ -589,7 +659,7 @@ uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto)
 	sum = calc_chksum(sum, pkt->cursor.pos, len);
 	net_pkt_skip(pkt, len + net_pkt_ip_opts_len(pkt));
 
-	sum = pkt_calc_chksum(pkt, sum);
+	sum = pkt_calc_chksum_copied(pkt, sum, data_len);
 
 	sum = (sum == 0U) ? 0xffff : htons(sum);
 
@@ -600,6 +670,17 @@ uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto)
 	return ~sum;
 }
 
+uint16_t net_chksum_update(uint16_t chksum, const void *old_data,
+			   const void *new_data, size_t len)
+{
+	uint16_t sum = ~ntohs(chksum);
+
+	sum = calc_chksum(sum, new_data, len);
+	sum = chksum_add16(sum, (uint16_t)~calc_chksum(0U, old_data, len));
+
+	return htons(~sum);
+}
+
 #if defined(CONFIG_NET_IPV4)
 uint16_t net_calc_chksum_ipv4(struct net_pkt *pkt)
 {
@@ -218,6 +218,75 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_SCHED_STATS)
+static void shell_hist_dump(const struct shell *shell, const char *name,
+			    const struct k_sched_hist *hist)
+{
+	shell_print(shell, "\t%s:", name);
+
+	for (int i = 0; i < CONFIG_SCHED_STATS_BUCKETS; i++) {
+		if (hist->bucket[i] == 0U) {
+			continue;
+		}
+
+		shell_print(shell, "\t  %s%10u: %u",
+			    (i == CONFIG_SCHED_STATS_BUCKETS - 1) ? ">=" : "  ",
+			    (i == 0) ? 0U : (uint32_t)BIT(i), hist->bucket[i]);
+	}
+}
+
+#if defined(CONFIG_SCHED_STATS_THREAD) && defined(CONFIG_THREAD_MONITOR)
+static void shell_sched_stats_dump(const struct k_thread *cthread,
+				   void *user_data)
+{
+	const struct shell *shell = (const struct shell *)user_data;
+	struct k_thread *thread = (struct k_thread *)cthread;
+	struct k_thread_sched_stats stats;
+	const char *tname;
+
+	if (k_thread_sched_stats_get(thread, &stats) != 0) {
+		return;
+	}
+
+	tname = k_thread_name_get(thread);
+
+	shell_print(shell, "%p %-10s switches %u, preemptions %u",
+		    thread, tname ? tname : "NA",
+		    stats.switches, stats.preemptions);
+	shell_hist_dump(shell, "wake latency (cycles)", &stats.wake_latency);
+	shell_hist_dump(shell, "run time (cycles)", &stats.run_time);
+}
+#endif
+
+static int cmd_kernel_sched_stats(const struct shell *shell,
+				  size_t argc, char **argv)
+{
+	struct k_cpu_sched_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		(void)k_cpu_sched_stats_get(i, &stats);
+
+		shell_print(shell,
+			    "CPU %d: switches %u, preemptions %u, max run queue depth %u",
+			    i, stats.switches, stats.preemptions,
+			    stats.runq_depth_max);
+		shell_hist_dump(shell, "wake latency (cycles)",
+				&stats.wake_latency);
+		shell_hist_dump(shell, "run time (cycles)", &stats.run_time);
+		shell_hist_dump(shell, "run queue depth", &stats.runq_depth);
+	}
+
+#if defined(CONFIG_SCHED_STATS_THREAD) && defined(CONFIG_THREAD_MONITOR)
+	shell_print(shell, "Threads:");
+	k_thread_foreach(shell_sched_stats_dump, (void *)shell);
+#endif
+	return 0;
+}
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -259,6 +328,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 		defined(CONFIG_THREAD_MONITOR)
 	SHELL_CMD(stacks, NULL, "List threads stack usage.", cmd_kernel_stacks),
 	SHELL_CMD(threads, NULL, "List kernel threads.", cmd_kernel_threads),
+#endif
+#if defined(CONFIG_SCHED_STATS)
+	SHELL_CMD(sched-stats, NULL, "Scheduler latency histograms.",
+		  cmd_kernel_sched_stats),
 #endif
 	SHELL_CMD(uptime, NULL, "Kernel uptime.", cmd_kernel_uptime),
 	SHELL_CMD(version, NULL, "Kernel version.", cmd_kernel_version),
@@ -0,0 +1,245 @@
+/* bulk_b.c */
+
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "master.h"
+
+#ifdef BULK_BENCH
+
+/*
+ * A producer fills BULK_BATCH messages (or bytes) at a time and a
+ * consumer drains them, through the one-at-a-time calls, the batch
+ * calls and the claim calls.  The first two copy through a staging
+ * buffer, the claim calls let both sides work in the object's buffer.
+ */
+#define BULK_BATCH 32
+#define BULK_MAX_MSG 16
+#define BULK_PIPE_CHUNK 256
+
+K_MSGQ_DEFINE(BULKQ4, 4, BULK_BATCH, 4);
+K_MSGQ_DEFINE(BULKQ16, 16, BULK_BATCH, 4);
+
+static uint32_t staging[BULK_PIPE_CHUNK / sizeof(uint32_t)];
+static volatile uint32_t sink;
+
+#define PRINT_BULK_HEADER(what)                                        \
+	do {                                                           \
+	PRINT_STRING(dashline, output_file);                           \
+	PRINT_F(output_file, "| %-75s |\n", what);                     \
+	PRINT_STRING(dashline, output_file);                           \
+	PRINT_STRING("|          |                 KB/sec, transferred "   \
+		     "with                         |\n", output_file);     \
+	PRINT_STRING("| size(B)  |    one at a time    |        batch  "   \
+		     "      |         claim        |\n", output_file);     \
+	PRINT_STRING(dashline, output_file);                           \
+	} while (0)
+
+#define PRINT_BULK(size, bytes, t)                                     \
+	PRINT_F(output_file, "|%10u|%21u|%21u|%22u|\n", (uint32_t)(size), \
+		bulk_rate(bytes, t[0]), bulk_rate(bytes, t[1]),          \
+		bulk_rate(bytes, t[2]))
+
+static uint32_t bulk_rate(uint32_t bytes, uint32_t cycles)
+{
+	uint64_t ns = k_cyc_to_ns_floor64(cycles);
+
+	return (uint32_t)(((uint64_t)bytes * 1000000U) / SAFE_DIVISOR(ns));
+}
+
+/* Stand-ins for the application writing and reading samples */
+static void produce(void *dst, size_t size)
+{
+	uint32_t *w = dst;
+
+	for (size_t i = 0; i < size / sizeof(uint32_t); i++) {
+		w[i] = i;
+	}
+}
+
+static void consume(const void *src, size_t size)
+{
+	const uint32_t *w = src;
+	uint32_t sum = 0;
+
+	for (size_t i = 0; i < size / sizeof(uint32_t); i++) {
+		sum += w[i];
+	}
+	sink = sum;
+}
+
+static uint32_t msgq_one(struct k_msgq *q, size_t size)
+{
+	char *msgs = (char *)staging;
+	uint32_t t;
+
+	t = BENCH_START();
+	for (int run = 0; run < NR_OF_BULK_RUNS; run++) {
+		produce(msgs, BULK_BATCH * size);
+		for (int i = 0; i < BULK_BATCH; i++) {
+			k_msgq_put(q, msgs + i * size, K_NO_WAIT);
+		}
+		for (int i = 0; i < BULK_BATCH; i++) {
+			k_msgq_get(q, msgs + i * size, K_NO_WAIT);
+		}
+		consume(msgs, BULK_BATCH * size);
+	}
+	t = TIME_STAMP_DELTA_GET(t);
+	check_result();
+
+	return t;
+}
+
+static uint32_t msgq_batch(struct k_msgq *q, size_t size)
+{
+	uint32_t t;
+
+	t = BENCH_START();
+	for (int run = 0; run < NR_OF_BULK_RUNS; run++) {
+		produce(staging, BULK_BATCH * size);
+		k_msgq_put_many(q, staging, BULK_BATCH, K_NO_WAIT);
+		k_msgq_get_many(q, staging, BULK_BATCH, K_NO_WAIT);
+		consume(staging, BULK_BATCH * size);
+	}
+	t = TIME_STAMP_DELTA_GET(t);
+	check_result();
+
+	return t;
+}
+
+static uint32_t msgq_claim(struct k_msgq *q, size_t size)
+{
+	void *msgs;
+	int num;
+	uint32_t t;
+
+	t = BENCH_START();
+	for (int run = 0; run < NR_OF_BULK_RUNS; run++) {
+		for (int done = 0; done < BULK_BATCH; done += num) {
+			num = k_msgq_put_claim(q, &msgs, BULK_BATCH - done);
+			produce(msgs, num * size);
+			k_msgq_put_finish(q, num);
+		}
+		for (int done = 0; done < BULK_BATCH; done += num) {
+			num = k_msgq_get_claim(q, &msgs, BULK_BATCH - done);
+			consume(msgs, num * size);
+			k_msgq_get_finish(q, num);
+		}
+	}
+	t = TIME_STAMP_DELTA_GET(t);
+	check_result();
+
+	return t;
+}
+
+static uint32_t pipe_one(struct k_pipe *pipe, size_t size)
+{
+	size_t bytes;
+	uint32_t t;
+
+	t = BENCH_START();
+	for (int run = 0; run < NR_OF_BULK_RUNS; run++) {
+		produce(staging, BULK_PIPE_CHUNK);
+		for (int i = 0; i < BULK_PIPE_CHUNK; i += size) {
+			k_pipe_put(pipe, (char *)staging + i, size, &bytes,
+				   size, K_NO_WAIT);
+		}
+		for (int i = 0; i < BULK_PIPE_CHUNK; i += size) {
+			k_pipe_get(pipe, (char *)staging + i, size, &bytes,
+				   size, K_NO_WAIT);
+		}
+		consume(staging, BULK_PIPE_CHUNK);
+	}
+	t = TIME_STAMP_DELTA_GET(t);
+	check_result();
+
+	return t;
+}
+
+static uint32_t pipe_batch(struct k_pipe *pipe)
+{
+	size_t bytes;
+	uint32_t t;
+
+	t = BENCH_START();
+	for (int run = 0; run < NR_OF_BULK_RUNS; run++) {
+		produce(staging, BULK_PIPE_CHUNK);
+		k_pipe_put(pipe, staging, BULK_PIPE_CHUNK, &bytes,
+			   BULK_PIPE_CHUNK, K_NO_WAIT);
+		k_pipe_get(pipe, staging, BULK_PIPE_CHUNK, &bytes,
+			   BULK_PIPE_CHUNK, K_NO_WAIT);
+		consume(staging, BULK_PIPE_CHUNK);
+	}
+	t = TIME_STAMP_DELTA_GET(t);
+	check_result();
+
+	return t;
+}
+
+static uint32_t pipe_claim(struct k_pipe *pipe)
+{
+	uint8_t *data;
+	int num;
+	uint32_t t;
+
+	t = BENCH_START();
+	for (int run = 0; run < NR_OF_BULK_RUNS; run++) {
+		for (int done = 0; done < BULK_PIPE_CHUNK; done += num) {
+			num = k_pipe_put_claim(pipe, &data,
+					       BULK_PIPE_CHUNK - done);
+			produce(data, num);
+			k_pipe_put_finish(pipe, num);
+		}
+		for (int done = 0; done < BULK_PIPE_CHUNK; done += num) {
+			num = k_pipe_get_claim(pipe, &data,
+					       BULK_PIPE_CHUNK - done);
+			consume(data, num);
+			k_pipe_get_finish(pipe, num);
+		}
+	}
+	t = TIME_STAMP_DELTA_GET(t);
+	check_result();
+
+	return t;
+}
+
+/**
+ *
+ * @brief Bulk transfer speed test
+ *
+ */
+void bulk_test(void)
+{
+	struct k_msgq *queues[] = { &BULKQ4, &BULKQ16 };
+	uint32_t time[3];
+
+	PRINT_STRING(dashline, output_file);
+	PRINT_STRING("|                 "
+		     "B U L K   T R A N S F E R   M E A S U R E M E N T S"
+		     "         |\n", output_file);
+	PRINT_BULK_HEADER("Stream messages through a message queue");
+
+	for (int i = 0; i < ARRAY_SIZE(queues); i++) {
+		size_t size = queues[i]->msg_size;
+
+		time[0] = msgq_one(queues[i], size);
+		time[1] = msgq_batch(queues[i], size);
+		time[2] = msgq_claim(queues[i], size);
+		PRINT_BULK(size, NR_OF_BULK_RUNS * BULK_BATCH * size, time);
+	}
+
+	PRINT_BULK_HEADER("Stream bytes through a pipe");
+
+	for (uint32_t size = 16U; size <= 64U; size <<= 1) {
+		time[0] = pipe_one(&PIPE_BIGBUFF, size);
+		time[1] = pipe_batch(&PIPE_BIGBUFF);
+		time[2] = pipe_claim(&PIPE_BIGBUFF);
+		PRINT_BULK(size, NR_OF_BULK_RUNS * BULK_PIPE_CHUNK, time);
+	}
+	PRINT_STRING(dashline, output_file);
+}
+
+#endif /* BULK_BENCH */
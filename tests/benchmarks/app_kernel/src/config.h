@@ -33,6 +33,9 @@
 /* flag for performing the Pipes benchmark */
 #define PIPE_BENCH
 
+/* flag for performing the bulk transfer benchmark */
+#define BULK_BENCH
+
 /* flag for performing the Event benchmark */
 #define EVENT_BENCH
 
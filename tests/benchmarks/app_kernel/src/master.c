@@ -131,6 +131,7 @@ void main(void)
 		memorymap_test();
 		mailbox_test();
 		pipe_test();
+		bulk_test();
 		PRINT_STRING("|         END OF TESTS                     "
 					 "                                   |\n",
 					 output_file);
@@ -44,6 +44,7 @@
 #define NR_OF_EVENT_RUNS  1000
 #define NR_OF_MBOX_RUNS 128
 #define NR_OF_PIPE_RUNS 256
+#define NR_OF_BULK_RUNS 64
 /* #define SEMA_WAIT_TIME (5 * CONFIG_SYS_CLOCK_TICKS_PER_SEC) */
 #define SEMA_WAIT_TIME (5000)
 /* global data */
@@ -122,6 +123,12 @@ extern void pipe_test(void);
 #define pipe_test dummy_test
 #endif
 
+#ifdef BULK_BENCH
+extern void bulk_test(void);
+#else
+#define bulk_test dummy_test
+#endif
+
 /* kernel objects needed for benchmarking */
 extern struct k_mutex DEMO_MUTEX;
 
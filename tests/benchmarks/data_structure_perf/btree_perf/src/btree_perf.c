@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/rb.h>
+#include <sys/btree.h>
+
+/* Head to head comparison of the red/black tree and the B+tree holding
+ * the same items: insertion in random order, searches for existing and
+ * missing keys, in-order walk, and removal. The B+tree is also built in
+ * bulk from sorted items.
+ */
+
+#define TREE_SIZE 4096
+#define NUM_NODES (2 * TREE_SIZE / (CONFIG_BTREE_NODE_KEYS / 2) + 8)
+
+struct container_node {
+	struct rbnode rb;
+	struct btnode bt;
+};
+
+static struct container_node items[TREE_SIZE];
+static struct btnode *sorted[TREE_SIZE];
+static uint32_t order[TREE_SIZE];
+static struct btree_node bt_nodes[NUM_NODES];
+static struct rbtree rb_tree;
+static struct btree bt_tree;
+
+static bool node_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	return CONTAINER_OF(a, struct container_node, rb)->bt.key <
+	       CONTAINER_OF(b, struct container_node, rb)->bt.key;
+}
+
+/* Lower bound search of the red/black tree, the same walk as
+ * rb_contains() but comparing keys.
+ */
+static struct rbnode *rb_lower_bound(struct rbtree *tree, btree_key_t key)
+{
+	struct rbnode *n = tree->root;
+	struct rbnode *found = NULL;
+
+	while (n != NULL) {
+		if (CONTAINER_OF(n, struct container_node, rb)->bt.key < key) {
+			n = z_rb_child(n, 1);
+		} else {
+			found = n;
+			n = z_rb_child(n, 0);
+		}
+	}
+
+	return found;
+}
+
+static void setup(void)
+{
+	uint32_t state = 1;
+
+	/* Keys are the even numbers, in a random insertion order */
+	for (uint32_t i = 0; i < TREE_SIZE; i++) {
+		items[i].bt.key = 2 * i;
+		sorted[i] = &items[i].bt;
+		order[i] = i;
+	}
+
+	for (uint32_t i = TREE_SIZE - 1; i > 0; i--) {
+		uint32_t j, tmp;
+
+		state = state * 1103515245U + 12345U;
+		j = (state >> 8) % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+
+	(void)memset(&rb_tree, 0, sizeof(rb_tree));
+	rb_tree.lessthan_fn = node_lessthan;
+	btree_init(&bt_tree, bt_nodes, ARRAY_SIZE(bt_nodes));
+}
+
+#define TIME(cycles, expr) do { \
+		uint32_t __start = k_cycle_get_32(); \
+		expr; \
+		cycles = k_cycle_get_32() - __start; \
+	} while (false)
+
+static void report(const char *op, uint32_t rb, uint32_t bt)
+{
+	TC_PRINT("%-12s rbtree %8u btree %8u cycles/op\n", op,
+		 rb / TREE_SIZE, bt / TREE_SIZE);
+}
+
+void test_btree_vs_rbtree(void)
+{
+	uint32_t rb_cycles, bt_cycles;
+	struct rbnode *rn;
+	struct btnode *bn;
+	size_t found;
+
+	setup();
+
+	TIME(rb_cycles, for (uint32_t i = 0; i < TREE_SIZE; i++) {
+		rb_insert(&rb_tree, &items[order[i]].rb);
+	});
+	TIME(bt_cycles, for (uint32_t i = 0; i < TREE_SIZE; i++) {
+		btree_insert(&bt_tree, &items[order[i]].bt);
+	});
+	report("insert", rb_cycles, bt_cycles);
+	zassert_equal(btree_count(&bt_tree), TREE_SIZE, NULL);
+
+	/* Hits */
+	found = 0;
+	TIME(rb_cycles, for (uint32_t i = 0; i < TREE_SIZE; i++) {
+		found += rb_lower_bound(&rb_tree, 2 * order[i]) != NULL;
+	});
+	zassert_equal(found, TREE_SIZE, NULL);
+	found = 0;
+	TIME(bt_cycles, for (uint32_t i = 0; i < TREE_SIZE; i++) {
+		found += btree_find(&bt_tree, 2 * order[i]) != NULL;
+	});
+	zassert_equal(found, TREE_SIZE, NULL);
+	report("search", rb_cycles, bt_cycles);
+
+	/* Odd keys, the lower bound is the next item */
+	found = 0;
+	TIME(rb_cycles, for (uint32_t i = 0; i < TREE_SIZE; i++) {
+		found += rb_lower_bound(&rb_tree, 2 * order[i] + 1) != NULL;
+	});
+	zassert_equal(found, TREE_SIZE - 1, NULL);
+	found = 0;
+	TIME(bt_cycles, for (uint32_t i = 0; i < TREE_SIZE; i++) {
+		found += btree_lower_bound(&bt_tree, 2 * order[i] + 1,
+					   NULL) != NULL;
+	});
+	zassert_equal(found, TREE_SIZE - 1, NULL);
+	report("lower bound", rb_cycles, bt_cycles);
+
+	found = 0;
+	TIME(rb_cycles, RB_FOR_EACH(&rb_tree, rn) {
+		found++;
+	});
+	zassert_equal(found, TREE_SIZE, NULL);
+	found = 0;
+	TIME(bt_cycles, BTREE_FOR_EACH(&bt_tree, bn) {
+		found++;
+	});
+	zassert_equal(found, TREE_SIZE, NULL);
+	report("walk", rb_cycles, bt_cycles);
+
+	TIME(rb_cycles, for (uint32_t i = 0; i < TREE_SIZE; i++) {
+		rb_remove(&rb_tree, &items[order[i]].rb);
+	});
+	TIME(bt_cycles, for (uint32_t i = 0; i < TREE_SIZE; i++) {
+		btree_remove(&bt_tree, &items[order[i]].bt);
+	});
+	report("remove", rb_cycles, bt_cycles);
+	zassert_true(btree_is_empty(&bt_tree), NULL);
+	zassert_is_null(rb_get_min(&rb_tree), NULL);
+
+	/* Sorted input, one by one and in bulk */
+	TIME(rb_cycles, for (uint32_t i = 0; i < TREE_SIZE; i++) {
+		rb_insert(&rb_tree, &items[i].rb);
+	});
+	TIME(bt_cycles, btree_insert_bulk(&bt_tree, sorted, TREE_SIZE));
+	report("sorted build", rb_cycles, bt_cycles);
+	zassert_equal(btree_count(&bt_tree), TREE_SIZE, NULL);
+
+	TC_PRINT("btree %u keys per node, height %u, %u nodes used\n",
+		 CONFIG_BTREE_NODE_KEYS, bt_tree.height,
+		 (uint32_t)(NUM_NODES - bt_tree.free_cnt));
+}
+
+void test_main(void)
+{
+	ztest_test_suite(btree_perf,
+			 ztest_unit_test(test_btree_vs_rbtree)
+			 );
+	ztest_run_test_suite(btree_perf);
+}
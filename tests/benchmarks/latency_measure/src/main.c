@@ -26,6 +26,7 @@ extern void mutex_lock_unlock(void);
 extern int coop_ctx_switch(void);
 extern int sema_test(void);
 extern int sema_context_switch(void);
+extern int sema_burst(void);
 extern int suspend_resume(void);
 extern void heap_malloc_free(void);
 
@@ -56,6 +57,8 @@ void test_thread(void *arg1, void *arg2, void *arg3)
 
 	sema_context_switch();
 
+	sema_burst();
+
 	mutex_lock_unlock();
 
 	heap_malloc_free();
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file measure time for releasing a semaphore in bursts
+ *
+ * This file contains the tests that compare giving a semaphore
+ * repeatedly with k_sem_give() against giving it once with
+ * k_sem_give_n(): from an ISR with nobody waiting, and from a thread
+ * with several higher priority threads waiting.
+ */
+
+#include <zephyr.h>
+#include <timing/timing.h>
+#include <irq_offload.h>
+#include "utils.h"
+
+/* the number of units given from the ISR */
+#define N_BURST 32
+
+/* the number of threads woken from the thread */
+#define N_WAITERS 8
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACK_SIZE)
+
+static K_THREAD_STACK_ARRAY_DEFINE(waiter_stacks, N_WAITERS, STACK_SIZE);
+static struct k_thread waiter_threads[N_WAITERS];
+
+K_SEM_DEFINE(burst_sema, 0, N_BURST);
+
+static timing_t timestamp_start;
+static timing_t timestamp_end;
+
+static void burst_give_isr(const void *use_give_n)
+{
+	timestamp_start = timing_counter_get();
+
+	if (use_give_n != NULL) {
+		k_sem_give_n(&burst_sema, N_BURST);
+	} else {
+		for (int i = 0; i < N_BURST; i++) {
+			k_sem_give(&burst_sema);
+		}
+	}
+
+	timestamp_end = timing_counter_get();
+}
+
+static void isr_burst(bool use_give_n, const char *label)
+{
+	uint32_t diff;
+
+	k_sem_reset(&burst_sema);
+
+	bench_test_start();
+	timing_start();
+
+	irq_offload(burst_give_isr, use_give_n ? INT_TO_POINTER(1) : NULL);
+
+	timing_stop();
+
+	if ((bench_test_end() == 0) &&
+	    (k_sem_count_get(&burst_sema) == N_BURST)) {
+		diff = timing_cycles_get(&timestamp_start, &timestamp_end);
+		PRINT_STATS_AVG(label, diff, N_BURST);
+	} else {
+		error_count++;
+		PRINT_OVERFLOW_ERROR();
+	}
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sem_take(&burst_sema, K_FOREVER);
+}
+
+static void wake_waiters(bool use_give_n, const char *label)
+{
+	uint32_t diff;
+
+	k_sem_reset(&burst_sema);
+
+	/* The waiters have a higher priority than this thread, so they
+	 * pend on the semaphore as soon as they are created.
+	 */
+	for (int i = 0; i < N_WAITERS; i++) {
+		k_thread_create(&waiter_threads[i], waiter_stacks[i],
+				STACK_SIZE, waiter, NULL, NULL, NULL,
+				K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+	}
+
+	bench_test_start();
+	timing_start();
+
+	timestamp_start = timing_counter_get();
+
+	if (use_give_n) {
+		k_sem_give_n(&burst_sema, N_WAITERS);
+	} else {
+		for (int i = 0; i < N_WAITERS; i++) {
+			k_sem_give(&burst_sema);
+		}
+	}
+
+	/* All waiters have run by the time we get back control */
+	timestamp_end = timing_counter_get();
+
+	timing_stop();
+
+	for (int i = 0; i < N_WAITERS; i++) {
+		k_thread_join(&waiter_threads[i], K_FOREVER);
+	}
+
+	if (bench_test_end() == 0) {
+		diff = timing_cycles_get(&timestamp_start, &timestamp_end);
+		PRINT_STATS_AVG(label, diff, N_WAITERS);
+	} else {
+		error_count++;
+		PRINT_OVERFLOW_ERROR();
+	}
+}
+
+/**
+ *
+ * @brief Compare single and bulk semaphore release
+ *
+ * @return 0 on success
+ */
+int sema_burst(void)
+{
+	isr_burst(false, "Average semaphore give from ISR (k_sem_give)");
+	isr_burst(true, "Average semaphore give from ISR (k_sem_give_n)");
+	wake_waiters(false, "Average time to wake a waiter (k_sem_give)");
+	wake_waiters(true, "Average time to wake a waiter (k_sem_give_n)");
+
+	return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/mem_blocks.h>
+
+/* Memory blocks allocator throughput benchmark.  The cost of an
+ * allocation is dominated by the search of the allocation bitmap for a
+ * free run of blocks, which depends on how the allocated blocks are
+ * laid out.  Each scenario sets up a layout and then repeatedly
+ * allocates and frees a contiguous run of blocks, which leaves the
+ * layout unchanged.
+ */
+
+#define NUM_BLOCKS 4096
+#define BLOCK_SIZE 8
+#define ROUNDS 256
+
+SYS_MEM_BLOCKS_DEFINE_STATIC(pool, BLOCK_SIZE, NUM_BLOCKS, 4);
+
+static void *blocks[NUM_BLOCKS];
+static bool freed[NUM_BLOCKS];
+
+static void fill(void)
+{
+	int ret = sys_mem_blocks_alloc(&pool, NUM_BLOCKS, blocks);
+
+	__ASSERT_NO_MSG(ret == 0);
+	ARG_UNUSED(ret);
+
+	memset(freed, 0, sizeof(freed));
+}
+
+static void release(size_t first, size_t count, size_t step)
+{
+	for (size_t i = first; i < first + count; i += step) {
+		sys_mem_blocks_free_contiguous(&pool, blocks[i], 1);
+		freed[i] = true;
+	}
+}
+
+/* Free whatever a scenario left allocated */
+static void drain(void)
+{
+	for (size_t i = 0; i < NUM_BLOCKS; i++) {
+		if (!freed[i]) {
+			release(i, 1, 1);
+		}
+	}
+}
+
+static void run(const char *name, size_t count)
+{
+	uint32_t start, cycles;
+	void *block;
+
+	start = k_cycle_get_32();
+	for (int r = 0; r < ROUNDS; r++) {
+		int ret = sys_mem_blocks_alloc_contiguous(&pool, count, &block);
+
+		__ASSERT_NO_MSG(ret == 0);
+		ARG_UNUSED(ret);
+		sys_mem_blocks_free_contiguous(&pool, block, count);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	printk("%-8s blocks %5u count %2u ops %5u cycles/op %6u\n", name,
+	       NUM_BLOCKS, (uint32_t)count, 2U * ROUNDS,
+	       cycles / (2U * ROUNDS));
+}
+
+void main(void)
+{
+	/* Nothing allocated, the run is found at the very start */
+	run("empty", 1);
+	run("empty", 16);
+
+	/* Everything but the last eighth allocated */
+	fill();
+	release(NUM_BLOCKS / 8 * 7, NUM_BLOCKS / 8, 1);
+	run("full", 1);
+	run("full", 16);
+	drain();
+
+	/* One free block every 32 blocks, which does not fit runs of
+	 * more than one block, and the last eighth free
+	 */
+	fill();
+	release(0, NUM_BLOCKS / 8 * 7, 32);
+	release(NUM_BLOCKS / 8 * 7, NUM_BLOCKS / 8, 1);
+	run("holes", 2);
+	run("holes", 16);
+	drain();
+
+	/* Every other block free */
+	fill();
+	release(1, NUM_BLOCKS / 8 * 7 - 1, 2);
+	release(NUM_BLOCKS / 8 * 7, NUM_BLOCKS / 8, 1);
+	run("striped", 2);
+	run("striped", 16);
+	drain();
+
+	printk("fin\n");
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* Memory slab throughput benchmark.  Several threads share one slab,
+ * each allocating a burst of blocks and freeing it again in a loop.
+ * The slab is sized either so that it never runs empty, or so that
+ * threads regularly block on it and get blocks handed over by the
+ * freeing threads.
+ */
+
+#define MAX_THREADS MAX(CONFIG_MP_NUM_CPUS, 2)
+#define BURST 16
+#define ROUNDS 1024
+#define BLOCK_SIZE 32
+#define STACK_SIZE 1024
+#define WORKER_PRIO 5
+
+K_MEM_SLAB_DEFINE_STATIC(slab, BLOCK_SIZE, MAX_THREADS * BURST, 4);
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_THREADS, STACK_SIZE);
+static struct k_thread threads[MAX_THREADS];
+static K_SEM_DEFINE(start_sem, 0, MAX_THREADS);
+
+/* The slab itself is defined with the maximum number of blocks, the
+ * runs with fewer just keep the rest allocated
+ */
+static void *reserved[MAX_THREADS * BURST];
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	void *blocks[BURST];
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sem_take(&start_sem, K_FOREVER);
+
+	for (int r = 0; r < ROUNDS; r++) {
+		for (int i = 0; i < BURST; i++) {
+			int ret = k_mem_slab_alloc(&slab, &blocks[i],
+						   K_FOREVER);
+
+			__ASSERT_NO_MSG(ret == 0);
+			ARG_UNUSED(ret);
+		}
+
+		/* Let the others at the slab while holding the burst */
+		k_yield();
+
+		for (int i = 0; i < BURST; i++) {
+			k_mem_slab_free(&slab, &blocks[i]);
+		}
+	}
+}
+
+static void run(int nthreads, uint32_t nblocks)
+{
+	uint32_t nreserved = MAX_THREADS * BURST - nblocks;
+	uint32_t ops = 2U * nthreads * BURST * ROUNDS;
+	uint32_t start, cycles;
+
+	for (int i = 0; i < nreserved; i++) {
+		k_mem_slab_alloc(&slab, &reserved[i], K_NO_WAIT);
+	}
+
+	for (int i = 0; i < nthreads; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				worker, NULL, NULL, NULL,
+				WORKER_PRIO, 0, K_NO_WAIT);
+	}
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < nthreads; i++) {
+		k_sem_give(&start_sem);
+	}
+	for (int i = 0; i < nthreads; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	for (int i = 0; i < nreserved; i++) {
+		k_mem_slab_free(&slab, &reserved[i]);
+	}
+
+	printk("threads %2d blocks %3u ops %7u cycles/op %5u\n",
+	       nthreads, nblocks, ops, cycles / ops);
+}
+
+void main(void)
+{
+	/* Start the workers from a higher priority than theirs so
+	 * they all get released at once
+	 */
+	k_thread_priority_set(k_current_get(), WORKER_PRIO - 1);
+
+	for (int n = 1; n <= MAX_THREADS; n++) {
+		run(n, n * BURST);
+		if (n > 1) {
+			/* The fewest blocks for which some thread can
+			 * always complete its burst
+			 */
+			run(n, n * (BURST - 1) + 1);
+		}
+	}
+
+	printk("max used %u\n", k_mem_slab_max_used_get(&slab));
+	printk("fin\n");
+}
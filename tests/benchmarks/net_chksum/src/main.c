@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_chksum_bench, LOG_LEVEL_INF);
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+
+#include "net_private.h"
+
+/* Internet checksum benchmark.  IPv6 UDP packets spread over network
+ * buffers are checksummed with net_calc_chksum() and with the former
+ * implementation, kept below as a reference, which summed the data one
+ * 16-bit word at a time.  Then the cost of a header rewrite is compared
+ * between summing the packet again and the incremental update, and the
+ * UDP send path is replayed, writing the payload and checksumming it.
+ */
+
+#define ROUNDS 64
+
+static const size_t lengths[] = { 64, 512, 1232 };
+
+static uint8_t payload[1232];
+
+static uint16_t ref_calc_chksum(uint16_t sum, const uint8_t *data, size_t len)
+{
+	const uint8_t *end;
+	uint16_t tmp;
+
+	end = data + len - 1;
+
+	while (data < end) {
+		tmp = (data[0] << 8) + data[1];
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+
+		data += 2;
+	}
+
+	if (data == end) {
+		tmp = data[0] << 8;
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+	}
+
+	return sum;
+}
+
+/* UDP checksum of an IPv6 packet without extension headers */
+static uint16_t ref_chksum_udp(struct net_pkt *pkt)
+{
+	struct net_buf *buf = pkt->buffer;
+	const uint8_t *pos = buf->data + NET_IPV6H_LEN;
+	size_t len = buf->len - NET_IPV6H_LEN;
+	uint16_t sum;
+
+	sum = net_pkt_get_len(pkt) - NET_IPV6H_LEN + IPPROTO_UDP;
+	sum = ref_calc_chksum(sum, buf->data + 8, 2 * sizeof(struct in6_addr));
+
+	while (buf) {
+		sum = ref_calc_chksum(sum, pos, len);
+
+		buf = buf->frags;
+		if (!buf || !buf->len) {
+			break;
+		}
+
+		pos = buf->data;
+
+		if (len % 2) {
+			sum += *pos;
+			if (sum < *pos) {
+				sum++;
+			}
+
+			pos++;
+			len = buf->len - 1;
+		} else {
+			len = buf->len;
+		}
+	}
+
+	sum = (sum == 0U) ? 0xffff : htons(sum);
+
+	return ~sum;
+}
+
+static struct net_pkt *build(size_t len)
+{
+	struct net_ipv6_hdr ip = {
+		.vtc = 0x60,
+		.nexthdr = IPPROTO_UDP,
+		.hop_limit = 64,
+		.src = { 0x20, 0x01, 0x0d, 0xb8, [15] = 0x01 },
+		.dst = { 0x20, 0x01, 0x0d, 0xb8, [15] = 0x02 },
+	};
+	struct net_udp_hdr udp = {
+		.src_port = htons(4242),
+		.dst_port = htons(4243),
+	};
+	struct net_pkt *pkt;
+	int ret;
+
+	ip.len = htons(NET_UDPH_LEN + len);
+	udp.len = ip.len;
+
+	pkt = net_pkt_alloc(K_NO_WAIT);
+	__ASSERT(pkt, "Cannot allocate pkt");
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV6H_LEN);
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	ret = net_pkt_alloc_buffer(pkt, len, IPPROTO_UDP, K_NO_WAIT);
+	__ASSERT(ret == 0, "Cannot allocate buffer");
+
+	ret = net_pkt_write(pkt, &ip, sizeof(ip));
+	ret |= net_pkt_write(pkt, &udp, sizeof(udp));
+
+	net_pkt_chksum_copy_begin(pkt);
+	ret |= net_pkt_write(pkt, payload, len);
+	net_pkt_chksum_copy_end(pkt);
+
+	__ASSERT(ret == 0, "Cannot write pkt");
+	ARG_UNUSED(ret);
+
+	return pkt;
+}
+
+static void bench_chksum(size_t len)
+{
+	struct net_pkt *pkt = build(len);
+	uint32_t start, ref_cycles, cycles;
+	uint16_t chksum = 0U;
+
+	__ASSERT(net_calc_chksum(pkt, IPPROTO_UDP) == ref_chksum_udp(pkt),
+		 "Checksum mismatch, len %zu", len);
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < ROUNDS; i++) {
+		chksum += ref_chksum_udp(pkt);
+	}
+	ref_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < ROUNDS; i++) {
+		chksum += net_calc_chksum(pkt, IPPROTO_UDP);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	printk("chksum  len %5zu reference %8u cycles net_calc_chksum %8u cycles\n",
+	       len, ref_cycles / ROUNDS, cycles / ROUNDS);
+
+	net_pkt_unref(pkt);
+	ARG_UNUSED(chksum);
+}
+
+static void bench_update(size_t len)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(udp_access, struct net_udp_hdr);
+	struct net_pkt *pkt = build(len);
+	struct net_udp_hdr *udp;
+	uint32_t start, full_cycles, cycles;
+	uint16_t port, chksum;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_skip(pkt, NET_IPV6H_LEN);
+
+	udp = (struct net_udp_hdr *)net_pkt_get_data(pkt, &udp_access);
+	__ASSERT(udp, "Cannot access UDP header");
+
+	udp->chksum = net_calc_chksum(pkt, IPPROTO_UDP);
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < ROUNDS; i++) {
+		udp->src_port = htons(ntohs(udp->src_port) + 1);
+		udp->chksum = 0U;
+		udp->chksum = net_calc_chksum(pkt, IPPROTO_UDP);
+	}
+	full_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < ROUNDS; i++) {
+		port = udp->src_port;
+		udp->src_port = htons(ntohs(port) + 1);
+		udp->chksum = net_chksum_update16(udp->chksum, port,
+						  udp->src_port);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	chksum = udp->chksum;
+	udp->chksum = 0U;
+	__ASSERT(chksum == net_calc_chksum(pkt, IPPROTO_UDP),
+		 "Incremental checksum mismatch, len %zu", len);
+	ARG_UNUSED(chksum);
+
+	printk("update  len %5zu full      %8u cycles incremental     %8u cycles\n",
+	       len, full_cycles / ROUNDS, cycles / ROUNDS);
+
+	net_pkt_unref(pkt);
+}
+
+static void bench_write(size_t len)
+{
+	uint32_t start, cycles = 0U;
+	uint16_t chksum = 0U;
+
+	for (int i = 0; i < ROUNDS; i++) {
+		struct net_pkt *pkt;
+
+		start = k_cycle_get_32();
+		pkt = build(len);
+		chksum += net_calc_chksum(pkt, IPPROTO_UDP);
+		cycles += k_cycle_get_32() - start;
+
+		net_pkt_unref(pkt);
+	}
+
+	printk("write   len %5zu                           %8u cycles\n",
+	       len, cycles / ROUNDS);
+	ARG_UNUSED(chksum);
+}
+
+void main(void)
+{
+	for (int i = 0; i < sizeof(payload); i++) {
+		payload[i] = (i * 31 + 7) & 0xff;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(lengths); i++) {
+		bench_chksum(lengths[i]);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(lengths); i++) {
+		bench_update(lengths[i]);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(lengths); i++) {
+		bench_write(lengths[i]);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* Connection demultiplexing benchmark.  A client sends UDP datagrams
+ * over the loopback interface to the first of a growing number of
+ * bound sockets, reading each one back before sending the next, so the
+ * per packet cost shows how the connection handler lookup depends on
+ * the number of registered handlers.
+ */
+
+#define BASE_PORT 4242
+#define PACKETS 256
+#define MAX_SOCKETS 64
+
+static int socks[MAX_SOCKETS];
+static int num_socks;
+
+static void bind_sockets(int count)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+	};
+	int ret;
+
+	while (num_socks < count) {
+		socks[num_socks] = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+		__ASSERT(socks[num_socks] >= 0, "socket() failed %d", errno);
+
+		addr.sin6_port = htons(BASE_PORT + num_socks);
+		ret = bind(socks[num_socks], (struct sockaddr *)&addr,
+			   sizeof(addr));
+		__ASSERT(ret == 0, "bind() failed %d", errno);
+		ARG_UNUSED(ret);
+
+		num_socks++;
+	}
+}
+
+static void run(int client, const struct sockaddr_in6 *addr, int count)
+{
+	uint32_t start, cycles;
+	uint32_t buf;
+	ssize_t len;
+
+	bind_sockets(count);
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < PACKETS; i++) {
+		len = sendto(client, &i, sizeof(i), 0,
+			     (const struct sockaddr *)addr, sizeof(*addr));
+		__ASSERT(len == sizeof(i), "sendto() failed %d", errno);
+
+		len = recv(socks[0], &buf, sizeof(buf), 0);
+		__ASSERT(len == sizeof(buf) && buf == i, "recv() failed %d",
+			 errno);
+	}
+	cycles = k_cycle_get_32() - start;
+	ARG_UNUSED(len);
+
+	printk("demux    sockets %3d packets %4u cycles/packet %8u\n",
+	       count, PACKETS, cycles / PACKETS);
+}
+
+void main(void)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(BASE_PORT),
+	};
+	int client;
+
+	inet_pton(AF_INET6, CONFIG_NET_CONFIG_MY_IPV6_ADDR, &addr.sin6_addr);
+
+	client = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+	__ASSERT(client >= 0, "socket() failed %d", errno);
+
+	run(client, &addr, 1);
+	run(client, &addr, MAX_SOCKETS / 4);
+	run(client, &addr, MAX_SOCKETS / 2);
+	run(client, &addr, MAX_SOCKETS);
+
+	for (int i = 0; i < num_socks; i++) {
+		close(socks[i]);
+	}
+	close(client);
+
+	printk("fin\n");
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_route_bench, LOG_LEVEL_INF);
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+
+#include "ipv6.h"
+#include "route.h"
+
+/* Routing table benchmark.  The table is filled with /64 routes through
+ * a single next hop, then random destinations within the routes are
+ * looked up, a few destinations are looked up over and over, and the
+ * routes are deleted.  The longest prefix search the table did before
+ * it was made a trie, checking every route in turn, is kept below as a
+ * reference and run over the same prefixes.
+ */
+
+#define LOOKUPS 256
+#define HOT_DESTS 4
+#define PREFIX_LEN 64
+
+static const int sizes[] = { 64, 512, CONFIG_NET_MAX_ROUTES };
+
+static struct in6_addr prefixes[CONFIG_NET_MAX_ROUTES];
+static struct net_route_entry *routes[CONFIG_NET_MAX_ROUTES];
+static struct in6_addr dests[LOOKUPS];
+
+static struct in6_addr nexthop = { { { 0xfe, 0x80, [15] = 0x01 } } };
+static uint8_t nexthop_lladdr[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static uint32_t seed = 1U;
+
+static uint32_t bench_rand(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed;
+}
+
+static int ref_lookup(const struct in6_addr *dst, int count)
+{
+	uint8_t longest = 0U;
+	int found = -1;
+
+	for (int i = 0; i < count; i++) {
+		if (net_ipv6_is_prefix(dst->s6_addr, prefixes[i].s6_addr,
+				       PREFIX_LEN) && PREFIX_LEN > longest) {
+			longest = PREFIX_LEN;
+			found = i;
+		}
+	}
+
+	return found;
+}
+
+static void bench(struct net_if *iface, int count)
+{
+	uint32_t start, add_cycles, cycles, hot_cycles, ref_cycles, del_cycles;
+	struct net_route_entry *route;
+	int found = 0;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < count; i++) {
+		routes[i] = net_route_add(iface, &prefixes[i], PREFIX_LEN,
+					  &nexthop, NET_IPV6_ND_INFINITE_LIFETIME,
+					  NET_ROUTE_PREFERENCE_MEDIUM);
+	}
+	add_cycles = k_cycle_get_32() - start;
+
+	for (int i = 0; i < count; i++) {
+		__ASSERT(routes[i], "Cannot add route %d", i);
+	}
+
+	for (int i = 0; i < LOOKUPS; i++) {
+		int n = bench_rand() % count;
+
+		dests[i] = prefixes[n];
+		UNALIGNED_PUT(bench_rand(), &dests[i].s6_addr32[2]);
+		UNALIGNED_PUT(bench_rand(), &dests[i].s6_addr32[3]);
+
+		__ASSERT(net_route_lookup(iface, &dests[i]) == routes[n],
+			 "Wrong route for destination %d", i);
+	}
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < LOOKUPS; i++) {
+		route = net_route_lookup(iface, &dests[i]);
+		found += route != NULL;
+	}
+	cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < LOOKUPS; i++) {
+		route = net_route_lookup(iface, &dests[i % HOT_DESTS]);
+		found += route != NULL;
+	}
+	hot_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < LOOKUPS; i++) {
+		found += ref_lookup(&dests[i], count) >= 0;
+	}
+	ref_cycles = k_cycle_get_32() - start;
+
+	__ASSERT(found == 3 * LOOKUPS, "Lookup failed");
+	ARG_UNUSED(found);
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < count; i++) {
+		(void)net_route_del(routes[i]);
+	}
+	del_cycles = k_cycle_get_32() - start;
+
+	__ASSERT(!net_route_lookup(iface, &dests[0]), "Route not deleted");
+
+	printk("route   routes %5d add %8u lookup %8u hot %8u linear %8u del %8u cycles\n",
+	       count, add_cycles / count, cycles / LOOKUPS,
+	       hot_cycles / LOOKUPS, ref_cycles / LOOKUPS, del_cycles / count);
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct net_linkaddr lladdr = {
+		.addr = nexthop_lladdr,
+		.len = sizeof(nexthop_lladdr),
+		.type = NET_LINK_ETHERNET,
+	};
+	struct net_nbr *nbr;
+
+	nbr = net_ipv6_nbr_add(iface, &nexthop, &lladdr, true,
+			       NET_IPV6_NBR_STATE_REACHABLE);
+	__ASSERT(nbr, "Cannot add next hop to neighbor cache");
+	ARG_UNUSED(nbr);
+
+	/* 2001:db8:xxxx:xxxx::/64, with the index spread by an odd factor
+	 * so that the prefixes are all different.
+	 */
+	for (int i = 0; i < ARRAY_SIZE(prefixes); i++) {
+		prefixes[i].s6_addr32[0] = htonl(0x20010db8);
+		prefixes[i].s6_addr32[1] = htonl(i * 2654435761U);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		bench(iface, sizes[i]);
+	}
+
+	printk("fin\n");
+}
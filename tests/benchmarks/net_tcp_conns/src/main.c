@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* TCP connections benchmark.  A growing number of client sockets are
+ * connected to a listening socket over the loopback interface, then a
+ * message is sent on each connection in turn and read on the accepted
+ * side before the next is sent.  The segment rate shows how the
+ * connection lookup and timer handling depend on the number of open
+ * connections.
+ */
+
+#define SERVER_PORT 4242
+#define SEGMENTS 512
+#define MAX_CONNS 16
+
+static int clients[MAX_CONNS];
+static int servers[MAX_CONNS];
+static int num_conns;
+
+static void open_conns(int server, const struct sockaddr_in6 *addr,
+		       int count)
+{
+	struct sockaddr_in6 peer;
+	socklen_t peer_len;
+	int ret;
+
+	while (num_conns < count) {
+		clients[num_conns] = socket(AF_INET6, SOCK_STREAM,
+					    IPPROTO_TCP);
+		__ASSERT(clients[num_conns] >= 0, "socket() failed %d", errno);
+
+		ret = connect(clients[num_conns],
+			      (const struct sockaddr *)addr, sizeof(*addr));
+		__ASSERT(ret == 0, "connect() failed %d", errno);
+		ARG_UNUSED(ret);
+
+		peer_len = sizeof(peer);
+		servers[num_conns] = accept(server, (struct sockaddr *)&peer,
+					    &peer_len);
+		__ASSERT(servers[num_conns] >= 0, "accept() failed %d", errno);
+
+		num_conns++;
+	}
+}
+
+static void run(int server, const struct sockaddr_in6 *addr, int count)
+{
+	uint32_t start, cycles;
+	uint32_t buf;
+	ssize_t len;
+
+	open_conns(server, addr, count);
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < SEGMENTS; i++) {
+		int c = i % count;
+
+		len = send(clients[c], &i, sizeof(i), 0);
+		__ASSERT(len == sizeof(i), "send() failed %d", errno);
+
+		len = recv(servers[c], &buf, sizeof(buf), 0);
+		__ASSERT(len == sizeof(buf) && buf == i, "recv() failed %d",
+			 errno);
+	}
+	cycles = MAX(k_cycle_get_32() - start, 1U);
+	ARG_UNUSED(len);
+
+	printk("tcp      conns %3d segments %4u segments/s %8u\n",
+	       count, SEGMENTS,
+	       (uint32_t)((uint64_t)SEGMENTS * sys_clock_hw_cycles_per_sec() /
+			  cycles));
+}
+
+void main(void)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(SERVER_PORT),
+	};
+	int server, ret;
+
+	inet_pton(AF_INET6, CONFIG_NET_CONFIG_MY_IPV6_ADDR, &addr.sin6_addr);
+
+	server = socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	__ASSERT(server >= 0, "socket() failed %d", errno);
+
+	ret = bind(server, (struct sockaddr *)&addr, sizeof(addr));
+	__ASSERT(ret == 0, "bind() failed %d", errno);
+
+	ret = listen(server, 2);
+	__ASSERT(ret == 0, "listen() failed %d", errno);
+	ARG_UNUSED(ret);
+
+	run(server, &addr, 1);
+	run(server, &addr, MAX_CONNS / 4);
+	run(server, &addr, MAX_CONNS / 2);
+	run(server, &addr, MAX_CONNS);
+
+	for (int i = 0; i < num_conns; i++) {
+		close(servers[i]);
+		close(clients[i]);
+	}
+	close(server);
+
+	printk("fin\n");
+}
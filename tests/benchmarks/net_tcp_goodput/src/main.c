@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <net/loopback.h>
+
+/* TCP goodput benchmark.  A bulk transfer runs on a connection over the
+ * loopback interface, which drops a share of the packets and delays all
+ * of them.  The receiver checks every byte, and the goodput is the data
+ * delivered to it per second of uptime, so it shows how the sender
+ * recovers from losses and fills a path with a longer round trip.
+ */
+
+#define SERVER_PORT 4242
+#define TOTAL (32 * 1024)
+#define CHUNK 512
+#define SENDER_STACK_SIZE 2048
+
+struct scenario {
+	uint32_t loss_pct;
+	uint32_t delay_ms;
+};
+
+static const struct scenario scenarios[] = {
+	{ 0, 0 },
+	{ 0, 20 },
+	{ 1, 20 },
+	{ 2, 20 },
+	{ 5, 20 },
+};
+
+static K_THREAD_STACK_DEFINE(sender_stack, SENDER_STACK_SIZE);
+static struct k_thread sender_thread;
+static uint8_t send_buf[CHUNK];
+static uint8_t recv_buf[CHUNK];
+
+/* Data pattern, the period is prime so that misplaced data is caught */
+static uint8_t pattern(uint32_t offset)
+{
+	return offset % 251;
+}
+
+static void sender(void *p1, void *p2, void *p3)
+{
+	int sock = POINTER_TO_INT(p1);
+	uint32_t offset = 0;
+	ssize_t len;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (offset < TOTAL) {
+		uint32_t chunk = MIN(TOTAL - offset, sizeof(send_buf));
+
+		for (uint32_t i = 0; i < chunk; i++) {
+			send_buf[i] = pattern(offset + i);
+		}
+
+		len = send(sock, send_buf, chunk, 0);
+		__ASSERT(len > 0, "send() failed %d", errno);
+
+		offset += len;
+	}
+}
+
+static void run(int server, const struct sockaddr_in6 *addr,
+		const struct scenario *sc)
+{
+	struct sockaddr_in6 peer;
+	socklen_t peer_len = sizeof(peer);
+	uint32_t offset = 0;
+	int64_t start;
+	uint32_t ms;
+	int client, conn, ret;
+	ssize_t len;
+
+	client = socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	__ASSERT(client >= 0, "socket() failed %d", errno);
+
+	ret = connect(client, (const struct sockaddr *)addr, sizeof(*addr));
+	__ASSERT(ret == 0, "connect() failed %d", errno);
+
+	conn = accept(server, (struct sockaddr *)&peer, &peer_len);
+	__ASSERT(conn >= 0, "accept() failed %d", errno);
+
+	loopback_set_packet_drop_ratio(sc->loss_pct / 100.0f);
+	loopback_set_packet_delay(sc->delay_ms);
+
+	start = k_uptime_get();
+
+	k_thread_create(&sender_thread, sender_stack,
+			K_THREAD_STACK_SIZEOF(sender_stack), sender,
+			INT_TO_POINTER(client), NULL, NULL,
+			K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+
+	while (offset < TOTAL) {
+		len = recv(conn, recv_buf, sizeof(recv_buf), 0);
+		__ASSERT(len > 0, "recv() failed %d", errno);
+
+		for (ssize_t i = 0; i < len; i++) {
+			__ASSERT(recv_buf[i] == pattern(offset + i),
+				 "data mismatch at %u", offset + (uint32_t)i);
+		}
+
+		offset += len;
+	}
+
+	ms = MAX((uint32_t)(k_uptime_get() - start), 1U);
+
+	k_thread_join(&sender_thread, K_FOREVER);
+
+	loopback_set_packet_drop_ratio(0.0f);
+	loopback_set_packet_delay(0);
+
+	printk("goodput  loss %3u%% delay %3u ms bytes %6u bytes/s %8u\n",
+	       sc->loss_pct, sc->delay_ms, TOTAL,
+	       (uint32_t)((uint64_t)TOTAL * MSEC_PER_SEC / ms));
+
+	close(conn);
+	close(client);
+	ARG_UNUSED(ret);
+}
+
+void main(void)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(SERVER_PORT),
+	};
+	int server, ret;
+
+	inet_pton(AF_INET6, CONFIG_NET_CONFIG_MY_IPV6_ADDR, &addr.sin6_addr);
+
+	server = socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	__ASSERT(server >= 0, "socket() failed %d", errno);
+
+	ret = bind(server, (struct sockaddr *)&addr, sizeof(addr));
+	__ASSERT(ret == 0, "bind() failed %d", errno);
+
+	ret = listen(server, 1);
+	__ASSERT(ret == 0, "listen() failed %d", errno);
+	ARG_UNUSED(ret);
+
+	for (int i = 0; i < ARRAY_SIZE(scenarios); i++) {
+		run(server, &addr, &scenarios[i]);
+	}
+
+	close(server);
+
+	printk("fin\n");
+}
@@ -38,6 +38,8 @@ static struct k_thread partner_thread;
 
 _wait_q_t waitq;
 
+void timeout_bench(void);
+
 enum {
 	UNPENDING,
 	UNPENDED_READYING,
@@ -148,5 +150,8 @@ void main(void)
 		       stamps[4] - stamps[3],
 		       whole, avg);
 	}
+
+	timeout_bench();
+
 	printk("fin\n");
 }
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+
+/* Timeout queue scaling benchmark: arms an increasing number of
+ * timeouts with pseudo-random durations directly through
+ * z_add_timeout(), then cancels them all in a different order with
+ * z_abort_timeout(), reporting the average cost of each operation.
+ * Compare CONFIG_TIMEOUT_QUEUE_DLIST against CONFIG_TIMEOUT_QUEUE_WHEEL.
+ */
+
+#define MAX_TIMEOUTS 2048
+
+static struct _timeout timeouts[MAX_TIMEOUTS];
+
+static const int counts[] = { 16, 64, 256, 1024, MAX_TIMEOUTS };
+
+static void dummy_fn(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+}
+
+static uint32_t rand_state = 1U;
+
+static uint32_t next_rand(void)
+{
+	/* Numerical Recipes LCG, good enough to scatter durations */
+	rand_state = rand_state * 1664525U + 1013904223U;
+	return rand_state >> 8;
+}
+
+void timeout_bench(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(counts); i++) {
+		int n = counts[i];
+		uint32_t start, insert, cancel;
+
+		start = k_cycle_get_32();
+		for (int j = 0; j < n; j++) {
+			/* Far enough out not to expire while measuring */
+			k_ticks_t ticks = 10000 + (next_rand() % 1000000U);
+
+			z_add_timeout(&timeouts[j], dummy_fn, K_TICKS(ticks));
+		}
+		insert = k_cycle_get_32() - start;
+
+		/* Cancel odd entries then even ones, so removals hit
+		 * both ends and the middle of the queue
+		 */
+		start = k_cycle_get_32();
+		for (int j = 1; j < n; j += 2) {
+			z_abort_timeout(&timeouts[j]);
+		}
+		for (int j = 0; j < n; j += 2) {
+			z_abort_timeout(&timeouts[j]);
+		}
+		cancel = k_cycle_get_32() - start;
+
+		printk("timeouts %4d insert %6u cancel %6u (cycles/op)\n",
+		       n, insert / n, cancel / n);
+	}
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* Deadline scheduling benchmark.  A set of periodic tasks is run at
+ * increasing total utilization, once scheduled earliest deadline first
+ * (all tasks at one priority, ordered by k_thread_deadline_set()) and
+ * once rate monotonic (static priorities by period).  Each job sets its
+ * deadline to the end of its period, burns its execution budget and
+ * sleeps until its next release.  A job finishing after the end of its
+ * period is late; the kernel's own count comes from
+ * CONFIG_SCHED_DEADLINE_MISS.  The overhead is the runtime the tasks
+ * used outside of burning their budgets, i.e. the cost of waking,
+ * setting deadlines, sleeping and switching, per job.
+ */
+
+#define NUM_TASKS 4
+#define RUN_MS 1000
+#define STACK_SIZE 1024
+#define EDF_PRIO 4
+
+/* k_busy_wait() granularity of the budget burning loop */
+#define BURN_STEP_US 50
+
+/* Non-harmonic periods, so rate monotonic stops being feasible well
+ * below full utilization while EDF does not
+ */
+static const uint32_t period_ms[NUM_TASKS] = { 10, 20, 25, 50 };
+static const int util_pct[] = { 50, 70, 90, 100, 110 };
+
+struct task {
+	struct k_thread thread;
+	k_ticks_t period;
+	uint32_t budget;
+	uint32_t jobs;
+	uint32_t late;
+	uint64_t burnt;
+};
+
+static struct task tasks[NUM_TASKS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_TASKS, STACK_SIZE);
+
+static k_ticks_t start_tick;
+static volatile bool stop;
+static atomic_t handler_misses;
+
+static void miss_handler(struct k_thread *thread, void *data)
+{
+	ARG_UNUSED(thread);
+	ARG_UNUSED(data);
+
+	atomic_inc(&handler_misses);
+}
+
+static uint64_t runtime(void)
+{
+	k_thread_runtime_stats_t rt;
+
+	k_thread_runtime_stats_get(k_current_get(), &rt);
+
+	return rt.execution_cycles;
+}
+
+/* k_busy_wait() alone measures wall clock time, which would count time
+ * spent preempted against the budget.  Burn the budget in CPU time
+ * instead.
+ */
+static void burn(struct task *task)
+{
+	uint64_t start = runtime(), now = start;
+
+	while (now - start < task->budget) {
+		k_busy_wait(BURN_STEP_US);
+		now = runtime();
+	}
+
+	task->burnt += now - start;
+}
+
+static void task_entry(void *p1, void *p2, void *p3)
+{
+	struct task *task = p1;
+	k_ticks_t release = start_tick;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!stop) {
+		k_ticks_t deadline = release + task->period;
+
+		k_ticks_t left;
+
+		k_sleep(K_TIMEOUT_ABS_TICKS(release));
+
+		left = MAX(deadline - k_uptime_ticks(), 0);
+		k_thread_deadline_set(k_current_get(),
+				      (int)k_ticks_to_cyc_floor32(left));
+		burn(task);
+
+		if (k_uptime_ticks() > deadline) {
+			task->late++;
+		}
+		task->jobs++;
+		release = deadline;
+	}
+}
+
+static void run(bool edf, int util)
+{
+	k_thread_runtime_stats_t rt;
+	uint64_t burnt = 0U, used = 0U;
+	uint32_t jobs = 0U, late = 0U, kernel = 0U;
+
+	stop = false;
+	atomic_set(&handler_misses, 0);
+	start_tick = k_uptime_ticks() + k_ms_to_ticks_ceil64(10);
+
+	for (int i = 0; i < NUM_TASKS; i++) {
+		struct task *task = &tasks[i];
+
+		/* Every task gets an equal share of the utilization */
+		task->period = k_ms_to_ticks_ceil64(period_ms[i]);
+		task->budget = k_us_to_cyc_floor32(period_ms[i] * 1000U *
+						   util / 100U / NUM_TASKS);
+		task->jobs = 0U;
+		task->late = 0U;
+		task->burnt = 0U;
+
+		k_thread_create(&task->thread, stacks[i], STACK_SIZE,
+				task_entry, task, NULL, NULL,
+				edf ? EDF_PRIO : EDF_PRIO - NUM_TASKS + i,
+				0, K_FOREVER);
+		k_thread_deadline_miss_handler_set(&task->thread,
+						   miss_handler, NULL);
+		k_thread_start(&task->thread);
+	}
+
+	k_msleep(RUN_MS);
+	stop = true;
+
+	for (int i = 0; i < NUM_TASKS; i++) {
+		struct task *task = &tasks[i];
+
+		/* Overloaded sets may never get back to the stop check */
+		if (k_thread_join(&task->thread, K_MSEC(RUN_MS)) != 0) {
+			k_thread_abort(&task->thread);
+		}
+
+		k_thread_runtime_stats_get(&task->thread, &rt);
+		used += rt.execution_cycles;
+		burnt += task->burnt;
+		jobs += task->jobs;
+		late += task->late;
+		kernel += k_thread_deadline_misses_get(&task->thread);
+	}
+
+	__ASSERT(kernel == (uint32_t)atomic_get(&handler_misses),
+		 "miss handler calls don't match the miss counters");
+
+	printk("%s util %3d%% jobs %u missed %u (kernel %u) miss %u.%u%% overhead %u cycles/job\n",
+	       edf ? "edf" : "rm", util, jobs, late, kernel,
+	       jobs == 0U ? 0U : late * 100U / jobs,
+	       jobs == 0U ? 0U : late * 1000U / jobs % 10U,
+	       (jobs == 0U || used < burnt) ? 0U :
+	       (uint32_t)((used - burnt) / jobs));
+}
+
+void main(void)
+{
+	/* Main runs cooperatively above the tasks so it always gets the
+	 * CPU back when its measurement window ends.
+	 */
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(0));
+
+	for (int i = 0; i < ARRAY_SIZE(util_pct); i++) {
+		run(true, util_pct[i]);
+		run(false, util_pct[i]);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* SMP scheduler scaling benchmark.  For an increasing number of CPUs,
+ * pairs of threads restricted to those CPUs wake each other through
+ * semaphores as fast as they can.  The waker stamps the cycle counter
+ * before giving, the woken thread accumulates the latency, and the
+ * total number of wakeups over a fixed window gives the switch rate.
+ */
+
+#define MAX_PAIRS CONFIG_MP_NUM_CPUS
+#define RUN_MS 1000
+#define STACK_SIZE 1024
+#define WORKER_PRIO 5
+
+struct pair {
+	struct k_sem sem[2];
+	uint32_t stamp;
+	uint32_t wakeups;
+	uint64_t latency;
+	struct k_thread threads[2];
+};
+
+static struct pair pairs[MAX_PAIRS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, 2 * MAX_PAIRS, STACK_SIZE);
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	struct pair *pair = p1;
+	int me = POINTER_TO_INT(p2);
+	int other = !me;
+
+	ARG_UNUSED(p3);
+
+	if (me == 0) {
+		pair->stamp = k_cycle_get_32();
+		k_sem_give(&pair->sem[other]);
+	}
+
+	while (true) {
+		k_sem_take(&pair->sem[me], K_FOREVER);
+		pair->latency += k_cycle_get_32() - pair->stamp;
+		pair->wakeups++;
+
+		pair->stamp = k_cycle_get_32();
+		k_sem_give(&pair->sem[other]);
+	}
+}
+
+static void run(int ncpus)
+{
+	uint32_t wakeups = 0U;
+	uint64_t latency = 0U;
+
+	for (int i = 0; i < ncpus; i++) {
+		struct pair *pair = &pairs[i];
+
+		pair->wakeups = 0U;
+		pair->latency = 0U;
+
+		for (int j = 0; j < 2; j++) {
+			struct k_thread *th = &pair->threads[j];
+
+			k_sem_init(&pair->sem[j], 0, 1);
+			k_thread_create(th, stacks[2 * i + j], STACK_SIZE,
+					worker, pair, INT_TO_POINTER(j), NULL,
+					WORKER_PRIO, 0, K_FOREVER);
+
+			k_thread_cpu_mask_clear(th);
+			for (int cpu = 0; cpu < ncpus; cpu++) {
+				k_thread_cpu_mask_enable(th, cpu);
+			}
+		}
+	}
+
+	for (int i = 0; i < ncpus; i++) {
+		k_thread_start(&pairs[i].threads[1]);
+		k_thread_start(&pairs[i].threads[0]);
+	}
+
+	k_msleep(RUN_MS);
+
+	for (int i = 0; i < ncpus; i++) {
+		k_thread_abort(&pairs[i].threads[0]);
+		k_thread_abort(&pairs[i].threads[1]);
+		wakeups += pairs[i].wakeups;
+		latency += pairs[i].latency;
+	}
+
+	printk("cpus %d threads %d switches/s %u wake %u (cycles)\n",
+	       ncpus, 2 * ncpus, (uint32_t)(wakeups * 1000ULL / RUN_MS),
+	       wakeups == 0U ? 0U : (uint32_t)(latency / wakeups));
+}
+
+void main(void)
+{
+	/* Main runs cooperatively above the workers so it always gets
+	 * back a CPU when its measurement window ends.
+	 */
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(0));
+
+	for (int ncpus = 1; ncpus <= CONFIG_MP_NUM_CPUS; ncpus++) {
+		run(ncpus);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* Socket churn benchmark.  Each round connects a TCP client to a
+ * listening socket over the loopback interface, accepts the connection
+ * and closes both ends, so every round allocates and frees two file
+ * descriptors and looks them up on each call.  Rounds are timed with a
+ * number of other descriptors held open to show how the cost depends
+ * on the occupancy of the descriptor table.
+ */
+
+#define SERVER_PORT 4242
+#define ROUNDS 64
+#define MAX_IDLE 8
+
+static int idle[MAX_IDLE];
+
+static void churn(int server, const struct sockaddr_in6 *addr)
+{
+	struct sockaddr_in6 peer;
+	socklen_t peer_len = sizeof(peer);
+	int client, conn, ret;
+
+	client = socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	__ASSERT(client >= 0, "socket() failed %d", errno);
+
+	ret = connect(client, (const struct sockaddr *)addr, sizeof(*addr));
+	__ASSERT(ret == 0, "connect() failed %d", errno);
+	ARG_UNUSED(ret);
+
+	conn = accept(server, (struct sockaddr *)&peer, &peer_len);
+	__ASSERT(conn >= 0, "accept() failed %d", errno);
+
+	close(conn);
+	close(client);
+}
+
+static void run(int server, const struct sockaddr_in6 *addr, int open_fds)
+{
+	uint32_t start, cycles;
+
+	for (int i = 0; i < open_fds; i++) {
+		idle[i] = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+		__ASSERT(idle[i] >= 0, "socket() failed %d", errno);
+	}
+
+	start = k_cycle_get_32();
+	for (int r = 0; r < ROUNDS; r++) {
+		churn(server, addr);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	printk("churn    open fds %2d rounds %4u cycles/round %8u\n",
+	       open_fds, ROUNDS, cycles / ROUNDS);
+
+	for (int i = 0; i < open_fds; i++) {
+		close(idle[i]);
+	}
+}
+
+void main(void)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(SERVER_PORT),
+	};
+	int server, ret;
+
+	inet_pton(AF_INET6, CONFIG_NET_CONFIG_MY_IPV6_ADDR, &addr.sin6_addr);
+
+	server = socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	__ASSERT(server >= 0, "socket() failed %d", errno);
+
+	ret = bind(server, (struct sockaddr *)&addr, sizeof(addr));
+	__ASSERT(ret == 0, "bind() failed %d", errno);
+
+	ret = listen(server, 2);
+	__ASSERT(ret == 0, "listen() failed %d", errno);
+	ARG_UNUSED(ret);
+
+	run(server, &addr, 0);
+	run(server, &addr, MAX_IDLE / 2);
+	run(server, &addr, MAX_IDLE);
+
+	close(server);
+
+	printk("fin\n");
+}
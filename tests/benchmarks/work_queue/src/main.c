@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* Work queue pool benchmark.  Batches of independent work items are
+ * submitted to a single-threaded queue and to a pool with one worker
+ * per CPU, and the time to drain each batch is measured.
+ */
+
+#define POOL_WORKERS MAX(CONFIG_MP_NUM_CPUS, 2)
+#define BATCH 64
+#define ROUNDS 64
+#define HEAVY_US 20
+#define STACK_SIZE 1024
+#define WORKER_PRIO 5
+
+static K_THREAD_STACK_DEFINE(single_stack, STACK_SIZE);
+static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks, POOL_WORKERS, STACK_SIZE);
+static struct k_work_q_worker pool_workers[POOL_WORKERS - 1];
+static struct k_work_q single_queue;
+static struct k_work_q pool_queue;
+
+static struct k_work items[BATCH];
+static atomic_t count;
+
+static void light_handler(struct k_work *work)
+{
+	atomic_inc(&count);
+}
+
+static void heavy_handler(struct k_work *work)
+{
+	k_busy_wait(HEAVY_US);
+	atomic_inc(&count);
+}
+
+static void run(struct k_work_q *queue, int nworkers,
+		k_work_handler_t handler, const char *label)
+{
+	uint32_t start, cycles;
+	uint32_t nitems = BATCH * ROUNDS;
+
+	for (int i = 0; i < BATCH; i++) {
+		k_work_init(&items[i], handler);
+	}
+	atomic_clear(&count);
+
+	start = k_cycle_get_32();
+	for (int r = 0; r < ROUNDS; r++) {
+		for (int i = 0; i < BATCH; i++) {
+			k_work_submit_to_queue(queue, &items[i]);
+		}
+		k_work_queue_drain(queue, false);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	if (atomic_get(&count) != nitems) {
+		printk("lost items: %ld of %u\n", atomic_get(&count), nitems);
+	}
+
+	printk("workers %2d items %5u cycles/item %6u (%s)\n",
+	       nworkers, nitems, cycles / nitems, label);
+}
+
+void main(void)
+{
+	/* Submit from a higher priority than the workers, so batches
+	 * are queued before they get processed.
+	 */
+	k_thread_priority_set(k_current_get(), WORKER_PRIO - 1);
+
+	k_work_queue_start(&single_queue, single_stack,
+			   K_THREAD_STACK_SIZEOF(single_stack),
+			   WORKER_PRIO, NULL);
+
+	k_work_queue_start(&pool_queue, pool_stacks[0],
+			   K_THREAD_STACK_SIZEOF(pool_stacks[0]),
+			   WORKER_PRIO, NULL);
+	for (int i = 0; i < POOL_WORKERS - 1; i++) {
+		k_work_queue_worker_add(&pool_queue, &pool_workers[i],
+					pool_stacks[i + 1],
+					K_THREAD_STACK_SIZEOF(pool_stacks[i + 1]),
+					WORKER_PRIO, -1);
+	}
+
+	run(&single_queue, 1, light_handler, "light");
+	run(&pool_queue, POOL_WORKERS, light_handler, "light");
+	run(&single_queue, 1, heavy_handler, "heavy");
+	run(&pool_queue, POOL_WORKERS, heavy_handler, "heavy");
+
+	printk("fin\n");
+}
@@ -475,6 +475,78 @@ void alloc_and_free_interval(void)
 	}
 }
 
+/* Reference first fit, testing one bit at a time */
+static int first_fit(sys_bitarray_t *ba, size_t num_bits, size_t *offset)
+{
+	size_t run = 0;
+
+	for (size_t bit = 0; bit < ba->num_bits; bit++) {
+		if (ba->bundles[bit / 32] & BIT(bit % 32)) {
+			run = 0;
+			continue;
+		}
+
+		if (++run == num_bits) {
+			*offset = bit + 1 - num_bits;
+			return 0;
+		}
+	}
+
+	return -ENOSPC;
+}
+
+void alloc_and_free_first_fit(void)
+{
+	int ret, expected_ret;
+	size_t offset, expected_offset;
+	uint32_t state = 1U;
+
+	/* Not a multiple of the bundle size, so the last bundle is
+	 * partially used
+	 */
+	SYS_BITARRAY_DEFINE(ba, 200);
+
+	printk("Testing bit array first fit on fragmented bits\n");
+
+	for (int round = 0; round < 16; round++) {
+		/* Each round thins out a random pattern a bit more */
+		for (int i = 0; i < ba.num_bundles; i++) {
+			state = state * 1103515245U + 12345U;
+			ba.bundles[i] = state;
+			for (int j = 0; j < round / 4; j++) {
+				state = state * 1103515245U + 12345U;
+				ba.bundles[i] &= state;
+			}
+		}
+
+		for (size_t num_bits = 1; num_bits <= ba.num_bits; num_bits++) {
+			expected_ret = first_fit(&ba, num_bits,
+						 &expected_offset);
+			ret = sys_bitarray_alloc(&ba, num_bits, &offset);
+			zassert_equal(ret, expected_ret,
+				      "alloc %zu bits returned %d (round %d)",
+				      num_bits, ret, round);
+			if (ret != 0) {
+				continue;
+			}
+
+			zassert_equal(offset, expected_offset,
+				      "alloc %zu bits at %zu, expected %zu",
+				      num_bits, offset, expected_offset);
+			ret = sys_bitarray_free(&ba, num_bits, offset);
+			zassert_equal(ret, 0, "free failed (%d)", ret);
+		}
+	}
+
+	/* A region ending at the last bit */
+	memset(ba.bundles, 0xff, ba.num_bundles * sizeof(ba.bundles[0]));
+	ba.bundles[ba.num_bundles - 1] = ~(uint32_t)BIT_MASK(8);
+	ba.bundles[ba.num_bundles - 2] = BIT_MASK(16);
+	ret = sys_bitarray_alloc(&ba, 24, &offset);
+	zassert_equal(ret, 0, "alloc at the end failed (%d)", ret);
+	zassert_equal(offset, 176, "allocated at %zu", offset);
+}
+
 /**
  * @brief Test bitarrays allocation and free
  *
@@ -500,6 +572,8 @@ void test_bitarray_alloc_free(void)
 	}
 
 	alloc_and_free_interval();
+
+	alloc_and_free_first_fit();
 }
 
 void test_bitarray_region_set_clear(void)
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_msgq.h"
+
+#define BULK_LEN 8
+
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+static struct k_msgq bulk_msgq;
+static char __aligned(4) bulk_buffer[MSG_SIZE * BULK_LEN];
+static uint32_t rx_data[BULK_LEN];
+static volatile int pend_ret;
+
+static void fill(uint32_t *msgs, int num, uint32_t first)
+{
+	for (int i = 0; i < num; i++) {
+		msgs[i] = first + i;
+	}
+}
+
+static void check(const uint32_t *msgs, int num, uint32_t first)
+{
+	for (int i = 0; i < num; i++) {
+		zassert_equal(msgs[i], first + i, "message %d is %u", i,
+			      msgs[i]);
+	}
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test sending and receiving several messages at once
+ * @see k_msgq_put_many(), k_msgq_get_many()
+ */
+void test_msgq_put_get_many(void)
+{
+	uint32_t tx[BULK_LEN + 2];
+
+	k_msgq_init(&bulk_msgq, bulk_buffer, MSG_SIZE, BULK_LEN);
+	fill(tx, ARRAY_SIZE(tx), 100);
+
+	zassert_equal(k_msgq_put_many(&bulk_msgq, tx, 0, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_msgq_get_many(&bulk_msgq, rx_data, 4, K_NO_WAIT),
+		      -ENOMSG, NULL);
+
+	/* Only the free space is filled */
+	zassert_equal(k_msgq_put_many(&bulk_msgq, tx, 5, K_NO_WAIT), 5, NULL);
+	zassert_equal(k_msgq_put_many(&bulk_msgq, &tx[5], 5, K_NO_WAIT), 3,
+		      NULL);
+	zassert_equal(k_msgq_put_many(&bulk_msgq, tx, 1, K_NO_WAIT), -ENOMSG,
+		      NULL);
+	zassert_equal(k_msgq_num_used_get(&bulk_msgq), BULK_LEN, NULL);
+
+	/* Messages come out in order, also across the buffer end */
+	zassert_equal(k_msgq_get_many(&bulk_msgq, rx_data, 6, K_NO_WAIT), 6,
+		      NULL);
+	check(rx_data, 6, 100);
+	zassert_equal(k_msgq_put_many(&bulk_msgq, &tx[8], 2, K_NO_WAIT), 2,
+		      NULL);
+	zassert_equal(k_msgq_get_many(&bulk_msgq, rx_data, BULK_LEN,
+				      K_NO_WAIT), 4, NULL);
+	check(rx_data, 4, 106);
+	zassert_equal(k_msgq_num_used_get(&bulk_msgq), 0, NULL);
+}
+
+static void get_many_entry(void *p1, void *p2, void *p3)
+{
+	pend_ret = k_msgq_get_many(&bulk_msgq, rx_data, BULK_LEN, TIMEOUT);
+}
+
+static void put_many_entry(void *p1, void *p2, void *p3)
+{
+	static uint32_t tx[2] = { 200, 201 };
+
+	pend_ret = k_msgq_put_many(&bulk_msgq, tx, ARRAY_SIZE(tx), TIMEOUT);
+}
+
+/**
+ * @brief Test waiting to send or receive several messages
+ * @details A receiver waiting on an empty queue gets the first of the
+ * messages sent at once, the others are queued.  A sender waiting on a
+ * full queue gets its first message queued when space is freed.
+ * @see k_msgq_put_many(), k_msgq_get_many()
+ */
+void test_msgq_many_pend(void)
+{
+	uint32_t tx[BULK_LEN + 1];
+
+	k_msgq_init(&bulk_msgq, bulk_buffer, MSG_SIZE, BULK_LEN);
+	fill(tx, ARRAY_SIZE(tx), 0);
+
+	k_thread_create(&tdata, tstack, STACK_SIZE, get_many_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_msleep(TIMEOUT_MS / 2);
+	zassert_equal(k_msgq_put_many(&bulk_msgq, tx, 3, K_NO_WAIT), 3, NULL);
+	k_thread_join(&tdata, K_FOREVER);
+	zassert_equal(pend_ret, 1, NULL);
+	zassert_equal(rx_data[0], 0, NULL);
+	zassert_equal(k_msgq_num_used_get(&bulk_msgq), 2, NULL);
+
+	/* Fill it up and wait to send more */
+	zassert_equal(k_msgq_put_many(&bulk_msgq, &tx[3], BULK_LEN - 2,
+				      K_NO_WAIT), BULK_LEN - 2, NULL);
+	k_thread_create(&tdata, tstack, STACK_SIZE, put_many_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_msleep(TIMEOUT_MS / 2);
+	zassert_equal(k_msgq_get_many(&bulk_msgq, rx_data, 2, K_NO_WAIT), 2,
+		      NULL);
+	check(rx_data, 2, 1);
+	k_thread_join(&tdata, K_FOREVER);
+	zassert_equal(pend_ret, 1, NULL);
+	zassert_equal(k_msgq_num_used_get(&bulk_msgq), BULK_LEN - 1, NULL);
+
+	zassert_equal(k_msgq_get_many(&bulk_msgq, rx_data, BULK_LEN,
+				      K_NO_WAIT), BULK_LEN - 1, NULL);
+	check(rx_data, BULK_LEN - 2, 3);
+	zassert_equal(rx_data[BULK_LEN - 2], 200, NULL);
+
+	/* Nothing to wait for */
+	zassert_equal(k_msgq_get_many(&bulk_msgq, rx_data, 1, K_MSEC(1)),
+		      -EAGAIN, NULL);
+}
+
+/**
+ * @brief Test writing and reading messages in place
+ * @see k_msgq_put_claim(), k_msgq_put_finish(), k_msgq_get_claim(),
+ * k_msgq_get_finish()
+ */
+void test_msgq_claim(void)
+{
+	uint32_t *msgs;
+	uint32_t msg;
+
+	k_msgq_init(&bulk_msgq, bulk_buffer, MSG_SIZE, BULK_LEN);
+
+	zassert_equal(k_msgq_put_claim(&bulk_msgq, (void **)&msgs, 6), 6, NULL);
+	zassert_equal(k_msgq_put_claim(&bulk_msgq, (void **)&msgs, 6), -EBUSY,
+		      NULL);
+	zassert_equal(k_msgq_put(&bulk_msgq, &msg, K_NO_WAIT), -EBUSY, NULL);
+	fill(msgs, 6, 10);
+	zassert_equal(k_msgq_put_finish(&bulk_msgq, 7), -EINVAL, NULL);
+
+	/* Commit fewer than claimed, the rest of the claim is released */
+	zassert_equal(k_msgq_put_finish(&bulk_msgq, 5), 0, NULL);
+	zassert_equal(k_msgq_num_used_get(&bulk_msgq), 5, NULL);
+	zassert_equal(k_msgq_get(&bulk_msgq, &msg, K_NO_WAIT), 0, NULL);
+	zassert_equal(msg, 10, NULL);
+
+	/* Claims stop at the end of the buffer */
+	zassert_equal(k_msgq_put_claim(&bulk_msgq, (void **)&msgs, BULK_LEN),
+		      BULK_LEN - 5, NULL);
+	fill(msgs, BULK_LEN - 5, 15);
+	zassert_equal(k_msgq_put_finish(&bulk_msgq, BULK_LEN - 5), 0, NULL);
+	zassert_equal(k_msgq_put_claim(&bulk_msgq, (void **)&msgs, BULK_LEN),
+		      1, NULL);
+	zassert_equal_ptr(msgs, bulk_buffer, NULL);
+	zassert_equal(k_msgq_put_finish(&bulk_msgq, 0), 0, NULL);
+
+	zassert_equal(k_msgq_get_claim(&bulk_msgq, (void **)&msgs, BULK_LEN),
+		      BULK_LEN - 1, NULL);
+	check(msgs, BULK_LEN - 1, 11);
+	zassert_equal(k_msgq_get(&bulk_msgq, &msg, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_get_finish(&bulk_msgq, BULK_LEN), -EINVAL, NULL);
+	zassert_equal(k_msgq_get_finish(&bulk_msgq, 3), 0, NULL);
+	zassert_equal(k_msgq_num_used_get(&bulk_msgq), 4, NULL);
+	zassert_equal(k_msgq_get(&bulk_msgq, &msg, K_NO_WAIT), 0, NULL);
+	zassert_equal(msg, 14, NULL);
+
+	/* Purging drops a claim */
+	zassert_equal(k_msgq_get_claim(&bulk_msgq, (void **)&msgs, 1), 1, NULL);
+	k_msgq_purge(&bulk_msgq);
+	zassert_equal(k_msgq_get_finish(&bulk_msgq, 1), -EINVAL, NULL);
+	zassert_equal(k_msgq_get_claim(&bulk_msgq, (void **)&msgs, 1), 0, NULL);
+}
+
+static void get_entry(void *p1, void *p2, void *p3)
+{
+	pend_ret = k_msgq_get(&bulk_msgq, rx_data, TIMEOUT);
+}
+
+/**
+ * @brief Test that messages written in place reach waiting receivers
+ * @see k_msgq_put_claim(), k_msgq_put_finish()
+ */
+void test_msgq_claim_pend(void)
+{
+	uint32_t *msgs;
+
+	k_msgq_init(&bulk_msgq, bulk_buffer, MSG_SIZE, BULK_LEN);
+
+	k_thread_create(&tdata, tstack, STACK_SIZE, get_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_msleep(TIMEOUT_MS / 2);
+
+	zassert_equal(k_msgq_put_claim(&bulk_msgq, (void **)&msgs, 2), 2, NULL);
+	fill(msgs, 2, 300);
+	zassert_equal(k_msgq_put_finish(&bulk_msgq, 2), 0, NULL);
+	k_thread_join(&tdata, K_FOREVER);
+
+	zassert_equal(pend_ret, 0, NULL);
+	zassert_equal(rx_data[0], 300, NULL);
+	zassert_equal(k_msgq_num_used_get(&bulk_msgq), 1, NULL);
+}
+
+/**
+ * @}
+ */
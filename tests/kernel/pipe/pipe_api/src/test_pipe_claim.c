@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Tests for writing and reading pipe data in place
+ * @ingroup kernel_pipe_tests
+ * @{
+ */
+
+#include <ztest.h>
+
+#define CLAIM_PIPE_SIZE 16
+#define CLAIM_STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define CLAIM_TIMEOUT K_MSEC(100)
+
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+
+static unsigned char __aligned(4) claim_buffer[CLAIM_PIPE_SIZE];
+static struct k_pipe claim_pipe;
+static unsigned char rx_data[CLAIM_PIPE_SIZE];
+static size_t rx_bytes;
+static volatile int rx_ret;
+
+/**
+ * @brief Claimed space is contiguous and written on finish
+ *
+ * @see k_pipe_put_claim(), k_pipe_put_finish(), k_pipe_get_claim(),
+ * k_pipe_get_finish()
+ */
+void test_pipe_claim(void)
+{
+	unsigned char *data;
+	unsigned char byte = 0;
+	size_t bytes;
+
+	k_pipe_init(&claim_pipe, claim_buffer, sizeof(claim_buffer));
+
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, 10), 10, NULL);
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, 10), -EBUSY, NULL);
+	zassert_equal(k_pipe_put(&claim_pipe, &byte, 1, &bytes, 0, K_NO_WAIT),
+		      -EBUSY, NULL);
+	memcpy(data, "0123456789", 10);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 11), -EINVAL, NULL);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 10), 0, NULL);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 10, NULL);
+
+	zassert_equal(k_pipe_get(&claim_pipe, rx_data, 4, &bytes, 4,
+				 K_NO_WAIT), 0, NULL);
+	zassert_mem_equal(rx_data, "0123", 4, NULL);
+
+	/* Claims stop at the end of the buffer */
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, CLAIM_PIPE_SIZE),
+		      CLAIM_PIPE_SIZE - 10, NULL);
+	memcpy(data, "abcdef", CLAIM_PIPE_SIZE - 10);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, CLAIM_PIPE_SIZE - 10), 0,
+		      NULL);
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, CLAIM_PIPE_SIZE), 4,
+		      NULL);
+	zassert_equal_ptr(data, claim_buffer, NULL);
+	memcpy(data, "ABCD", 4);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 4), 0, NULL);
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, 1), 0, "pipe full");
+
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &data, CLAIM_PIPE_SIZE),
+		      CLAIM_PIPE_SIZE - 4, NULL);
+	zassert_mem_equal(data, "456789abcdef", CLAIM_PIPE_SIZE - 4, NULL);
+	zassert_equal(k_pipe_get(&claim_pipe, rx_data, 1, &bytes, 0,
+				 K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_pipe_get_finish(&claim_pipe, CLAIM_PIPE_SIZE), -EINVAL,
+		      NULL);
+	zassert_equal(k_pipe_get_finish(&claim_pipe, CLAIM_PIPE_SIZE - 4), 0,
+		      NULL);
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &data, CLAIM_PIPE_SIZE), 4,
+		      NULL);
+	zassert_mem_equal(data, "ABCD", 4, NULL);
+
+	/* Flushing drops a claim */
+	k_pipe_flush(&claim_pipe);
+	zassert_equal(k_pipe_get_finish(&claim_pipe, 4), -EINVAL, NULL);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0, NULL);
+}
+
+static void reader_entry(void *p1, void *p2, void *p3)
+{
+	rx_ret = k_pipe_get(&claim_pipe, rx_data, 6, &rx_bytes, 6,
+			    CLAIM_TIMEOUT);
+}
+
+static void writer_entry(void *p1, void *p2, void *p3)
+{
+	static unsigned char tx[] = "wxyz";
+
+	rx_ret = k_pipe_put(&claim_pipe, tx, 4, &rx_bytes, 4, CLAIM_TIMEOUT);
+}
+
+/**
+ * @brief Data written or consumed in place unblocks waiting threads
+ *
+ * @see k_pipe_put_finish(), k_pipe_get_finish()
+ */
+void test_pipe_claim_pend(void)
+{
+	unsigned char *data;
+
+	k_pipe_init(&claim_pipe, claim_buffer, sizeof(claim_buffer));
+
+	k_thread_create(&tdata, tstack, CLAIM_STACK_SIZE, reader_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_msleep(10);
+
+	/* A partial write doesn't complete the reader's request */
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, 4), 4, NULL);
+	memcpy(data, "0123", 4);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 4), 0, NULL);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0, NULL);
+
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, 4), 4, NULL);
+	memcpy(data, "4567", 4);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 4), 0, NULL);
+	k_thread_join(&tdata, K_FOREVER);
+
+	zassert_equal(rx_ret, 0, NULL);
+	zassert_equal(rx_bytes, 6, NULL);
+	zassert_mem_equal(rx_data, "012345", 6, NULL);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 2, NULL);
+
+	/* Fill the pipe and have a writer wait for space */
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, CLAIM_PIPE_SIZE),
+		      CLAIM_PIPE_SIZE - 8, NULL);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, CLAIM_PIPE_SIZE - 8), 0,
+		      NULL);
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, CLAIM_PIPE_SIZE), 6,
+		      NULL);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 6), 0, NULL);
+	zassert_equal(k_pipe_write_avail(&claim_pipe), 0, NULL);
+
+	k_thread_create(&tdata, tstack, CLAIM_STACK_SIZE, writer_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_msleep(10);
+
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &data, 4), 4, NULL);
+	zassert_mem_equal(data, "67", 2, NULL);
+	zassert_equal(k_pipe_get_finish(&claim_pipe, 4), 0, NULL);
+	k_thread_join(&tdata, K_FOREVER);
+
+	zassert_equal(rx_ret, 0, NULL);
+	zassert_equal(rx_bytes, 4, NULL);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), CLAIM_PIPE_SIZE, NULL);
+}
+
+/**
+ * @}
+ */
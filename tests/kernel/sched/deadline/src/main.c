@@ -211,11 +211,137 @@ void test_unqueued(void)
 	}
 }
 
+static volatile bool later_ran;
+static volatile bool later_ran_first;
+
+void earlier_worker(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	/* Push our deadline past the other thread's: it must take over
+	 * right away, before we get to look at the flag.
+	 */
+	k_thread_deadline_set(k_current_get(), k_ms_to_cyc_ceil32(200));
+	later_ran_first = later_ran;
+}
+
+void later_worker(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	later_ran = true;
+}
+
+/**
+ * @brief Validate that pushing out a deadline reschedules
+ *
+ * @details Start two threads at the same priority.  The one with the
+ * earlier deadline runs first and sets its own deadline after the other
+ * thread's, which must then preempt it immediately.
+ *
+ * @ingroup kernel_sched_tests
+ */
+void test_deadline_set_preempt(void)
+{
+	later_ran = false;
+	later_ran_first = false;
+
+	worker_tids[0] = k_thread_create(&worker_threads[0],
+			worker_stacks[0], STACK_SIZE,
+			earlier_worker, NULL, NULL, NULL,
+			K_LOWEST_APPLICATION_THREAD_PRIO,
+			0, K_FOREVER);
+	worker_tids[1] = k_thread_create(&worker_threads[1],
+			worker_stacks[1], STACK_SIZE,
+			later_worker, NULL, NULL, NULL,
+			K_LOWEST_APPLICATION_THREAD_PRIO,
+			0, K_FOREVER);
+
+	k_thread_deadline_set(worker_tids[0], k_ms_to_cyc_ceil32(10));
+	k_thread_deadline_set(worker_tids[1], k_ms_to_cyc_ceil32(100));
+	k_thread_start(worker_tids[0]);
+	k_thread_start(worker_tids[1]);
+
+	k_sleep(K_MSEC(50));
+
+	zassert_true(later_ran, "later deadline thread did not run");
+	zassert_true(later_ran_first,
+		     "deadline pushed out without preemption");
+
+	k_thread_abort(worker_tids[0]);
+	k_thread_abort(worker_tids[1]);
+}
+
+#ifdef CONFIG_SCHED_DEADLINE_MISS
+static int miss_calls;
+
+static void miss_handler(struct k_thread *thread, void *data)
+{
+	zassert_equal(thread, k_current_get(), "wrong thread");
+	zassert_equal(data, &miss_calls, "wrong handler data");
+	miss_calls++;
+}
+#endif
+
+/**
+ * @brief Validate deadline miss accounting
+ *
+ * @details Running past a deadline and then blocking counts one miss
+ * and calls the handler once.  Blocking before the deadline meets it,
+ * even if the thread wakes up again after it has expired.
+ *
+ * @ingroup kernel_sched_tests
+ */
+void test_deadline_miss(void)
+{
+#ifdef CONFIG_SCHED_DEADLINE_MISS
+	k_tid_t self = k_current_get();
+	uint32_t misses = k_thread_deadline_misses_get(self);
+
+	miss_calls = 0;
+	k_thread_deadline_miss_handler_set(self, miss_handler, &miss_calls);
+
+	/* Overrun: busy past the deadline, then block */
+	k_thread_deadline_set(self, k_us_to_cyc_ceil32(1000));
+	k_busy_wait(5000);
+	k_sleep(K_MSEC(1));
+	zassert_equal(k_thread_deadline_misses_get(self), misses + 1,
+		      "overrun not counted");
+	zassert_equal(miss_calls, 1, "handler not called once");
+
+	/* Still only one miss per deadline */
+	k_busy_wait(5000);
+	k_sleep(K_MSEC(1));
+	zassert_equal(k_thread_deadline_misses_get(self), misses + 1,
+		      "expired deadline counted twice");
+
+	/* Met: block early, keep running after the deadline expired */
+	k_thread_deadline_set(self, k_us_to_cyc_ceil32(10000));
+	k_sleep(K_MSEC(1));
+	k_sleep(K_MSEC(20));
+	k_busy_wait(5000);
+	k_sleep(K_MSEC(1));
+	zassert_equal(k_thread_deadline_misses_get(self), misses + 1,
+		      "met deadline counted as missed");
+	zassert_equal(miss_calls, 1, "handler called for met deadline");
+
+	k_thread_deadline_miss_handler_set(self, NULL, NULL);
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(suite_deadline,
 			 ztest_unit_test(test_deadline),
 			 ztest_unit_test(test_yield),
-			 ztest_unit_test(test_unqueued));
+			 ztest_unit_test(test_unqueued),
+			 ztest_unit_test(test_deadline_set_preempt),
+			 ztest_unit_test(test_deadline_miss));
 	ztest_run_test_suite(suite_deadline);
 }
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+
+#define NUM_WAKES 16
+#define NUM_QUEUED 4
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACK_SIZE)
+
+#define MAIN_PRIO K_PRIO_PREEMPT(5)
+#define HI_PRIO K_PRIO_PREEMPT(1)
+#define LO_PRIO K_PRIO_PREEMPT(8)
+
+static struct k_thread hi_thread;
+static K_THREAD_STACK_DEFINE(hi_stack, STACK_SIZE);
+
+static struct k_thread lo_threads[NUM_QUEUED];
+static K_THREAD_STACK_ARRAY_DEFINE(lo_stacks, NUM_QUEUED, STACK_SIZE);
+
+static K_SEM_DEFINE(wake_sem, 0, 1);
+static volatile int wakes;
+
+static uint32_t hist_sum(const struct k_sched_hist *hist)
+{
+	uint32_t sum = 0;
+
+	for (int i = 0; i < CONFIG_SCHED_STATS_BUCKETS; i++) {
+		sum += hist->bucket[i];
+	}
+
+	return sum;
+}
+
+static void hi_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&wake_sem, K_FOREVER);
+		wakes++;
+	}
+}
+
+static void lo_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+}
+
+/* Start the high priority waiter and let it block on the semaphore */
+static void start_waiter(void)
+{
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	k_thread_create(&hi_thread, hi_stack, STACK_SIZE, hi_entry,
+			NULL, NULL, NULL, HI_PRIO, 0, K_NO_WAIT);
+	wakes = 0;
+}
+
+/**
+ * @brief Each wakeup of a higher priority thread is counted once
+ *
+ * @details Wake a blocked thread NUM_WAKES times.  Every wakeup must
+ * add exactly one wake latency sample and one run time sample to the
+ * woken thread, and preempt the waker each time.
+ */
+void test_thread_wake_latency(void)
+{
+	struct k_thread_sched_stats hi_stats, main_stats;
+
+	if (!IS_ENABLED(CONFIG_SCHED_STATS_THREAD)) {
+		ztest_test_skip();
+	}
+
+	start_waiter();
+
+	/* Let it block the first time before measuring */
+	k_msleep(1);
+	zassert_ok(k_thread_sched_stats_reset(&hi_thread), NULL);
+	zassert_ok(k_thread_sched_stats_reset(k_current_get()), NULL);
+
+	for (int i = 0; i < NUM_WAKES; i++) {
+		k_sem_give(&wake_sem);
+	}
+	zassert_equal(wakes, NUM_WAKES, "waiter didn't preempt");
+
+	zassert_ok(k_thread_sched_stats_get(&hi_thread, &hi_stats), NULL);
+	zassert_ok(k_thread_sched_stats_get(k_current_get(), &main_stats),
+		   NULL);
+
+	zassert_equal(hi_stats.switches, NUM_WAKES, NULL);
+	zassert_equal(hist_sum(&hi_stats.wake_latency), NUM_WAKES, NULL);
+	zassert_equal(hist_sum(&hi_stats.run_time), NUM_WAKES, NULL);
+	zassert_equal(hi_stats.preemptions, 0, "blocking isn't preemption");
+
+	zassert_equal(main_stats.preemptions, NUM_WAKES, NULL);
+	zassert_equal(main_stats.switches, NUM_WAKES, NULL);
+	zassert_equal(hist_sum(&main_stats.wake_latency), 0,
+		      "preempted thread was never woken");
+
+	k_thread_abort(&hi_thread);
+}
+
+/**
+ * @brief Per-CPU statistics count every switch
+ *
+ * @details The per-CPU histograms see both sides of each wakeup: the
+ * waiter switching in and the waker resuming.
+ */
+void test_cpu_stats(void)
+{
+	struct k_cpu_sched_stats stats;
+
+	start_waiter();
+	k_msleep(1);
+	zassert_ok(k_cpu_sched_stats_reset(0), NULL);
+
+	/* The reset applies right away, not at the next switch */
+	zassert_ok(k_cpu_sched_stats_get(0, &stats), NULL);
+	zassert_equal(stats.switches, 0, NULL);
+	zassert_equal(hist_sum(&stats.run_time), 0, NULL);
+
+	for (int i = 0; i < NUM_WAKES; i++) {
+		k_sem_give(&wake_sem);
+	}
+
+	zassert_ok(k_cpu_sched_stats_get(0, &stats), NULL);
+	zassert_equal(stats.switches, 2 * NUM_WAKES, NULL);
+	zassert_equal(stats.preemptions, NUM_WAKES, NULL);
+	zassert_equal(hist_sum(&stats.wake_latency), NUM_WAKES, NULL);
+	zassert_equal(hist_sum(&stats.run_time), 2 * NUM_WAKES, NULL);
+	zassert_equal(hist_sum(&stats.runq_depth), 2 * NUM_WAKES, NULL);
+
+	k_thread_abort(&hi_thread);
+}
+
+/**
+ * @brief Run queue depth is sampled at switch time
+ *
+ * @details Make NUM_QUEUED lower priority threads ready, then sleep.
+ * The first of them to be switched in must see the others queued.
+ */
+void test_runq_depth(void)
+{
+	struct k_cpu_sched_stats stats;
+
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	zassert_ok(k_cpu_sched_stats_reset(0), NULL);
+
+	for (int i = 0; i < NUM_QUEUED; i++) {
+		k_thread_create(&lo_threads[i], lo_stacks[i], STACK_SIZE,
+				lo_entry, NULL, NULL, NULL, LO_PRIO, 0,
+				K_NO_WAIT);
+	}
+	k_msleep(10);
+
+	zassert_ok(k_cpu_sched_stats_get(0, &stats), NULL);
+	zassert_true(stats.runq_depth_max >= NUM_QUEUED - 1,
+		     "max depth %u", stats.runq_depth_max);
+	zassert_equal(hist_sum(&stats.wake_latency), NUM_QUEUED + 1,
+		      "each started thread and the sleeper wake once");
+}
+
+void test_invalid_args(void)
+{
+	struct k_cpu_sched_stats cpu_stats;
+	struct k_thread_sched_stats thread_stats;
+	int ret = IS_ENABLED(CONFIG_SCHED_STATS_THREAD) ? 0 : -ENOTSUP;
+
+	zassert_equal(k_cpu_sched_stats_get(-1, &cpu_stats), -EINVAL, NULL);
+	zassert_equal(k_cpu_sched_stats_get(CONFIG_MP_NUM_CPUS, &cpu_stats),
+		      -EINVAL, NULL);
+	zassert_equal(k_cpu_sched_stats_get(0, NULL), -EINVAL, NULL);
+	zassert_equal(k_cpu_sched_stats_reset(CONFIG_MP_NUM_CPUS), -EINVAL,
+		      NULL);
+
+	zassert_equal(k_thread_sched_stats_get(NULL, &thread_stats), -EINVAL,
+		      NULL);
+	zassert_equal(k_thread_sched_stats_get(k_current_get(), NULL),
+		      -EINVAL, NULL);
+	zassert_equal(k_thread_sched_stats_reset(NULL), -EINVAL, NULL);
+
+	zassert_equal(k_thread_sched_stats_get(k_current_get(), &thread_stats),
+		      ret, NULL);
+	zassert_equal(k_thread_sched_stats_reset(k_current_get()), ret, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sched_stats,
+			 ztest_unit_test(test_thread_wake_latency),
+			 ztest_unit_test(test_cpu_stats),
+			 ztest_unit_test(test_runq_depth),
+			 ztest_unit_test(test_invalid_args));
+	ztest_run_test_suite(sched_stats);
+}
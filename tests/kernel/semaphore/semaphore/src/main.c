@@ -863,6 +863,50 @@ void test_sem_multiple_threads_wait(void)
 	}
 }
 
+/**
+ * @brief Test giving a semaphore several times at once
+ * @ingroup kernel_semaphore_tests
+ * @see k_sem_give_n()
+ */
+void test_sem_give_n(void)
+{
+	k_sem_reset(&simple_sem);
+	k_sem_reset(&multiple_thread_sem);
+
+	for (int i = 0; i < TOTAL_THREADS_WAITING; i++) {
+		k_thread_create(&multiple_tid[i],
+				multiple_stack[i], STACK_SIZE,
+				sem_multiple_threads_wait_helper,
+				NULL, NULL, NULL,
+				K_PRIO_PREEMPT(1),
+				K_USER | K_INHERIT_PERMS, K_NO_WAIT);
+	}
+
+	/* giving time for the other threads to pend */
+	k_sleep(K_MSEC(500));
+
+	/* one unit for each waiter, the rest goes to the count */
+	k_sem_give_n(&multiple_thread_sem, TOTAL_THREADS_WAITING + 2);
+
+	/* giving time for the other threads to execute */
+	k_sleep(K_MSEC(500));
+
+	for (int i = 0; i < TOTAL_THREADS_WAITING; i++) {
+		expect_k_sem_take(&simple_sem, K_FOREVER, 0,
+			"Some of the threads did not get multiple_thread_sem: %d != %d");
+	}
+	expect_k_sem_count_get_nomsg(&multiple_thread_sem, 2U);
+
+	/* the count saturates at the limit */
+	k_sem_give_n(&multiple_thread_sem, SEM_MAX_VAL);
+	expect_k_sem_count_get_nomsg(&multiple_thread_sem, SEM_MAX_VAL);
+
+	k_sem_give_n(&multiple_thread_sem, 0);
+	expect_k_sem_count_get_nomsg(&multiple_thread_sem, SEM_MAX_VAL);
+
+	k_sem_reset(&multiple_thread_sem);
+}
+
 /**
  * @brief Test semaphore timeout period
  * @ingroup kernel_semaphore_tests
@@ -1348,6 +1392,7 @@ void test_main(void)
 			 ztest_unit_test(test_sem_give_take_from_isr),
 			 ztest_user_unit_test(test_k_sem_correct_count_limit),
 			 ztest_unit_test(test_sem_multiple_threads_wait),
+			 ztest_unit_test(test_sem_give_n),
 			 ztest_unit_test(test_sem_measure_timeouts),
 			 ztest_unit_test(test_sem_measure_timeout_from_thread),
 			 ztest_1cpu_unit_test(test_sem_multiple_take_and_timeouts),
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+
+#define NUM_TIMERS 8
+#define NUM_PERIODS 5
+#define PERIOD_MS 100
+#define STAGGER_MS 5
+#define SLACK_MS 50
+
+/* Two expiries handled in the same timer interrupt see the same cycle
+ * count, give or take the time spent running the callbacks.
+ */
+#define SAME_WAKEUP_CYC (k_ticks_to_cyc_floor32(1) / 2)
+
+/* Rounding to ticks of the start time and timeouts */
+#define TOLERANCE_MS 2
+
+static struct k_timer timers[NUM_TIMERS];
+static uint32_t stamps[NUM_TIMERS * NUM_PERIODS];
+static uint32_t expiries[NUM_TIMERS];
+static atomic_t num_stamps;
+static uint32_t start_cyc;
+static uint32_t max_late_ms;
+
+static void expiry_fn(struct k_timer *timer)
+{
+	int idx = timer - timers;
+	uint32_t now = k_cycle_get_32();
+	uint32_t due_ms = idx * STAGGER_MS + expiries[idx]++ * PERIOD_MS;
+	uint32_t at_ms = k_cyc_to_ms_floor32(now - start_cyc);
+	atomic_val_t n = atomic_inc(&num_stamps);
+
+	zassert_true(at_ms + TOLERANCE_MS >= due_ms,
+		     "timer %d early: %u ms < %u ms", idx, at_ms, due_ms);
+	zassert_true(at_ms <= due_ms + max_late_ms + TOLERANCE_MS,
+		     "timer %d late: %u ms > %u ms", idx, at_ms, due_ms);
+
+	if (n < ARRAY_SIZE(stamps)) {
+		stamps[n] = now;
+	}
+	if (expiries[idx] == NUM_PERIODS) {
+		k_timer_stop(timer);
+	}
+}
+
+/* Runs the staggered timers and returns the number of timer
+ * interrupts their expiries were handled in
+ */
+static int run_timers(k_timeout_t slack, uint32_t slack_ms)
+{
+	int wakeups = 0;
+
+	atomic_clear(&num_stamps);
+	max_late_ms = slack_ms;
+
+	/* Start on a tick boundary */
+	k_sleep(K_TICKS(1));
+	start_cyc = k_cycle_get_32();
+
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		expiries[i] = 0U;
+		k_timer_init(&timers[i], expiry_fn, NULL);
+		k_timer_slack_set(&timers[i], slack);
+		k_timer_start(&timers[i], K_MSEC(i * STAGGER_MS),
+			      K_MSEC(PERIOD_MS));
+	}
+
+	k_msleep(NUM_PERIODS * PERIOD_MS);
+
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		zassert_equal(expiries[i], NUM_PERIODS,
+			      "timer %d expired %u times", i, expiries[i]);
+	}
+	zassert_equal(atomic_get(&num_stamps), ARRAY_SIZE(stamps), NULL);
+
+	for (int i = 0; i < ARRAY_SIZE(stamps); i++) {
+		if ((i == 0) || (stamps[i] - stamps[i - 1] > SAME_WAKEUP_CYC)) {
+			wakeups++;
+		}
+	}
+
+	return wakeups;
+}
+
+/**
+ * @brief Staggered timers share wakeups within their slack
+ *
+ * @details Run NUM_TIMERS periodic timers started STAGGER_MS apart,
+ * first without slack, then with a slack covering all of them.  Each
+ * expiry must happen within its slack, but with slack all timers of a
+ * period must be handled in one wakeup.
+ */
+void test_timer_slack_coalesce(void)
+{
+	struct k_timeout_slack_stats stats;
+	int strict, coalesced;
+
+	k_timeout_slack_stats_reset();
+	strict = run_timers(K_NO_WAIT, 0);
+	k_timeout_slack_stats_get(&stats);
+
+	zassert_equal(strict, NUM_TIMERS * NUM_PERIODS,
+		      "%d wakeups without slack", strict);
+	zassert_equal(stats.wakeups_saved, 0, NULL);
+	zassert_equal(stats.deferred, 0, NULL);
+
+	k_timeout_slack_stats_reset();
+	coalesced = run_timers(K_MSEC(SLACK_MS), SLACK_MS);
+	k_timeout_slack_stats_get(&stats);
+
+	TC_PRINT("%d wakeups without slack, %d with\n", strict, coalesced);
+	zassert_equal(coalesced, NUM_PERIODS, "%d wakeups with slack",
+		      coalesced);
+	zassert_true(stats.wakeups_saved >= strict - coalesced,
+		     "%u wakeups saved", stats.wakeups_saved);
+	zassert_true(stats.deferred >= (NUM_TIMERS - 1) * NUM_PERIODS,
+		     "%u deferred", stats.deferred);
+}
+
+static uint32_t strict_cyc, lax_cyc;
+
+static void strict_fn(struct k_timer *timer)
+{
+	strict_cyc = k_cycle_get_32();
+}
+
+static void lax_fn(struct k_timer *timer)
+{
+	lax_cyc = k_cycle_get_32();
+}
+
+/**
+ * @brief The slack of one timeout never delays another
+ *
+ * @details A timer with a long slack expiring before one without
+ * slack must not defer the latter, but may share its wakeup.
+ */
+void test_timer_slack_strict(void)
+{
+	struct k_timer lax, strict;
+	uint32_t start;
+
+	k_timer_init(&lax, lax_fn, NULL);
+	k_timer_init(&strict, strict_fn, NULL);
+	k_timer_slack_set(&lax, K_MSEC(10 * SLACK_MS));
+
+	k_sleep(K_TICKS(1));
+	start = k_cycle_get_32();
+	k_timer_start(&lax, K_MSEC(STAGGER_MS), K_NO_WAIT);
+	k_timer_start(&strict, K_MSEC(SLACK_MS), K_NO_WAIT);
+
+	k_msleep(2 * SLACK_MS);
+
+	zassert_within(k_cyc_to_ms_floor32(strict_cyc - start), SLACK_MS,
+		       TOLERANCE_MS, "strict timer deferred");
+	zassert_true(lax_cyc - start <= strict_cyc - start,
+		     "lax timer expired after strict one");
+	zassert_true(strict_cyc - lax_cyc <= SAME_WAKEUP_CYC,
+		     "lax timer didn't share the strict one's wakeup");
+}
+
+#define NUM_WORK 4
+
+static struct k_work_delayable works[NUM_WORK];
+static atomic_t works_run;
+
+static void work_handler(struct k_work *work)
+{
+	atomic_inc(&works_run);
+}
+
+/**
+ * @brief Delayable work items share wakeups within their slack
+ */
+void test_work_slack(void)
+{
+	struct k_timeout_slack_stats stats;
+
+	atomic_clear(&works_run);
+	k_sleep(K_TICKS(1));
+	k_timeout_slack_stats_reset();
+
+	for (int i = 0; i < NUM_WORK; i++) {
+		k_work_init_delayable(&works[i], work_handler);
+		k_work_delayable_slack_set(&works[i], K_MSEC(SLACK_MS));
+		zassert_equal(k_work_schedule(&works[i],
+					      K_MSEC((i + 1) * STAGGER_MS)),
+			      1, NULL);
+	}
+
+	k_msleep(SLACK_MS + NUM_WORK * STAGGER_MS);
+
+	k_timeout_slack_stats_get(&stats);
+	zassert_equal(atomic_get(&works_run), NUM_WORK, NULL);
+	zassert_equal(stats.wakeups_saved, NUM_WORK - 1, NULL);
+	zassert_equal(stats.deferred, NUM_WORK, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(timer_slack,
+			 ztest_unit_test(test_timer_slack_coalesce),
+			 ztest_unit_test(test_timer_slack_strict),
+			 ztest_unit_test(test_work_slack));
+	ztest_run_test_suite(timer_slack);
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define NUM_WORKERS 4
+/* Preemptible so the test thread gets back control while the workers
+ * are busy.
+ */
+#define POOL_PRIORITY K_PRIO_PREEMPT(1)
+#define DELAY_MS 20
+
+BUILD_ASSERT(CONFIG_ZTEST_THREAD_PRIORITY < POOL_PRIORITY,
+	     "ZTEST not higher priority than the pool");
+
+static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks, NUM_WORKERS, STACK_SIZE);
+static struct k_work_q_worker pool_workers[NUM_WORKERS - 1];
+static struct k_work_q pool_queue;
+
+static struct k_work works[NUM_WORKERS];
+static struct k_work_sync work_sync;
+
+/* Given by the test thread to release blocked handlers */
+static struct k_sem rel_sem;
+
+static atomic_t running;
+static atomic_t max_running;
+static atomic_t run_count;
+static atomic_t resubmits;
+static k_tid_t last_thread;
+
+static void enter_handler(void)
+{
+	atomic_val_t now = atomic_inc(&running) + 1;
+	atomic_val_t max = atomic_get(&max_running);
+
+	while ((now > max) && !atomic_cas(&max_running, max, now)) {
+		max = atomic_get(&max_running);
+	}
+}
+
+static void exit_handler(void)
+{
+	last_thread = k_current_get();
+	atomic_inc(&run_count);
+	atomic_dec(&running);
+}
+
+static void block_handler(struct k_work *work)
+{
+	enter_handler();
+	k_sem_take(&rel_sem, K_FOREVER);
+	exit_handler();
+}
+
+static void delay_handler(struct k_work *work)
+{
+	enter_handler();
+	k_msleep(DELAY_MS);
+	exit_handler();
+}
+
+/* Resubmits itself while running, so that it is queued and running
+ * at the same time.
+ */
+static void resubmit_handler(struct k_work *work)
+{
+	enter_handler();
+	if (atomic_dec(&resubmits) > 1) {
+		zassert_equal(k_work_submit_to_queue(&pool_queue, work), 2,
+			      NULL);
+	}
+	k_msleep(1);
+	exit_handler();
+}
+
+static void reset_counters(void)
+{
+	atomic_clear(&running);
+	atomic_clear(&max_running);
+	atomic_clear(&run_count);
+	last_thread = NULL;
+}
+
+static void *pool_setup(void)
+{
+	k_sem_init(&rel_sem, 0, NUM_WORKERS);
+
+	k_work_queue_start(&pool_queue, pool_stacks[0],
+			   K_THREAD_STACK_SIZEOF(pool_stacks[0]),
+			   POOL_PRIORITY, &(struct k_work_queue_config) {
+				   .name = "pool",
+			   });
+
+	/* The last worker is bound to CPU 0 */
+	for (int i = 0; i < NUM_WORKERS - 1; i++) {
+		k_work_queue_worker_add(&pool_queue, &pool_workers[i],
+					pool_stacks[i + 1],
+					K_THREAD_STACK_SIZEOF(pool_stacks[i + 1]),
+					POOL_PRIORITY,
+					(i == NUM_WORKERS - 2) ? 0 : -1);
+	}
+
+	return NULL;
+}
+
+/* Independent items run in parallel on the workers of the pool */
+static void test_pool_parallel(void)
+{
+	reset_counters();
+
+	for (int i = 0; i < NUM_WORKERS; i++) {
+		k_work_init(&works[i], block_handler);
+		zassert_equal(k_work_submit_to_queue(&pool_queue, &works[i]),
+			      1, NULL);
+	}
+
+	/* Let all workers pick up an item and block */
+	k_msleep(DELAY_MS);
+	zassert_equal(atomic_get(&running), NUM_WORKERS, NULL);
+
+	for (int i = 0; i < NUM_WORKERS; i++) {
+		k_sem_give(&rel_sem);
+	}
+	zassert_equal(k_work_queue_drain(&pool_queue, false), 1, NULL);
+	zassert_equal(atomic_get(&run_count), NUM_WORKERS, NULL);
+	zassert_equal(atomic_get(&running), 0, NULL);
+}
+
+/* An item resubmitted while running is not started by another worker
+ * before the current invocation completes.
+ */
+static void test_pool_no_reentrancy(void)
+{
+	reset_counters();
+	atomic_set(&resubmits, 10);
+
+	k_work_init(&works[0], resubmit_handler);
+	zassert_equal(k_work_submit_to_queue(&pool_queue, &works[0]), 1,
+		      NULL);
+
+	zassert_equal(k_work_queue_drain(&pool_queue, false), 1, NULL);
+	zassert_equal(atomic_get(&run_count), 10, NULL);
+	zassert_equal(atomic_get(&max_running), 1, NULL);
+}
+
+/* Flushing a running item waits for it even though other workers are
+ * idle and could process the flusher right away.
+ */
+static void test_pool_running_flush(void)
+{
+	reset_counters();
+
+	k_work_init(&works[0], delay_handler);
+	zassert_equal(k_work_submit_to_queue(&pool_queue, &works[0]), 1,
+		      NULL);
+
+	/* Let it start */
+	k_msleep(1);
+	zassert_equal(k_work_busy_get(&works[0]), K_WORK_RUNNING, NULL);
+
+	zassert_true(k_work_flush(&works[0], &work_sync), NULL);
+	zassert_equal(k_work_busy_get(&works[0]), 0, NULL);
+	zassert_equal(atomic_get(&run_count), 1, NULL);
+}
+
+/* Flushing an item that is both running and queued waits for the
+ * queued invocation too.
+ */
+static void test_pool_running_queued_flush(void)
+{
+	reset_counters();
+
+	k_work_init(&works[0], delay_handler);
+	zassert_equal(k_work_submit_to_queue(&pool_queue, &works[0]), 1,
+		      NULL);
+	k_msleep(1);
+	zassert_equal(k_work_submit_to_queue(&pool_queue, &works[0]), 2,
+		      NULL);
+
+	zassert_true(k_work_flush(&works[0], &work_sync), NULL);
+	zassert_equal(k_work_busy_get(&works[0]), 0, NULL);
+	zassert_equal(atomic_get(&run_count), 2, NULL);
+	zassert_equal(atomic_get(&max_running), 1, NULL);
+}
+
+/* Synchronous cancellation of a running and queued item removes the
+ * queued invocation and waits for the running one.
+ */
+static void test_pool_cancel_sync(void)
+{
+	reset_counters();
+
+	k_work_init(&works[0], delay_handler);
+	zassert_equal(k_work_submit_to_queue(&pool_queue, &works[0]), 1,
+		      NULL);
+	k_msleep(1);
+	zassert_equal(k_work_submit_to_queue(&pool_queue, &works[0]), 2,
+		      NULL);
+
+	zassert_true(k_work_cancel_sync(&works[0], &work_sync), NULL);
+	zassert_equal(k_work_busy_get(&works[0]), 0, NULL);
+	zassert_equal(atomic_get(&run_count), 1, NULL);
+}
+
+/* Bound items only run on the workers pinned to their CPU */
+static void test_pool_affinity(void)
+{
+	k_tid_t bound_thread = &pool_workers[NUM_WORKERS - 2].thread;
+
+	zassert_equal(k_work_cpu_affinity_set(&works[0], CONFIG_MP_NUM_CPUS),
+		      -EINVAL, NULL);
+	zassert_equal(k_work_cpu_affinity_set(&works[0], -2), -EINVAL, NULL);
+
+	for (int i = 0; i < 5; i++) {
+		reset_counters();
+
+		k_work_init(&works[0], delay_handler);
+		zassert_equal(k_work_cpu_affinity_set(&works[0], 0), 0, NULL);
+		zassert_equal(k_work_submit_to_queue(&pool_queue, &works[0]),
+			      1, NULL);
+		zassert_true(k_work_flush(&works[0], &work_sync), NULL);
+		zassert_equal(last_thread, bound_thread, NULL);
+	}
+}
+
+/* Draining waits for the items running on all workers */
+static void test_pool_drain(void)
+{
+	reset_counters();
+
+	for (int i = 0; i < NUM_WORKERS; i++) {
+		k_work_init(&works[i], delay_handler);
+		zassert_equal(k_work_submit_to_queue(&pool_queue, &works[i]),
+			      1, NULL);
+	}
+
+	zassert_equal(k_work_queue_drain(&pool_queue, true), 1, NULL);
+	zassert_equal(atomic_get(&run_count), NUM_WORKERS, NULL);
+	zassert_equal(k_work_submit_to_queue(&pool_queue, &works[0]),
+		      -EBUSY, NULL);
+	zassert_equal(k_work_queue_unplug(&pool_queue), 0, NULL);
+}
+
+void test_main(void)
+{
+	pool_setup();
+
+	ztest_test_suite(work_pool,
+			 ztest_1cpu_unit_test(test_pool_parallel),
+			 ztest_unit_test(test_pool_no_reentrancy),
+			 ztest_unit_test(test_pool_running_flush),
+			 ztest_unit_test(test_pool_running_queued_flush),
+			 ztest_unit_test(test_pool_cancel_sync),
+			 ztest_unit_test(test_pool_affinity),
+			 ztest_unit_test(test_pool_drain));
+	ztest_run_test_suite(work_pool);
+}
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/btree.h>
+
+#define NUM_ITEMS 600
+#define NUM_NODES (2 * NUM_ITEMS / (CONFIG_BTREE_NODE_KEYS / 2) + 8)
+
+struct item {
+	struct btnode node;
+	uint32_t seq;
+	bool in_tree;
+};
+
+static struct item items[NUM_ITEMS];
+static struct btnode *sorted[NUM_ITEMS];
+static struct btree_node nodes[NUM_NODES];
+static struct btree tree;
+static uint32_t seq;
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+	return rand_state >> 8;
+}
+
+/* Check node fill, key order and that all leaves are at the same depth.
+ * Returns the number of items below @p node.
+ */
+static size_t check_node(struct btree_node *node, int depth,
+			 btree_key_t lo, btree_key_t hi, bool is_root)
+{
+	size_t cnt = 0;
+
+	zassert_true(depth < tree.height, "Tree deeper than its height");
+	if (!is_root) {
+		zassert_true(node->count >= Z_BTREE_MIN_KEYS,
+			     "Node underflow %d", node->count);
+	}
+
+	for (int i = 0; i < node->count; i++) {
+		zassert_true(node->keys[i] >= lo && node->keys[i] <= hi,
+			     "Key out of range");
+		if (i > 0) {
+			zassert_true(node->keys[i - 1] <= node->keys[i],
+				     "Keys out of order");
+		}
+	}
+
+	if (node->leaf) {
+		zassert_equal(depth, tree.height - 1, "Unbalanced tree");
+		for (int i = 0; i < node->count; i++) {
+			zassert_equal(node->keys[i], node->items[i]->key, NULL);
+		}
+		return node->count;
+	}
+
+	for (int i = 0; i <= node->count; i++) {
+		cnt += check_node(node->children[i], depth + 1,
+				  (i > 0) ? node->keys[i - 1] : lo,
+				  (i < node->count) ? node->keys[i] : hi,
+				  false);
+	}
+
+	return cnt;
+}
+
+static void check_tree(void)
+{
+	struct item *it, *prev = NULL;
+	size_t cnt = 0, expected = 0;
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		expected += items[i].in_tree ? 1 : 0;
+	}
+	zassert_equal(btree_count(&tree), expected, NULL);
+
+	if (tree.root != NULL) {
+		zassert_equal(check_node(tree.root, 0, 0, UINT64_MAX, true),
+			      expected, NULL);
+	} else {
+		zassert_equal(expected, 0, NULL);
+	}
+
+	/* Walk in order, equal keys in insertion order */
+	BTREE_FOR_EACH_CONTAINER(&tree, it, node) {
+		zassert_true(it->in_tree, "Removed item found");
+		if (prev != NULL) {
+			zassert_true(prev->node.key < it->node.key ||
+				     (prev->node.key == it->node.key &&
+				      prev->seq < it->seq),
+				     "Items out of order");
+		}
+		prev = it;
+		cnt++;
+	}
+	zassert_equal(cnt, expected, NULL);
+}
+
+static void reset(void)
+{
+	btree_init(&tree, nodes, ARRAY_SIZE(nodes));
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		items[i].in_tree = false;
+	}
+	seq = 0;
+	rand_state = 1;
+}
+
+static void insert(struct item *it)
+{
+	it->seq = seq++;
+	zassert_equal(btree_insert(&tree, &it->node), 0, NULL);
+	it->in_tree = true;
+}
+
+static void test_btree_insert_remove(void)
+{
+	reset();
+
+	zassert_true(btree_is_empty(&tree), NULL);
+	zassert_is_null(btree_get_min(&tree, NULL), NULL);
+	zassert_is_null(btree_get_max(&tree), NULL);
+	zassert_equal(btree_remove(&tree, &items[0].node), -ENOENT, NULL);
+
+	/* Ascending, descending and random keys, then remove all in
+	 * random order, checking the tree along the way.
+	 */
+	for (int round = 0; round < 3; round++) {
+		for (int i = 0; i < NUM_ITEMS; i++) {
+			if (round == 0) {
+				items[i].node.key = i;
+			} else if (round == 1) {
+				items[i].node.key = NUM_ITEMS - i;
+			} else {
+				items[i].node.key = next_rand() % 100000;
+			}
+			insert(&items[i]);
+			if (i % 50 == 0) {
+				check_tree();
+			}
+		}
+		check_tree();
+
+		for (int n = NUM_ITEMS; n > 0; n--) {
+			int i = next_rand() % NUM_ITEMS;
+
+			while (!items[i].in_tree) {
+				i = (i + 1) % NUM_ITEMS;
+			}
+			zassert_equal(btree_remove(&tree, &items[i].node), 0,
+				      NULL);
+			items[i].in_tree = false;
+			zassert_equal(btree_remove(&tree, &items[i].node),
+				      -ENOENT, NULL);
+			if (n % 50 == 0) {
+				check_tree();
+			}
+		}
+		check_tree();
+		zassert_true(btree_is_empty(&tree), NULL);
+		zassert_is_null(tree.root, NULL);
+		zassert_equal(tree.free_cnt, NUM_NODES, "Nodes leaked");
+	}
+}
+
+static void test_btree_random_mix(void)
+{
+	reset();
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		items[i].node.key = next_rand() % 64;
+	}
+
+	for (int op = 0; op < 20 * NUM_ITEMS; op++) {
+		struct item *it = &items[next_rand() % NUM_ITEMS];
+
+		if (it->in_tree) {
+			zassert_equal(btree_remove(&tree, &it->node), 0, NULL);
+			it->in_tree = false;
+		} else {
+			insert(it);
+		}
+
+		if (op % 500 == 0) {
+			check_tree();
+		}
+	}
+	check_tree();
+}
+
+static void test_btree_duplicates(void)
+{
+	struct btree_iter iter;
+	struct btnode *n;
+	int i;
+
+	reset();
+
+	/* Enough equal keys to span several leaves */
+	for (i = 0; i < 100; i++) {
+		items[i].node.key = (i < 10) ? 1 : ((i < 90) ? 5 : 9);
+		insert(&items[i]);
+	}
+	check_tree();
+
+	n = btree_find(&tree, 5);
+	zassert_equal_ptr(n, &items[10].node, "Not the first equal item");
+
+	n = btree_lower_bound(&tree, 5, &iter);
+	for (i = 10; i < 90; i++) {
+		zassert_equal_ptr(n, &items[i].node, "Not in insertion order");
+		n = btree_iter_next(&iter);
+	}
+	zassert_equal(n->key, 9, NULL);
+
+	/* Remove the last ones of the run first */
+	for (i = 89; i >= 10; i -= 3) {
+		zassert_equal(btree_remove(&tree, &items[i].node), 0, NULL);
+		items[i].in_tree = false;
+	}
+	check_tree();
+}
+
+static void test_btree_lower_bound(void)
+{
+	struct btree_iter iter;
+	struct btnode *n;
+
+	reset();
+
+	zassert_is_null(btree_lower_bound(&tree, 0, &iter), NULL);
+	zassert_is_null(btree_iter_next(&iter), NULL);
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		items[i].node.key = 10 * (uint64_t)i + 10;
+		insert(&items[i]);
+	}
+
+	for (btree_key_t key = 0; key <= 10 * NUM_ITEMS + 1; key++) {
+		n = btree_lower_bound(&tree, key, &iter);
+		if (key > 10 * NUM_ITEMS) {
+			zassert_is_null(n, NULL);
+			continue;
+		}
+		zassert_equal(n->key, 10 * ceiling_fraction(MAX(key, 10), 10),
+			      "Wrong lower bound for %u", (uint32_t)key);
+		zassert_equal_ptr(btree_find(&tree, key),
+				  (key % 10 == 0 && key > 0) ? n : NULL, NULL);
+
+		if (n->key < 10 * NUM_ITEMS) {
+			zassert_equal(btree_iter_next(&iter)->key, n->key + 10,
+				      NULL);
+		} else {
+			zassert_is_null(btree_iter_next(&iter), NULL);
+		}
+	}
+
+	zassert_equal_ptr(btree_get_min(&tree, NULL), &items[0].node, NULL);
+	zassert_equal_ptr(btree_get_max(&tree),
+			  &items[NUM_ITEMS - 1].node, NULL);
+}
+
+static void test_btree_bulk(void)
+{
+	reset();
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		items[i].node.key = i / 3;
+		items[i].seq = i;
+		items[i].in_tree = true;
+		sorted[i] = &items[i].node;
+	}
+
+	/* Unsorted input is refused */
+	sorted[0] = &items[NUM_ITEMS - 1].node;
+	zassert_equal(btree_insert_bulk(&tree, sorted, NUM_ITEMS), -EINVAL,
+		      NULL);
+	sorted[0] = &items[0].node;
+
+	/* Every size up to a few levels builds a valid tree */
+	for (int cnt = 0; cnt <= NUM_ITEMS; cnt += (cnt < 40) ? 1 : 37) {
+		btree_init(&tree, nodes, ARRAY_SIZE(nodes));
+		for (int i = 0; i < NUM_ITEMS; i++) {
+			items[i].in_tree = i < cnt;
+		}
+
+		zassert_equal(btree_insert_bulk(&tree, sorted, cnt), 0, NULL);
+		check_tree();
+	}
+
+	btree_init(&tree, nodes, ARRAY_SIZE(nodes));
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		items[i].in_tree = true;
+	}
+	zassert_equal(btree_insert_bulk(&tree, sorted, NUM_ITEMS), 0, NULL);
+	check_tree();
+
+	/* A tree built in bulk remains usable */
+	seq = NUM_ITEMS;
+	for (int i = 0; i < NUM_ITEMS; i += 2) {
+		zassert_equal(btree_remove(&tree, &items[i].node), 0, NULL);
+		items[i].in_tree = false;
+	}
+	check_tree();
+
+	/* Bulk insert into a non empty tree inserts one by one */
+	for (int i = 0; i < NUM_ITEMS; i += 2) {
+		items[i].seq = seq++;
+		items[i].in_tree = true;
+		sorted[i / 2] = &items[i].node;
+	}
+	zassert_equal(btree_insert_bulk(&tree, sorted, NUM_ITEMS / 2), 0,
+		      NULL);
+	check_tree();
+}
+
+static void test_btree_exhaust(void)
+{
+	static struct btree_node few[4];
+	int i, rc = 0;
+
+	btree_init(&tree, few, ARRAY_SIZE(few));
+	for (i = 0; i < NUM_ITEMS; i++) {
+		items[i].node.key = i;
+		items[i].seq = i;
+		items[i].in_tree = false;
+		sorted[i] = &items[i].node;
+	}
+
+	for (i = 0; i < NUM_ITEMS; i++) {
+		rc = btree_insert(&tree, &items[i].node);
+		if (rc != 0) {
+			break;
+		}
+		items[i].in_tree = true;
+	}
+
+	zassert_equal(rc, -ENOMEM, NULL);
+	/* The tree is intact after the failed insert */
+	check_tree();
+	zassert_equal(btree_count(&tree), i, NULL);
+	for (int j = 0; j < i; j++) {
+		zassert_equal(btree_remove(&tree, &items[j].node), 0, NULL);
+		items[j].in_tree = false;
+	}
+	zassert_true(btree_is_empty(&tree), NULL);
+	zassert_equal(tree.free_cnt, ARRAY_SIZE(few), NULL);
+
+	zassert_equal(btree_insert_bulk(&tree, sorted, NUM_ITEMS), -ENOMEM,
+		      NULL);
+	zassert_true(btree_is_empty(&tree), NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(btree,
+			 ztest_unit_test(test_btree_insert_remove),
+			 ztest_unit_test(test_btree_random_mix),
+			 ztest_unit_test(test_btree_duplicates),
+			 ztest_unit_test(test_btree_lower_bound),
+			 ztest_unit_test(test_btree_bulk),
+			 ztest_unit_test(test_btree_exhaust)
+			 );
+	ztest_run_test_suite(btree);
+}
@@ -809,6 +809,27 @@ static void test_cbprintf_must_runtime_package(void)
 	zassert_equal(rv, 0, NULL);
 }
 
+#ifdef CONFIG_CBPRINTF_PRECOMPILED
+#ifdef __cplusplus
+extern "C" {
+#endif
+void test_cbprintf_precompiled(void);
+void test_cbprintf_precompiled_throughput(void);
+#ifdef __cplusplus
+}
+#endif
+#else
+static void test_cbprintf_precompiled(void)
+{
+	ztest_test_skip();
+}
+
+static void test_cbprintf_precompiled_throughput(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 #ifdef __cplusplus
@@ -832,7 +853,9 @@ void test_main(void)
 			 ztest_unit_test(test_cbprintf_ro_rw_loc),
 			 ztest_unit_test(test_cbprintf_ro_rw_loc_const_char_ptr),
 			 ztest_unit_test(test_cbprintf_rw_loc_const_char_ptr),
-			 ztest_unit_test(test_cbprintf_must_runtime_package)
+			 ztest_unit_test(test_cbprintf_must_runtime_package),
+			 ztest_unit_test(test_cbprintf_precompiled),
+			 ztest_unit_test(test_cbprintf_precompiled_throughput)
 			 );
 
 	ztest_run_test_suite(cbprintf_package);
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/cbprintf.h>
+
+struct out_buffer {
+	char *buf;
+	size_t idx;
+	size_t size;
+};
+
+static int out(int c, void *dest)
+{
+	struct out_buffer *buf = dest;
+
+	if (buf->idx < buf->size) {
+		buf->buf[buf->idx++] = (char)(unsigned char)c;
+		return (int)(unsigned char)c;
+	}
+
+	return EOF;
+}
+
+static int null_out(int c, void *dest)
+{
+	ARG_UNUSED(dest);
+
+	return c;
+}
+
+static char exp_str[128];
+static char out_str[128];
+static uint8_t __aligned(CBPRINTF_PACKAGE_ALIGNMENT) package[256];
+
+/* Package the arguments for the descriptor's format string and check that
+ * output through the descriptor matches the one of snprintfcb().
+ */
+#define TEST_DESC(desc, ...) do { \
+	struct out_buffer buf = { \
+		.buf = out_str, .idx = 0, .size = sizeof(out_str) - 1 \
+	}; \
+	int exp_len = snprintfcb(exp_str, sizeof(exp_str), (desc)->fmt, \
+				 __VA_ARGS__); \
+	int len = cbprintf_package(package, sizeof(package), 0, (desc)->fmt, \
+				   __VA_ARGS__); \
+	zassert_true(len > 0, "cbprintf_package() returned %d", len); \
+	len = cbpprintf_desc(out, &buf, (desc), package); \
+	out_str[buf.idx] = '\0'; \
+	zassert_equal(len, exp_len, "Unexpected length %d, exp %d", len, \
+		      exp_len); \
+	zassert_equal(strcmp(out_str, exp_str), 0, \
+		      "Strings differ\nexp: |%s|\ngot: |%s|\n", exp_str, \
+		      out_str); \
+} while (0)
+
+static CBPRINTF_FMT_DESC_DEFINE(desc_plain, "no conversions");
+static CBPRINTF_FMT_DESC_DEFINE(desc_int, "%d %-5u|%05x %#o %hhd %lld%%");
+static CBPRINTF_FMT_DESC_DEFINE(desc_str, "[%s] [%8s] [%-8.3s] %c");
+static CBPRINTF_FMT_DESC_DEFINE(desc_star, "%*d|%-*d|%.*s|");
+static CBPRINTF_FMT_DESC_DEFINE(desc_ptr, "%p %zu %ld %lx end");
+static CBPRINTF_FMT_DESC_DEFINE(desc_invalid, "%d %y %u");
+static CBPRINTF_FMT_DESC_DEFINE(desc_many,
+	"%d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d");
+
+void test_cbprintf_precompiled(void)
+{
+	char rw_str[] = "rw string";
+	long long ll = -0x112233445566LL;
+
+	zassert_equal(cbprintf_fmt_compile(&desc_plain), 0, NULL);
+	zassert_equal(desc_plain.conv_cnt, 0, NULL);
+	TEST_DESC(&desc_plain, 0);
+
+	TEST_DESC(&desc_int, -10, 20U, 0x1f, 8, 300, ll);
+	zassert_equal(desc_int.conv_cnt, 7, NULL);
+
+	TEST_DESC(&desc_str, "ro", rw_str, rw_str, 'z');
+	TEST_DESC(&desc_star, 6, -12, -4, 7, 2, "abcdef");
+	TEST_DESC(&desc_star, -6, 12, 4, -7, -1, "abcdef");
+	TEST_DESC(&desc_ptr, (void *)0x1234, (size_t)77, -5L, 0xabcdL);
+
+	/* Invalid conversions are output as they are. */
+	TEST_DESC(&desc_invalid, 1, 2U);
+
+#if CONFIG_CBPRINTF_PRECOMPILED_MAX_CONV < 17
+	/* Format strings which do not fit are parsed each time. */
+	zassert_equal(cbprintf_fmt_compile(&desc_many), -EINVAL, NULL);
+#endif
+	TEST_DESC(&desc_many, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+		  15, 16, 17);
+
+	/* Package for another format string falls back to parsing it. */
+	struct out_buffer buf = {
+		.buf = out_str, .idx = 0, .size = sizeof(out_str) - 1
+	};
+	int len = cbprintf_package(package, sizeof(package), 0, "other %d", 5);
+
+	zassert_true(len > 0, NULL);
+	len = cbpprintf_desc(out, &buf, &desc_int, package);
+	out_str[buf.idx] = '\0';
+	zassert_equal(strcmp(out_str, "other 5"), 0, "got: |%s|", out_str);
+}
+
+#define TP_ROUNDS 1000
+
+static CBPRINTF_FMT_DESC_DEFINE(desc_tp,
+	"<%u> %s: conn %p state %d seq 0x%08x len %u\n");
+
+/* Compare packaging and output of a typical log message using runtime
+ * packaging, static packaging and static packaging with a precompiled
+ * format string.
+ */
+void test_cbprintf_precompiled_throughput(void)
+{
+	static const char *mod = "net_tcp";
+	void *conn = &desc_tp;
+	uint32_t start, t_rt_pkg, t_st_pkg, t_out, t_desc_out;
+	int len = 0;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < TP_ROUNDS; i++) {
+		len = cbprintf_package(package, sizeof(package), 0, desc_tp.fmt,
+				       i, mod, conn, 4, 0x1000U + i, 536U);
+	}
+	t_rt_pkg = k_cycle_get_32() - start;
+	zassert_true(len > 0, NULL);
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < TP_ROUNDS; i++) {
+		CBPRINTF_STATIC_PACKAGE(package, sizeof(package), len, 0,
+					CBPRINTF_PACKAGE_CONST_CHAR_RO,
+					desc_tp.fmt, i, mod, conn, 4,
+					0x1000U + i, 536U);
+	}
+	t_st_pkg = k_cycle_get_32() - start;
+	zassert_true(len > 0, NULL);
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < TP_ROUNDS; i++) {
+		len = cbpprintf(null_out, NULL, package);
+	}
+	t_out = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < TP_ROUNDS; i++) {
+		zassert_equal(cbpprintf_desc(null_out, NULL, &desc_tp, package),
+			      len, NULL);
+	}
+	t_desc_out = k_cycle_get_32() - start;
+
+	TC_PRINT("package runtime %u static %u cycles/msg\n",
+		 t_rt_pkg / TP_ROUNDS, t_st_pkg / TP_ROUNDS);
+	TC_PRINT("output parsed %u precompiled %u cycles/msg\n",
+		 t_out / TP_ROUNDS, t_desc_out / TP_ROUNDS);
+}
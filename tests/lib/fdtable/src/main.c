@@ -175,6 +175,114 @@ void test_z_fd_multiple_access(void)
 	zassert_equal(errno, EBADF, "fd was found");
 }
 
+#ifndef CONFIG_POSIX_MAX_FDS_DYNAMIC
+#define CONFIG_POSIX_MAX_FDS_DYNAMIC 0
+#endif
+
+#define FD_TOTAL (CONFIG_POSIX_MAX_FDS + CONFIG_POSIX_MAX_FDS_DYNAMIC)
+
+static int fds[FD_TOTAL];
+
+void test_z_reserve_fd_exhaust(void)
+{
+	int count = 0;
+	int fd;
+
+	/* Take every free descriptor, including the ones allocated on
+	 * demand, and check that each is handed out once.
+	 */
+	while ((fd = z_reserve_fd()) >= 0) {
+		zassert_true(count < FD_TOTAL, "too many descriptors");
+		zassert_true(fd < FD_TOTAL, "fd %d out of range", fd);
+		for (int i = 0; i < count; i++) {
+			zassert_not_equal(fds[i], fd, "fd %d reserved twice", fd);
+		}
+		fds[count++] = fd;
+	}
+
+	zassert_equal(errno, ENFILE, "unexpected error %d", errno);
+	zassert_true(count > 0, "no descriptor reserved");
+
+	/* A freed descriptor is reused. */
+	z_free_fd(fds[count - 1]);
+	fd = z_reserve_fd();
+	zassert_equal(fd, fds[count - 1], "freed fd not reused");
+
+	for (int i = 0; i < count; i++) {
+		z_free_fd(fds[i]);
+	}
+
+	fd = z_reserve_fd();
+	zassert_true(fd >= 0, "fd < 0");
+	z_free_fd(fd);
+}
+
+#define CHURN_THREADS 2
+#define CHURN_ROUNDS 1000
+
+static struct k_thread churn_threads[CHURN_THREADS];
+static K_THREAD_STACK_ARRAY_DEFINE(churn_stacks, CHURN_THREADS,
+				   CONFIG_ZTEST_STACK_SIZE +
+				   CONFIG_TEST_EXTRA_STACK_SIZE);
+static atomic_t churn_errors;
+
+static void churn_cb(void *p1, void *p2, void *p3)
+{
+	const struct fd_op_vtable *vtable;
+	void *obj;
+	int fd;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < CHURN_ROUNDS; i++) {
+		fd = z_alloc_fd(p1, VTABLE_INIT);
+		if (fd < 0) {
+			/* Table momentarily full, try again. */
+			k_yield();
+			continue;
+		}
+
+		/* Nobody else may have been given the same descriptor. */
+		obj = z_get_fd_obj_and_vtable(fd, &vtable, NULL);
+		if (obj != p1) {
+			atomic_inc(&churn_errors);
+		}
+
+		if (i % 8 == 0) {
+			k_yield();
+		}
+
+		obj = z_get_fd_obj_and_vtable(fd, &vtable, NULL);
+		if (obj != p1) {
+			atomic_inc(&churn_errors);
+		}
+
+		z_free_fd(fd);
+	}
+}
+
+void test_z_fd_concurrent_alloc(void)
+{
+	static int objs[CHURN_THREADS];
+
+	atomic_set(&churn_errors, 0);
+
+	for (int i = 0; i < CHURN_THREADS; i++) {
+		k_thread_create(&churn_threads[i], churn_stacks[i],
+				K_THREAD_STACK_SIZEOF(churn_stacks[i]),
+				churn_cb, &objs[i], NULL, NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < CHURN_THREADS; i++) {
+		k_thread_join(&churn_threads[i], K_FOREVER);
+	}
+
+	zassert_equal(atomic_get(&churn_errors), 0,
+		      "descriptor shared between threads");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_fdtable,
@@ -184,7 +292,9 @@ void test_main(void)
 			 ztest_unit_test(test_z_finalize_fd),
 			 ztest_unit_test(test_z_alloc_fd),
 			 ztest_unit_test(test_z_free_fd),
-			 ztest_unit_test(test_z_fd_multiple_access)
+			 ztest_unit_test(test_z_fd_multiple_access),
+			 ztest_unit_test(test_z_reserve_fd_exhaust),
+			 ztest_unit_test(test_z_fd_concurrent_alloc)
 		);
 	ztest_run_test_suite(test_fdtable);
 }
@@ -485,6 +485,263 @@ static void test_heap_listeners(void)
 #endif /* CONFIG_SYS_HEAP_LISTENER */
 }
 
+/* Small block alloc/free throughput through the synchronized k_heap
+ * API, which is where CONFIG_HEAP_CPU_CACHE makes a difference.  Each
+ * round allocates a burst of mixed small sizes and then frees it, so
+ * the heap stays valid and the cache (if any) is exercised on both
+ * paths.
+ */
+#define KHEAP_BURST 16
+#define KHEAP_ROUNDS 512
+
+static void test_k_heap_throughput(void)
+{
+	static struct k_heap kheap;
+	void *blocks[KHEAP_BURST];
+	uint32_t start, cycles;
+	size_t largest;
+
+	k_heap_init(&kheap, heapmem, SMALL_HEAP_SZ);
+	largest = sys_heap_largest_free(&kheap.heap);
+	zassert_true(largest > SMALL_HEAP_SZ / 2, "largest free %zu", largest);
+
+	start = k_cycle_get_32();
+	for (int r = 0; r < KHEAP_ROUNDS; r++) {
+		for (int i = 0; i < KHEAP_BURST; i++) {
+			blocks[i] = k_heap_alloc(&kheap, 8 + 8 * (i % 8),
+						 K_NO_WAIT);
+			zassert_not_null(blocks[i], "alloc failed");
+		}
+		for (int i = 0; i < KHEAP_BURST; i++) {
+			k_heap_free(&kheap, blocks[i]);
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("k_heap small alloc/free: %u cycles/op\n",
+		 cycles / (2 * KHEAP_BURST * KHEAP_ROUNDS));
+	zassert_true(sys_heap_validate(&kheap.heap), "invalid heap");
+
+#ifdef CONFIG_HEAP_CPU_CACHE
+	k_heap_cache_flush(&kheap);
+#endif
+	zassert_equal(sys_heap_largest_free(&kheap.heap), largest,
+		      "free memory not merged back");
+}
+
+static void test_k_heap_cpu_cache(void)
+{
+#ifdef CONFIG_HEAP_CPU_CACHE
+	static struct k_heap kheap;
+	struct k_heap_cache_stats stats;
+	void *p1, *p2, *big;
+
+	k_heap_init(&kheap, heapmem, SMALL_HEAP_SZ);
+
+	zassert_equal(k_heap_cache_stats_get(NULL, &stats), -EINVAL, "");
+	zassert_equal(k_heap_cache_stats_get(&kheap, NULL), -EINVAL, "");
+
+	/* First allocation misses and refills, the freed block is
+	 * then handed back out by the next one of the same class.
+	 */
+	p1 = k_heap_alloc(&kheap, 10, K_NO_WAIT);
+	zassert_not_null(p1, "alloc failed");
+	k_heap_free(&kheap, p1);
+	p2 = k_heap_alloc(&kheap, 16, K_NO_WAIT);
+	zassert_equal(p1, p2, "cached block not reused");
+
+	zassert_equal(k_heap_cache_stats_get(&kheap, &stats), 0, "");
+	zassert_equal(stats.misses, 1, "misses %u", stats.misses);
+	zassert_equal(stats.hits, 1, "hits %u", stats.hits);
+	zassert_true(stats.cached_bytes > 0, "nothing cached");
+	zassert_equal(stats.largest_free,
+		      sys_heap_largest_free(&kheap.heap), "");
+	zassert_true(sys_heap_validate(&kheap.heap), "invalid heap");
+
+	/* Overfilling a magazine returns a batch to the heap */
+	void *blocks[CONFIG_HEAP_CPU_CACHE_DEPTH + 1];
+
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		blocks[i] = k_heap_alloc(&kheap, 16, K_NO_WAIT);
+		zassert_not_null(blocks[i], "alloc failed");
+	}
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		k_heap_free(&kheap, blocks[i]);
+	}
+	k_heap_free(&kheap, p2);
+
+	zassert_equal(k_heap_cache_stats_get(&kheap, &stats), 0, "");
+	zassert_true(stats.flushes > 0, "no flush");
+	zassert_true(sys_heap_validate(&kheap.heap), "invalid heap");
+
+	/* An allocation needing the whole heap only succeeds once
+	 * the cached blocks have been returned, which the slow path
+	 * must do on its own.
+	 */
+	big = k_heap_alloc(&kheap, SMALL_HEAP_SZ / 2, K_NO_WAIT);
+	zassert_not_null(big, "cache not flushed on failure");
+	k_heap_free(&kheap, big);
+
+	k_heap_cache_flush(&kheap);
+	zassert_equal(k_heap_cache_stats_get(&kheap, &stats), 0, "");
+	zassert_equal(stats.cached_bytes, 0, "cache not empty");
+	zassert_true(stats.largest_free >= SMALL_HEAP_SZ / 2,
+		     "largest free %zu", stats.largest_free);
+	zassert_true(sys_heap_validate(&kheap.heap), "invalid heap");
+#else
+	ztest_test_skip();
+#endif
+}
+
+#ifdef CONFIG_HEAP_CPU_CACHE
+static K_THREAD_STACK_DEFINE(waiter_stack, 1024);
+static struct k_thread waiter_thread;
+static struct k_heap waiter_heap;
+static void *waiter_mem;
+static int64_t waiter_ms;
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	int64_t start = k_uptime_get();
+
+	waiter_mem = k_heap_alloc(&waiter_heap, SMALL_HEAP_SZ / 2,
+				  K_SECONDS(5));
+	waiter_ms = k_uptime_get() - start;
+}
+#endif
+
+/* Frees of cacheable blocks must reach the heap, and wake a thread
+ * blocked on it, rather than be parked in a magazine.
+ */
+static void test_k_heap_cpu_cache_waiter(void)
+{
+#ifdef CONFIG_HEAP_CPU_CACHE
+	void *blocks[SMALL_HEAP_SZ / 16];
+	int count = 0;
+
+	k_heap_init(&waiter_heap, heapmem, SMALL_HEAP_SZ);
+
+	while (count < ARRAY_SIZE(blocks)) {
+		blocks[count] = k_heap_alloc(&waiter_heap, 16, K_NO_WAIT);
+		if (blocks[count] == NULL) {
+			break;
+		}
+		count++;
+	}
+
+	k_thread_create(&waiter_thread, waiter_stack,
+			K_THREAD_STACK_SIZEOF(waiter_stack), waiter,
+			NULL, NULL, NULL, K_HIGHEST_APPLICATION_THREAD_PRIO,
+			0, K_NO_WAIT);
+	k_sleep(K_MSEC(10));
+	zassert_is_null(waiter_mem, "allocated from a full heap");
+
+	for (int i = 0; i < count; i++) {
+		k_heap_free(&waiter_heap, blocks[i]);
+	}
+
+	zassert_equal(k_thread_join(&waiter_thread, K_SECONDS(10)), 0, "");
+	zassert_not_null(waiter_mem, "waiter not served");
+	zassert_true(waiter_ms < 1000, "waiter woken late, %lld ms",
+		     waiter_ms);
+
+	k_heap_free(&waiter_heap, waiter_mem);
+	zassert_true(sys_heap_validate(&waiter_heap.heap), "invalid heap");
+#else
+	ztest_test_skip();
+#endif
+}
+
+#define STRESS_THREADS 4
+#define STRESS_BLOCKS 8
+#define STRESS_ROUNDS 2000
+
+static K_THREAD_STACK_ARRAY_DEFINE(stress_stacks, STRESS_THREADS, 1024);
+static struct k_thread stress_threads[STRESS_THREADS];
+static struct k_heap stress_heap;
+
+static void stress_thread(void *p1, void *p2, void *p3)
+{
+	uint32_t seed = POINTER_TO_UINT(p1) + 1U;
+	void *blocks[STRESS_BLOCKS] = { NULL };
+
+	for (int r = 0; r < STRESS_ROUNDS; r++) {
+		int i;
+
+		seed = seed * 1103515245U + 12345U;
+		i = (seed >> 16) % STRESS_BLOCKS;
+
+		if (blocks[i] == NULL) {
+			/* Mostly cacheable sizes, a few larger ones */
+			size_t sz = ((seed & 0xf) == 0U) ?
+				    200 + (seed >> 4) % 200 :
+				    8 + (seed >> 4) % 56;
+
+			blocks[i] = k_heap_alloc(&stress_heap, sz,
+						 K_MSEC(10));
+			fill_block(blocks[i], sz);
+		} else {
+			check_fill(blocks[i]);
+			k_heap_free(&stress_heap, blocks[i]);
+			blocks[i] = NULL;
+		}
+
+		if ((seed & 0x700) == 0U) {
+			k_yield();
+		}
+	}
+
+	for (int i = 0; i < STRESS_BLOCKS; i++) {
+		if (blocks[i] != NULL) {
+			check_fill(blocks[i]);
+			k_heap_free(&stress_heap, blocks[i]);
+		}
+	}
+}
+
+/* Several threads at one priority allocate and free from the same
+ * k_heap, yielding to each other and, where the timer can preempt
+ * them, time sliced at every tick.  This needs no SMP: with
+ * CONFIG_HEAP_CPU_CACHE they all share the magazines of the one CPU.
+ * Once done, all the memory must merge back into the heap.
+ */
+static void test_k_heap_stress(void)
+{
+	int prio = K_LOWEST_APPLICATION_THREAD_PRIO;
+	size_t largest;
+
+	k_heap_init(&stress_heap, heapmem, SMALL_HEAP_SZ);
+	largest = sys_heap_largest_free(&stress_heap.heap);
+
+	k_sched_time_slice_set(1, prio);
+	for (int i = 0; i < STRESS_THREADS; i++) {
+		k_thread_create(&stress_threads[i], stress_stacks[i],
+				K_THREAD_STACK_SIZEOF(stress_stacks[i]),
+				stress_thread, UINT_TO_POINTER(i), NULL, NULL,
+				prio, 0, K_NO_WAIT);
+	}
+	for (int i = 0; i < STRESS_THREADS; i++) {
+		zassert_equal(k_thread_join(&stress_threads[i], K_FOREVER),
+			      0, "");
+	}
+	k_sched_time_slice_set(0, prio);
+
+	zassert_true(sys_heap_validate(&stress_heap.heap), "invalid heap");
+#ifdef CONFIG_HEAP_CPU_CACHE
+	struct k_heap_cache_stats stats;
+
+	zassert_equal(k_heap_cache_stats_get(&stress_heap, &stats), 0, "");
+	TC_PRINT("cache hits %u misses %u flushes %u, %zu bytes cached, "
+		 "largest free %zu\n", stats.hits, stats.misses,
+		 stats.flushes, stats.cached_bytes, stats.largest_free);
+	zassert_true(stats.hits > 0, "cache unused");
+
+	k_heap_cache_flush(&stress_heap);
+#endif
+	zassert_equal(sys_heap_largest_free(&stress_heap.heap), largest,
+		      "memory leaked");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_heap_test,
@@ -493,7 +750,11 @@ void test_main(void)
 			 ztest_unit_test(test_fragmentation),
 			 ztest_unit_test(test_big_heap),
 			 ztest_unit_test(test_solo_free_header),
-			 ztest_unit_test(test_heap_listeners)
+			 ztest_unit_test(test_heap_listeners),
+			 ztest_unit_test(test_k_heap_throughput),
+			 ztest_unit_test(test_k_heap_cpu_cache),
+			 ztest_unit_test(test_k_heap_cpu_cache_waiter),
+			 ztest_unit_test(test_k_heap_stress)
 			 );
 
 	ztest_run_test_suite(lib_heap_test);
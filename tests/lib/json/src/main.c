@@ -6,6 +6,7 @@
 #include <string.h>
 #include <zephyr/types.h>
 #include <stdbool.h>
+#include <float.h>
 #include <ztest.h>
 #include <data/json.h>
 
@@ -557,6 +558,148 @@ static void test_json_key_not_in_descr(void)
 	zassert_equal(ret, 0, "No items should be decoded");
 }
 
+#define MANY_FIELDS 40
+#define MANY_FIELD(i, _) int f##i
+#define MANY_FIELD_DESCR(i, _) \
+	JSON_OBJ_DESCR_PRIM(struct test_many, f##i, JSON_TOK_NUMBER)
+
+struct test_many {
+	LISTIFY(MANY_FIELDS, MANY_FIELD, (;));
+};
+
+static const struct json_obj_descr many_descr[] = {
+	LISTIFY(MANY_FIELDS, MANY_FIELD_DESCR, (,))
+};
+
+static void test_json_many_fields(void)
+{
+	struct test_many many;
+	char encoded[MANY_FIELDS * sizeof("\"f00\":-100,")];
+	int64_t ret;
+	size_t len;
+
+	/* Encode back to front, to also check out of order lookups */
+	len = snprintk(encoded, sizeof(encoded), "{");
+	for (int i = MANY_FIELDS - 1; i >= 0; i--) {
+		len += snprintk(encoded + len, sizeof(encoded) - len,
+				"\"f%d\":%d%s", i, -i, i > 0 ? "," : "}");
+	}
+
+	ret = json_obj_parse64(encoded, len, many_descr, ARRAY_SIZE(many_descr),
+			       &many);
+	zassert_equal(ret, BIT64_MASK(MANY_FIELDS),
+		      "Not all fields decoded correctly");
+	zassert_equal(many.f0, 0, NULL);
+	zassert_equal(many.f31, -31, NULL);
+	zassert_equal(many.f32, -32, NULL);
+	zassert_equal(many.f39, -39, NULL);
+}
+
+struct test_wide_numbers {
+	int64_t big;
+	int64_t small;
+	double dbl[6];
+	size_t dbl_len;
+};
+
+static const struct json_obj_descr wide_numbers_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct test_wide_numbers, big, JSON_TOK_INT64),
+	JSON_OBJ_DESCR_PRIM(struct test_wide_numbers, small, JSON_TOK_INT64),
+	JSON_OBJ_DESCR_ARRAY(struct test_wide_numbers, dbl, 6, dbl_len,
+			     JSON_TOK_DOUBLE),
+};
+
+static void test_json_int64(void)
+{
+	struct test_wide_numbers nums = {
+		.big = INT64_MAX,
+		.small = INT64_MIN,
+	};
+	char encoded[] = "{\"big\":9223372036854775807,"
+			 "\"small\":-9223372036854775808,"
+			 "\"dbl\":[]}";
+	char buffer[sizeof(encoded)];
+	int ret;
+
+	ret = json_obj_encode_buf(wide_numbers_descr,
+				  ARRAY_SIZE(wide_numbers_descr), &nums,
+				  buffer, sizeof(buffer));
+	zassert_equal(ret, 0, "Encoding function failed");
+	zassert_true(!strcmp(buffer, encoded), "Encoded '%s'", buffer);
+
+	memset(&nums, 0, sizeof(nums));
+	ret = json_obj_parse(encoded, sizeof(encoded) - 1, wide_numbers_descr,
+			     ARRAY_SIZE(wide_numbers_descr), &nums);
+	zassert_equal(ret, BIT64_MASK(ARRAY_SIZE(wide_numbers_descr)),
+		      "Not all fields decoded correctly");
+	zassert_equal(nums.big, INT64_MAX, NULL);
+	zassert_equal(nums.small, INT64_MIN, NULL);
+
+	strcpy(encoded, "{\"big\":9223372036854775808}");
+	ret = json_obj_parse(encoded, strlen(encoded), wide_numbers_descr,
+			     ARRAY_SIZE(wide_numbers_descr), &nums);
+	zassert_equal(ret, -ERANGE, "Overflow not detected");
+}
+
+static void test_json_double(void)
+{
+	struct test_wide_numbers nums;
+	char encoded[] = "{\"dbl\":[0.5,-1.25e3,1E-2,123456789012,"
+			 "0.1,1.5e300]}";
+	char precise[] = "{\"dbl\":[0.30000000000000004,"
+			 "1.7976931348623157e308]}";
+	const double expected[] = {
+		0.5, -1.25e3, 1E-2, 123456789012.0, 0.1, 1.5e300
+	};
+	char buffer[sizeof(encoded) * 2];
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_JSON_LIBRARY_FP_SUPPORT)) {
+		ztest_test_skip();
+	}
+
+	ret = json_obj_parse(encoded, sizeof(encoded) - 1, wide_numbers_descr,
+			     ARRAY_SIZE(wide_numbers_descr), &nums);
+	zassert_equal(ret, BIT(2), "Array not decoded");
+	zassert_equal(nums.dbl_len, ARRAY_SIZE(expected), NULL);
+	for (int i = 0; i < ARRAY_SIZE(expected); i++) {
+		zassert_equal(nums.dbl[i], expected[i], "dbl[%d]", i);
+	}
+
+	ret = json_obj_parse(precise, sizeof(precise) - 1, wide_numbers_descr,
+			     ARRAY_SIZE(wide_numbers_descr), &nums);
+	zassert_equal(ret, BIT(2), "Array not decoded");
+	zassert_equal(nums.dbl[0], 0.30000000000000004, NULL);
+	zassert_equal(nums.dbl[1], DBL_MAX, NULL);
+
+	strcpy(encoded, "{\"dbl\":[1e999]}");
+	ret = json_obj_parse(encoded, strlen(encoded), wide_numbers_descr,
+			     ARRAY_SIZE(wide_numbers_descr), &nums);
+	zassert_equal(ret, -EINVAL, "Overflow not detected");
+
+	if (!IS_ENABLED(CONFIG_CBPRINTF_FP_SUPPORT)) {
+		return;
+	}
+
+	/* Encoded doubles have to read back the same */
+	memset(&nums, 0, sizeof(nums));
+	memcpy(nums.dbl, expected, sizeof(expected));
+	nums.dbl_len = ARRAY_SIZE(expected);
+	ret = json_obj_encode_buf(wide_numbers_descr,
+				  ARRAY_SIZE(wide_numbers_descr), &nums,
+				  buffer, sizeof(buffer));
+	zassert_equal(ret, 0, "Encoding function failed");
+
+	memset(&nums, 0, sizeof(nums));
+	ret = json_obj_parse(buffer, strlen(buffer), wide_numbers_descr,
+			     ARRAY_SIZE(wide_numbers_descr), &nums);
+	zassert_equal(ret, BIT64_MASK(ARRAY_SIZE(wide_numbers_descr)),
+		      "Encoded '%s' not decoded", buffer);
+	for (int i = 0; i < ARRAY_SIZE(expected); i++) {
+		zassert_equal(nums.dbl[i], expected[i], "dbl[%d]", i);
+	}
+}
+
 static void test_json_escape(void)
 {
 	char buf[42];
@@ -662,6 +805,12 @@ static void test_json_encode_bounds_check(void)
 	zassert_equal(ret, -ENOMEM, "Bounds check failed");
 }
 
+extern void test_json_stream(void);
+extern void test_json_stream_chunks(void);
+extern void test_json_stream_invalid(void);
+extern void test_json_stream_limits(void);
+extern void test_json_throughput(void);
+
 void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
@@ -686,7 +835,15 @@ void test_main(void)
 			 ztest_unit_test(test_json_encode_bounds_check),
 			 ztest_unit_test(test_json_limits),
 			 ztest_unit_test(test_json_arr_obj_encoding),
-			 ztest_unit_test(test_json_arr_obj_decoding)
+			 ztest_unit_test(test_json_arr_obj_decoding),
+			 ztest_unit_test(test_json_many_fields),
+			 ztest_unit_test(test_json_int64),
+			 ztest_unit_test(test_json_double),
+			 ztest_unit_test(test_json_stream),
+			 ztest_unit_test(test_json_stream_chunks),
+			 ztest_unit_test(test_json_stream_invalid),
+			 ztest_unit_test(test_json_stream_limits),
+			 ztest_unit_test(test_json_throughput)
 			 );
 
 	ztest_run_test_suite(lib_json_test);
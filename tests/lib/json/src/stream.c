@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <data/json.h>
+#include <timing/timing.h>
+
+struct collect {
+	char out[256];
+	size_t len;
+	int fail_at;
+	int count;
+};
+
+/* Append a token as "<type><depth>[value]" with ':' after keys, so a
+ * whole document turns into one string that is easy to compare.
+ */
+static int collect_cb(const struct json_stream_token *token, void *user_data)
+{
+	struct collect *c = user_data;
+
+	if (++c->count == c->fail_at) {
+		return -ECANCELED;
+	}
+
+	c->len += snprintk(c->out + c->len, sizeof(c->out) - c->len, "%c%u",
+			   token->type, token->depth);
+	if (token->value != NULL) {
+		c->len += snprintk(c->out + c->len, sizeof(c->out) - c->len,
+				   "[%.*s]", (int)token->len, token->value);
+	}
+	if (token->key) {
+		c->len += snprintk(c->out + c->len, sizeof(c->out) - c->len,
+				   ":");
+	}
+
+	return 0;
+}
+
+static const char doc[] =
+	" {\"name\" : \"zephyr\\\"\\u00e9\", \"n\":[1, -2.5e+3, 0],\n"
+	"\"o\":{\"t\":true,\"f\":false,\"z\":null,\"e\":{}},\"a\":[[],[{}]]}\t";
+
+static const char doc_tokens[] =
+	"{0\"1[name]:\"1[zephyr\\\"\\u00e9]\"1[n]:[1" "02[1]" "02[-2.5e+3]"
+	"02[0]]1\"1[o]:{1\"2[t]:t2[true]\"2[f]:f2[false]\"2[z]:n2[null]"
+	"\"2[e]:{2}2}1\"1[a]:[1[2]2[2{3}3]2]1}0";
+
+static int stream_all(const char *data, size_t len, size_t chunk,
+		      struct collect *c, char *buf, size_t buf_size)
+{
+	struct json_stream stream;
+	int ret;
+
+	json_stream_init(&stream, buf, buf_size, collect_cb, c);
+
+	for (size_t i = 0; i < len; i += chunk) {
+		ret = json_stream_feed(&stream, data + i, MIN(chunk, len - i));
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return json_stream_finish(&stream);
+}
+
+void test_json_stream(void)
+{
+	struct collect c = { 0 };
+	char buf[16];
+	int ret;
+
+	ret = stream_all(doc, sizeof(doc) - 1, sizeof(doc), &c, buf,
+			 sizeof(buf));
+	zassert_equal(ret, 0, "Streaming failed: %d", ret);
+	zassert_true(!strcmp(c.out, doc_tokens), "Got '%s'", c.out);
+
+	/* Top level scalars, the number only ends with the document */
+	memset(&c, 0, sizeof(c));
+	ret = stream_all(" -12.5e3 ", 9, 9, &c, buf, sizeof(buf));
+	zassert_equal(ret, 0, NULL);
+	zassert_true(!strcmp(c.out, "00[-12.5e3]"), "Got '%s'", c.out);
+
+	memset(&c, 0, sizeof(c));
+	ret = stream_all("42", 2, 1, &c, buf, sizeof(buf));
+	zassert_equal(ret, 0, NULL);
+	zassert_true(!strcmp(c.out, "00[42]"), "Got '%s'", c.out);
+
+	memset(&c, 0, sizeof(c));
+	ret = stream_all("\"s\"", 3, 3, &c, buf, sizeof(buf));
+	zassert_equal(ret, 0, NULL);
+	zassert_true(!strcmp(c.out, "\"0[s]"), "Got '%s'", c.out);
+}
+
+void test_json_stream_chunks(void)
+{
+	struct json_stream stream;
+	struct collect c;
+	char buf[16];
+	int ret;
+
+	for (size_t chunk = 1; chunk < sizeof(doc); chunk++) {
+		memset(&c, 0, sizeof(c));
+		ret = stream_all(doc, sizeof(doc) - 1, chunk, &c, buf,
+				 sizeof(buf));
+		zassert_equal(ret, 0, "chunk %zu failed: %d", chunk, ret);
+		zassert_true(!strcmp(c.out, doc_tokens), "chunk %zu: '%s'",
+			     chunk, c.out);
+	}
+
+	/* Split in two at every position */
+	for (size_t split = 0; split < sizeof(doc); split++) {
+		memset(&c, 0, sizeof(c));
+		json_stream_init(&stream, buf, sizeof(buf), collect_cb, &c);
+		zassert_ok(json_stream_feed(&stream, doc, split), NULL);
+		zassert_ok(json_stream_feed(&stream, doc + split,
+					    sizeof(doc) - 1 - split), NULL);
+		zassert_ok(json_stream_finish(&stream), NULL);
+		zassert_true(!strcmp(c.out, doc_tokens), "split %zu: '%s'",
+			     split, c.out);
+	}
+}
+
+void test_json_stream_invalid(void)
+{
+	static const char * const invalid[] = {
+		"", "{", "}", "[1,]", "{\"a\":1,}", "{\"a\" 1}", "{\"a\":1]",
+		"[1}", "{1:2}", "[1 2]", "[tru]", "[nul1]", "[\"a\\x\"]",
+		"[\"\\u12g4\"]", "[1.]", "[-]", "[1e]", "[01]", "{} {}",
+		"[\"a\nb\"]", "[]]", "{\"a\"::1}", "[,1]",
+	};
+	struct collect c;
+	char buf[16];
+	int ret;
+
+	for (int i = 0; i < ARRAY_SIZE(invalid); i++) {
+		for (size_t chunk = 1; chunk <= 8; chunk *= 8) {
+			memset(&c, 0, sizeof(c));
+			ret = stream_all(invalid[i], strlen(invalid[i]), chunk,
+					 &c, buf, sizeof(buf));
+			zassert_equal(ret, -EINVAL, "'%s' by %zu gave %d",
+				      invalid[i], chunk, ret);
+		}
+	}
+}
+
+void test_json_stream_limits(void)
+{
+	char deep[2 * (JSON_STREAM_MAX_DEPTH + 1)];
+	struct json_stream stream;
+	struct collect c = { 0 };
+	char buf[4];
+	int ret;
+
+	/* A token split across chunks has to fit the buffer */
+	ret = stream_all("[\"abcdef\"]", 10, 3, &c, buf, sizeof(buf));
+	zassert_equal(ret, -ENOMEM, "Got %d", ret);
+
+	/* ... but not one handed over in one piece */
+	memset(&c, 0, sizeof(c));
+	ret = stream_all("[\"abcdef\"]", 10, 10, &c, buf, sizeof(buf));
+	zassert_equal(ret, 0, "Got %d", ret);
+
+	for (int depth = JSON_STREAM_MAX_DEPTH; depth <= JSON_STREAM_MAX_DEPTH + 1;
+	     depth++) {
+		memset(deep, '[', depth);
+		memset(deep + depth, ']', depth);
+		memset(&c, 0, sizeof(c));
+		ret = stream_all(deep, 2 * depth, 2 * depth, &c, buf,
+				 sizeof(buf));
+		zassert_equal(ret, depth > JSON_STREAM_MAX_DEPTH ? -E2BIG : 0,
+			      "depth %d gave %d", depth, ret);
+	}
+
+	/* Callback errors stop the tokenizer and stick */
+	memset(&c, 0, sizeof(c));
+	c.fail_at = 3;
+	json_stream_init(&stream, buf, sizeof(buf), collect_cb, &c);
+	ret = json_stream_feed(&stream, "[1,2,3]", 7);
+	zassert_equal(ret, -ECANCELED, "Got %d", ret);
+	zassert_equal(c.count, 3, "Callback called after an error");
+	ret = json_stream_feed(&stream, "[", 1);
+	zassert_equal(ret, -ECANCELED, "Error not sticky");
+	zassert_equal(json_stream_finish(&stream), -ECANCELED, NULL);
+}
+
+/* A device status report in the shape of those parsed by subsys/mgmt */
+struct bench_chunk {
+	const char *part;
+	const char *name;
+	const char *version;
+	int size;
+};
+
+struct bench_doc {
+	const char *id;
+	int time;
+	bool active;
+	struct bench_chunk chunks[4];
+	size_t chunks_len;
+};
+
+static const struct json_obj_descr bench_chunk_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct bench_chunk, part, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct bench_chunk, name, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct bench_chunk, version, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct bench_chunk, size, JSON_TOK_NUMBER),
+};
+
+static const struct json_obj_descr bench_doc_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct bench_doc, id, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct bench_doc, time, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct bench_doc, active, JSON_TOK_TRUE),
+	JSON_OBJ_DESCR_OBJ_ARRAY(struct bench_doc, chunks, 4, chunks_len,
+				 bench_chunk_descr,
+				 ARRAY_SIZE(bench_chunk_descr)),
+};
+
+static const char bench_json[] =
+	"{\"id\":\"f3a1c2d4\",\"time\":1650000000,\"active\":true,"
+	"\"chunks\":[{\"part\":\"os\",\"name\":\"zephyr\","
+	"\"version\":\"3.0.99\",\"size\":262144},"
+	"{\"part\":\"app\",\"name\":\"sensor-hub\","
+	"\"version\":\"1.4.2\",\"size\":65536},"
+	"{\"part\":\"bt\",\"name\":\"controller\","
+	"\"version\":\"2.1.0\",\"size\":131072}]}";
+
+#define BENCH_RUNS 200
+#define BENCH_CHUNK 64
+
+static int count_cb(const struct json_stream_token *token, void *user_data)
+{
+	(*(int *)user_data)++;
+
+	return 0;
+}
+
+static uint32_t kb_per_sec(uint64_t cycles)
+{
+	uint64_t ns = timing_cycles_to_ns(cycles);
+
+	return ns == 0U ? 0U :
+	       (uint32_t)((uint64_t)BENCH_RUNS * (sizeof(bench_json) - 1) *
+			  NSEC_PER_SEC / 1024U / ns);
+}
+
+/**
+ * @brief Compare decoding into a struct with streaming tokenization
+ *
+ * @details json_obj_parse() modifies its input, so each run decodes a
+ * fresh copy.  The streaming tokenizer gets the document in
+ * BENCH_CHUNK byte pieces, as it would arrive from a socket.
+ */
+void test_json_throughput(void)
+{
+	static char work[sizeof(bench_json)];
+	struct json_stream stream;
+	struct bench_doc bench;
+	timing_t start, end;
+	uint64_t parse, tokenize;
+	char buf[32];
+	int tokens = 0;
+	int ret;
+
+	timing_init();
+	timing_start();
+
+	start = timing_counter_get();
+	for (int i = 0; i < BENCH_RUNS; i++) {
+		memcpy(work, bench_json, sizeof(bench_json));
+		ret = json_obj_parse(work, sizeof(bench_json) - 1,
+				     bench_doc_descr,
+				     ARRAY_SIZE(bench_doc_descr), &bench);
+		zassert_equal(ret, BIT_MASK(ARRAY_SIZE(bench_doc_descr)),
+			      "Decoding failed");
+	}
+	end = timing_counter_get();
+	parse = timing_cycles_get(&start, &end);
+
+	start = timing_counter_get();
+	for (int i = 0; i < BENCH_RUNS; i++) {
+		json_stream_init(&stream, buf, sizeof(buf), count_cb, &tokens);
+		for (size_t j = 0; j < sizeof(bench_json) - 1;
+		     j += BENCH_CHUNK) {
+			json_stream_feed(&stream, bench_json + j,
+					 MIN(BENCH_CHUNK,
+					     sizeof(bench_json) - 1 - j));
+		}
+		zassert_ok(json_stream_finish(&stream), "Streaming failed");
+	}
+	end = timing_counter_get();
+	tokenize = timing_cycles_get(&start, &end);
+
+	timing_stop();
+
+	zassert_equal(bench.chunks_len, 3, NULL);
+	zassert_equal(bench.chunks[2].size, 131072, NULL);
+	zassert_equal(tokens, BENCH_RUNS * 41, "Got %d tokens", tokens);
+
+	TC_PRINT("json_obj_parse   %8u KB/s\n", kb_per_sec(parse));
+	TC_PRINT("json_stream_feed %8u KB/s\n", kb_per_sec(tokenize));
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <sys/mem_blocks.h>
+#include <sys/sys_heap.h>
+#include <sys/util.h>
+
+#define BLK_SZ      64
+#define NUM_BLOCKS  8
+#define BIG_BLOCKS  64
+#define BENCH_SLOTS 16
+#define BENCH_OPS   4096
+
+SYS_MEM_BLOCKS_DEFINE_BUDDY(buddy_01, BLK_SZ, NUM_BLOCKS, 4);
+SYS_MEM_BLOCKS_DEFINE_BUDDY_STATIC(buddy_02, BLK_SZ, BIG_BLOCKS, 4);
+SYS_MEM_BLOCKS_DEFINE_STATIC(first_fit, BLK_SZ, BIG_BLOCKS, 4);
+
+/* Room for the same blocks plus the heap's own bookkeeping */
+static uint8_t heap_mem[BLK_SZ * BIG_BLOCKS + 512];
+static struct sys_heap heap;
+
+static sys_multi_mem_blocks_t buddy_group;
+
+static void *block_at(sys_mem_blocks_t *mem_block, size_t idx)
+{
+	return mem_block->buffer + idx * BLK_SZ;
+}
+
+static void check_stats(sys_mem_blocks_t *mem_block, size_t free_blocks,
+			size_t max_free_chunk)
+{
+	struct sys_mem_blocks_buddy_stats stats;
+	int ret;
+
+	ret = sys_mem_blocks_buddy_stats_get(mem_block, &stats);
+	zassert_equal(ret, 0, "stats failed (%d)", ret);
+	zassert_equal(stats.free_blocks, free_blocks,
+		      "%zu blocks free, expected %zu", stats.free_blocks,
+		      free_blocks);
+	zassert_equal(stats.max_free_chunk, max_free_chunk,
+		      "largest free chunk %zu, expected %zu",
+		      stats.max_free_chunk, max_free_chunk);
+}
+
+static void test_buddy_alloc_free(void)
+{
+	void *blocks[NUM_BLOCKS];
+	int ret;
+
+	/* Single blocks come out in address order */
+	for (int j = 0; j < 4; j++) {
+		ret = sys_mem_blocks_alloc(&buddy_01, NUM_BLOCKS, blocks);
+		zassert_equal(ret, 0, "sys_mem_blocks_alloc failed (%d)", ret);
+		for (int i = 0; i < NUM_BLOCKS; i++) {
+			zassert_equal(blocks[i], block_at(&buddy_01, i),
+				      "block %d out of order", i);
+		}
+		check_stats(&buddy_01, 0, 0);
+
+		ret = sys_mem_blocks_alloc(&buddy_01, 1, blocks);
+		zassert_equal(ret, -ENOMEM, "allocated from an empty object");
+
+		ret = sys_mem_blocks_free(&buddy_01, NUM_BLOCKS, blocks);
+		zassert_equal(ret, 0, "sys_mem_blocks_free failed (%d)", ret);
+		check_stats(&buddy_01, NUM_BLOCKS, NUM_BLOCKS);
+	}
+
+	ret = sys_mem_blocks_free(&buddy_01, 1, blocks);
+	zassert_equal(ret, -EFAULT, "freed a free block");
+	check_stats(&buddy_01, NUM_BLOCKS, NUM_BLOCKS);
+}
+
+static void test_buddy_split_merge(void)
+{
+	void *a, *b, *c;
+	int ret;
+
+	/* Three blocks take an aligned chunk of four, the fourth block
+	 * is free again right away
+	 */
+	ret = sys_mem_blocks_alloc_contiguous(&buddy_01, 3, &a);
+	zassert_equal(ret, 0, "alloc failed (%d)", ret);
+	zassert_equal(a, block_at(&buddy_01, 0), NULL);
+	check_stats(&buddy_01, 5, 4);
+
+	/* Two blocks split the free chunk of four */
+	ret = sys_mem_blocks_alloc_contiguous(&buddy_01, 2, &b);
+	zassert_equal(ret, 0, "alloc failed (%d)", ret);
+	zassert_equal(b, block_at(&buddy_01, 4), NULL);
+	check_stats(&buddy_01, 3, 2);
+
+	/* One block fits the single free one left of the first chunk */
+	ret = sys_mem_blocks_alloc_contiguous(&buddy_01, 1, &c);
+	zassert_equal(ret, 0, "alloc failed (%d)", ret);
+	zassert_equal(c, block_at(&buddy_01, 3), NULL);
+	check_stats(&buddy_01, 2, 2);
+
+	ret = sys_mem_blocks_alloc_contiguous(&buddy_01, 3, &a);
+	zassert_equal(ret, -ENOMEM, "no chunk of four is free");
+
+	/* Freeing merges buddies all the way up */
+	ret = sys_mem_blocks_free_contiguous(&buddy_01, block_at(&buddy_01, 0),
+					     3);
+	zassert_equal(ret, 0, "free failed (%d)", ret);
+	check_stats(&buddy_01, 5, 2);
+
+	ret = sys_mem_blocks_free_contiguous(&buddy_01, c, 1);
+	zassert_equal(ret, 0, "free failed (%d)", ret);
+	check_stats(&buddy_01, 6, 4);
+
+	ret = sys_mem_blocks_free_contiguous(&buddy_01, b, 2);
+	zassert_equal(ret, 0, "free failed (%d)", ret);
+	check_stats(&buddy_01, NUM_BLOCKS, NUM_BLOCKS);
+
+	/* A run may be freed in parts other than it was allocated in */
+	ret = sys_mem_blocks_alloc_contiguous(&buddy_01, 5, &a);
+	zassert_equal(ret, 0, "alloc failed (%d)", ret);
+	check_stats(&buddy_01, 3, 2);
+	ret = sys_mem_blocks_free_contiguous(&buddy_01, block_at(&buddy_01, 1),
+					     4);
+	zassert_equal(ret, 0, "free failed (%d)", ret);
+	ret = sys_mem_blocks_free_contiguous(&buddy_01, a, 1);
+	zassert_equal(ret, 0, "free failed (%d)", ret);
+	check_stats(&buddy_01, NUM_BLOCKS, NUM_BLOCKS);
+}
+
+static void test_buddy_get(void)
+{
+	void *a;
+	int ret;
+
+	/* Taking blocks 2 to 4 splits both halves */
+	ret = sys_mem_blocks_get(&buddy_01, block_at(&buddy_01, 2), 3);
+	zassert_equal(ret, 0, "get failed (%d)", ret);
+	check_stats(&buddy_01, 5, 2);
+
+	ret = sys_mem_blocks_get(&buddy_01, block_at(&buddy_01, 4), 1);
+	zassert_equal(ret, -ENOMEM, "got a taken block");
+
+	ret = sys_mem_blocks_alloc_contiguous(&buddy_01, 2, &a);
+	zassert_equal(ret, 0, "alloc failed (%d)", ret);
+	zassert_equal(a, block_at(&buddy_01, 0), NULL);
+
+	ret = sys_mem_blocks_free_contiguous(&buddy_01, block_at(&buddy_01, 0),
+					     5);
+	zassert_equal(ret, 0, "free failed (%d)", ret);
+	check_stats(&buddy_01, NUM_BLOCKS, NUM_BLOCKS);
+}
+
+static sys_mem_blocks_t *buddy_choice(struct sys_multi_mem_blocks *group,
+				      void *cfg)
+{
+	ARG_UNUSED(cfg);
+
+	return group->allocators[0];
+}
+
+static void test_buddy_multi(void)
+{
+	void *blocks[NUM_BLOCKS];
+	size_t blk_size;
+	int ret;
+
+	sys_multi_mem_blocks_init(&buddy_group, buddy_choice);
+	sys_multi_mem_blocks_add_allocator(&buddy_group, &buddy_01);
+
+	ret = sys_multi_mem_blocks_alloc(&buddy_group, NULL, NUM_BLOCKS / 2,
+					 blocks, &blk_size);
+	zassert_equal(ret, 0, "sys_multi_mem_blocks_alloc failed (%d)", ret);
+	zassert_equal(blk_size, BLK_SZ, NULL);
+	check_stats(&buddy_01, NUM_BLOCKS / 2, NUM_BLOCKS / 2);
+
+	ret = sys_multi_mem_blocks_free(&buddy_group, NUM_BLOCKS / 2, blocks);
+	zassert_equal(ret, 0, "sys_multi_mem_blocks_free failed (%d)", ret);
+	check_stats(&buddy_01, NUM_BLOCKS, NUM_BLOCKS);
+}
+
+struct slot {
+	void *mem;
+	size_t count;
+};
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+
+	return rand_state >> 16;
+}
+
+static size_t bits_set(sys_bitarray_t *bitarray)
+{
+	size_t count = 0;
+
+	for (int i = 0; i < bitarray->num_bundles; i++) {
+		count += __builtin_popcount(bitarray->bundles[i]);
+	}
+
+	return count;
+}
+
+/* Random runs of blocks, checking the free chunks against the bitmap
+ * of allocated blocks after every step
+ */
+static void test_buddy_random(void)
+{
+	struct slot slots[BENCH_SLOTS] = { 0 };
+	struct sys_mem_blocks_buddy_stats stats;
+	size_t allocated = 0;
+	int ret;
+
+	rand_state = 1U;
+
+	for (int i = 0; i < BENCH_OPS; i++) {
+		struct slot *slot = &slots[next_rand() % BENCH_SLOTS];
+
+		if (slot->mem != NULL) {
+			ret = sys_mem_blocks_free_contiguous(&buddy_02,
+							     slot->mem,
+							     slot->count);
+			zassert_equal(ret, 0, "free failed (%d)", ret);
+			allocated -= slot->count;
+			slot->mem = NULL;
+		} else {
+			slot->count = next_rand() % 12 + 1;
+			ret = sys_mem_blocks_alloc_contiguous(&buddy_02,
+							      slot->count,
+							      &slot->mem);
+			if (ret == 0) {
+				allocated += slot->count;
+			} else {
+				slot->mem = NULL;
+			}
+		}
+
+		/* The free chunks have to add up with the blocks bitmap */
+		zassert_ok(sys_mem_blocks_buddy_stats_get(&buddy_02, &stats),
+			   NULL);
+		zassert_equal(stats.free_blocks, BIG_BLOCKS - allocated,
+			      "%zu free blocks, %zu allocated",
+			      stats.free_blocks, allocated);
+		zassert_equal(bits_set(buddy_02.bitmap), allocated, NULL);
+	}
+
+	for (int i = 0; i < BENCH_SLOTS; i++) {
+		if (slots[i].mem != NULL) {
+			sys_mem_blocks_free_contiguous(&buddy_02, slots[i].mem,
+						       slots[i].count);
+		}
+	}
+	check_stats(&buddy_02, BIG_BLOCKS, BIG_BLOCKS);
+}
+
+static void *bench_alloc(void *alloc, size_t count)
+{
+	void *mem = NULL;
+
+	if (alloc == &heap) {
+		return sys_heap_alloc(&heap, count * BLK_SZ);
+	}
+
+	(void)sys_mem_blocks_alloc_contiguous(alloc, count, &mem);
+	return mem;
+}
+
+static void bench_free(void *alloc, void *mem, size_t count)
+{
+	if (alloc == &heap) {
+		sys_heap_free(&heap, mem);
+	} else {
+		sys_mem_blocks_free_contiguous(alloc, mem, count);
+	}
+}
+
+/* Random allocations of 1 to 8 blocks into a fixed number of slots,
+ * the same sequence for every allocator
+ */
+static void bench(const char *name, void *alloc)
+{
+	struct slot slots[BENCH_SLOTS] = { 0 };
+	uint32_t start, cycles, failed = 0U;
+
+	rand_state = 1U;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < BENCH_OPS; i++) {
+		struct slot *slot = &slots[next_rand() % BENCH_SLOTS];
+
+		if (slot->mem != NULL) {
+			bench_free(alloc, slot->mem, slot->count);
+			slot->mem = NULL;
+		} else {
+			slot->count = next_rand() % 8 + 1;
+			slot->mem = bench_alloc(alloc, slot->count);
+			failed += slot->mem == NULL;
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	for (int i = 0; i < BENCH_SLOTS; i++) {
+		if (slots[i].mem != NULL) {
+			bench_free(alloc, slots[i].mem, slots[i].count);
+		}
+	}
+
+	TC_PRINT("%-9s ops %5u failed %4u cycles/op %6u\n", name,
+		 BENCH_OPS, failed, cycles / BENCH_OPS);
+}
+
+static void test_buddy_throughput(void)
+{
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+
+	bench("buddy", &buddy_02);
+	bench("first fit", &first_fit);
+	bench("sys_heap", &heap);
+
+	check_stats(&buddy_02, BIG_BLOCKS, BIG_BLOCKS);
+}
+
+void test_buddy_suite(void)
+{
+	ztest_test_suite(lib_mem_block_buddy_test,
+			 ztest_unit_test(test_buddy_alloc_free),
+			 ztest_unit_test(test_buddy_split_merge),
+			 ztest_unit_test(test_buddy_get),
+			 ztest_unit_test(test_buddy_multi),
+			 ztest_unit_test(test_buddy_random),
+			 ztest_unit_test(test_buddy_throughput)
+			 );
+
+	ztest_run_test_suite(lib_mem_block_buddy_test);
+}
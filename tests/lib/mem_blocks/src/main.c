@@ -800,6 +800,8 @@ static void test_multi_mem_block_invalid_params(void)
 		      "sys_multi_mem_blocks_free should fail with -EINVAL but not");
 }
 
+extern void test_buddy_suite(void);
+
 void test_main(void)
 {
 	sys_multi_mem_blocks_init(&alloc_group, choice_fn);
@@ -831,4 +833,8 @@ void test_main(void)
 			 );
 
 	ztest_run_test_suite(lib_mem_block_test);
+
+	if (IS_ENABLED(CONFIG_SYS_MEM_BLOCKS_BUDDY)) {
+		test_buddy_suite();
+	}
 }
@@ -905,8 +905,14 @@ uint32_t rand_get(uint32_t min, uint32_t max)
 	return min + (sys_rand32_get() % max);
 }
 
-void test_overwrite_consistency(void)
+#define MAX_BATCH_CLAIM 4
+
+/* Claims up to @p max_claim packets before allocating, using the batch API
+ * when more than one packet is claimed.
+ */
+static void overwrite_consistency(size_t max_claim)
 {
+	const union mpsc_pbuf_generic *claimed[MAX_BATCH_CLAIM];
 	struct mpsc_pbuf_buffer buffer;
 	static struct mpsc_pbuf_buffer_config cfg = {
 		.buf = buf32,
@@ -920,18 +926,25 @@ void test_overwrite_consistency(void)
 	int repeat = 50000;
 	int id = 0;
 
+	current_rd_idx = 0;
+
 	while (id < repeat) {
-		struct test_data_var *t = NULL;
 		bool alloc_during_claim = (rand_get(1, 5) <= 2);
+		size_t n = 0;
 
 		/* Occasionally claim buffer to simulate that claiming is
 		 * interrupted by allocation.
 		 */
-		if (alloc_during_claim) {
-			t = (struct test_data_var *)mpsc_pbuf_claim(&buffer);
-			if (t) {
-				validate_packet(t);
-			}
+		if (alloc_during_claim && max_claim == 1) {
+			claimed[0] = mpsc_pbuf_claim(&buffer);
+			n = claimed[0] ? 1 : 0;
+		} else if (alloc_during_claim) {
+			n = mpsc_pbuf_claim_batch(&buffer, claimed,
+						  rand_get(1, max_claim));
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			validate_packet((struct test_data_var *)claimed[i]);
 		}
 
 		uint32_t wr_cnt = rand_get(1, 200);
@@ -948,9 +961,11 @@ void test_overwrite_consistency(void)
 			mpsc_pbuf_commit(&buffer, (union mpsc_pbuf_generic *)t);
 		}
 
-		/* Put back item claimed before committing new items. */
-		if (t) {
-			mpsc_pbuf_free(&buffer, (union mpsc_pbuf_generic *)t);
+		/* Put back items claimed before committing new items. */
+		if (n == 1) {
+			mpsc_pbuf_free(&buffer, claimed[0]);
+		} else {
+			mpsc_pbuf_free_batch(&buffer, claimed, n);
 		}
 
 		uint32_t rd_cnt = rand_get(1, 30);
@@ -969,6 +984,16 @@ void test_overwrite_consistency(void)
 	}
 }
 
+void test_overwrite_consistency(void)
+{
+	overwrite_consistency(1);
+}
+
+void test_overwrite_consistency_batch(void)
+{
+	overwrite_consistency(MAX_BATCH_CLAIM);
+}
+
 K_THREAD_STACK_DEFINE(t1_stack, 1024);
 K_THREAD_STACK_DEFINE(t2_stack, 1024);
 
@@ -1191,6 +1216,251 @@ void test_utilization(void)
 	zassert_true(packet == NULL, NULL);
 }
 
+static union test_item *alloc_commit(struct mpsc_pbuf_buffer *buffer,
+				     uint32_t len, uint32_t data, bool commit)
+{
+	union test_item *t;
+
+	t = (union test_item *)mpsc_pbuf_alloc(buffer, len, K_NO_WAIT);
+	zassert_true(t, NULL);
+	t->data.len = len;
+	t->data.data = data;
+	if (commit) {
+		mpsc_pbuf_commit(buffer, &t->item);
+	}
+
+	return t;
+}
+
+void claim_batch(bool pow2)
+{
+	const union mpsc_pbuf_generic *items[4];
+	struct mpsc_pbuf_buffer buffer;
+	union test_item *t;
+	uint32_t exp = 0;
+	uint32_t data = 0;
+	size_t n;
+
+	init(&buffer, false, pow2);
+
+	/* Packets of different length make the buffer wrap with skip
+	 * packets at various positions.
+	 */
+	for (int round = 0; round < 64; round++) {
+		for (int i = 0; i < 10; i++) {
+			alloc_commit(&buffer, (data % 4) + 1, data, true);
+			data++;
+		}
+
+		while ((n = mpsc_pbuf_claim_batch(&buffer, items,
+						  ARRAY_SIZE(items))) > 0) {
+			for (size_t i = 0; i < n; i++) {
+				t = (union test_item *)items[i];
+				zassert_equal(t->data.data, exp, NULL);
+				zassert_equal(t->data.len, (exp % 4) + 1, NULL);
+				exp++;
+			}
+			mpsc_pbuf_free_batch(&buffer, items, n);
+		}
+
+		zassert_equal(exp, data, NULL);
+	}
+
+	/* Claiming stops at the first packet which is not committed. */
+	alloc_commit(&buffer, 1, 0, true);
+	t = alloc_commit(&buffer, 2, 1, false);
+	alloc_commit(&buffer, 3, 2, true);
+
+	n = mpsc_pbuf_claim_batch(&buffer, items, ARRAY_SIZE(items));
+	zassert_equal(n, 1, NULL);
+	zassert_equal(((union test_item *)items[0])->data.data, 0, NULL);
+	mpsc_pbuf_free_batch(&buffer, items, n);
+
+	mpsc_pbuf_commit(&buffer, &t->item);
+
+	n = mpsc_pbuf_claim_batch(&buffer, items, ARRAY_SIZE(items));
+	zassert_equal(n, 2, NULL);
+	zassert_equal(((union test_item *)items[0])->data.data, 1, NULL);
+	zassert_equal(((union test_item *)items[1])->data.data, 2, NULL);
+	mpsc_pbuf_free_batch(&buffer, items, n);
+
+	zassert_equal(mpsc_pbuf_claim_batch(&buffer, items, ARRAY_SIZE(items)),
+		      0, NULL);
+	zassert_equal(mpsc_pbuf_claim(&buffer), NULL, NULL);
+}
+
+void test_claim_batch(void)
+{
+	claim_batch(true);
+	claim_batch(false);
+}
+
+/* Packets claimed in a batch are not overwritten while the producer drops
+ * the oldest packets to make space.
+ */
+void test_claim_batch_overwrite(void)
+{
+	const union mpsc_pbuf_generic *items[3];
+	struct mpsc_pbuf_buffer buffer;
+	struct mpsc_pbuf_buffer_config config = {
+		.buf = buf32,
+		.size = ARRAY_SIZE(buf32),
+		.notify_drop = ignore_drop,
+		.get_wlen = get_wlen,
+		.flags = MPSC_PBUF_MODE_OVERWRITE
+	};
+	union test_item test_1word = {.data = {.valid = 1, .len = 1 }};
+	union test_item *t;
+	uint32_t prev;
+	size_t n;
+
+	mpsc_pbuf_init(&buffer, &config);
+
+	for (int i = 0; i < buffer.size - 1; i++) {
+		test_1word.data.data = i;
+		mpsc_pbuf_put_word(&buffer, test_1word.item);
+	}
+
+	n = mpsc_pbuf_claim_batch(&buffer, items, ARRAY_SIZE(items));
+	zassert_equal(n, ARRAY_SIZE(items), NULL);
+
+	for (int i = 0; i < 5; i++) {
+		test_1word.data.data = buffer.size - 1 + i;
+		mpsc_pbuf_put_word(&buffer, test_1word.item);
+	}
+
+	for (int i = 0; i < n; i++) {
+		t = (union test_item *)items[i];
+		zassert_equal(t->data.data, i, "Claimed packet overwritten");
+	}
+	mpsc_pbuf_free_batch(&buffer, items, n);
+
+	prev = n - 1;
+	while ((t = (union test_item *)mpsc_pbuf_claim(&buffer)) != NULL) {
+		zassert_true(t->data.data > prev, "%d after %d",
+			     t->data.data, prev);
+		prev = t->data.data;
+		mpsc_pbuf_free(&buffer, &t->item);
+	}
+
+	zassert_equal(prev, buffer.size - 1 + 4, NULL);
+}
+
+#define MP_PRODUCERS 3
+#define MP_PACKETS 2000
+#define MP_STACK_SIZE 1024
+#define MP_SEQ_BITS 16
+
+K_THREAD_STACK_ARRAY_DEFINE(mp_stacks, MP_PRODUCERS, MP_STACK_SIZE);
+static struct k_thread mp_threads[MP_PRODUCERS];
+
+static void mp_producer(void *p0, void *p1, void *p2)
+{
+	struct mpsc_pbuf_buffer *buffer = p0;
+	uint32_t id = (uintptr_t)p1;
+	union test_item *t;
+
+	for (uint32_t i = 0; i < MP_PACKETS; i++) {
+		/* One and two word packets, as in a log storm of short
+		 * messages.
+		 */
+		uint32_t len = (i & 1) + 1;
+
+		do {
+			t = (union test_item *)mpsc_pbuf_alloc(buffer, len,
+							       K_MSEC(10));
+		} while (t == NULL);
+
+		t->data.len = len;
+		t->data.data = (id << MP_SEQ_BITS) | i;
+		mpsc_pbuf_commit(buffer, &t->item);
+	}
+}
+
+/* Drain packets from producer threads, claiming up to @p batch packets at a
+ * time. Returns the number of cycles spent in claiming and freeing.
+ */
+static uint32_t mp_consume(struct mpsc_pbuf_buffer *buffer, size_t batch)
+{
+	const union mpsc_pbuf_generic *items[16];
+	uint32_t next[MP_PRODUCERS] = { 0 };
+	uint32_t cycles = 0;
+	uint32_t cnt = 0;
+	int prio = k_thread_priority_get(k_current_get());
+
+	for (uintptr_t i = 0; i < MP_PRODUCERS; i++) {
+		k_thread_create(&mp_threads[i], mp_stacks[i], MP_STACK_SIZE,
+				mp_producer, buffer, (void *)i, NULL,
+				prio, 0, K_NO_WAIT);
+	}
+
+	while (cnt < MP_PRODUCERS * MP_PACKETS) {
+		uint32_t t = get_cyc();
+		size_t n;
+
+		if (batch == 1) {
+			items[0] = mpsc_pbuf_claim(buffer);
+			n = items[0] ? 1 : 0;
+		} else {
+			n = mpsc_pbuf_claim_batch(buffer, items, batch);
+		}
+
+		if (n == 0) {
+			k_yield();
+			continue;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			union test_item *p = (union test_item *)items[i];
+			uint32_t id = p->data.data >> MP_SEQ_BITS;
+			uint32_t seq = p->data.data & BIT_MASK(MP_SEQ_BITS);
+
+			/* Packets of each producer arrive in order. */
+			zassert_true(id < MP_PRODUCERS, NULL);
+			zassert_equal(seq, next[id], "%d: got %d exp %d",
+				      id, seq, next[id]);
+			zassert_equal(p->data.len, (seq & 1) + 1, NULL);
+			next[id]++;
+		}
+
+		if (batch == 1) {
+			mpsc_pbuf_free(buffer, items[0]);
+		} else {
+			mpsc_pbuf_free_batch(buffer, items, n);
+		}
+
+		cycles += get_cyc() - t;
+		cnt += n;
+	}
+
+	for (int i = 0; i < MP_PRODUCERS; i++) {
+		k_thread_join(&mp_threads[i], K_FOREVER);
+	}
+
+	zassert_equal(mpsc_pbuf_claim(buffer), NULL, NULL);
+
+	return cycles;
+}
+
+/* Multiple producer threads fill the buffer while the consumer drains it
+ * one packet at a time and then in batches.
+ */
+void test_benchmark_multi_producer(void)
+{
+	static const size_t batches[] = { 1, 4, 16 };
+	struct mpsc_pbuf_buffer buffer;
+
+	for (int i = 0; i < ARRAY_SIZE(batches); i++) {
+		uint32_t t;
+
+		init(&buffer, false, true);
+		t = mp_consume(&buffer, batches[i]);
+		PRINT("%d producers, batch %2d: %d cycles per packet\n",
+		      MP_PRODUCERS, (int)batches[i],
+		      t / (MP_PRODUCERS * MP_PACKETS));
+	}
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -1213,8 +1483,12 @@ void test_main(void)
 		ztest_unit_test(test_overwrite_while_claimed),
 		ztest_unit_test(test_overwrite_while_claimed2),
 		ztest_unit_test(test_overwrite_consistency),
+		ztest_unit_test(test_overwrite_consistency_batch),
 		ztest_unit_test(test_pending_alloc),
-		ztest_unit_test(test_utilization)
+		ztest_unit_test(test_utilization),
+		ztest_unit_test(test_claim_batch),
+		ztest_unit_test(test_claim_batch_overwrite),
+		ztest_unit_test(test_benchmark_multi_producer)
 		);
 	ztest_run_test_suite(test_log_buffer);
 }
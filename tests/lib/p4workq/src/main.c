@@ -270,13 +270,178 @@ static void test_p4wq_simple(void)
 	zassert_true(has_run, "high-priority item didn't run");
 }
 
+#define BENCH_ITEMS 64
+#define BENCH_WORK 4000
+#define BENCH_STACK 1024
+
+static struct k_p4wq bench_wq[CONFIG_MP_NUM_CPUS];
+static struct k_thread bench_threads[CONFIG_MP_NUM_CPUS * CONFIG_MP_NUM_CPUS];
+static K_THREAD_STACK_ARRAY_DEFINE(bench_stacks,
+				   CONFIG_MP_NUM_CPUS * CONFIG_MP_NUM_CPUS,
+				   BENCH_STACK);
+static struct k_p4wq_work bench_items[BENCH_ITEMS];
+static int bench_cpu[BENCH_ITEMS];
+
+static void bench_handler(struct k_p4wq_work *work)
+{
+	volatile uint32_t x = 0;
+
+	for (int i = 0; i < BENCH_WORK; i++) {
+		x += i;
+	}
+
+	unsigned int key = irq_lock();
+
+	bench_cpu[work - bench_items] = _current_cpu->id;
+	irq_unlock(key);
+}
+
+/* Sets up a queue with one worker per CPU for the first n CPUs, the
+ * workers are pinned when the queue supports pinned items.
+ */
+static struct k_p4wq *bench_queue(int n)
+{
+	struct k_p4wq *q = &bench_wq[n - 1];
+
+	k_p4wq_init(q);
+	for (int i = 0; i < n; i++) {
+		int t = (n - 1) * CONFIG_MP_NUM_CPUS + i;
+
+#ifdef CONFIG_P4WQ_PER_CPU
+		zassert_ok(k_p4wq_add_cpu_thread(q, &bench_threads[t],
+						 bench_stacks[t], BENCH_STACK,
+						 i), NULL);
+#else
+		k_p4wq_add_thread(q, &bench_threads[t], bench_stacks[t],
+				  BENCH_STACK);
+#endif
+	}
+
+	return q;
+}
+
+/* Submits all items from this thread, pinned round robin to the first
+ * n CPUs if pin is set, and returns the cycles taken to complete them.
+ */
+static uint32_t bench_run(struct k_p4wq *q, int n, bool pin)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_ITEMS; i++) {
+		bench_items[i] = (struct k_p4wq_work){
+			.priority = 1,
+			.deadline = i,
+			.handler = bench_handler,
+			.sync = true,
+		};
+		bench_cpu[i] = -1;
+
+#ifdef CONFIG_P4WQ_PER_CPU
+		if (pin) {
+			k_p4wq_submit_cpu(q, &bench_items[i], i % n);
+			continue;
+		}
+#endif
+		k_p4wq_submit(q, &bench_items[i]);
+	}
+
+	for (int i = 0; i < BENCH_ITEMS; i++) {
+		zassert_ok(k_p4wq_wait(&bench_items[i], K_FOREVER), NULL);
+		if (pin) {
+			zassert_equal(bench_cpu[i], i % n,
+				      "pinned item ran on CPU %d", bench_cpu[i]);
+		}
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static void bench_report(struct k_p4wq *q, int n, bool pin, uint32_t cycles)
+{
+	TC_PRINT("workers %d %-8s cycles/item %6u", n,
+		 pin ? "pinned" : "shared", cycles / BENCH_ITEMS);
+
+#ifdef CONFIG_P4WQ_STATS
+	struct k_p4wq_stats stats;
+
+	k_p4wq_stats_get(q, &stats);
+	zassert_equal(stats.submitted, BENCH_ITEMS, NULL);
+	zassert_equal(stats.executed, BENCH_ITEMS, NULL);
+	TC_PRINT(" latency avg %6u max %6u stolen %3u",
+		 (uint32_t)(stats.latency_total / stats.executed),
+		 stats.latency_max, stats.stolen);
+	k_p4wq_stats_reset(q);
+#else
+	ARG_UNUSED(q);
+#endif
+	TC_PRINT("\n");
+}
+
+/* Scaling benchmark: the same batch of compute bound items run by one
+ * worker per CPU for an increasing number of CPUs, submitted from a
+ * single thread and, with CONFIG_P4WQ_PER_CPU, pinned round robin to
+ * the workers' CPUs.
+ */
+static void test_scaling(void)
+{
+	k_thread_priority_set(k_current_get(), -1);
+
+	for (int n = 1; n <= CONFIG_MP_NUM_CPUS; n++) {
+		struct k_p4wq *q = bench_queue(n);
+
+		bench_report(q, n, false, bench_run(q, n, false));
+		if (IS_ENABLED(CONFIG_P4WQ_PER_CPU)) {
+			bench_report(q, n, true, bench_run(q, n, true));
+		}
+	}
+}
+
+#ifdef CONFIG_P4WQ_STATS
+static void cancel_handler(struct k_p4wq_work *item)
+{
+	ARG_UNUSED(item);
+}
+#endif
+
+/* Canceled items are accounted and never reach a handler */
+static void test_stats(void)
+{
+#ifndef CONFIG_P4WQ_STATS
+	ztest_test_skip();
+#else
+	struct k_p4wq_stats stats;
+	int prio = 2;
+
+	k_thread_priority_set(k_current_get(), prio);
+	k_p4wq_stats_reset(&wq);
+
+	simple_item = (struct k_p4wq_work){
+		.priority = prio + 1,
+		.handler = cancel_handler,
+	};
+	k_p4wq_submit(&wq, &simple_item);
+	zassert_true(k_p4wq_cancel(&wq, &simple_item), NULL);
+
+	k_p4wq_submit(&wq, &simple_item);
+	k_msleep(10);
+
+	k_p4wq_stats_get(&wq, &stats);
+	zassert_equal(stats.submitted, 2, NULL);
+	zassert_equal(stats.canceled, 1, NULL);
+	zassert_equal(stats.executed, 1, NULL);
+	zassert_true(stats.latency_max >= stats.latency_total, NULL);
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_p4wq_test,
 			 ztest_1cpu_unit_test(test_p4wq_simple),
 			 ztest_unit_test(test_resubmit),
 			 ztest_unit_test(test_fill_queue),
-			 ztest_unit_test(test_stress));
+			 ztest_unit_test(test_stress),
+			 ztest_1cpu_unit_test(test_stats),
+			 ztest_unit_test(test_scaling));
 
 	ztest_run_test_suite(lib_p4wq_test);
 }
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/rb.h>
+
+/* tests/unit/rbtree checks the tree invariants, but is built without
+ * optimization.  This builds rb.c as the kernel uses it, where the
+ * compiler is free to reorder accesses it can prove don't alias.
+ */
+
+#define NUM_NODES 4096
+
+struct item {
+	struct rbnode node;
+	uint32_t key;
+};
+
+static struct item items[NUM_NODES];
+static uint16_t order[NUM_NODES];
+static struct rbtree tree;
+
+static bool item_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	return CONTAINER_OF(a, struct item, node)->key <
+	       CONTAINER_OF(b, struct item, node)->key;
+}
+
+static uint32_t seed = 1U;
+
+static uint32_t test_rand(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 8;
+}
+
+static void shuffle(void)
+{
+	for (int i = 0; i < NUM_NODES; i++) {
+		order[i] = i;
+	}
+
+	for (int i = NUM_NODES - 1; i > 0; i--) {
+		int j = test_rand() % (i + 1);
+		uint16_t tmp = order[i];
+
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+}
+
+/* Walks the tree, checking its items are in key order, and returns
+ * their number
+ */
+static int check_walk(void)
+{
+	struct rbnode *node;
+	uint32_t last = 0U;
+	int count = 0;
+
+	RB_FOR_EACH(&tree, node) {
+		uint32_t key = CONTAINER_OF(node, struct item, node)->key;
+
+		zassert_true(count == 0 || key > last, "tree out of order");
+		last = key;
+		count++;
+		zassert_true(count <= NUM_NODES, "tree has a loop");
+	}
+
+	return count;
+}
+
+/**
+ * @brief Test removing nodes in random order from a large tree
+ *
+ * @details Fill a tree in random order, then remove every node in
+ * another random order, which exercises all the rebalancing cases.
+ * The tree must stay ordered, and hold exactly the nodes not removed
+ * yet.
+ *
+ * @ingroup lib_rbtree_tests
+ */
+void test_rbtree_random_remove(void)
+{
+	int removed;
+
+	(void)memset(&tree, 0, sizeof(tree));
+	tree.lessthan_fn = item_lessthan;
+
+	shuffle();
+	for (int i = 0; i < NUM_NODES; i++) {
+		items[order[i]].key = order[i];
+		rb_insert(&tree, &items[order[i]].node);
+	}
+
+	zassert_equal(check_walk(), NUM_NODES, "wrong item count");
+
+	shuffle();
+	for (removed = 0; removed < NUM_NODES; removed++) {
+		struct rbnode *node = &items[order[removed]].node;
+
+		zassert_true(rb_contains(&tree, node), "item %d lost",
+			     order[removed]);
+		rb_remove(&tree, node);
+		zassert_false(rb_contains(&tree, node), "item %d not removed",
+			      order[removed]);
+		/* Catches a broken tree before a later rb_remove() can
+		 * loop forever in it
+		 */
+		zassert_equal(check_walk(), NUM_NODES - removed - 1,
+			      "wrong item count");
+	}
+
+	zassert_is_null(rb_get_min(&tree), "tree not empty");
+	zassert_is_null(rb_get_max(&tree), "tree not empty");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(rbtree,
+			 ztest_unit_test(test_rbtree_random_remove));
+	ztest_run_test_suite(rbtree);
+}
@@ -0,0 +1,450 @@
+/*
+ * Copyright (c) 2022 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <ztress.h>
+#include <sys/ring_buffer.h>
+#include <sys/ring_buffer_lockfree.h>
+#include <stdint.h>
+
+#define SPSC_SIZE 32
+#define SLOT_SIZE 8
+#define NUM_SLOTS 8
+
+static struct ring_buf_spsc spsc;
+static uint8_t spsc_data[SPSC_SIZE];
+
+RING_BUF_MPMC_DECLARE(mpmc, SLOT_SIZE, NUM_SLOTS);
+
+/**
+ * @brief Test SPSC ring buffer claim and finish
+ *
+ * @details Validate that claims are limited by free space, available data
+ * and the end of the buffer, and that surplus claimed bytes are returned.
+ *
+ * @ingroup lib_ringbuffer_tests
+ */
+void test_ringbuffer_spsc_claim(void)
+{
+	uint8_t in[SPSC_SIZE], out[SPSC_SIZE];
+	uint8_t *data;
+	uint32_t len;
+
+	for (int i = 0; i < sizeof(in); i++) {
+		in[i] = i;
+	}
+
+	ring_buf_spsc_init(&spsc, sizeof(spsc_data), spsc_data);
+	zassert_true(ring_buf_spsc_is_empty(&spsc), NULL);
+	zassert_equal(ring_buf_spsc_capacity_get(&spsc), SPSC_SIZE, NULL);
+
+	/* Nothing to read */
+	zassert_equal(ring_buf_spsc_get_claim(&spsc, &data, 1), 0, NULL);
+
+	/* Claimed but not finished data is not visible to the consumer */
+	len = ring_buf_spsc_put_claim(&spsc, &data, 20);
+	zassert_equal(len, 20, NULL);
+	memcpy(data, in, len);
+	zassert_true(ring_buf_spsc_is_empty(&spsc), NULL);
+	zassert_equal(ring_buf_spsc_put_finish(&spsc, 21), -EINVAL, NULL);
+
+	/* Finish less than claimed, the rest returns to the free space */
+	zassert_ok(ring_buf_spsc_put_finish(&spsc, 16), NULL);
+	zassert_equal(ring_buf_spsc_size_get(&spsc), 16, NULL);
+	zassert_equal(ring_buf_spsc_space_get(&spsc), SPSC_SIZE - 16, NULL);
+
+	len = ring_buf_spsc_get_claim(&spsc, &data, 32);
+	zassert_equal(len, 16, NULL);
+	zassert_equal(memcmp(data, in, len), 0, NULL);
+	zassert_equal(ring_buf_spsc_get_finish(&spsc, 17), -EINVAL, NULL);
+	zassert_ok(ring_buf_spsc_get_finish(&spsc, 8), NULL);
+	zassert_equal(ring_buf_spsc_size_get(&spsc), 8, NULL);
+
+	/* Claim stops at the end of the buffer */
+	len = ring_buf_spsc_put_claim(&spsc, &data, 32);
+	zassert_equal(len, 16, NULL);
+	len = ring_buf_spsc_put_claim(&spsc, &data, 32);
+	zassert_equal(len, 8, NULL);
+	zassert_equal(data, spsc_data, NULL);
+	zassert_equal(ring_buf_spsc_put_claim(&spsc, &data, 1), 0, NULL);
+	zassert_ok(ring_buf_spsc_put_finish(&spsc, 24), NULL);
+	zassert_equal(ring_buf_spsc_space_get(&spsc), 0, NULL);
+
+	/* Copy API across the wrap */
+	zassert_equal(ring_buf_spsc_get(&spsc, out, sizeof(out)), 32, NULL);
+	zassert_equal(memcmp(out, &in[8], 8), 0, NULL);
+	zassert_true(ring_buf_spsc_is_empty(&spsc), NULL);
+
+	zassert_equal(ring_buf_spsc_put(&spsc, in, sizeof(in)), sizeof(in),
+		      NULL);
+	zassert_equal(ring_buf_spsc_put(&spsc, in, 1), 0, NULL);
+	zassert_equal(ring_buf_spsc_get(&spsc, NULL, 4), 4, NULL);
+	zassert_equal(ring_buf_spsc_get(&spsc, out, sizeof(out)), 28, NULL);
+	zassert_equal(memcmp(out, &in[4], 28), 0, NULL);
+}
+
+/**
+ * @brief Test MPMC ring buffer claim and finish
+ *
+ * @details Validate that slots are read in the order they were claimed for
+ * writing, that a slot which is not finished stops consumers and that
+ * empty records are skipped.
+ *
+ * @ingroup lib_ringbuffer_tests
+ */
+void test_ringbuffer_mpmc_claim(void)
+{
+	uint8_t *slots[NUM_SLOTS];
+	uint8_t out[SLOT_SIZE * 2];
+	uint8_t *data;
+	uint32_t len;
+
+	for (int i = 0; i < NUM_SLOTS; i++) {
+		zassert_equal(ring_buf_mpmc_put_claim(&mpmc, &slots[i]),
+			      SLOT_SIZE, NULL);
+	}
+	zassert_equal(ring_buf_mpmc_put_claim(&mpmc, &data), 0, "Not full");
+	zassert_equal(ring_buf_mpmc_put_finish(&mpmc, slots[0] + 1, 1),
+		      -EINVAL, NULL);
+	zassert_equal(ring_buf_mpmc_put_finish(&mpmc, slots[0],
+					       SLOT_SIZE + 1),
+		      -EINVAL, NULL);
+
+	/* Slot 0 is not finished so nothing can be read */
+	for (int i = NUM_SLOTS - 1; i > 0; i--) {
+		memset(slots[i], i, SLOT_SIZE);
+		zassert_ok(ring_buf_mpmc_put_finish(&mpmc, slots[i],
+						    i == 2 ? 0 : i), NULL);
+	}
+	zassert_equal(ring_buf_mpmc_get_claim(&mpmc, &data), 0, NULL);
+
+	zassert_ok(ring_buf_mpmc_put_finish(&mpmc, slots[0], SLOT_SIZE), NULL);
+
+	len = ring_buf_mpmc_get_claim(&mpmc, &data);
+	zassert_equal(len, SLOT_SIZE, NULL);
+	zassert_equal(data, slots[0], NULL);
+
+	/* Producers wait for the slot to be released */
+	zassert_equal(ring_buf_mpmc_put_claim(&mpmc, &data), 0, NULL);
+	zassert_ok(ring_buf_mpmc_get_finish(&mpmc, slots[0]), NULL);
+	zassert_equal(ring_buf_mpmc_put(&mpmc, (uint8_t *)"abcdefghij", 10),
+		      SLOT_SIZE, NULL);
+
+	/* The empty record in slot 2 is skipped */
+	for (int i = 1; i < NUM_SLOTS; i++) {
+		if (i == 2) {
+			continue;
+		}
+		len = ring_buf_mpmc_get(&mpmc, out, sizeof(out));
+		zassert_equal(len, i, NULL);
+		zassert_equal(out[0], i, NULL);
+	}
+
+	len = ring_buf_mpmc_get(&mpmc, out, 4);
+	zassert_equal(len, SLOT_SIZE, NULL);
+	zassert_equal(memcmp(out, "abcd", 4), 0, NULL);
+	zassert_equal(ring_buf_mpmc_get(&mpmc, out, sizeof(out)), 0, NULL);
+}
+
+static bool spsc_produce(void *user_data, uint32_t iter_cnt, bool last,
+			 int prio)
+{
+	static uint8_t cnt;
+	static uint32_t wr = 8;
+	uint8_t *data;
+	uint32_t len;
+
+	if (iter_cnt == 0) {
+		cnt = 0;
+	}
+
+	len = ring_buf_spsc_put_claim(&spsc, &data, wr);
+	if (len == 0) {
+		return true;
+	}
+
+	for (uint32_t i = 0; i < len; i++) {
+		data[i] = cnt++;
+	}
+
+	wr = (wr == 14) ? 8 : wr + 1;
+	zassert_ok(ring_buf_spsc_put_finish(&spsc, len), NULL);
+
+	return true;
+}
+
+static bool spsc_consume(void *user_data, uint32_t iter_cnt, bool last,
+			 int prio)
+{
+	static uint8_t cnt;
+	static uint32_t rd = 8;
+	uint8_t *data;
+	uint32_t len;
+
+	if (iter_cnt == 0) {
+		cnt = 0;
+	}
+
+	len = ring_buf_spsc_get_claim(&spsc, &data, rd);
+	if (len == 0) {
+		return true;
+	}
+
+	for (uint32_t i = 0; i < len; i++) {
+		zassert_equal(data[i], cnt, "Got %02x, exp: %02x", data[i],
+			      cnt);
+		cnt++;
+	}
+
+	rd = (rd == 14) ? 8 : rd + 1;
+	zassert_ok(ring_buf_spsc_get_finish(&spsc, len), NULL);
+
+	return true;
+}
+
+static void spsc_ztress(ztress_handler high_handler,
+			ztress_handler low_handler)
+{
+	ring_buf_spsc_init(&spsc, sizeof(spsc_data), spsc_data);
+
+	/* force internal 32-bit index roll-over */
+	ring_buf_spsc_internal_reset(&spsc, UINT32_MAX - SPSC_SIZE / 2);
+
+	ztress_set_timeout(K_MSEC(1000));
+	ZTRESS_EXECUTE(ZTRESS_THREAD(high_handler, NULL, 0, 0,
+				     Z_TIMEOUT_TICKS(20)),
+		       ZTRESS_THREAD(low_handler, NULL, 0, 2000,
+				     Z_TIMEOUT_TICKS(20)));
+}
+
+/* Zero-copy API. Test is validating single producer, single consumer from
+ * different priorities, without a lock.
+ */
+void test_ringbuffer_spsc_stress(void)
+{
+	PRINT("Producing interrupts consuming\n");
+	spsc_ztress(spsc_produce, spsc_consume);
+
+	PRINT("Consuming interrupts producing\n");
+	spsc_ztress(spsc_consume, spsc_produce);
+}
+
+#define MPMC_PRODUCERS 2
+#define MPMC_CONSUMERS 2
+
+struct mpmc_record {
+	uint32_t id;
+	uint32_t seq;
+};
+
+static uint32_t mpmc_put_seq[MPMC_PRODUCERS];
+static uint32_t mpmc_got_seq[MPMC_CONSUMERS][MPMC_PRODUCERS];
+static atomic_t mpmc_got_cnt;
+
+static bool mpmc_produce(void *user_data, uint32_t iter_cnt, bool last,
+			 int prio)
+{
+	uint32_t id = (uintptr_t)user_data;
+	struct mpmc_record *rec;
+	uint8_t *data;
+
+	if (ring_buf_mpmc_put_claim(&mpmc, &data) == 0) {
+		return true;
+	}
+
+	rec = (struct mpmc_record *)data;
+	rec->id = id;
+	rec->seq = ++mpmc_put_seq[id];
+	zassert_ok(ring_buf_mpmc_put_finish(&mpmc, data, sizeof(*rec)), NULL);
+
+	return true;
+}
+
+/* Consumers claim slots in increasing order, so each of them sees records
+ * of a producer in the order they were written even though some records
+ * are taken by the other consumer.
+ */
+static bool mpmc_consume(void *user_data, uint32_t iter_cnt, bool last,
+			 int prio)
+{
+	uint32_t *got_seq = mpmc_got_seq[(uintptr_t)user_data];
+	struct mpmc_record rec;
+
+	while (ring_buf_mpmc_get(&mpmc, (uint8_t *)&rec, sizeof(rec))) {
+		zassert_true(rec.id < MPMC_PRODUCERS, NULL);
+		zassert_true(rec.seq > got_seq[rec.id], "%d: got %d after %d",
+			     rec.id, rec.seq, got_seq[rec.id]);
+		got_seq[rec.id] = rec.seq;
+		atomic_inc(&mpmc_got_cnt);
+	}
+
+	return true;
+}
+
+/* Producer in a timer and a thread, two consumer threads. */
+void test_ringbuffer_mpmc_stress(void)
+{
+	uint32_t put_cnt = 0;
+
+	memset(mpmc_put_seq, 0, sizeof(mpmc_put_seq));
+	memset(mpmc_got_seq, 0, sizeof(mpmc_got_seq));
+	atomic_set(&mpmc_got_cnt, 0);
+	ring_buf_mpmc_init(&mpmc, SLOT_SIZE, NUM_SLOTS,
+			   _ring_buf_mpmc_data_mpmc, _ring_buf_mpmc_slots_mpmc);
+
+	ztress_set_timeout(K_MSEC(1000));
+	ZTRESS_EXECUTE(ZTRESS_TIMER(mpmc_produce, (void *)0, 0,
+				    Z_TIMEOUT_TICKS(4)),
+		       ZTRESS_THREAD(mpmc_consume, (void *)0, 0, 0,
+				     Z_TIMEOUT_TICKS(20)),
+		       ZTRESS_THREAD(mpmc_produce, (void *)1, 0, 1000,
+				     Z_TIMEOUT_TICKS(20)),
+		       ZTRESS_THREAD(mpmc_consume, (void *)1, 0, 1000,
+				     Z_TIMEOUT_TICKS(20)));
+
+	/* Drain what was left after the consumers were stopped */
+	mpmc_consume((void *)0, 1, true, 0);
+
+	for (int i = 0; i < MPMC_PRODUCERS; i++) {
+		put_cnt += mpmc_put_seq[i];
+	}
+	zassert_equal(atomic_get(&mpmc_got_cnt), put_cnt, NULL);
+	PRINT("%d records passed\n", put_cnt);
+}
+
+#define TP_TOTAL (64 * 1024)
+#define TP_CHUNK 64
+#define TP_STACKSIZE (512 + CONFIG_TEST_EXTRA_STACK_SIZE)
+
+enum tp_mode {
+	TP_LOCKED,
+	TP_SPSC,
+	TP_MPMC,
+};
+
+static struct ring_buf tp_locked;
+static struct k_spinlock tp_lock;
+static uint8_t tp_data[1024];
+static struct ring_buf_mpmc tp_mpmc;
+static struct ring_buf_mpmc_slot tp_slots[sizeof(tp_data) / TP_CHUNK];
+static K_THREAD_STACK_DEFINE(tp_stack, TP_STACKSIZE);
+static struct k_thread tp_thread;
+
+static uint32_t tp_put(enum tp_mode mode, const uint8_t *data)
+{
+	k_spinlock_key_t key;
+	uint32_t len;
+
+	switch (mode) {
+	case TP_LOCKED:
+		key = k_spin_lock(&tp_lock);
+		len = ring_buf_put(&tp_locked, data, TP_CHUNK);
+		k_spin_unlock(&tp_lock, key);
+		return len;
+	case TP_SPSC:
+		return ring_buf_spsc_put(&spsc, data, TP_CHUNK);
+	default:
+		return ring_buf_mpmc_put(&tp_mpmc, data, TP_CHUNK);
+	}
+}
+
+static uint32_t tp_get(enum tp_mode mode, uint8_t *data)
+{
+	k_spinlock_key_t key;
+	uint32_t len;
+
+	switch (mode) {
+	case TP_LOCKED:
+		key = k_spin_lock(&tp_lock);
+		len = ring_buf_get(&tp_locked, data, TP_CHUNK);
+		k_spin_unlock(&tp_lock, key);
+		return len;
+	case TP_SPSC:
+		return ring_buf_spsc_get(&spsc, data, TP_CHUNK);
+	default:
+		return ring_buf_mpmc_get(&tp_mpmc, data, TP_CHUNK);
+	}
+}
+
+static void tp_producer(void *p1, void *p2, void *p3)
+{
+	enum tp_mode mode = (uintptr_t)p1;
+	uint8_t chunk[TP_CHUNK];
+	uint32_t sent = 0;
+
+	while (sent < TP_TOTAL) {
+		uint32_t len;
+
+		memset(chunk, (uint8_t)(sent / TP_CHUNK), sizeof(chunk));
+		len = tp_put(mode, chunk);
+		if (len == 0) {
+			/* On a single CPU let the consumer run. */
+			k_yield();
+			continue;
+		}
+
+		/* Chunks are read and written whole and the buffer size is a
+		 * multiple of the chunk size, so no partial writes happen.
+		 */
+		zassert_equal(len, TP_CHUNK, NULL);
+		sent += len;
+	}
+}
+
+static void tp_run(const char *name, enum tp_mode mode)
+{
+	uint8_t chunk[TP_CHUNK];
+	uint32_t received = 0;
+	uint32_t start, cycles;
+	uint64_t ns;
+
+	k_thread_create(&tp_thread, tp_stack, TP_STACKSIZE, tp_producer,
+			(void *)(uintptr_t)mode, NULL, NULL,
+			k_thread_priority_get(k_current_get()), 0, K_NO_WAIT);
+
+	start = k_cycle_get_32();
+	while (received < TP_TOTAL) {
+		uint32_t len = tp_get(mode, chunk);
+
+		if (len == 0) {
+			k_yield();
+			continue;
+		}
+
+		zassert_equal(chunk[0], (uint8_t)(received / TP_CHUNK),
+			      "%s: data lost at %d", name, received);
+		received += len;
+	}
+	cycles = k_cycle_get_32() - start;
+
+	k_thread_join(&tp_thread, K_FOREVER);
+
+	ns = k_cyc_to_ns_floor64(cycles);
+	PRINT("%-10s %u bytes, %u KB/s\n", name, received,
+	      ns ? (uint32_t)((uint64_t)received * NSEC_PER_SEC / 1024U / ns) :
+	      0U);
+}
+
+/**
+ * @brief Measure throughput between a producer and a consumer thread
+ *
+ * @details The producer thread writes 64 byte chunks which the test thread
+ * reads, through a @ref ring_buf guarded by a spinlock and through the
+ * lock-free variants. On SMP the two threads run on different CPUs.
+ *
+ * @ingroup lib_ringbuffer_tests
+ */
+void test_ringbuffer_lockfree_throughput(void)
+{
+	ring_buf_init(&tp_locked, sizeof(tp_data), tp_data);
+	tp_run("locked", TP_LOCKED);
+
+	ring_buf_spsc_init(&spsc, sizeof(tp_data), tp_data);
+	tp_run("spsc", TP_SPSC);
+
+	ring_buf_mpmc_init(&tp_mpmc, TP_CHUNK, ARRAY_SIZE(tp_slots), tp_data,
+			   tp_slots);
+	tp_run("mpmc", TP_MPMC);
+}
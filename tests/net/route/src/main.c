@@ -544,6 +544,188 @@ static void test_route_preference(void)
 	net_route_del(entry);
 }
 
+static void test_route_longest_match(void)
+{
+	struct in6_addr prefix_64 = { { { 0x20, 0x01, 0x0d, 0xb8 } } };
+	struct in6_addr prefix_112 = dest_addr;
+	struct in6_addr in_112 = dest_addr;
+	struct in6_addr in_64 = prefix_64;
+	struct in6_addr outside = prefix_64;
+	struct net_route_entry *route_64, *route_112, *route_128;
+
+	prefix_112.s6_addr[14] = 0U;
+	prefix_112.s6_addr[15] = 0U;
+	in_112.s6_addr[15] = 0x01;
+	in_64.s6_addr[11] = 0x01;
+	outside.s6_addr[3] = 0xb9;
+
+	/* Most specific first, the routes covering a new one get replaced */
+	route_128 = net_route_add(my_iface, &dest_addr, 128, &peer_addr,
+				  NET_IPV6_ND_INFINITE_LIFETIME,
+				  NET_ROUTE_PREFERENCE_LOW);
+	route_112 = net_route_add(my_iface, &prefix_112, 112, &peer_addr,
+				  NET_IPV6_ND_INFINITE_LIFETIME,
+				  NET_ROUTE_PREFERENCE_LOW);
+	route_64 = net_route_add(my_iface, &prefix_64, 64, &peer_addr_alt,
+				 NET_IPV6_ND_INFINITE_LIFETIME,
+				 NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(route_128, "Route add failed");
+	zassert_not_null(route_112, "Route add failed");
+	zassert_not_null(route_64, "Route add failed");
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), route_128,
+			  "Wrong /128 match");
+	zassert_equal_ptr(net_route_lookup(NULL, &in_112), route_112,
+			  "Wrong /112 match");
+	zassert_equal_ptr(net_route_lookup(my_iface, &in_64), route_64,
+			  "Wrong /64 match");
+	zassert_is_null(net_route_lookup(my_iface, &outside),
+			"Route found outside of the prefixes");
+	zassert_is_null(net_route_lookup(peer_iface, &dest_addr),
+			"Route found on the wrong interface");
+
+	zassert_equal(net_route_del(route_112), 0, "Route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &in_112), route_64,
+			  "Wrong match after /112 deletion");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), route_128,
+			  "Wrong match after /112 deletion");
+
+	zassert_equal(net_route_del(route_128), 0, "Route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), route_64,
+			  "Wrong match after /128 deletion");
+
+	zassert_equal(net_route_del(route_64), 0, "Route del failed");
+	zassert_is_null(net_route_lookup(my_iface, &dest_addr),
+			"Route found after deletion");
+}
+
+#define LPM_ENTRIES 64
+
+struct lpm_test_entry {
+	struct net_lpm_node node;
+	uint8_t key[4];
+	uint8_t len;
+	bool in_trie;
+};
+
+static struct lpm_test_entry lpm_entries[LPM_ENTRIES];
+static struct net_lpm_glue lpm_glue[LPM_ENTRIES - 1];
+static uint32_t lpm_seed = 1U;
+
+static uint32_t lpm_rand(void)
+{
+	lpm_seed = lpm_seed * 1103515245U + 12345U;
+
+	return lpm_seed >> 8;
+}
+
+static bool lpm_prefix_match(struct lpm_test_entry *e, const uint8_t *addr)
+{
+	uint32_t key = sys_get_be32(e->key);
+	uint32_t mask = e->len ? UINT32_MAX << (32 - e->len) : 0U;
+
+	return ((key ^ sys_get_be32(addr)) & mask) == 0U;
+}
+
+/* Linear search, keeping the first inserted of the equal prefixes */
+static struct lpm_test_entry *lpm_ref_lookup(const uint8_t *addr,
+					     const int *order, int count)
+{
+	struct lpm_test_entry *found = NULL;
+
+	for (int i = 0; i < count; i++) {
+		struct lpm_test_entry *e = &lpm_entries[order[i]];
+
+		if (!e->in_trie || !lpm_prefix_match(e, addr)) {
+			continue;
+		}
+
+		if (!found || e->len > found->len) {
+			found = e;
+		}
+	}
+
+	return found;
+}
+
+static void lpm_check(struct net_lpm_trie *trie, const int *order, int count)
+{
+	for (int i = 0; i < 512; i++) {
+		struct lpm_test_entry *e = &lpm_entries[lpm_rand() % LPM_ENTRIES];
+		struct net_lpm_node *node;
+		uint8_t addr[4];
+
+		/* Mostly addresses near the prefixes, some random ones */
+		sys_put_be32(sys_get_be32(e->key) ^ (lpm_rand() >> (i % 32)),
+			     addr);
+
+		node = net_lpm_lookup(trie, addr, NULL, NULL);
+		zassert_equal_ptr(node ? CONTAINER_OF(node, struct lpm_test_entry,
+						      node) : NULL,
+				  lpm_ref_lookup(addr, order, count),
+				  "Wrong match for %08x", sys_get_be32(addr));
+	}
+}
+
+static void test_lpm_trie(void)
+{
+	struct net_lpm_trie trie;
+	int order[LPM_ENTRIES * 2];
+	int count = 0;
+
+	net_lpm_init(&trie, 32, lpm_glue, ARRAY_SIZE(lpm_glue));
+
+	for (int i = 0; i < LPM_ENTRIES; i++) {
+		struct lpm_test_entry *e = &lpm_entries[i];
+
+		/* Few distinct high bits so that prefixes nest and repeat */
+		e->len = lpm_rand() % 33;
+		sys_put_be32((lpm_rand() & 0xc3c00000) |
+			     (lpm_rand() & 0x0000ffff), e->key);
+
+		zassert_ok(net_lpm_insert(&trie, &e->node, e->key, e->len),
+			   "Insert failed");
+		e->in_trie = true;
+		order[count++] = i;
+	}
+
+	lpm_check(&trie, order, count);
+
+	for (int round = 0; round < 4; round++) {
+		/* Remove half of the entries, then insert them again */
+		for (int i = round % 2; i < LPM_ENTRIES; i += 2) {
+			net_lpm_remove(&trie, &lpm_entries[i].node);
+			lpm_entries[i].in_trie = false;
+		}
+
+		lpm_check(&trie, order, count);
+
+		count = 0;
+		for (int i = 0; i < LPM_ENTRIES; i++) {
+			if (lpm_entries[i].in_trie) {
+				order[count++] = i;
+			}
+		}
+
+		for (int i = round % 2; i < LPM_ENTRIES; i += 2) {
+			zassert_ok(net_lpm_insert(&trie, &lpm_entries[i].node,
+						  lpm_entries[i].key,
+						  lpm_entries[i].len),
+				   "Insert failed");
+			lpm_entries[i].in_trie = true;
+			order[count++] = i;
+		}
+
+		lpm_check(&trie, order, count);
+	}
+
+	for (int i = 0; i < LPM_ENTRIES; i++) {
+		net_lpm_remove(&trie, &lpm_entries[i].node);
+	}
+
+	zassert_is_null(trie.root, "Trie not empty");
+}
+
 
 /*test case main entry*/
 void test_main(void)
@@ -566,6 +748,8 @@ void test_main(void)
 			ztest_unit_test(test_route_add_many),
 			ztest_unit_test(test_route_del_many),
 			ztest_unit_test(test_route_lifetime),
-			ztest_unit_test(test_route_preference));
+			ztest_unit_test(test_route_preference),
+			ztest_unit_test(test_route_longest_match),
+			ztest_unit_test(test_lpm_trie));
 	ztest_run_test_suite(test_route);
 }
@@ -21,6 +21,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_UTILS_LOG_LEVEL);
 #include <sys/printk.h>
 #include <net/net_core.h>
 #include <net/net_ip.h>
+#include <net/net_pkt.h>
 #include <net/ethernet.h>
 #include <linker/sections.h>
 
@@ -848,11 +849,243 @@ void test_addr_parse(void)
 #endif
 }
 
+/* Straightforward RFC 1071 sum, one 16-bit word at a time */
+static uint32_t chksum_ref_add(uint32_t sum, const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		sum += (i % 2) ? data[i] : (data[i] << 8);
+	}
+
+	return sum;
+}
+
+static uint16_t chksum_ref_fold(uint32_t sum)
+{
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return htons(~sum & 0xffff);
+}
+
+#define CHKSUM_PAYLOAD_LEN 301
+
+static uint8_t chksum_data[NET_IPV6H_LEN + NET_UDPH_LEN + CHKSUM_PAYLOAD_LEN];
+
+static void chksum_data_setup(void)
+{
+	struct net_ipv6_hdr *ip = (struct net_ipv6_hdr *)chksum_data;
+	struct net_udp_hdr *udp =
+		(struct net_udp_hdr *)(chksum_data + NET_IPV6H_LEN);
+	uint16_t len = NET_UDPH_LEN + CHKSUM_PAYLOAD_LEN;
+
+	for (int i = 0; i < sizeof(chksum_data); i++) {
+		chksum_data[i] = (i * 7 + 0xf0) & 0xff;
+	}
+
+	ip->vtc = 0x60;
+	ip->nexthdr = IPPROTO_UDP;
+	ip->len = htons(len);
+	udp->len = htons(len);
+	udp->chksum = 0U;
+}
+
+static uint16_t chksum_data_ref(void)
+{
+	uint16_t len = NET_UDPH_LEN + CHKSUM_PAYLOAD_LEN;
+	uint32_t sum = len + IPPROTO_UDP;
+
+	sum = chksum_ref_add(sum, chksum_data + 8, 32);
+	sum = chksum_ref_add(sum, chksum_data + NET_IPV6H_LEN, len);
+
+	return chksum_ref_fold(sum);
+}
+
+/* Build the packet out of fragments of the given sizes, the last one
+ * holding the rest of the data.
+ */
+static struct net_pkt *chksum_pkt_build(const size_t *frags, int count)
+{
+	struct net_pkt *pkt;
+	size_t offset = 0;
+
+	pkt = net_pkt_alloc(K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	for (int i = 0; i <= count; i++) {
+		size_t len = (i < count) ? frags[i] :
+			     sizeof(chksum_data) - offset;
+		struct net_buf *frag;
+
+		frag = net_pkt_get_frag(pkt, K_NO_WAIT);
+		zassert_not_null(frag, "Cannot allocate frag");
+		zassert_true(len <= net_buf_tailroom(frag), "Frag too long");
+
+		net_buf_add_mem(frag, chksum_data + offset, len);
+		net_pkt_frag_add(pkt, frag);
+		offset += len;
+	}
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV6H_LEN);
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+void test_chksum(void)
+{
+	static const size_t splits[][4] = {
+		{ 48, 100, 100, 0 },
+		{ 49, 1, 127, 73 },
+		{ 41, 7, 125, 127 },
+		{ 55, 1, 127, 127 },
+		{ 48, 0, 99, 127 },
+	};
+	uint16_t expected;
+
+	chksum_data_setup();
+	expected = chksum_data_ref();
+
+	for (int i = 0; i < ARRAY_SIZE(splits); i++) {
+		struct net_pkt *pkt = chksum_pkt_build(splits[i], 4);
+
+		zassert_equal(net_calc_chksum(pkt, IPPROTO_UDP), expected,
+			      "Wrong checksum with split %d", i);
+
+		net_pkt_unref(pkt);
+	}
+}
+
+void test_chksum_update(void)
+{
+	uint8_t hdr[NET_IPV4H_LEN] = {
+		0x45, 0x00, 0x00, 0x54, 0x12, 0x34, 0x40, 0x00,
+		0x40, 0x01, 0x00, 0x00, 0xc0, 0x00, 0x02, 0x01,
+		0xc6, 0x33, 0x64, 0x07,
+	};
+	struct net_ipv4_hdr *ip = (struct net_ipv4_hdr *)hdr;
+	struct in_addr addr = { { { 203, 0, 113, 254 } } };
+	struct in_addr old_addr;
+	uint16_t old_word, new_word;
+	uint16_t chksum;
+
+	ip->chksum = chksum_ref_fold(chksum_ref_add(0, hdr, sizeof(hdr)));
+
+	/* TTL decrement, as done when forwarding */
+	memcpy(&old_word, &ip->ttl, sizeof(old_word));
+	ip->ttl--;
+	memcpy(&new_word, &ip->ttl, sizeof(new_word));
+
+	chksum = net_chksum_update16(ip->chksum, old_word, new_word);
+
+	ip->chksum = 0U;
+	zassert_equal(chksum,
+		      chksum_ref_fold(chksum_ref_add(0, hdr, sizeof(hdr))),
+		      "Wrong checksum after TTL update");
+	ip->chksum = chksum;
+
+	/* Source address rewrite, as done by NAT */
+	memcpy(&old_addr, ip->src, sizeof(old_addr));
+	memcpy(ip->src, &addr, sizeof(addr));
+
+	chksum = net_chksum_update(ip->chksum, &old_addr, &addr, sizeof(addr));
+
+	ip->chksum = 0U;
+	zassert_equal(chksum,
+		      chksum_ref_fold(chksum_ref_add(0, hdr, sizeof(hdr))),
+		      "Wrong checksum after address update");
+}
+
+static struct net_pkt *chksum_pkt_alloc(void)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc(K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV6H_LEN);
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	zassert_ok(net_pkt_alloc_buffer(pkt, CHKSUM_PAYLOAD_LEN, IPPROTO_UDP,
+					K_NO_WAIT),
+		   "Cannot allocate buffer");
+
+	return pkt;
+}
+
+void test_chksum_copy(void)
+{
+#if defined(CONFIG_NET_PKT_CHKSUM_COPY)
+	static const size_t split[] = { 48, 57, 127 };
+	const uint8_t *payload = chksum_data + NET_IPV6H_LEN + NET_UDPH_LEN;
+	struct net_pkt *src, *pkt;
+	uint16_t expected;
+
+	chksum_data_setup();
+	expected = chksum_data_ref();
+
+	/* Payload written in pieces of odd length */
+	pkt = chksum_pkt_alloc();
+
+	zassert_ok(net_pkt_write(pkt, chksum_data,
+				 NET_IPV6H_LEN + NET_UDPH_LEN),
+		   "Cannot write headers");
+
+	net_pkt_chksum_copy_begin(pkt);
+	zassert_ok(net_pkt_write(pkt, payload, 1), "Cannot write");
+	zassert_ok(net_pkt_write(pkt, payload + 1, 100), "Cannot write");
+	zassert_ok(net_pkt_write(pkt, payload + 101,
+				 CHKSUM_PAYLOAD_LEN - 101), "Cannot write");
+	net_pkt_chksum_copy_end(pkt);
+
+	zassert_equal(pkt->chksum_len, CHKSUM_PAYLOAD_LEN,
+		      "Payload not summed");
+	zassert_equal(net_calc_chksum(pkt, IPPROTO_UDP), expected,
+		      "Wrong checksum after write");
+
+	net_pkt_unref(pkt);
+
+	/* Payload copied, from an odd offset, out of a packet with odd
+	 * fragment sizes
+	 */
+	src = chksum_pkt_build(split, ARRAY_SIZE(split));
+	net_pkt_set_overwrite(src, true);
+	net_pkt_skip(src, NET_IPV6H_LEN + NET_UDPH_LEN + 3);
+
+	pkt = chksum_pkt_alloc();
+
+	zassert_ok(net_pkt_write(pkt, chksum_data,
+				 NET_IPV6H_LEN + NET_UDPH_LEN + 3),
+		   "Cannot write headers");
+
+	net_pkt_chksum_copy_begin(pkt);
+	zassert_ok(net_pkt_copy(pkt, src, CHKSUM_PAYLOAD_LEN - 3),
+		   "Cannot copy");
+	net_pkt_chksum_copy_end(pkt);
+
+	zassert_equal(pkt->chksum_len, CHKSUM_PAYLOAD_LEN - 3,
+		      "Payload not summed");
+	zassert_equal(net_calc_chksum(pkt, IPPROTO_UDP), expected,
+		      "Wrong checksum after copy");
+
+	net_pkt_unref(src);
+	net_pkt_unref(pkt);
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_utils_fn,
 			 ztest_user_unit_test(test_net_addr),
-			 ztest_unit_test(test_addr_parse));
+			 ztest_unit_test(test_addr_parse),
+			 ztest_unit_test(test_chksum),
+			 ztest_unit_test(test_chksum_update),
+			 ztest_unit_test(test_chksum_copy));
 
 	ztest_run_test_suite(test_utils_fn);
 }